@@ -30,6 +30,9 @@ extern int32_t tsS3BlockSize;
 extern int32_t tsS3BlockCacheSize;
 extern int32_t tsS3PageCacheSize;
 extern int32_t tsS3UploadDelaySec;
+extern char    tsS3CacheDir[];
+extern int32_t tsS3CacheSizeMB;
+extern int32_t tsS3CacheReadAhead;
 
 int32_t s3Init();
 void    s3CleanUp();
@@ -21,6 +21,7 @@
 #define TSDB_COLUMN_ENCODE_XOR      "delta-i"
 #define TSDB_COLUMN_ENCODE_RLE      "bit-packing"
 #define TSDB_COLUMN_ENCODE_DELTAD   "delta-d"
+#define TSDB_COLUMN_ENCODE_DICT     "dict"
 #define TSDB_COLUMN_ENCODE_DISABLED "disabled"
 
 #define TSDB_COLUMN_COMPRESS_UNKNOWN  "unknown"
@@ -41,6 +42,7 @@
 #define TSDB_COLVAL_ENCODE_XOR      2
 #define TSDB_COLVAL_ENCODE_RLE      3
 #define TSDB_COLVAL_ENCODE_DELTAD   4
+#define TSDB_COLVAL_ENCODE_DICT     5
 #define TSDB_COLVAL_ENCODE_DISABLED 0xff
 
 #define TSDB_COLVAL_COMPRESS_NOCHANGE 0
@@ -61,7 +63,7 @@
 #define TSDB_CL_COMPRESS_OPTION_LEN 12
 #define TSDB_CL_OPTION_LEN          9
 
-extern const char* supportedEncode[5];
+extern const char* supportedEncode[6];
 extern const char* supportedCompress[6];
 extern const char* supportedLevel[3];
 
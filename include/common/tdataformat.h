@@ -173,6 +173,12 @@ typedef struct {
   int32_t  dataCompressedSize;
 } SColDataCompressInfo;
 
+// the dictionary codes of a decompressed dict encoded column, kept by the caller of tColDataDecompressWithDict
+typedef struct {
+  int32_t  nEntry;  // # of dictionary entries, 0 if the column is not dict encoded
+  int32_t *aCode;   // dictionary code of each row, -1 for the rows without data
+} SColDataDict;
+
 typedef void *(*xMallocFn)(void *, int32_t);
 
 void    tColDataDestroy(void *ph);
@@ -190,6 +196,8 @@ extern void (*tColDataCalcSMA[])(SColData *pColData, int64_t *sum, int64_t *max,
 
 int32_t tColDataCompress(SColData *colData, SColDataCompressInfo *info, SBuffer *output, SBuffer *assist);
 int32_t tColDataDecompress(void *input, SColDataCompressInfo *info, SColData *colData, SBuffer *assist);
+int32_t tColDataDecompressWithDict(void *input, SColDataCompressInfo *info, SColData *colData, SColDataDict *pDict,
+                                   SBuffer *assist);
 
 // for stmt bind
 int32_t tColDataAddValueByBind(SColData *pColData, TAOS_MULTI_BIND *pBind, int32_t buffMaxLen);
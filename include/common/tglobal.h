@@ -74,6 +74,13 @@ extern int32_t tsNumOfRpcSessions;
 extern int32_t tsTimeToGetAvailableConn;
 extern int32_t tsKeepAliveIdle;
 extern int32_t tsNumOfCommitThreads;
+extern int32_t tsNumOfApplyThreads;
+extern int32_t tsCommitFileSetConcurrency;
+extern int32_t tsNumOfReplayThreads;
+extern int32_t tsReplayBufferSizeMB;
+extern int32_t tsBufPoolHugePage;
+extern int32_t tsBufPoolNumaNode;
+extern int32_t tsSttMergePolicy;
 extern int32_t tsNumOfTaskQueueThreads;
 extern int32_t tsNumOfMnodeQueryThreads;
 extern int32_t tsNumOfMnodeFetchThreads;
@@ -88,12 +95,14 @@ extern int32_t tsNumOfSnodeStreamThreads;
 extern int32_t tsNumOfSnodeWriteThreads;
 extern int64_t tsQueueMemoryAllowed;
 extern int32_t tsRetentionSpeedLimitMB;
+extern int32_t tsIoRateLimitMB;
 
 // sync raft
 extern int32_t tsElectInterval;
 extern int32_t tsHeartbeatInterval;
 extern int32_t tsHeartbeatTimeout;
 extern int32_t tsSnapReplMaxWaitN;
+extern int32_t tsSyncLogReplMaxBatchN;
 
 // arbitrator
 extern int32_t tsArbHeartBeatIntervalSec;
@@ -159,6 +168,10 @@ extern int32_t tsCacheLazyLoadThreshold;  // cost threshold for last/last_row lo
 // query client
 extern int32_t tsQueryPolicy;
 extern int32_t tsQueryRspPolicy;
+extern int32_t tsQueryPrefetchBlocks;
+extern int32_t tsColDataCacheSize;
+extern int32_t tsLastCacheBackend;
+extern int32_t tsLastCacheWarmupTables;
 extern int64_t tsQueryMaxConcurrentTables;
 extern int32_t tsQuerySmaOptimize;
 extern int32_t tsQueryRsmaTolerance;
@@ -203,6 +216,8 @@ extern uint32_t tsMaxRange;
 extern uint32_t tsCurRange;
 extern bool     tsIfAdtFse;
 extern char     tsCompressor[];
+extern bool     tsCompressAdaptive;
+extern int32_t  tsCompressSampleRows;
 
 // tfs
 extern int32_t  tsDiskCfgNum;
@@ -231,6 +246,8 @@ extern int64_t tsmaDataDeleteMark;
 
 // wal
 extern int64_t tsWalFsyncDataSizeLimit;
+extern int32_t tsWalGroupCommitUs;
+extern char    tsWalCompressor[];
 
 // internal
 extern int32_t tsTransPullupInterval;
@@ -169,6 +169,8 @@ typedef union {
 
 typedef void (*TsdReaderNotifyCbFn)(ETsdReaderNotifyType type, STsdReaderNotifyInfo* info, void* param);
 
+struct SFilterInfo;
+
 typedef struct TsdReader {
   int32_t      (*tsdReaderOpen)(void* pVnode, SQueryTableDataCond* pCond, void* pTableList, int32_t numOfTables,
                            SSDataBlock* pResBlock, void** ppReader, const char* idstr, SHashObj** pIgnoreTables);
@@ -179,6 +181,7 @@ typedef struct TsdReader {
 
   int32_t      (*tsdReaderRetrieveBlockSMAInfo)();
   SSDataBlock *(*tsdReaderRetrieveDataBlock)();
+  int32_t      (*tsdReaderRetrieveRemainCols)(void* pReader, bool load);
 
   void         (*tsdReaderReleaseDataBlock)();
 
@@ -189,6 +192,8 @@ typedef struct TsdReader {
 
   void         (*tsdSetFilesetDelimited)(void* pReader);
   void         (*tsdSetSetNotifyCb)(void* pReader, TsdReaderNotifyCbFn notifyFn, void* param);
+  void         (*tsdSetFilterInfo)(void* pReader, struct SFilterInfo* pFilterInfo);
+  int32_t      (*tsdSetZeroCopy)(void* pReader, bool zeroCopy);
 } TsdReader;
 
 typedef struct SStoreCacheReader {
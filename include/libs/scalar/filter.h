@@ -59,6 +59,10 @@ extern int32_t filterConverNcharColumns(SFilterInfo *pFilterInfo, int32_t rows,
 extern int32_t filterFreeNcharColumns(SFilterInfo *pFilterInfo);
 extern void    filterFreeInfo(SFilterInfo *info);
 extern bool    filterRangeExecute(SFilterInfo *info, SColumnDataAgg *pColsAgg, int32_t numOfCols, int32_t numOfRows);
+extern bool    filterHasColRange(SFilterInfo *info);
+extern bool    filterGetDictColId(SFilterInfo *info, int16_t *colId);
+extern int32_t filterExecuteOnDict(SFilterInfo *info, SColumnInfoData *pDict, int32_t numOfEntries, int8_t *pRes,
+                                   int32_t *numOfQualified);
 
 /* condition split interface */
 int32_t filterPartitionCond(SNode **pCondition, SNode **pPrimaryKeyCond, SNode **pTagIndexCond, SNode **pTagCond,
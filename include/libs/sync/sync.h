@@ -41,6 +41,8 @@ extern "C" {
 
 #define SYNC_MAX_RETRY_BACKOFF         5
 #define SYNC_LOG_REPL_RETRY_WAIT_MS    100
+#define SYNC_LOG_REPL_MAX_BATCH_N      1024
+#define SYNC_LOG_REPL_MAX_BATCH_BYTES  (1024 * 1024)
 #define SYNC_APPEND_ENTRIES_TIMEOUT_MS 10000
 #define SYNC_HEART_TIMEOUT_MS          1000 * 15
 
@@ -222,10 +224,13 @@ typedef struct SSyncLogStore {
 
   SyncIndex (*syncLogWriteIndex)(struct SSyncLogStore* pLogStore);
   SyncIndex (*syncLogLastIndex)(struct SSyncLogStore* pLogStore);
+  SyncIndex (*syncLogSyncedIndex)(struct SSyncLogStore* pLogStore, bool forceSync);
   SyncIndex (*syncLogIndexRetention)(struct SSyncLogStore* pLogStore, int64_t bytes);
   SyncTerm (*syncLogLastTerm)(struct SSyncLogStore* pLogStore);
 
   int32_t (*syncLogAppendEntry)(struct SSyncLogStore* pLogStore, SSyncRaftEntry* pEntry, bool forcSync);
+  int32_t (*syncLogWriteEntry)(struct SSyncLogStore* pLogStore, SSyncRaftEntry* pEntry);
+  void (*syncLogFlush)(struct SSyncLogStore* pLogStore, bool forceSync);
   int32_t (*syncLogGetEntry)(struct SSyncLogStore* pLogStore, SyncIndex index, SSyncRaftEntry** ppEntry);
   int32_t (*syncLogTruncate)(struct SSyncLogStore* pLogStore, SyncIndex fromIndex);
 
@@ -34,6 +34,7 @@ extern "C" {
 // clang-format on
 
 #define WAL_PROTO_VER     0
+#define WAL_PROTO_VER_CMPR 1  // the body is compressed, led by SWalCmprHead
 #define WAL_NOSUFFIX_LEN  20
 #define WAL_SUFFIX_AT     (WAL_NOSUFFIX_LEN + 1)
 #define WAL_LOG_SUFFIX    "log"
@@ -50,6 +51,12 @@ typedef enum {
   TAOS_WAL_FSYNC = 2,
 } EWalType;
 
+typedef enum {
+  TAOS_WAL_CMPR_NONE = 0,
+  TAOS_WAL_CMPR_LZ4 = 1,
+  TAOS_WAL_CMPR_ZSTD = 2,
+} EWalCmpr;
+
 typedef struct {
   int32_t  vgId;
   int32_t  fsyncPeriod;      // millisecond
@@ -61,6 +68,7 @@ typedef struct {
   int32_t  encryptAlgorithm;
   char     encryptKey[ENCRYPT_KEY_LEN + 1];
   int8_t   clearFiles;
+  int8_t   compressor;  // EWalCmpr of the bodies written
 } SWalCfg;
 
 typedef struct {
@@ -100,8 +108,16 @@ typedef struct {
   uint32_t cksumBody;
   SWalCont head;
 } SWalCkHead;
+
+typedef struct {
+  int8_t  compressor;
+  int32_t rawLen;
+} SWalCmprHead;
 #pragma pack(pop)
 
+// called by the wal flush thread when the logs until ver are fsynced by the group commit
+typedef void (*FWalSynced)(int64_t param, int64_t ver);
+
 typedef struct SWal {
   // cfg
   SWalCfg cfg;
@@ -117,13 +133,25 @@ typedef struct SWal {
   // status
   int64_t totSize;
   int64_t lastRollSeq;
+  int32_t logGen;  // changed when the logs may be rewritten, by rollback or restore from snapshot
   // ctl
   int64_t       refId;
   TdThreadMutex mutex;
+  // group commit
+  int64_t    syncedVer;  // the logs until syncedVer are fsynced
+  int8_t     syncPending;
+  int32_t    syncCode;  // the error of a failed fsync, no more logs are taken as fsynced or written then
+  FWalSynced syncedFp;
+  int64_t    syncedParam;
   // ref
   SHashObj *pRefHash;  // refId -> SWalRef
+  // blocks of the idx files shared by the readers
+  struct SLRUCache *pIdxCache;
   // path
   char path[WAL_PATH_LEN];
+  // reusable compress buffer
+  void   *pCmprBuf;
+  int32_t cmprBufLen;
   // reusable write head
   SWalCkHead writeHead;
 } SWal;
@@ -168,6 +196,7 @@ void    walCleanUp();
 // handle open and ctl
 SWal   *walOpen(const char *path, SWalCfg *pCfg);
 int32_t walAlter(SWal *, SWalCfg *pCfg);
+EWalCmpr walGetCompressor(const char *name);
 int32_t walPersist(SWal *);
 void    walClose(SWal *);
 
@@ -183,6 +212,9 @@ int32_t walWriteWithSyncInfo(SWal *, int64_t index, tmsg_t msgType, SWalSyncInfo
 int64_t walAppendLog(SWal *, int64_t index, tmsg_t msgType, SWalSyncInfo syncMeta, const void *body, int32_t bodyLen);
 
 void walFsync(SWal *, bool force);
+// group commit
+int64_t walGetSyncedVer(SWal *);
+void    walSetSyncedCb(SWal *, FWalSynced fp, int64_t param);
 
 // apis for lifecycle management
 int32_t walCommit(SWal *, int64_t ver);
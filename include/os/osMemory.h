@@ -53,6 +53,15 @@ void    taosPrintBackTrace();
 void    taosMemoryTrim(int32_t size);
 void   *taosMemoryMallocAlign(uint32_t alignment, int64_t size);
 
+#define TD_HUGE_PAGE_NONE 0  // plain anonymous mapping
+#define TD_HUGE_PAGE_THP  1  // transparent huge pages advised by madvise
+#define TD_HUGE_PAGE_2M   2  // reserved 2MB huge pages, fall back to TD_HUGE_PAGE_THP
+#define TD_HUGE_PAGE_1G   3  // reserved 1GB huge pages, fall back to TD_HUGE_PAGE_THP
+
+void   *taosMemoryMapHuge(int64_t size, int32_t hugePage, int64_t *pMapSize);
+void    taosMemoryUnmap(void *ptr, int64_t mapSize);
+int32_t taosMemoryBindNode(void *ptr, int64_t mapSize, int32_t node);
+
 #define taosMemoryFreeClear(ptr)   \
   do {                             \
     if (ptr) {                     \
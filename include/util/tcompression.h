@@ -155,6 +155,8 @@ int32_t getWordLength(char type);
 int32_t tsDecompressIntImpl_Hw(const char *const input, const int32_t nelements, char *const output, const char type);
 int32_t tsDecompressFloatImplAvx512(const char *const input, const int32_t nelements, char *const output);
 int32_t tsDecompressFloatImplAvx2(const char *const input, const int32_t nelements, char *const output);
+int32_t tsDecompressDoubleImplAvx512(const char *const input, const int32_t nelements, char *const output);
+int32_t tsDecompressDoubleImplAvx2(const char *const input, const int32_t nelements, char *const output);
 int32_t tsDecompressTimestampAvx512(const char *const input, const int32_t nelements, char *const output,
                                     bool bigEndian);
 int32_t tsDecompressTimestampAvx2(const char *const input, const int32_t nelements, char *const output, bool bigEndian);
@@ -204,6 +206,8 @@ int32_t getWordLength(char type);
 int32_t tsDecompressIntImpl_Hw(const char *const input, const int32_t nelements, char *const output, const char type);
 int32_t tsDecompressFloatImplAvx512(const char *const input, const int32_t nelements, char *const output);
 int32_t tsDecompressFloatImplAvx2(const char *const input, const int32_t nelements, char *const output);
+int32_t tsDecompressDoubleImplAvx512(const char *const input, const int32_t nelements, char *const output);
+int32_t tsDecompressDoubleImplAvx2(const char *const input, const int32_t nelements, char *const output);
 int32_t tsDecompressTimestampAvx512(const char *const input, const int32_t nelements, char *const output,
                                     bool bigEndian);
 int32_t tsDecompressTimestampAvx2(const char *const input, const int32_t nelements, char *const output, bool bigEndian);
@@ -251,6 +255,7 @@ typedef enum {
   L1_XOR,
   L1_RLE,
   L1_DELTAD,
+  L1_DICT,
   L1_DISABLED = 0xFF,
 } TCmprL1Type;
 
@@ -17,8 +17,9 @@
 #include "tcompression.h"
 #include "tutil.h"
 
-const char* supportedEncode[5] = {TSDB_COLUMN_ENCODE_SIMPLE8B, TSDB_COLUMN_ENCODE_XOR, TSDB_COLUMN_ENCODE_RLE,
-                                  TSDB_COLUMN_ENCODE_DELTAD, TSDB_COLUMN_ENCODE_DISABLED};
+const char* supportedEncode[6] = {TSDB_COLUMN_ENCODE_SIMPLE8B, TSDB_COLUMN_ENCODE_XOR,
+                                  TSDB_COLUMN_ENCODE_RLE,      TSDB_COLUMN_ENCODE_DELTAD,
+                                  TSDB_COLUMN_ENCODE_DICT,     TSDB_COLUMN_ENCODE_DISABLED};
 
 const char* supportedCompress[6] = {TSDB_COLUMN_COMPRESS_LZ4,  TSDB_COLUMN_COMPRESS_TSZ,
                                     TSDB_COLUMN_COMPRESS_XZ,   TSDB_COLUMN_COMPRESS_ZLIB,
@@ -127,6 +128,9 @@ const char* columnEncodeStr(uint8_t type) {
     case TSDB_COLVAL_ENCODE_DELTAD:
       encode = TSDB_COLUMN_ENCODE_DELTAD;
       break;
+    case TSDB_COLVAL_ENCODE_DICT:
+      encode = TSDB_COLUMN_ENCODE_DICT;
+      break;
     case TSDB_COLVAL_ENCODE_DISABLED:
       encode = TSDB_COLUMN_ENCODE_DISABLED;
       break;
@@ -209,6 +213,8 @@ uint8_t columnEncodeVal(const char* encode) {
     e = TSDB_COLVAL_ENCODE_RLE;
   } else if (0 == strcmp(encode, TSDB_COLUMN_ENCODE_DELTAD)) {
     e = TSDB_COLVAL_ENCODE_DELTAD;
+  } else if (0 == strcmp(encode, TSDB_COLUMN_ENCODE_DICT)) {
+    e = TSDB_COLVAL_ENCODE_DICT;
   } else if (0 == strcmp(encode, TSDB_COLUMN_ENCODE_DISABLED)) {
     e = TSDB_COLVAL_ENCODE_DISABLED;
   } else {
@@ -358,6 +364,7 @@ int8_t validColCompress(uint8_t type, uint8_t l2) {
 // | timestamp/bigint/ubigint | delta-i  |
 // | bool  |  bit-packing   |
 // | flout/double | delta-d |
+// | varchar/nchar | dict |
 //
 int8_t validColEncode(uint8_t type, uint8_t l1) {
   if (l1 == TSDB_COLVAL_ENCODE_NOCHANGE) {
@@ -371,6 +378,8 @@ int8_t validColEncode(uint8_t type, uint8_t l1) {
     return TSDB_COLVAL_ENCODE_SIMPLE8B == l1 || TSDB_COLVAL_ENCODE_XOR == l1 ? 1 : 0;
   } else if (type >= TSDB_DATA_TYPE_FLOAT && type <= TSDB_DATA_TYPE_DOUBLE) {
     return TSDB_COLVAL_ENCODE_DELTAD == l1 ? 1 : 0;
+  } else if (type == TSDB_DATA_TYPE_VARCHAR || type == TSDB_DATA_TYPE_NCHAR) {
+    return l1 == TSDB_COLVAL_ENCODE_DISABLED || l1 == TSDB_COLVAL_ENCODE_DICT ? 1 : 0;
   } else if ((type == TSDB_DATA_TYPE_VARCHAR || type == TSDB_DATA_TYPE_NCHAR) || type == TSDB_DATA_TYPE_JSON ||
              type == TSDB_DATA_TYPE_VARBINARY || type == TSDB_DATA_TYPE_BINARY || type == TSDB_DATA_TYPE_GEOMETRY) {
     return l1 == TSDB_COLVAL_ENCODE_DISABLED ? 1 : 0;
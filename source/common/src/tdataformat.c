@@ -17,6 +17,7 @@
 #include "tdataformat.h"
 #include "tRealloc.h"
 #include "tdatablock.h"
+#include "tglobal.h"
 #include "tlog.h"
 
 static int32_t (*tColDataAppendValueImpl[8][3])(SColData *pColData, uint8_t *pData, uint32_t nData);
@@ -2736,6 +2737,335 @@ _exit:
   return code;
 }
 
+// dictionary encoding ================================
+#define DICT_CODE_EMPTY (-1)
+
+/**
+ * @brief Encode a var-length column as the distinct values and a code for each row. The codes take the place of the
+ * offsets, and the dictionary, i.e. number of entries, offset of each entry and the entries, takes the place of the
+ * data. Nothing is encoded if there are too many distinct values for the dictionary to pay off.
+ */
+static int32_t tColDataDictEncode(SColData *colData, SBuffer *codes, SBuffer *dict, bool *encoded) {
+  int32_t code = 0;
+  int32_t nEntry = 0;
+  int32_t maxEntry = colData->nVal / 2;
+  SBuffer entries, bytes;
+
+  *encoded = false;
+  if (colData->nData <= 0 || maxEntry <= 0) {
+    return 0;
+  }
+
+  SHashObj *pHash = taosHashInit(64, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY), false, HASH_NO_LOCK);
+  if (pHash == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  tBufferInit(&entries);
+  tBufferInit(&bytes);
+  tBufferClear(codes);
+  tBufferClear(dict);
+
+  code = tBufferEnsureCapacity(codes, sizeof(int32_t) * colData->nVal);
+  if (code) goto _exit;
+
+  for (int32_t i = 0; i < colData->nVal; i++) {
+    int32_t offset = colData->aOffset[i];
+    int32_t len = ((i + 1 < colData->nVal) ? colData->aOffset[i + 1] : colData->nData) - offset;
+    int32_t dictCode = DICT_CODE_EMPTY;
+
+    if (len > 0) {
+      int32_t *pCode = taosHashGet(pHash, colData->pData + offset, len);
+      if (pCode) {
+        dictCode = *pCode;
+      } else if (nEntry < maxEntry) {
+        dictCode = nEntry++;
+        if ((code = taosHashPut(pHash, colData->pData + offset, len, &dictCode, sizeof(dictCode)))) goto _exit;
+        if ((code = tBufferPutI32(&entries, bytes.size))) goto _exit;
+        if ((code = tBufferPut(&bytes, colData->pData + offset, len))) goto _exit;
+      } else {
+        goto _exit;
+      }
+    }
+
+    if ((code = tBufferPutI32(codes, dictCode))) goto _exit;
+  }
+
+  if ((code = tBufferPutI32(dict, nEntry))) goto _exit;
+  if ((code = tBufferPut(dict, entries.data, entries.size))) goto _exit;
+  if ((code = tBufferPut(dict, bytes.data, bytes.size))) goto _exit;
+  *encoded = (dict->size < colData->nData);
+
+_exit:
+  taosHashCleanup(pHash);
+  tBufferDestroy(&entries);
+  tBufferDestroy(&bytes);
+  return code;
+}
+
+// restore the offsets and data of a var-length column from the codes in aOffset and the dictionary, the codes are kept
+// in pDict if it is not NULL
+static int32_t tColDataDictDecode(SColData *colData, const uint8_t *dict, int32_t dictSize, SColDataDict *pDict) {
+  int32_t nEntry = 0;
+  int32_t nData = 0;
+
+  if (dictSize < sizeof(int32_t)) {
+    return TSDB_CODE_FILE_CORRUPTED;
+  }
+  memcpy(&nEntry, dict, sizeof(int32_t));
+  if (nEntry < 0 || dictSize < sizeof(int32_t) * (nEntry + 1)) {
+    return TSDB_CODE_FILE_CORRUPTED;
+  }
+
+  const int32_t *entryOffset = (const int32_t *)(dict + sizeof(int32_t));
+  const uint8_t *bytes = dict + sizeof(int32_t) * (nEntry + 1);
+  int32_t        nBytes = dictSize - sizeof(int32_t) * (nEntry + 1);
+
+#define DICT_ENTRY_LEN(c) ((((c) + 1 < nEntry) ? entryOffset[(c) + 1] : nBytes) - entryOffset[(c)])
+
+  for (int32_t i = 0; i < colData->nVal; i++) {
+    int32_t dictCode = colData->aOffset[i];
+    if (dictCode < DICT_CODE_EMPTY || dictCode >= nEntry) {
+      return TSDB_CODE_FILE_CORRUPTED;
+    }
+    if (dictCode != DICT_CODE_EMPTY) {
+      int32_t len = DICT_ENTRY_LEN(dictCode);
+      if (entryOffset[dictCode] < 0 || len < 0 || entryOffset[dictCode] + len > nBytes) {
+        return TSDB_CODE_FILE_CORRUPTED;
+      }
+      nData += len;
+    }
+  }
+
+  if (nData > 0) {
+    int32_t code = tRealloc(&colData->pData, nData);
+    if (code) return code;
+  }
+
+  // keep the codes, so a filter can be evaluated once per distinct value instead of once per row
+  if (pDict) {
+    int32_t code = tRealloc((uint8_t **)&pDict->aCode, sizeof(int32_t) * colData->nVal);
+    if (code) return code;
+    memcpy(pDict->aCode, colData->aOffset, sizeof(int32_t) * colData->nVal);
+    pDict->nEntry = nEntry;
+  }
+
+  colData->nData = 0;
+  for (int32_t i = 0; i < colData->nVal; i++) {
+    int32_t dictCode = colData->aOffset[i];
+
+    colData->aOffset[i] = colData->nData;
+    if (dictCode != DICT_CODE_EMPTY) {
+      int32_t len = DICT_ENTRY_LEN(dictCode);
+      memcpy(colData->pData + colData->nData, bytes + entryOffset[dictCode], len);
+      colData->nData += len;
+    }
+  }
+
+#undef DICT_ENTRY_LEN
+  return 0;
+}
+
+// the codes of a dict encoded block are INT values encoded by simple8b, with the compression of the block
+static FORCE_INLINE void tColDataDictCodeCmprAlg(uint32_t cmprAlg, uint32_t *codeCmprAlg) {
+  SET_COMPRESS(L1_SIMPLE_8B, COMPRESS_L2_TYPE_U32(cmprAlg), COMPRESS_L2_TYPE_LEVEL_U32(cmprAlg), *codeCmprAlg);
+}
+
+static int32_t tColDataCompressDict(SColData *colData, SColDataCompressInfo *info, SBuffer *output, SBuffer *assist,
+                                    bool *encoded) {
+  int32_t code;
+  SBuffer codes, dict;
+
+  tBufferInit(&codes);
+  tBufferInit(&dict);
+
+  code = tColDataDictEncode(colData, &codes, &dict, encoded);
+  if (code || !(*encoded)) {
+    goto _exit;
+  }
+
+  // codes, small non-negative integers that simple8b packs into a few bits each
+  info->offsetOriginalSize = codes.size;
+  SCompressInfo cinfo = {
+      .dataType = TSDB_DATA_TYPE_INT,
+      .originalSize = info->offsetOriginalSize,
+  };
+  tColDataDictCodeCmprAlg(info->cmprAlg, &cinfo.cmprAlg);
+
+  code = tCompressDataToBuffer(codes.data, &cinfo, output, assist);
+  if (code) goto _exit;
+  info->offsetCompressedSize = cinfo.compressedSize;
+
+  // dictionary
+  info->dataOriginalSize = dict.size;
+  cinfo = (SCompressInfo){
+      .dataType = colData->type,
+      .cmprAlg = info->cmprAlg,
+      .originalSize = info->dataOriginalSize,
+  };
+
+  code = tCompressDataToBuffer(dict.data, &cinfo, output, assist);
+  if (code) goto _exit;
+  info->dataCompressedSize = cinfo.compressedSize;
+
+_exit:
+  tBufferDestroy(&codes);
+  tBufferDestroy(&dict);
+  return code;
+}
+
+static int32_t tColDataDecompressDict(void *input, SColDataCompressInfo *info, SColData *colData, SColDataDict *pDict,
+                                      SBuffer *assist) {
+  int32_t code;
+  SBuffer dict;
+
+  SCompressInfo cinfo = {
+      .cmprAlg = info->cmprAlg,
+      .dataType = colData->type,
+      .originalSize = info->dataOriginalSize,
+      .compressedSize = info->dataCompressedSize,
+  };
+
+  tBufferInit(&dict);
+  code = tDecompressDataToBuffer(input, &cinfo, &dict, assist);
+  if (code == 0) {
+    code = tColDataDictDecode(colData, dict.data, dict.size, pDict);
+  }
+
+  tBufferDestroy(&dict);
+  return code;
+}
+
+// adaptive compression ================================
+static int32_t tColDataCmprAlgCost(uint8_t l1, uint8_t l2) {
+  // relative decode cost, a cheaper candidate wins unless a costlier one saves about 6% of the size per level
+  int32_t cost = (l1 == L1_DISABLED) ? 0 : 1;
+  if (l2 == L2_LZ4) {
+    cost += 1;
+  } else if (l2 != L2_DISABLED) {
+    cost += 3;
+  }
+  return cost;
+}
+
+static int32_t tColDataGetCandidateL1(int8_t type, uint8_t l1, uint8_t *aL1) {
+  int32_t n = 0;
+
+  aL1[n++] = l1;
+  switch (type) {
+    case TSDB_DATA_TYPE_BIGINT:
+    case TSDB_DATA_TYPE_UBIGINT:
+      // both are encoded as BIGINT, which simple8b supports, while TIMESTAMP is encoded with its own type
+      if (l1 != L1_SIMPLE_8B) aL1[n++] = L1_SIMPLE_8B;
+      if (l1 != L1_XOR) aL1[n++] = L1_XOR;
+      break;
+    case TSDB_DATA_TYPE_TIMESTAMP:
+      if (l1 != L1_XOR) aL1[n++] = L1_XOR;
+      break;
+    case TSDB_DATA_TYPE_FLOAT:
+    case TSDB_DATA_TYPE_DOUBLE:
+      if (l1 != L1_DELTAD) aL1[n++] = L1_DELTAD;
+      if (l1 != L1_DISABLED) aL1[n++] = L1_DISABLED;
+      break;
+    default:
+      // encoding of the other types is fixed by the type itself
+      break;
+  }
+
+  return n;
+}
+
+/**
+ * @brief Choose the compression algorithm of a column block by compressing a prefix of its data with the candidate
+ * encode/compress pairs, the winner is returned in cmprAlg and saved with the block, so decoding needs nothing new.
+ */
+static int32_t tColDataSelectCmprAlg(SColData *colData, uint32_t *cmprAlg, SBuffer *assist) {
+  int32_t code = 0;
+
+  if (!tsCompressAdaptive || colData->nData <= 0 || (colData->flag & HAS_VALUE) == 0) {
+    return 0;
+  }
+
+  // the old style algorithms, i.e. ONE_STAGE_COMP/TWO_STAGE_COMP, are kept as they are
+  DEFINE_VAR(*cmprAlg)
+  if (l1 == L1_UNKNOWN && l2 == L2_UNKNOWN) {
+    return 0;
+  }
+
+  int32_t nSample = TMIN(colData->nVal, tsCompressSampleRows);
+  int32_t sampleSize = 0;
+  if (IS_VAR_DATA_TYPE(colData->type)) {
+    sampleSize = (nSample < colData->nVal) ? colData->aOffset[nSample] : colData->nData;
+  } else {
+    sampleSize = TMIN(colData->nData, nSample * tDataTypes[colData->type].bytes);
+  }
+  if (sampleSize <= 0) {
+    return 0;
+  }
+
+  uint8_t aL1[4];
+  uint8_t aL2[] = {l2, L2_DISABLED, L2_LZ4, L2_ZSTD};
+  int32_t nL1 = tColDataGetCandidateL1(colData->type, l1, aL1);
+
+  SBuffer sample, decoded;
+  tBufferInit(&sample);
+  tBufferInit(&decoded);
+  code = tBufferEnsureCapacity(&sample, sampleSize + COMP_OVERFLOW_BYTES);
+  if (code == 0) {
+    code = tBufferEnsureCapacity(&decoded, sampleSize);
+  }
+  if (code) {
+    tBufferDestroy(&sample);
+    tBufferDestroy(&decoded);
+    return code;
+  }
+
+  uint32_t bestAlg = *cmprAlg;
+  int64_t  bestScore = INT64_MAX;
+  for (int32_t i = 0; i < nL1; i++) {
+    for (int32_t j = 0; j < tListLen(aL2); j++) {
+      // skip the duplicated candidates of the configured one
+      if (j > 0 && aL2[j] == l2) {
+        continue;
+      }
+
+      uint32_t alg = 0;
+      SET_COMPRESS(aL1[i], aL2[j], lvl, alg);
+
+      SCompressInfo cinfo = {
+          .dataType = colData->type,
+          .cmprAlg = alg,
+          .originalSize = sampleSize,
+      };
+      code = tCompressData(colData->pData, &cinfo, sample.data, sample.capacity, assist);
+      if (code) {
+        // an encoding that does not fit the data is not a candidate
+        code = 0;
+        continue;
+      }
+
+      int64_t score = (int64_t)cinfo.compressedSize * (16 + tColDataCmprAlgCost(aL1[i], aL2[j]));
+      if (score >= bestScore) {
+        continue;
+      }
+
+      // a candidate wins only if the sample reads back as it was written
+      if (tDecompressData(sample.data, &cinfo, decoded.data, decoded.capacity, assist) != 0 ||
+          memcmp(decoded.data, colData->pData, sampleSize) != 0) {
+        continue;
+      }
+
+      bestScore = score;
+      bestAlg = alg;
+    }
+  }
+
+  tBufferDestroy(&sample);
+  tBufferDestroy(&decoded);
+  *cmprAlg = bestAlg;
+  return 0;
+}
+
 int32_t tColDataCompress(SColData *colData, SColDataCompressInfo *info, SBuffer *output, SBuffer *assist) {
   int32_t code;
   SBuffer local;
@@ -2760,6 +3090,12 @@ int32_t tColDataCompress(SColData *colData, SColDataCompressInfo *info, SBuffer
     assist = &local;
   }
 
+  code = tColDataSelectCmprAlg(colData, &info->cmprAlg, assist);
+  if (code) {
+    tBufferDestroy(&local);
+    return code;
+  }
+
   // bitmap
   if (colData->flag != HAS_VALUE) {
     if (colData->flag == (HAS_NONE | HAS_NULL | HAS_VALUE)) {
@@ -2788,6 +3124,21 @@ int32_t tColDataCompress(SColData *colData, SColDataCompressInfo *info, SBuffer
     return 0;
   }
 
+  // offset and data in dictionary
+  if (IS_VAR_DATA_TYPE(colData->type) && COMPRESS_L1_TYPE_U32(info->cmprAlg) == L1_DICT) {
+    bool encoded = false;
+
+    code = tColDataCompressDict(colData, info, output, assist, &encoded);
+    if (code || encoded) {
+      tBufferDestroy(&local);
+      return code;
+    }
+
+    // record the fallback in the block, so it can be decoded as a plain column
+    DEFINE_VAR(info->cmprAlg)
+    SET_COMPRESS(L1_DISABLED, l2, lvl, info->cmprAlg);
+  }
+
   // offset
   if (IS_VAR_DATA_TYPE(colData->type)) {
     info->offsetOriginalSize = sizeof(int32_t) * info->numOfData;
@@ -2831,6 +3182,11 @@ int32_t tColDataCompress(SColData *colData, SColDataCompressInfo *info, SBuffer
 }
 
 int32_t tColDataDecompress(void *input, SColDataCompressInfo *info, SColData *colData, SBuffer *assist) {
+  return tColDataDecompressWithDict(input, info, colData, NULL, assist);
+}
+
+int32_t tColDataDecompressWithDict(void *input, SColDataCompressInfo *info, SColData *colData, SColDataDict *pDict,
+                                   SBuffer *assist) {
   int32_t  code;
   SBuffer  local;
   uint8_t *data = (uint8_t *)input;
@@ -2839,6 +3195,9 @@ int32_t tColDataDecompress(void *input, SColDataCompressInfo *info, SColData *co
   if (assist == NULL) {
     assist = &local;
   }
+  if (pDict) {
+    pDict->nEntry = 0;
+  }
 
   tColDataClear(colData);
   colData->cid = info->columnId;
@@ -2879,7 +3238,7 @@ int32_t tColDataDecompress(void *input, SColDataCompressInfo *info, SColData *co
     goto _exit;
   }
 
-  // offset
+  // offset, or the codes of a dict encoded block
   if (info->offsetOriginalSize > 0) {
     SCompressInfo cinfo = {
         .cmprAlg = info->cmprAlg,
@@ -2887,6 +3246,9 @@ int32_t tColDataDecompress(void *input, SColDataCompressInfo *info, SColData *co
         .originalSize = info->offsetOriginalSize,
         .compressedSize = info->offsetCompressedSize,
     };
+    if (IS_VAR_DATA_TYPE(colData->type) && COMPRESS_L1_TYPE_U32(info->cmprAlg) == L1_DICT) {
+      tColDataDictCodeCmprAlg(info->cmprAlg, &cinfo.cmprAlg);
+    }
 
     code = tRealloc((uint8_t **)&colData->aOffset, cinfo.originalSize);
     if (code) {
@@ -2903,6 +3265,19 @@ int32_t tColDataDecompress(void *input, SColDataCompressInfo *info, SColData *co
     data += cinfo.compressedSize;
   }
 
+  // data in dictionary
+  if (info->dataOriginalSize > 0 && IS_VAR_DATA_TYPE(colData->type) &&
+      COMPRESS_L1_TYPE_U32(info->cmprAlg) == L1_DICT) {
+    code = tColDataDecompressDict(data, info, colData, pDict, assist);
+    if (code) {
+      tBufferDestroy(&local);
+      return code;
+    }
+
+    data += info->dataCompressedSize;
+    goto _exit;
+  }
+
   // data
   if (info->dataOriginalSize > 0) {
     colData->nData = info->dataOriginalSize;
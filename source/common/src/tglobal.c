@@ -60,6 +60,13 @@ int32_t tsTimeToGetAvailableConn = 500000;
 int32_t tsKeepAliveIdle = 60;
 
 int32_t tsNumOfCommitThreads = 2;
+int32_t tsNumOfApplyThreads = 0;  // 0 means the tables of a submit are applied serially
+int32_t tsCommitFileSetConcurrency = 1;  // file sets a vnode commit writes at the same time
+int32_t tsNumOfReplayThreads = 0;  // 0 means the wal is replayed by the apply thread alone on restore
+int32_t tsReplayBufferSizeMB = 256;  // bytes of the wal messages a vnode decodes ahead on restore at most
+int32_t tsBufPoolHugePage = 0;    // TD_HUGE_PAGE_*, 0 means the vnode buffer pools are malloced
+int32_t tsBufPoolNumaNode = -1;   // the NUMA node the vnode buffer pools are bound to, -1 means not bound
+int32_t tsSttMergePolicy = 0;     // 0: merge stt files by level, 1: pick stt files by cost
 int32_t tsNumOfTaskQueueThreads = 16;
 int32_t tsNumOfMnodeQueryThreads = 16;
 int32_t tsNumOfMnodeFetchThreads = 1;
@@ -75,12 +82,14 @@ int32_t tsNumOfSnodeWriteThreads = 1;
 int32_t tsMaxStreamBackendCache = 128;  // M
 int32_t tsPQSortMemThreshold = 16;      // M
 int32_t tsRetentionSpeedLimitMB = 0;    // unlimited
+int32_t tsIoRateLimitMB = 0;            // tsdb I/O per disk, unlimited
 
 // sync raft
 int32_t tsElectInterval = 25 * 1000;
 int32_t tsHeartbeatInterval = 1000;
 int32_t tsHeartbeatTimeout = 20 * 1000;
 int32_t tsSnapReplMaxWaitN = 128;
+int32_t tsSyncLogReplMaxBatchN = 1;  // entries in one append entries msg, 1 for the followers of old versions
 
 // mnode
 int64_t tsMndSdbWriteDelta = 200;
@@ -163,6 +172,10 @@ int32_t tmqRowSize = 4096;
 // query
 int32_t tsQueryPolicy = 1;
 int32_t tsQueryRspPolicy = 0;
+int32_t tsQueryPrefetchBlocks = 4;  // file blocks read ahead by a tsdb reader, 0 to disable
+int32_t tsColDataCacheSize = 0;     // MB, decompressed column data cache of each vnode, 0 to disable
+int32_t tsLastCacheBackend = 0;     // last/last_row cache of new vnodes, 0: rocksdb, 1: memory
+int32_t tsLastCacheWarmupTables = 0;  // tables whose last/last_row cache is loaded after vnode open, 0: disabled
 int64_t tsQueryMaxConcurrentTables = 200;  // unit is TSDB_TABLE_NUM_UNIT
 bool    tsEnableQueryHb = true;
 bool    tsEnableScience = false;  // on taos-cli show float and doulbe with scientific notation if true
@@ -254,6 +267,10 @@ uint32_t tsCurRange = 100;                      // current quantization interval
 bool     tsIfAdtFse = false;                    // ADT-FSE algorithom or original huffman algorithom
 char     tsCompressor[32] = "ZSTD_COMPRESSOR";  // ZSTD_COMPRESSOR or GZIP_COMPRESSOR
 
+// adaptive compression, select the encode and compress algorithm of each column block by sampling
+bool    tsCompressAdaptive = false;
+int32_t tsCompressSampleRows = 512;
+
 // udf
 #ifdef WINDOWS
 bool tsStartUdfd = false;
@@ -263,6 +280,8 @@ bool    tsStartUdfd = true;
 
 // wal
 int64_t tsWalFsyncDataSizeLimit = (100 * 1024 * 1024L);
+int32_t tsWalGroupCommitUs = 0;  // 0 means fsync each write of the wals with fsync period 0
+char    tsWalCompressor[16] = "none";  // none, lz4 or zstd
 
 // ttl
 bool    tsTtlChangeOnWrite = false;  // if true, ttl delete time changes on last write
@@ -312,6 +331,9 @@ int32_t tsS3BlockSize = -1;        // number of tsdb pages (4096)
 int32_t tsS3BlockCacheSize = 16;   // number of blocks
 int32_t tsS3PageCacheSize = 4096;  // number of pages
 int32_t tsS3UploadDelaySec = 60;
+char    tsS3CacheDir[PATH_MAX] = "";  // local dir caching the segments of s3 objects, empty to disable
+int32_t tsS3CacheSizeMB = 10240;
+int32_t tsS3CacheReadAhead = 4;  // segments read ahead on sequential access, 0 to disable
 
 bool tsExperimental = true;
 
@@ -664,8 +686,22 @@ static int32_t taosAddServerCfg(SConfig *pCfg) {
 
   if (cfgAddInt32(pCfg, "queryBufferSize", tsQueryBufferSize, -1, 500000000000, CFG_SCOPE_SERVER, CFG_DYN_NONE) != 0) return -1;
   if (cfgAddInt32(pCfg, "queryRspPolicy", tsQueryRspPolicy, 0, 1, CFG_SCOPE_SERVER, CFG_DYN_ENT_SERVER) != 0) return -1;
+  if (cfgAddInt32(pCfg, "queryPrefetchBlocks", tsQueryPrefetchBlocks, 0, 256, CFG_SCOPE_SERVER, CFG_DYN_ENT_SERVER) != 0) return -1;
+  if (cfgAddInt32(pCfg, "colDataCacheSize", tsColDataCacheSize, 0, 65536, CFG_SCOPE_SERVER, CFG_DYN_NONE) != 0) return -1;
+  if (cfgAddInt32(pCfg, "lastCacheBackend", tsLastCacheBackend, 0, 1, CFG_SCOPE_SERVER, CFG_DYN_NONE) != 0) return -1;
+  if (cfgAddInt32(pCfg, "lastCacheWarmupTables", tsLastCacheWarmupTables, 0, 10000000, CFG_SCOPE_SERVER,
+                  CFG_DYN_NONE) != 0)
+    return -1;
   if (cfgAddInt32(pCfg, "numOfCommitThreads", tsNumOfCommitThreads, 1, 1024, CFG_SCOPE_SERVER, CFG_DYN_NONE) != 0) return -1;
+  if (cfgAddInt32(pCfg, "numOfApplyThreads", tsNumOfApplyThreads, 0, 256, CFG_SCOPE_SERVER, CFG_DYN_NONE) != 0) return -1;
+  if (cfgAddInt32(pCfg, "commitFileSetConcurrency", tsCommitFileSetConcurrency, 1, 64, CFG_SCOPE_SERVER, CFG_DYN_NONE) != 0) return -1;
+  if (cfgAddInt32(pCfg, "numOfReplayThreads", tsNumOfReplayThreads, 0, 256, CFG_SCOPE_SERVER, CFG_DYN_NONE) != 0) return -1;
+  if (cfgAddInt32(pCfg, "replayBufferSizeMB", tsReplayBufferSizeMB, 1, 65536, CFG_SCOPE_SERVER, CFG_DYN_NONE) != 0) return -1;
+  if (cfgAddInt32(pCfg, "bufPoolHugePage", tsBufPoolHugePage, 0, 3, CFG_SCOPE_SERVER, CFG_DYN_NONE) != 0) return -1;
+  if (cfgAddInt32(pCfg, "bufPoolNumaNode", tsBufPoolNumaNode, -1, 1023, CFG_SCOPE_SERVER, CFG_DYN_NONE) != 0) return -1;
+  if (cfgAddInt32(pCfg, "sttMergePolicy", tsSttMergePolicy, 0, 1, CFG_SCOPE_SERVER, CFG_DYN_NONE) != 0) return -1;
   if (cfgAddInt32(pCfg, "retentionSpeedLimitMB", tsRetentionSpeedLimitMB, 0, 1024, CFG_SCOPE_SERVER, CFG_DYN_NONE) != 0) return -1;
+  if (cfgAddInt32(pCfg, "ioRateLimitMB", tsIoRateLimitMB, 0, 1048576, CFG_SCOPE_SERVER, CFG_DYN_NONE) != 0) return -1;
 
   if (cfgAddInt32(pCfg, "numOfMnodeReadThreads", tsNumOfMnodeReadThreads, 1, 1024, CFG_SCOPE_SERVER, CFG_DYN_NONE) != 0) return -1;
   if (cfgAddInt32(pCfg, "numOfVnodeQueryThreads", tsNumOfVnodeQueryThreads, 4, 1024, CFG_SCOPE_SERVER, CFG_DYN_NONE) != 0) return -1;
@@ -688,6 +724,7 @@ static int32_t taosAddServerCfg(SConfig *pCfg) {
   if (cfgAddInt32(pCfg, "syncHeartbeatInterval", tsHeartbeatInterval, 10, 1000 * 60 * 24 * 2, CFG_SCOPE_SERVER, CFG_DYN_NONE) != 0) return -1;
   if (cfgAddInt32(pCfg, "syncHeartbeatTimeout", tsHeartbeatTimeout, 10, 1000 * 60 * 24 * 2, CFG_SCOPE_SERVER, CFG_DYN_NONE) != 0) return -1;
   if (cfgAddInt32(pCfg, "syncSnapReplMaxWaitN", tsSnapReplMaxWaitN, 16, (TSDB_SYNC_SNAP_BUFFER_SIZE >> 2), CFG_SCOPE_SERVER, CFG_DYN_NONE) != 0) return -1;
+  if (cfgAddInt32(pCfg, "syncLogReplMaxBatchN", tsSyncLogReplMaxBatchN, 1, 1024, CFG_SCOPE_SERVER, CFG_DYN_NONE) != 0) return -1;
 
   if (cfgAddInt32(pCfg, "arbHeartBeatIntervalSec", tsArbHeartBeatIntervalSec, 1, 60 * 24 * 2, CFG_SCOPE_SERVER, CFG_DYN_NONE) != 0) return -1;
   if (cfgAddInt32(pCfg, "arbCheckSyncIntervalSec", tsArbCheckSyncIntervalSec, 1, 60 * 24 * 2, CFG_SCOPE_SERVER, CFG_DYN_NONE) != 0) return -1;
@@ -747,6 +784,8 @@ static int32_t taosAddServerCfg(SConfig *pCfg) {
   if (cfgAddInt32(pCfg, "timeseriesThreshold", tsTimeSeriesThreshold, 0, 2000, CFG_SCOPE_SERVER, CFG_DYN_ENT_SERVER) != 0) return -1;
 
   if (cfgAddInt64(pCfg, "walFsyncDataSizeLimit", tsWalFsyncDataSizeLimit, 100 * 1024 * 1024, INT64_MAX, CFG_SCOPE_SERVER, CFG_DYN_NONE) != 0) return -1;
+  if (cfgAddInt32(pCfg, "walGroupCommitUs", tsWalGroupCommitUs, 0, 100000, CFG_SCOPE_SERVER, CFG_DYN_NONE) != 0) return -1;
+  if (cfgAddString(pCfg, "walCompressor", tsWalCompressor, CFG_SCOPE_SERVER, CFG_DYN_NONE) != 0) return -1;
 
   if (cfgAddBool(pCfg, "udf", tsStartUdfd, CFG_SCOPE_SERVER, CFG_DYN_NONE) != 0) return -1;
   if (cfgAddString(pCfg, "udfdResFuncs", tsUdfdResFuncs, CFG_SCOPE_SERVER, CFG_DYN_NONE) != 0) return -1;
@@ -768,6 +807,8 @@ static int32_t taosAddServerCfg(SConfig *pCfg) {
   if (cfgAddInt32(pCfg, "curRange", tsCurRange, 0, 65536, CFG_SCOPE_SERVER, CFG_DYN_NONE) != 0) return -1;
   if (cfgAddBool(pCfg, "ifAdtFse", tsIfAdtFse, CFG_SCOPE_SERVER, CFG_DYN_NONE) != 0) return -1;
   if (cfgAddString(pCfg, "compressor", tsCompressor, CFG_SCOPE_SERVER, CFG_DYN_NONE) != 0) return -1;
+  if (cfgAddBool(pCfg, "compressAdaptive", tsCompressAdaptive, CFG_SCOPE_SERVER, CFG_DYN_NONE) != 0) return -1;
+  if (cfgAddInt32(pCfg, "compressSampleRows", tsCompressSampleRows, 16, 65536, CFG_SCOPE_SERVER, CFG_DYN_NONE) != 0) return -1;
 
   if (cfgAddBool(pCfg, "filterScalarMode", tsFilterScalarMode, CFG_SCOPE_SERVER, CFG_DYN_NONE) != 0) return -1;
   if (cfgAddInt32(pCfg, "maxStreamBackendCache", tsMaxStreamBackendCache, 16, 1024, CFG_SCOPE_SERVER, CFG_DYN_ENT_SERVER) != 0) return -1;
@@ -780,6 +821,9 @@ static int32_t taosAddServerCfg(SConfig *pCfg) {
 
   if (cfgAddInt32(pCfg, "s3PageCacheSize", tsS3PageCacheSize, 4, 1024 * 1024 * 1024, CFG_SCOPE_SERVER, CFG_DYN_ENT_SERVER) != 0) return -1;
   if (cfgAddInt32(pCfg, "s3UploadDelaySec", tsS3UploadDelaySec, 1, 60 * 60 * 24 * 30, CFG_SCOPE_SERVER, CFG_DYN_ENT_SERVER) != 0) return -1;
+  if (cfgAddString(pCfg, "s3CacheDir", tsS3CacheDir, CFG_SCOPE_SERVER, CFG_DYN_NONE) != 0) return -1;
+  if (cfgAddInt32(pCfg, "s3CacheSizeMB", tsS3CacheSizeMB, 0, 1024 * 1024 * 1024, CFG_SCOPE_SERVER, CFG_DYN_NONE) != 0) return -1;
+  if (cfgAddInt32(pCfg, "s3CacheReadAhead", tsS3CacheReadAhead, 0, 64, CFG_SCOPE_SERVER, CFG_DYN_NONE) != 0) return -1;
 
   // min free disk space used to check if the disk is full [50MB, 1GB]
   if (cfgAddInt64(pCfg, "minDiskFreeSize", tsMinDiskFreeSize, TFS_MIN_DISK_FREE_SIZE, 1024 * 1024 * 1024, CFG_SCOPE_SERVER, CFG_DYN_ENT_SERVER) != 0) return -1;
@@ -1130,7 +1174,15 @@ static int32_t taosSetServerCfg(SConfig *pCfg) {
   tsTimeToGetAvailableConn = cfgGetItem(pCfg, "timeToGetAvailableConn")->i32;
 
   tsNumOfCommitThreads = cfgGetItem(pCfg, "numOfCommitThreads")->i32;
+  tsNumOfApplyThreads = cfgGetItem(pCfg, "numOfApplyThreads")->i32;
+  tsCommitFileSetConcurrency = cfgGetItem(pCfg, "commitFileSetConcurrency")->i32;
+  tsNumOfReplayThreads = cfgGetItem(pCfg, "numOfReplayThreads")->i32;
+  tsReplayBufferSizeMB = cfgGetItem(pCfg, "replayBufferSizeMB")->i32;
+  tsBufPoolHugePage = cfgGetItem(pCfg, "bufPoolHugePage")->i32;
+  tsBufPoolNumaNode = cfgGetItem(pCfg, "bufPoolNumaNode")->i32;
+  tsSttMergePolicy = cfgGetItem(pCfg, "sttMergePolicy")->i32;
   tsRetentionSpeedLimitMB = cfgGetItem(pCfg, "retentionSpeedLimitMB")->i32;
+  tsIoRateLimitMB = cfgGetItem(pCfg, "ioRateLimitMB")->i32;
   tsNumOfMnodeReadThreads = cfgGetItem(pCfg, "numOfMnodeReadThreads")->i32;
   tsNumOfVnodeQueryThreads = cfgGetItem(pCfg, "numOfVnodeQueryThreads")->i32;
   tsRatioOfVnodeStreamThreads = cfgGetItem(pCfg, "ratioOfVnodeStreamThreads")->fval;
@@ -1162,6 +1214,10 @@ static int32_t taosSetServerCfg(SConfig *pCfg) {
   tsMonitorMaxLogs = cfgGetItem(pCfg, "monitorMaxLogs")->i32;
   tsMonitorComp = cfgGetItem(pCfg, "monitorComp")->bval;
   tsQueryRspPolicy = cfgGetItem(pCfg, "queryRspPolicy")->i32;
+  tsQueryPrefetchBlocks = cfgGetItem(pCfg, "queryPrefetchBlocks")->i32;
+  tsColDataCacheSize = cfgGetItem(pCfg, "colDataCacheSize")->i32;
+  tsLastCacheBackend = cfgGetItem(pCfg, "lastCacheBackend")->i32;
+  tsLastCacheWarmupTables = cfgGetItem(pCfg, "lastCacheWarmupTables")->i32;
   tsMonitorLogProtocol = cfgGetItem(pCfg, "monitorLogProtocol")->bval;
   tsMonitorForceV2 = cfgGetItem(pCfg, "monitorForceV2")->i32;
 
@@ -1196,11 +1252,14 @@ static int32_t taosSetServerCfg(SConfig *pCfg) {
   tsTimeSeriesThreshold = cfgGetItem(pCfg, "timeseriesThreshold")->i32;
 
   tsWalFsyncDataSizeLimit = cfgGetItem(pCfg, "walFsyncDataSizeLimit")->i64;
+  tsWalGroupCommitUs = cfgGetItem(pCfg, "walGroupCommitUs")->i32;
+  tstrncpy(tsWalCompressor, cfgGetItem(pCfg, "walCompressor")->str, sizeof(tsWalCompressor));
 
   tsElectInterval = cfgGetItem(pCfg, "syncElectInterval")->i32;
   tsHeartbeatInterval = cfgGetItem(pCfg, "syncHeartbeatInterval")->i32;
   tsHeartbeatTimeout = cfgGetItem(pCfg, "syncHeartbeatTimeout")->i32;
   tsSnapReplMaxWaitN = cfgGetItem(pCfg, "syncSnapReplMaxWaitN")->i32;
+  tsSyncLogReplMaxBatchN = cfgGetItem(pCfg, "syncLogReplMaxBatchN")->i32;
 
   tsArbHeartBeatIntervalSec = cfgGetItem(pCfg, "arbHeartBeatIntervalSec")->i32;
   tsArbCheckSyncIntervalSec = cfgGetItem(pCfg, "arbCheckSyncIntervalSec")->i32;
@@ -1226,6 +1285,8 @@ static int32_t taosSetServerCfg(SConfig *pCfg) {
   tsCurRange = cfgGetItem(pCfg, "curRange")->i32;
   tsIfAdtFse = cfgGetItem(pCfg, "ifAdtFse")->bval;
   tstrncpy(tsCompressor, cfgGetItem(pCfg, "compressor")->str, sizeof(tsCompressor));
+  tsCompressAdaptive = cfgGetItem(pCfg, "compressAdaptive")->bval;
+  tsCompressSampleRows = cfgGetItem(pCfg, "compressSampleRows")->i32;
 
   tsDisableStream = cfgGetItem(pCfg, "disableStream")->bval;
   tsStreamBufferSize = cfgGetItem(pCfg, "streamBufferSize")->i64;
@@ -1246,6 +1307,9 @@ static int32_t taosSetServerCfg(SConfig *pCfg) {
   tsS3MigrateEnabled = (bool)cfgGetItem(pCfg, "s3MigrateEnabled")->bval;
   tsS3PageCacheSize = cfgGetItem(pCfg, "s3PageCacheSize")->i32;
   tsS3UploadDelaySec = cfgGetItem(pCfg, "s3UploadDelaySec")->i32;
+  tstrncpy(tsS3CacheDir, cfgGetItem(pCfg, "s3CacheDir")->str, PATH_MAX);
+  tsS3CacheSizeMB = cfgGetItem(pCfg, "s3CacheSizeMB")->i32;
+  tsS3CacheReadAhead = cfgGetItem(pCfg, "s3CacheReadAhead")->i32;
 
   tsExperimental = cfgGetItem(pCfg, "experimental")->bval;
 
@@ -1569,6 +1633,7 @@ static int32_t taosCfgDynamicOptionsForServer(SConfig *pCfg, const char *name) {
                                          {"mqRebalanceInterval", &tsMqRebalanceInterval},
                                          {"numOfLogLines", &tsNumOfLogLines},
                                          {"queryRspPolicy", &tsQueryRspPolicy},
+                                         {"queryPrefetchBlocks", &tsQueryPrefetchBlocks},
                                          {"timeseriesThreshold", &tsTimeSeriesThreshold},
                                          {"tmqMaxTopicNum", &tmqMaxTopicNum},
                                          {"tmqRowSize", &tmqRowSize},
@@ -21,6 +21,7 @@
 #include <tmsg.h>
 #include <iostream>
 #include <tdatablock.h>
+#include <tRealloc.h>
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wwrite-strings"
@@ -570,4 +571,159 @@ for (int r = 0; r < nRows; ++r) {
   taosArrayDestroy(pArray);
   taosMemoryFree(pTSchema);
 }
-#endif
\ No newline at end of file
+
+TEST(testCase, ColDataAdaptiveCompressTest) {
+  const int32_t nRows = 4096;
+  const int8_t  types[] = {TSDB_DATA_TYPE_TIMESTAMP, TSDB_DATA_TYPE_BIGINT, TSDB_DATA_TYPE_UBIGINT,
+                           TSDB_DATA_TYPE_DOUBLE,    TSDB_DATA_TYPE_INT,    TSDB_DATA_TYPE_VARCHAR};
+  char          str[16] = {0};
+
+  bool adaptive = tsCompressAdaptive;
+  tsCompressAdaptive = true;
+
+  for (int32_t t = 0; t < sizeof(types) / sizeof(types[0]); t++) {
+    SColData colData = {0};
+    tColDataInit(&colData, t + 1, types[t], 0);
+
+    for (int32_t i = 0; i < nRows; i++) {
+      SValue value = {.type = types[t]};
+      if (types[t] == TSDB_DATA_TYPE_DOUBLE) {
+        double d = 220.0 + (i % 3) * 0.5;
+        memcpy(&value.val, &d, sizeof(d));
+      } else if (types[t] == TSDB_DATA_TYPE_VARCHAR) {
+        snprintf(str, sizeof(str), "dev-%d", i % 5);
+        value.pData = (uint8_t *)str;
+        value.nData = strlen(str);
+      } else {
+        value.val = (types[t] == TSDB_DATA_TYPE_INT) ? 17 : 1700000000000 + i * 1000;
+      }
+
+      SColVal colVal = (i % 100 == 99) ? COL_VAL_NULL(t + 1, types[t]) : COL_VAL_VALUE(t + 1, value);
+      ASSERT_EQ(tColDataAppendValue(&colData, &colVal), 0);
+    }
+
+    SBuffer output, assist;
+    tBufferInit(&output);
+    tBufferInit(&assist);
+
+    SColDataCompressInfo info = {0};
+    uint8_t              l1 = (types[t] == TSDB_DATA_TYPE_TIMESTAMP) ? L1_XOR : L1_SIMPLE_8B;
+    SET_COMPRESS(l1, L2_ZSTD, L2_LVL_MEDIUM, info.cmprAlg);
+    ASSERT_EQ(tColDataCompress(&colData, &info, &output, &assist), 0);
+
+    // simple8b has no TIMESTAMP implementation, so it must never be picked for one
+    if (types[t] == TSDB_DATA_TYPE_TIMESTAMP) {
+      ASSERT_NE(COMPRESS_L1_TYPE_U32(info.cmprAlg), L1_SIMPLE_8B);
+    }
+
+    // the selected algorithm is all a reader needs to restore the data
+    SColData colData2 = {0};
+    tColDataInit(&colData2, 0, 0, 0);
+    ASSERT_EQ(tColDataDecompress(output.data, &info, &colData2, &assist), 0);
+    ASSERT_EQ(colData2.nVal, colData.nVal);
+    ASSERT_EQ(colData2.nData, colData.nData);
+
+    for (int32_t i = 0; i < nRows; i++) {
+      SColVal cv1, cv2;
+      tColDataGetValue(&colData, i, &cv1);
+      tColDataGetValue(&colData2, i, &cv2);
+      ASSERT_EQ(cv1.flag, cv2.flag);
+      if (!COL_VAL_IS_VALUE(&cv1)) continue;
+      if (IS_VAR_DATA_TYPE(types[t])) {
+        ASSERT_EQ(cv1.value.nData, cv2.value.nData);
+        ASSERT_EQ(memcmp(cv1.value.pData, cv2.value.pData, cv1.value.nData), 0);
+      } else {
+        ASSERT_EQ(cv1.value.val, cv2.value.val);
+      }
+    }
+
+    tBufferDestroy(&output);
+    tBufferDestroy(&assist);
+    tColDataDestroy(&colData);
+    tColDataDestroy(&colData2);
+  }
+
+  tsCompressAdaptive = adaptive;
+}
+
+TEST(testCase, ColDataDictCompressTest) {
+  const int32_t nRows = 4096;
+  const int32_t cardinality[] = {7, nRows};
+  char          str[32] = {0};
+
+  for (int32_t c = 0; c < sizeof(cardinality) / sizeof(cardinality[0]); c++) {
+    SColData colData = {0};
+    tColDataInit(&colData, 1, TSDB_DATA_TYPE_VARCHAR, 0);
+
+    for (int32_t i = 0; i < nRows; i++) {
+      SValue value = {.type = TSDB_DATA_TYPE_VARCHAR};
+      snprintf(str, sizeof(str), "region-%d", i % cardinality[c]);
+      value.pData = (uint8_t *)str;
+      value.nData = (i % 50 == 49) ? 0 : strlen(str);
+
+      SColVal colVal = (i % 100 == 99) ? COL_VAL_NULL(1, TSDB_DATA_TYPE_VARCHAR) : COL_VAL_VALUE(1, value);
+      ASSERT_EQ(tColDataAppendValue(&colData, &colVal), 0);
+    }
+
+    SBuffer output, assist;
+    tBufferInit(&output);
+    tBufferInit(&assist);
+
+    SColDataCompressInfo info = {0};
+    SET_COMPRESS(L1_DICT, L2_LZ4, L2_LVL_MEDIUM, info.cmprAlg);
+    ASSERT_EQ(tColDataCompress(&colData, &info, &output, &assist), 0);
+
+    // too many distinct values fall back to the plain layout
+    if (cardinality[c] == nRows) {
+      ASSERT_EQ(COMPRESS_L1_TYPE_U32(info.cmprAlg), L1_DISABLED);
+    } else {
+      ASSERT_EQ(COMPRESS_L1_TYPE_U32(info.cmprAlg), L1_DICT);
+      ASSERT_LT(info.dataOriginalSize, colData.nData);
+    }
+
+    SColData colData2 = {0};
+    tColDataInit(&colData2, 0, 0, 0);
+    ASSERT_EQ(tColDataDecompress(output.data, &info, &colData2, &assist), 0);
+    ASSERT_EQ(colData2.nVal, colData.nVal);
+    ASSERT_EQ(colData2.nData, colData.nData);
+
+    for (int32_t i = 0; i < nRows; i++) {
+      SColVal cv1, cv2;
+      tColDataGetValue(&colData, i, &cv1);
+      tColDataGetValue(&colData2, i, &cv2);
+      ASSERT_EQ(cv1.flag, cv2.flag);
+      if (!COL_VAL_IS_VALUE(&cv1)) continue;
+      ASSERT_EQ(cv1.value.nData, cv2.value.nData);
+      ASSERT_EQ(memcmp(cv1.value.pData, cv2.value.pData, cv1.value.nData), 0);
+    }
+
+    // the codes are kept for the caller if asked, equal values share a code
+    SColDataDict dict = {0};
+    SColData     colData3 = {0};
+    tColDataInit(&colData3, 0, 0, 0);
+    ASSERT_EQ(tColDataDecompressWithDict(output.data, &info, &colData3, &dict, &assist), 0);
+    ASSERT_EQ(colData3.nData, colData.nData);
+    if (cardinality[c] == nRows) {
+      ASSERT_EQ(dict.nEntry, 0);
+    } else {
+      ASSERT_EQ(dict.nEntry, cardinality[c]);
+      for (int32_t i = 0; i < nRows; i++) {
+        SColVal cv;
+        tColDataGetValue(&colData3, i, &cv);
+        if (!COL_VAL_IS_VALUE(&cv) || cv.value.nData == 0) {
+          ASSERT_EQ(dict.aCode[i], -1);
+        } else {
+          ASSERT_EQ(dict.aCode[i], dict.aCode[i % cardinality[c]]);
+        }
+      }
+    }
+    tFree(dict.aCode);
+    tColDataDestroy(&colData3);
+
+    tBufferDestroy(&output);
+    tBufferDestroy(&assist);
+    tColDataDestroy(&colData);
+    tColDataDestroy(&colData2);
+  }
+}
+#endif
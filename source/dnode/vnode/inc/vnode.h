@@ -168,6 +168,7 @@ int32_t      tsdbNextDataBlock2(STsdbReader *pReader, bool *hasNext);
 int32_t      tsdbRetrieveDatablockSMA2(STsdbReader *pReader, SSDataBlock *pDataBlock, bool *allHave, bool *hasNullSMA);
 void         tsdbReleaseDataBlock2(STsdbReader *pReader);
 SSDataBlock *tsdbRetrieveDataBlock2(STsdbReader *pTsdbReadHandle, SArray *pColumnIdList);
+int32_t      tsdbRetrieveRemainCols2(STsdbReader *pReader, bool load);
 int32_t      tsdbReaderReset2(STsdbReader *pReader, SQueryTableDataCond *pCond);
 int32_t      tsdbGetFileBlocksDistInfo2(STsdbReader *pReader, STableBlockDistInfo *pTableBlockInfo);
 int64_t      tsdbGetNumOfRowsInMemTable2(STsdbReader *pHandle);
@@ -178,6 +179,8 @@ void         tsdbReaderSetCloseFlag(STsdbReader *pReader);
 int64_t      tsdbGetLastTimestamp2(SVnode *pVnode, void *pTableList, int32_t numOfTables, const char *pIdStr);
 void         tsdbSetFilesetDelimited(STsdbReader *pReader);
 void         tsdbReaderSetNotifyCb(STsdbReader *pReader, TsdReaderNotifyCbFn notifyFn, void *param);
+void         tsdbReaderSetFilterInfo(STsdbReader *pReader, struct SFilterInfo *pFilterInfo);
+int32_t      tsdbReaderSetZeroCopy(STsdbReader *pReader, bool zeroCopy);
 
 int32_t tsdbReuseCacherowsReader(void *pReader, void *pTableIdList, int32_t numOfTables);
 int32_t tsdbCacherowsReaderOpen(void *pVnode, int32_t type, void *pTableIdList, int32_t numOfTables, int32_t numOfCols,
@@ -296,11 +299,15 @@ typedef struct {
   int64_t compStorage;
 } SVnodeStats;
 
+#define TSDB_CACHE_BACKEND_ROCKSDB 0
+#define TSDB_CACHE_BACKEND_MEM     1
+
 struct SVnodeCfg {
   int32_t     vgId;
   char        dbname[TSDB_DB_FNAME_LEN];
   uint64_t    dbId;
   int32_t     cacheLastSize;
+  int8_t      cacheBackend;
   int32_t     szPage;
   int32_t     szCache;
   uint64_t    szBuf;
@@ -76,6 +76,7 @@ typedef struct STsdbDataIter2   STsdbDataIter2;
 typedef struct STsdbFilterInfo  STsdbFilterInfo;
 typedef struct STFileSystem     STFileSystem;
 typedef struct STsdbRowKey      STsdbRowKey;
+typedef struct SCacheWarmup     SCacheWarmup;
 
 #define TSDBROW_ROW_FMT ((int8_t)0x0)
 #define TSDBROW_COL_FMT ((int8_t)0x1)
@@ -204,6 +205,8 @@ int32_t tBlockDataDecompress(SBufferReader *br, SBlockData *blockData, SBuffer *
 int32_t tBlockDataDecompressKeyPart(const SDiskDataHdr *hdr, SBufferReader *br, SBlockData *blockData, SBuffer *assist);
 int32_t tBlockDataDecompressColData(const SDiskDataHdr *hdr, const SBlockCol *blockCol, SBufferReader *br,
                                     SBlockData *blockData, SBuffer *assist);
+int32_t tBlockDataDecompressColDataDict(const SDiskDataHdr *hdr, const SBlockCol *blockCol, SBufferReader *br,
+                                        SBlockData *blockData, SColDataDict *pDict, SBuffer *assist);
 
 SColData *tBlockDataGetColData(SBlockData *pBlockData, int16_t cid);
 int32_t   tBlockDataAddColData(SBlockData *pBlockData, int16_t cid, int8_t type, int8_t cflag, SColData **ppColData);
@@ -251,6 +254,7 @@ int32_t tsdbTbDataIterCreate(STbData *pTbData, STsdbRowKey *pFrom, int8_t backwa
 void *  tsdbTbDataIterDestroy(STbDataIter *pIter);
 void    tsdbTbDataIterOpen(STbData *pTbData, STsdbRowKey *pFrom, int8_t backward, STbDataIter *pIter);
 bool    tsdbTbDataIterNext(STbDataIter *pIter);
+TSDBROW *tsdbTbDataIterMergeGet(STbDataIter *pIter);
 void    tsdbMemTableCountRows(SMemTable *pMemTable, SSHashObj *pTableMap, int64_t *rowsNum);
 
 // STbData
@@ -375,6 +379,9 @@ struct STsdb {
   TdThreadMutex        bMutex;
   SLRUCache *          pgCache;
   TdThreadMutex        pgMutex;
+  SLRUCache *          cdCache;  // decompressed column data of file blocks
+  int64_t              cdCacheHit;
+  int64_t              cdCacheMiss;
   struct STFileSystem *pFS;  // new
   SRocksCache          rCache;
   SCompMonitor         *pCompMonitor;
@@ -382,6 +389,7 @@ struct STsdb {
     SVHashTable *ht;
     SArray      *arr;
   } *commitInfo;
+  SCacheWarmup *pCacheWarmup;
 };
 
 struct TSDBKEY {
@@ -390,6 +398,7 @@ struct TSDBKEY {
 };
 
 typedef struct SMemSkipListNode SMemSkipListNode;
+typedef struct SMemSegChunk     SMemSegChunk;
 typedef struct SMemSkipList {
   int64_t           size;
   uint32_t          seed;
@@ -399,6 +408,13 @@ typedef struct SMemSkipList {
   SMemSkipListNode *pTail;
 } SMemSkipList;
 
+// rows appended in key order, without the skip list nodes
+typedef struct SMemAppendSeg {
+  int64_t       size;
+  SMemSegChunk *pHead;
+  SMemSegChunk *pTail;
+} SMemAppendSeg;
+
 struct STbData {
   tb_uid_t     suid;
   tb_uid_t     uid;
@@ -408,6 +424,7 @@ struct STbData {
   SDelData *   pHead;
   SDelData *   pTail;
   SMemSkipList sl;
+  SMemAppendSeg seg;
   STbData *    next;
   SRBTreeNode  rbtn[1];
 };
@@ -449,6 +466,14 @@ struct SMemSkipListNode {
   SMemSkipListNode *forwards[0];
 };
 
+struct SMemSegChunk {
+  SMemSegChunk *prev;
+  SMemSegChunk *next;
+  int32_t       capacity;
+  int32_t       nRow;
+  TSDBROW       aRow[];
+};
+
 struct STsdbRowKey {
   SRowKey key;
   int64_t version;
@@ -551,6 +576,9 @@ struct STbDataIter {
   STbData *         pTbData;
   int8_t            backward;
   SMemSkipListNode *pNode;
+  SMemSegChunk *    pChunk;   // position in the append segment, NULL if the segment is not iterated
+  int32_t           iSegRow;
+  int8_t            fromSeg;  // the current row is from the append segment
   TSDBROW *         pRow;
   TSDBROW           row;
 };
@@ -665,6 +693,7 @@ typedef struct {
   int32_t     fid;
   int64_t     cid;
   int64_t     blkno;
+  int32_t     ioDisk;  // disk of the vnode I/O scheduler
 } STsdbFD;
 
 struct SDelFWriter {
@@ -935,6 +964,7 @@ typedef struct {
 
 int32_t tsdbOpenCache(STsdb *pTsdb);
 void    tsdbCloseCache(STsdb *pTsdb);
+void    tsdbCacheWarmupStop(STsdb *pTsdb);
 int32_t tsdbCacheRowFormatUpdate(STsdb *pTsdb, tb_uid_t suid, tb_uid_t uid, int64_t version, int32_t nRow, SRow **aRow);
 int32_t tsdbCacheColFormatUpdate(STsdb *pTsdb, tb_uid_t suid, tb_uid_t uid, SBlockData *pBlockData);
 int32_t tsdbCacheDel(STsdb *pTsdb, tb_uid_t suid, tb_uid_t uid, TSKEY sKey, TSKEY eKey);
@@ -949,6 +979,12 @@ int32_t tsdbBICacheRelease(SLRUCache *pCache, LRUHandle *h);
 int32_t tsdbCacheGetBlockS3(SLRUCache *pCache, STsdbFD *pFD, LRUHandle **handle);
 int32_t tsdbCacheGetPageS3(SLRUCache *pCache, STsdbFD *pFD, int64_t pgno, LRUHandle **handle);
 int32_t tsdbCacheSetPageS3(SLRUCache *pCache, STsdbFD *pFD, int64_t pgno, uint8_t *pPage);
+
+int32_t tsdbColDataCacheGet(STsdb *pTsdb, int32_t fid, int64_t cid, int64_t blockOffset, int16_t colId,
+                            SBlockData *pBlockData, bool *hit);
+int32_t tsdbColDataCachePut(STsdb *pTsdb, int32_t fid, int64_t cid, int64_t blockOffset, const SColData *pColData);
+void    tsdbColDataCacheInvalidate(STsdb *pTsdb, int32_t fid, int64_t cid);
+void    tsdbColDataCacheGetStat(STsdb *pTsdb, int64_t *hit, int64_t *miss, size_t *usage);
 int32_t tsdbCacheRelease(SLRUCache *pCache, LRUHandle *h);
 
 int32_t tsdbCacheDeleteLastrow(SLRUCache *pCache, tb_uid_t uid, TSKEY eKey);
@@ -985,6 +1021,10 @@ static FORCE_INLINE TSDBROW *tsdbTbDataIterGet(STbDataIter *pIter) {
     return pIter->pRow;
   }
 
+  if (pIter->pChunk) {
+    return tsdbTbDataIterMergeGet(pIter);
+  }
+
   if (pIter->backward) {
     if (pIter->pNode == pIter->pTbData->sl.pHead) {
       return NULL;
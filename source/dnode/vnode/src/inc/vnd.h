@@ -65,6 +65,32 @@ int32_t vnodeAWait(SVATaskID* taskID);
 int32_t vnodeACancel(SVATaskID* taskID);
 int32_t vnodeAsyncSetWorkers(int64_t async, int32_t numWorkers);
 
+// vnodeIo.c
+#define VNODE_IO_DISK(did) ((did).level * TFS_MAX_DISKS_PER_TIER + (did).id)
+
+int32_t   vnodeIoOpen();
+void      vnodeIoClose();
+EVIoClass vnodeIoSetClass(EVIoClass ioClass);
+int32_t   vnodeIoGetDisk(STfs* pTfs, const char* path);
+void      vnodeIoAcquire(SVnode* pVnode, int32_t disk, int64_t bytes);
+void      vnodeIoReport(SVnode* pVnode);
+
+// vnodeS3Cache.c
+typedef int32_t (*FVS3CacheRead)(const char* object, int64_t offset, int64_t size, bool check, uint8_t** ppBlock);
+
+int32_t       vnodeS3CacheOpen();
+void          vnodeS3CacheClose();
+int32_t       vnodeS3CacheGet(const char* object, int64_t objSize, int64_t offset, int64_t size, bool check,
+                              uint8_t** ppBlock);
+void          vnodeS3CachePrefetch(const char* object, int64_t objSize, int64_t offset, int64_t size);
+FVS3CacheRead vnodeS3CacheSetRead(FVS3CacheRead fp);
+
+// vnodeReplay.c
+int32_t vnodeReplayOpen(SVnode* pVnode);
+void    vnodeReplayClose(SVnode* pVnode);
+bool    vnodeReplayTake(SVnode* pVnode, int64_t ver, const void* pMsg, int32_t len, SSubmitReq2* pSubmitReq,
+                        void** ppBuf, int32_t* code);
+
 // vnodeBufPool.c
 typedef struct SVBufPoolNode SVBufPoolNode;
 struct SVBufPoolNode {
@@ -88,6 +114,7 @@ struct SVBufPool {
   int32_t           id;
   volatile int32_t  nRef;
   TdThreadSpinlock* lock;
+  int64_t           mapSize;  // size of the mapping if the pool is mmapped, 0 if malloced
   int64_t           size;
   uint8_t*          ptr;
   SVBufPoolNode*    pTail;
@@ -123,6 +150,10 @@ int32_t vnodeSyncCommit(SVnode* pVnode);
 int32_t vnodeAsyncCommit(SVnode* pVnode);
 bool    vnodeShouldRollback(SVnode* pVnode);
 
+// vnodeSvr.c
+int32_t vnodeApplySubmitInParallel(SVnode* pVnode, int64_t ver, SSubmitReq2* pSubmitReq, int32_t* affectedRows);
+int32_t vnodeScanSubmitReq(SVnode* pVnode, int64_t ver, SSubmitReq2* pSubmitReq);
+
 // vnodeSync.c
 int64_t vnodeClusterId(SVnode* pVnode);
 int32_t vnodeNodeId(SVnode* pVnode);
@@ -60,6 +60,7 @@ typedef struct STsdb              STsdb;
 typedef struct STQ                STQ;
 typedef struct SVState            SVState;
 typedef struct SVStatis           SVStatis;
+typedef struct SVBufPoolStat      SVBufPoolStat;
 typedef struct SVBufPool          SVBufPool;
 typedef struct SQueueWorker       SQHandle;
 typedef struct STsdbKeepCfg       STsdbKeepCfg;
@@ -85,6 +86,7 @@ typedef struct SSnapDataHdr       SSnapDataHdr;
 typedef struct SCommitInfo        SCommitInfo;
 typedef struct SCompactInfo       SCompactInfo;
 typedef struct SQueryNode         SQueryNode;
+typedef struct SVReplay           SVReplay;
 
 #define VNODE_META_DIR  "meta"
 #define VNODE_TSDB_DIR  "tsdb"
@@ -106,7 +108,12 @@ typedef struct SQueryNode         SQueryNode;
 #define VND_INFO_FNAME     "vnode.json"
 #define VND_INFO_FNAME_TMP "vnode_tmp.json"
 
-#define VNODE_METRIC_SQL_COUNT "taosd_sql_req:count"
+#define VNODE_METRIC_SQL_COUNT   "taosd_sql_req:count"
+#define VNODE_METRIC_COMMIT_TIME "taosd_vnode_commit:time"
+#define VNODE_METRIC_IO_BYTES    "taosd_vnode_io:bytes"
+#define VNODE_METRIC_CD_CACHE    "taosd_vnode_col_data_cache:count"
+#define VNODE_METRIC_BUF_POOL    "taosd_vnode_buf_pool:count"
+#define VNODE_METRIC_BUF_WAIT    "taosd_vnode_buf_pool_wait:time"
 
 #define VNODE_METRIC_TAG_NAME_SQL_TYPE   "sql_type"
 #define VNODE_METRIC_TAG_NAME_CLUSTER_ID "cluster_id"
@@ -115,8 +122,16 @@ typedef struct SQueryNode         SQueryNode;
 #define VNODE_METRIC_TAG_NAME_VGROUP_ID  "vgroup_id"
 #define VNODE_METRIC_TAG_NAME_USERNAME   "username"
 #define VNODE_METRIC_TAG_NAME_RESULT     "result"
+#define VNODE_METRIC_TAG_NAME_PHASE      "phase"
+#define VNODE_METRIC_TAG_NAME_IO_CLASS   "io_class"
+#define VNODE_METRIC_TAG_NAME_EVENT      "event"
 
 #define VNODE_METRIC_TAG_VALUE_INSERT_AFFECTED_ROWS "inserted_rows"
+#define VNODE_METRIC_TAG_VALUE_CACHE_HIT             "hit"
+#define VNODE_METRIC_TAG_VALUE_CACHE_MISS            "miss"
+#define VNODE_METRIC_TAG_VALUE_POOL_REUSE            "reuse"
+#define VNODE_METRIC_TAG_VALUE_POOL_OVERFLOW         "overflow"
+#define VNODE_METRIC_TAG_VALUE_POOL_WAIT             "wait"
 // #define VNODE_METRIC_TAG_VALUE_INSERT "insert"
 // #define VNODE_METRIC_TAG_VALUE_DELETE "delete"
 
@@ -230,6 +245,9 @@ int32_t tsdbBegin(STsdb* pTsdb);
 // int32_t tsdbPrepareCommit(STsdb* pTsdb);
 // int32_t tsdbCommit(STsdb* pTsdb, SCommitInfo* pInfo);
 int32_t tsdbCacheCommit(STsdb* pTsdb);
+int32_t tsdbCacheSnapshot(STsdb* pTsdb, int64_t committed);
+int32_t tsdbCacheLoadSnapshot(STsdb* pTsdb, int64_t lastVer);
+int32_t tsdbCacheWarmupStart(STsdb* pTsdb);
 int32_t tsdbCacheNewTable(STsdb* pTsdb, int64_t uid, tb_uid_t suid, SSchemaWrapper* pSchemaRow);
 int32_t tsdbCacheDropTable(STsdb* pTsdb, int64_t uid, tb_uid_t suid, SSchemaWrapper* pSchemaRow);
 int32_t tsdbCacheDropSubTables(STsdb* pTsdb, SArray* uids, tb_uid_t suid);
@@ -437,6 +455,14 @@ struct SVStatis {
   int64_t nBatchInsertSuccess;  // delta
 };
 
+struct SVBufPoolStat {
+  int64_t nReuse;     // times a pool is put back to the free list
+  int64_t nOverflow;  // times a pool is put back after growing beyond its region
+  int64_t maxUsed;    // max bytes used by a pool before it is put back
+  int64_t nWait;      // times the writer waits for a free pool
+  int64_t waitTime;   // total time the writer waits for a free pool, in ms
+};
+
 struct SVnodeInfo {
   SVnodeCfg config;
   SVState   state;
@@ -465,11 +491,29 @@ typedef struct SVCommitSched {
   int64_t maxWaitMs;
 } SVCommitSched;
 
+// I/O classes of the dnode I/O scheduler, from the highest priority to the lowest
+typedef enum {
+  EVIO_CLASS_COMMIT = 0,
+  EVIO_CLASS_QUERY,
+  EVIO_CLASS_MERGE,
+  EVIO_CLASS_RETENTION,  // retention and s3 migration
+  EVIO_CLASS_MAX,
+} EVIoClass;
+
 typedef struct SVMonitorObj {
   char            strClusterId[TSDB_CLUSTER_ID_LEN];
   char            strDnodeId[TSDB_NODE_ID_LEN];
   char            strVgId[TSDB_VGROUP_ID_LEN];
   taos_counter_t* insertCounter;
+  taos_counter_t* commitCounter;
+  taos_counter_t* ioCounter;
+  int64_t         ioBytes[EVIO_CLASS_MAX];  // bytes of tsdb I/O not reported yet
+  taos_counter_t* cdCacheCounter;
+  int64_t         cdCacheHit;   // hits of the column data cache reported so far
+  int64_t         cdCacheMiss;  // misses of the column data cache reported so far
+  taos_counter_t* bufPoolCounter;
+  taos_counter_t* bufWaitCounter;
+  SVBufPoolStat   bufPoolStat;  // buffer pool statistics reported so far
 } SVMonitorObj;
 
 typedef struct {
@@ -502,6 +546,7 @@ struct SVnode {
   SVBufPool*    recycleHead;
   SVBufPool*    recycleTail;
   SVBufPool*    onRecycle;
+  SVBufPoolStat poolStat;
 
   // commit variables
   SVAChannelID commitChannel;
@@ -522,6 +567,7 @@ struct SVnode {
   int64_t       blockSeq;
   SQHandle*     pQuery;
   SVMonitorObj  monitor;
+  SVReplay*     pReplay;  // the wal decoded ahead on restore
 };
 
 #define TD_VID(PVNODE) ((PVNODE)->config.vgId)
@@ -537,6 +583,7 @@ struct SVnode {
 #define TSDB_CACHE_NO(c)       ((c).cacheLast == 0)
 #define TSDB_CACHE_LAST_ROW(c) (((c).cacheLast & 1) > 0)
 #define TSDB_CACHE_LAST(c)     (((c).cacheLast & 2) > 0)
+#define TSDB_CACHE_IN_MEM(c)   ((c).cacheBackend == TSDB_CACHE_BACKEND_MEM)
 
 struct STbUidStore {
   tb_uid_t  suid;
@@ -596,10 +643,21 @@ struct SSnapDataHdr {
   uint8_t data[];
 };
 
+typedef enum {
+  VND_COMMIT_PHASE_WAL = 0,    // persist wal
+  VND_COMMIT_PHASE_TSDB_BUILD, // build the file sets to commit
+  VND_COMMIT_PHASE_TSDB_WRITE, // write the file sets
+  VND_COMMIT_PHASE_TSDB_EDIT,  // begin the file system edit
+  VND_COMMIT_PHASE_CACHE,      // commit the last cache
+  VND_COMMIT_PHASE_FINISH,     // commit sma, tq, meta and the vnode info
+  VND_COMMIT_PHASE_MAX,
+} EVCommitPhase;
+
 struct SCommitInfo {
   SVnodeInfo info;
   SVnode*    pVnode;
   TXN*       txn;
+  int64_t    cost[VND_COMMIT_PHASE_MAX];  // time of each commit phase, in us
 };
 
 struct SCompactInfo {
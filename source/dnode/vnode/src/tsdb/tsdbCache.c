@@ -126,6 +126,36 @@ static void tsdbClosePgCache(STsdb *pTsdb) {
   }
 }
 
+static int32_t tsdbOpenCDCache(STsdb *pTsdb) {
+  if (tsColDataCacheSize <= 0) {
+    pTsdb->cdCache = NULL;
+    return 0;
+  }
+
+  SLRUCache *pCache = taosLRUCacheInit((int64_t)tsColDataCacheSize * 1024 * 1024, 0, .5);
+  if (pCache == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  taosLRUCacheSetStrictCapacity(pCache, false);
+
+  pTsdb->cdCache = pCache;
+  pTsdb->cdCacheHit = 0;
+  pTsdb->cdCacheMiss = 0;
+  return 0;
+}
+
+static void tsdbCloseCDCache(STsdb *pTsdb) {
+  SLRUCache *pCache = pTsdb->cdCache;
+  if (pCache) {
+    tsdbDebug("vgId:%d, col data cache elems:%d, hit:%" PRId64 ", miss:%" PRId64, TD_VID(pTsdb->pVnode),
+              taosLRUCacheGetElems(pCache), pTsdb->cdCacheHit, pTsdb->cdCacheMiss);
+    taosLRUCacheEraseUnrefEntries(pCache);
+    taosLRUCacheCleanup(pCache);
+    pTsdb->cdCache = NULL;
+  }
+}
+
 #define ROCKS_KEY_LEN (sizeof(tb_uid_t) + sizeof(int16_t) + sizeof(int8_t))
 
 enum {
@@ -295,6 +325,10 @@ static void tsdbCloseRocksCache(STsdb *pTsdb) {
 }
 
 static void rocksMayWrite(STsdb *pTsdb, bool force, bool read, bool lock) {
+  if (TSDB_CACHE_IN_MEM(pTsdb->pVnode->config)) {
+    return;
+  }
+
   rocksdb_writebatch_t *wb = pTsdb->rCache.writebatch;
   if (read) {
     if (lock) {
@@ -503,6 +537,11 @@ static void tsdbCachePutBatch(SLastCol *pLastCol, const void *key, size_t klen,
   char                 *rocks_value = NULL;
   size_t                vlen = 0;
 
+  // the memory backend keeps nothing out of the lru, an evicted value is loaded from tsdb again
+  if (TSDB_CACHE_IN_MEM(pTsdb->pVnode->config)) {
+    return;
+  }
+
   tsdbCacheSerialize(pLastCol, &rocks_value, &vlen);
 
   taosThreadMutexLock(&rCache->rMutex);
@@ -548,6 +587,10 @@ int32_t tsdbCacheCommit(STsdb *pTsdb) {
   SLRUCache            *pCache = pTsdb->lruCache;
   rocksdb_writebatch_t *wb = pTsdb->rCache.writebatch;
 
+  if (TSDB_CACHE_IN_MEM(pTsdb->pVnode->config)) {
+    return code;
+  }
+
   taosThreadMutexLock(&pTsdb->lruMutex);
 
   taosLRUCacheApply(pCache, tsdbCacheFlushDirty, &pTsdb->flushState);
@@ -659,6 +702,10 @@ int32_t tsdbCacheCommitNoLock(STsdb *pTsdb) {
   SLRUCache            *pCache = pTsdb->lruCache;
   rocksdb_writebatch_t *wb = pTsdb->rCache.writebatch;
 
+  if (TSDB_CACHE_IN_MEM(pTsdb->pVnode->config)) {
+    return code;
+  }
+
   taosLRUCacheApply(pCache, tsdbCacheFlushDirty, &pTsdb->flushState);
 
   rocksMayWrite(pTsdb, true, false, false);
@@ -696,8 +743,10 @@ static int32_t tsdbCacheDropTableColumn(STsdb *pTsdb, int64_t uid, int16_t cid,
   char  **errs = taosMemoryCalloc(2, sizeof(char *));
 
   // rocksMayWrite(pTsdb, true, false, false);
-  rocksdb_multi_get(pTsdb->rCache.db, pTsdb->rCache.readoptions, 2, (const char *const *)keys_list, keys_list_sizes,
-                    values_list, values_list_sizes, errs);
+  if (!TSDB_CACHE_IN_MEM(pTsdb->pVnode->config)) {
+    rocksdb_multi_get(pTsdb->rCache.db, pTsdb->rCache.readoptions, 2, (const char *const *)keys_list, keys_list_sizes,
+                      values_list, values_list_sizes, errs);
+  }
 
   for (int i = 0; i < 2; ++i) {
     if (errs[i]) {
@@ -1039,12 +1088,14 @@ static int32_t tsdbCacheUpdate(STsdb *pTsdb, tb_uid_t suid, tb_uid_t uid, SArray
         tsdbCacheUpdateLastCol(pLastCol, pRowKey, pColVal);
       }
       taosLRUCacheRelease(pCache, h, false);
-    } else {
+    } else if (!TSDB_CACHE_IN_MEM(pTsdb->pVnode->config)) {
       if (!remainCols) {
         remainCols = taosArrayInit(num_keys * 2, sizeof(SIdxKey));
       }
       taosArrayPush(remainCols, &(SIdxKey){i, *key});
     }
+    // the memory backend does not know whether a missing value was evicted or never loaded, so it is left to be
+    // loaded from tsdb, which has the new row, on the next read
   }
 
   if (remainCols) {
@@ -1425,6 +1476,10 @@ static int32_t tsdbCacheLoadFromRaw(STsdb *pTsdb, tb_uid_t uid, SArray *pLastArr
       code = -1;
     }
 
+    if (TSDB_CACHE_IN_MEM(pTsdb->pVnode->config)) {
+      continue;
+    }
+
     // store result back to rocks cache
     wb = pTsdb->rCache.rwritebatch;
     char  *value = NULL;
@@ -1458,47 +1513,65 @@ static int32_t tsdbCacheLoadFromRaw(STsdb *pTsdb, tb_uid_t uid, SArray *pLastArr
   return code;
 }
 
-static int32_t tsdbCacheLoadFromRocks(STsdb *pTsdb, tb_uid_t uid, SArray *pLastArray, SArray *remainCols,
-                                      SCacheRowsReader *pr, int8_t ltype) {
+/*
+ * Look up the keys of remainCols in rocks with multi-gets of at most ROCKS_BATCH_SIZE keys. The values found are put
+ * into the lru and into pLastArrays[idx / numOfCols] at idx % numOfCols, the keys not found are left in remainCols.
+ */
+static int32_t tsdbCacheGetFromRocks(STsdb *pTsdb, SArray *remainCols, SArray **pLastArrays, int32_t numOfCols) {
   int32_t code = 0;
   int     num_keys = TARRAY_SIZE(remainCols);
-  char  **keys_list = taosMemoryMalloc(num_keys * sizeof(char *));
-  size_t *keys_list_sizes = taosMemoryMalloc(num_keys * sizeof(size_t));
-  char   *key_list = taosMemoryMalloc(num_keys * ROCKS_KEY_LEN);
-  for (int i = 0; i < num_keys; ++i) {
-    int16_t cid = *(int16_t *)taosArrayGet(remainCols, i);
 
-    memcpy(key_list + i * ROCKS_KEY_LEN, &((SIdxKey *)taosArrayGet(remainCols, i))->key, ROCKS_KEY_LEN);
-    keys_list[i] = key_list + i * ROCKS_KEY_LEN;
-    keys_list_sizes[i] = ROCKS_KEY_LEN;
+  if (TSDB_CACHE_IN_MEM(pTsdb->pVnode->config) || num_keys == 0) {
+    return code;
   }
 
-  char  **values_list = taosMemoryCalloc(num_keys, sizeof(char *));
-  size_t *values_list_sizes = taosMemoryCalloc(num_keys, sizeof(size_t));
-  char  **errs = taosMemoryMalloc(num_keys * sizeof(char *));
-  rocksdb_multi_get(pTsdb->rCache.db, pTsdb->rCache.readoptions, num_keys, (const char *const *)keys_list,
-                    keys_list_sizes, values_list, values_list_sizes, errs);
-  for (int i = 0; i < num_keys; ++i) {
-    if (errs[i]) {
-      tsdbError("vgId:%d, %s failed at line %d since %s, index:%d", TD_VID(pTsdb->pVnode), __func__, __LINE__, errs[i],
-                i);
-      rocksdb_free(errs[i]);
-    }
+  int     batch = TMIN(num_keys, ROCKS_BATCH_SIZE);
+  SArray *missCols = taosArrayInit(num_keys, sizeof(SIdxKey));
+  char  **keys_list = taosMemoryMalloc(batch * sizeof(char *));
+  size_t *keys_list_sizes = taosMemoryMalloc(batch * sizeof(size_t));
+  char  **values_list = taosMemoryCalloc(batch, sizeof(char *));
+  size_t *values_list_sizes = taosMemoryCalloc(batch, sizeof(size_t));
+  char  **errs = taosMemoryCalloc(batch, sizeof(char *));
+  if (!missCols || !keys_list || !keys_list_sizes || !values_list || !values_list_sizes || !errs) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _exit;
   }
 
   SLRUCache *pCache = pTsdb->lruCache;
-  for (int i = 0, j = 0; i < num_keys && j < TARRAY_SIZE(remainCols); ++i) {
-    SLastCol *pLastCol = tsdbCacheDeserialize(values_list[i], values_list_sizes[i]);
-    SLastCol *PToFree = pLastCol;
-    SIdxKey  *idxKey = &((SIdxKey *)TARRAY_DATA(remainCols))[j];
-    if (pLastCol) {
+  for (int start = 0; start < num_keys; start += batch) {
+    int n = TMIN(batch, num_keys - start);
+    for (int i = 0; i < n; ++i) {
+      keys_list[i] = (char *)&((SIdxKey *)TARRAY_DATA(remainCols))[start + i].key;
+      keys_list_sizes[i] = ROCKS_KEY_LEN;
+    }
+
+    rocksdb_multi_get(pTsdb->rCache.db, pTsdb->rCache.readoptions, n, (const char *const *)keys_list, keys_list_sizes,
+                      values_list, values_list_sizes, errs);
+
+    for (int i = 0; i < n; ++i) {
+      SIdxKey *idxKey = &((SIdxKey *)TARRAY_DATA(remainCols))[start + i];
+      if (errs[i]) {
+        tsdbError("vgId:%d, %s failed at line %d since %s, index:%d", TD_VID(pTsdb->pVnode), __func__, __LINE__,
+                  errs[i], start + i);
+        rocksdb_free(errs[i]);
+        errs[i] = NULL;
+      }
+
+      SLastCol *pLastCol = tsdbCacheDeserialize(values_list[i], values_list_sizes[i]);
+      SLastCol *PToFree = pLastCol;
+      if (pLastCol == NULL) {
+        taosArrayPush(missCols, idxKey);
+        rocksdb_free(values_list[i]);
+        continue;
+      }
+
       SLastCol *pTmpLastCol = taosMemoryCalloc(1, sizeof(SLastCol));
       *pTmpLastCol = *pLastCol;
       pLastCol = pTmpLastCol;
 
       size_t charge = sizeof(*pLastCol);
-      for (int8_t i = 0; i < pLastCol->rowKey.numOfPKs; i++) {
-        SValue *pValue = &pLastCol->rowKey.pks[i];
+      for (int8_t j = 0; j < pLastCol->rowKey.numOfPKs; j++) {
+        SValue *pValue = &pLastCol->rowKey.pks[j];
         if (IS_VAR_DATA_TYPE(pValue->type)) {
           reallocVarDataVal(pValue);
           charge += pValue->nData;
@@ -1516,35 +1589,88 @@ static int32_t tsdbCacheLoadFromRocks(STsdb *pTsdb, tb_uid_t uid, SArray *pLastA
       }
 
       SLastCol lastCol = *pLastCol;
-      for (int8_t i = 0; i < lastCol.rowKey.numOfPKs; i++) {
-        reallocVarDataVal(&lastCol.rowKey.pks[i]);
+      for (int8_t j = 0; j < lastCol.rowKey.numOfPKs; j++) {
+        reallocVarDataVal(&lastCol.rowKey.pks[j]);
       }
       reallocVarData(&lastCol.colVal);
-      taosArraySet(pLastArray, idxKey->idx, &lastCol);
-      taosArrayRemove(remainCols, j);
+      taosArraySet(pLastArrays[idxKey->idx / numOfCols], idxKey->idx % numOfCols, &lastCol);
 
       taosMemoryFreeClear(PToFree);
-      taosMemoryFree(values_list[i]);
-    } else {
-      ++j;
+      rocksdb_free(values_list[i]);
     }
   }
 
-  taosMemoryFree(errs);
-  taosMemoryFree(key_list);
+  taosArrayClear(remainCols);
+  taosArrayAddAll(remainCols, missCols);
+
+_exit:
+  taosArrayDestroy(missCols);
   taosMemoryFree(keys_list);
   taosMemoryFree(keys_list_sizes);
   taosMemoryFree(values_list);
   taosMemoryFree(values_list_sizes);
+  taosMemoryFree(errs);
+  return code;
+}
+
+static FTsdbCacheLoadRaw tsdbCacheLoadRawFp = tsdbCacheLoadFromRaw;
+
+/**
+ * @brief replace the load of the cached columns from tsdb, for the tests
+ *
+ * @return the previous one
+ */
+FTsdbCacheLoadRaw tsdbCacheSetLoadRaw(FTsdbCacheLoadRaw fp) {
+  FTsdbCacheLoadRaw old = tsdbCacheLoadRawFp;
+  tsdbCacheLoadRawFp = fp ? fp : tsdbCacheLoadFromRaw;
+  return old;
+}
+
+static int32_t tsdbCacheLoadFromRocks(STsdb *pTsdb, tb_uid_t uid, SArray *pLastArray, SArray *remainCols,
+                                      SCacheRowsReader *pr, int8_t ltype) {
+  int32_t code = tsdbCacheGetFromRocks(pTsdb, remainCols, &pLastArray, TARRAY_SIZE(pr->pCidList));
 
   if (TARRAY_SIZE(remainCols) > 0) {
     // tsdbTrace("tsdb/cache: vgId: %d, load %" PRId64 " from raw", TD_VID(pTsdb->pVnode), uid);
-    code = tsdbCacheLoadFromRaw(pTsdb, uid, pLastArray, remainCols, pr, ltype);
+    code = tsdbCacheLoadRawFp(pTsdb, uid, pLastArray, remainCols, pr, ltype);
   }
 
   return code;
 }
 
+static SLastKey tsdbCacheGetKey(SCacheRowsReader *pr, tb_uid_t uid, int32_t i, int8_t ltype) {
+  int16_t  cid = ((int16_t *)TARRAY_DATA(pr->pCidList))[i];
+  SLastKey key = {.lflag = ltype, .uid = uid, .cid = cid};
+
+  // for select last_row, last case
+  int32_t funcType = FUNCTION_TYPE_CACHE_LAST;
+  if (pr->pFuncTypeList != NULL && taosArrayGetSize(pr->pFuncTypeList) > i) {
+    funcType = ((int32_t *)TARRAY_DATA(pr->pFuncTypeList))[i];
+  }
+  if (((pr->type & CACHESCAN_RETRIEVE_LAST) == CACHESCAN_RETRIEVE_LAST) && FUNCTION_TYPE_CACHE_LAST_ROW == funcType) {
+    int8_t tempType = CACHESCAN_RETRIEVE_LAST_ROW | (pr->type ^ CACHESCAN_RETRIEVE_LAST);
+    key.lflag = (tempType & CACHESCAN_RETRIEVE_LAST) >> 3;
+  }
+
+  return key;
+}
+
+static bool tsdbCacheGetFromLRU(SLRUCache *pCache, SLastKey *key, SLastCol *pLastCol) {
+  LRUHandle *h = taosLRUCacheLookup(pCache, key, ROCKS_KEY_LEN);
+  if (h == NULL) {
+    return false;
+  }
+
+  *pLastCol = *(SLastCol *)taosLRUCacheValue(pCache, h);
+  for (int8_t j = 0; j < pLastCol->rowKey.numOfPKs; j++) {
+    reallocVarDataVal(&pLastCol->rowKey.pks[j]);
+  }
+  reallocVarData(&pLastCol->colVal);
+
+  taosLRUCacheRelease(pCache, h, false);
+  return true;
+}
+
 int32_t tsdbCacheGetBatch(STsdb *pTsdb, tb_uid_t uid, SArray *pLastArray, SCacheRowsReader *pr, int8_t ltype) {
   int32_t    code = 0;
   SArray    *remainCols = NULL;
@@ -1553,34 +1679,13 @@ int32_t tsdbCacheGetBatch(STsdb *pTsdb, tb_uid_t uid, SArray *pLastArray, SCache
   int        num_keys = TARRAY_SIZE(pCidList);
 
   for (int i = 0; i < num_keys; ++i) {
-    int16_t cid = ((int16_t *)TARRAY_DATA(pCidList))[i];
-
-    SLastKey key = {.lflag = ltype, .uid = uid, .cid = cid};
-    // for select last_row, last case
-    int32_t funcType = FUNCTION_TYPE_CACHE_LAST;
-    if (pr->pFuncTypeList != NULL && taosArrayGetSize(pr->pFuncTypeList) > i) {
-      funcType = ((int32_t *)TARRAY_DATA(pr->pFuncTypeList))[i];
-    }
-    if (((pr->type & CACHESCAN_RETRIEVE_LAST) == CACHESCAN_RETRIEVE_LAST) && FUNCTION_TYPE_CACHE_LAST_ROW == funcType) {
-      int8_t tempType = CACHESCAN_RETRIEVE_LAST_ROW | (pr->type ^ CACHESCAN_RETRIEVE_LAST);
-      key.lflag = (tempType & CACHESCAN_RETRIEVE_LAST) >> 3;
-    }
-
-    LRUHandle *h = taosLRUCacheLookup(pCache, &key, ROCKS_KEY_LEN);
-    if (h) {
-      SLastCol *pLastCol = (SLastCol *)taosLRUCacheValue(pCache, h);
-
-      SLastCol lastCol = *pLastCol;
-      for (int8_t j = 0; j < lastCol.rowKey.numOfPKs; j++) {
-        reallocVarDataVal(&lastCol.rowKey.pks[j]);
-      }
-      reallocVarData(&lastCol.colVal);
+    SLastKey key = tsdbCacheGetKey(pr, uid, i, ltype);
+    SLastCol lastCol = {0};
+    if (tsdbCacheGetFromLRU(pCache, &key, &lastCol)) {
       taosArrayPush(pLastArray, &lastCol);
-
-      taosLRUCacheRelease(pCache, h, false);
     } else {
       SLastCol noneCol = {.rowKey.ts = TSKEY_MIN,
-                          .colVal = COL_VAL_NONE(cid, pr->pSchema->columns[pr->pSlotIds[i]].type)};
+                          .colVal = COL_VAL_NONE(key.cid, pr->pSchema->columns[pr->pSlotIds[i]].type)};
 
       taosArrayPush(pLastArray, &noneCol);
 
@@ -1594,20 +1699,10 @@ int32_t tsdbCacheGetBatch(STsdb *pTsdb, tb_uid_t uid, SArray *pLastArray, SCache
   if (remainCols && TARRAY_SIZE(remainCols) > 0) {
     taosThreadMutexLock(&pTsdb->lruMutex);
     for (int i = 0; i < TARRAY_SIZE(remainCols);) {
-      SIdxKey   *idxKey = &((SIdxKey *)TARRAY_DATA(remainCols))[i];
-      LRUHandle *h = taosLRUCacheLookup(pCache, &idxKey->key, ROCKS_KEY_LEN);
-      if (h) {
-        SLastCol *pLastCol = (SLastCol *)taosLRUCacheValue(pCache, h);
-
-        SLastCol lastCol = *pLastCol;
-        for (int8_t j = 0; j < lastCol.rowKey.numOfPKs; j++) {
-          reallocVarDataVal(&lastCol.rowKey.pks[j]);
-        }
-        reallocVarData(&lastCol.colVal);
+      SIdxKey *idxKey = &((SIdxKey *)TARRAY_DATA(remainCols))[i];
+      SLastCol lastCol = {0};
+      if (tsdbCacheGetFromLRU(pCache, &idxKey->key, &lastCol)) {
         taosArraySet(pLastArray, idxKey->idx, &lastCol);
-
-        taosLRUCacheRelease(pCache, h, false);
-
         taosArrayRemove(remainCols, i);
       } else {
         ++i;
@@ -1618,12 +1713,102 @@ int32_t tsdbCacheGetBatch(STsdb *pTsdb, tb_uid_t uid, SArray *pLastArray, SCache
     code = tsdbCacheLoadFromRocks(pTsdb, uid, pLastArray, remainCols, pr, ltype);
 
     taosThreadMutexUnlock(&pTsdb->lruMutex);
+  }
+
+  if (remainCols) {
+    taosArrayDestroy(remainCols);
+  }
+
+  return code;
+}
+
+/**
+ * @brief get the cached columns of a batch of tables, the rows of table i are appended to pLastArrays[i]
+ *
+ * The lru is probed for all the tables first, then the misses of the whole batch are looked up in rocks together, and
+ * only the keys still missing are loaded from tsdb table by table.
+ */
+int32_t tsdbCacheGetTablesBatch(STsdb *pTsdb, const STableKeyInfo *pTables, int32_t numOfTables, SArray **pLastArrays,
+                                SCacheRowsReader *pr, int8_t ltype) {
+  int32_t    code = 0;
+  SArray    *remainCols = NULL;
+  SLRUCache *pCache = pTsdb->lruCache;
+  int        num_keys = TARRAY_SIZE(pr->pCidList);
 
-    if (remainCols) {
-      taosArrayDestroy(remainCols);
+  for (int32_t t = 0; t < numOfTables; ++t) {
+    for (int i = 0; i < num_keys; ++i) {
+      SLastKey key = tsdbCacheGetKey(pr, pTables[t].uid, i, ltype);
+      SLastCol lastCol = {0};
+      if (tsdbCacheGetFromLRU(pCache, &key, &lastCol)) {
+        taosArrayPush(pLastArrays[t], &lastCol);
+      } else {
+        SLastCol noneCol = {.rowKey.ts = TSKEY_MIN,
+                            .colVal = COL_VAL_NONE(key.cid, pr->pSchema->columns[pr->pSlotIds[i]].type)};
+
+        taosArrayPush(pLastArrays[t], &noneCol);
+
+        if (!remainCols) {
+          remainCols = taosArrayInit(num_keys, sizeof(SIdxKey));
+        }
+        taosArrayPush(remainCols, &(SIdxKey){t * num_keys + i, key});
+      }
     }
   }
 
+  if (remainCols == NULL) {
+    return code;
+  }
+
+  taosThreadMutexLock(&pTsdb->lruMutex);
+
+  // loaded by others before the lock
+  int32_t nRemain = 0;
+  for (int32_t i = 0; i < TARRAY_SIZE(remainCols); ++i) {
+    SIdxKey *idxKey = &((SIdxKey *)TARRAY_DATA(remainCols))[i];
+    SLastCol lastCol = {0};
+    if (tsdbCacheGetFromLRU(pCache, &idxKey->key, &lastCol)) {
+      taosArraySet(pLastArrays[idxKey->idx / num_keys], idxKey->idx % num_keys, &lastCol);
+    } else {
+      ((SIdxKey *)TARRAY_DATA(remainCols))[nRemain++] = *idxKey;
+    }
+  }
+  taosArrayPopTailBatch(remainCols, TARRAY_SIZE(remainCols) - nRemain);
+
+  code = tsdbCacheGetFromRocks(pTsdb, remainCols, pLastArrays, num_keys);
+
+  taosThreadMutexUnlock(&pTsdb->lruMutex);
+
+  if (code != 0) {
+    taosArrayDestroy(remainCols);
+    return code;
+  }
+
+  // the keys are in table order, load the ones of each table from tsdb, with the lock taken table by table as
+  // tsdbCacheGetBatch does, so that the writers are not held for the whole batch. Stop at the first table failed.
+  SArray *tableCols = taosArrayInit(num_keys, sizeof(SIdxKey));
+  for (int32_t i = 0; i < TARRAY_SIZE(remainCols) && tableCols && code == 0;) {
+    int32_t t = ((SIdxKey *)TARRAY_DATA(remainCols))[i].idx / num_keys;
+
+    taosArrayClear(tableCols);
+    for (; i < TARRAY_SIZE(remainCols); ++i) {
+      SIdxKey idxKey = ((SIdxKey *)TARRAY_DATA(remainCols))[i];
+      if (idxKey.idx / num_keys != t) break;
+
+      idxKey.idx %= num_keys;
+      taosArrayPush(tableCols, &idxKey);
+    }
+
+    taosThreadMutexLock(&pTsdb->lruMutex);
+    code = tsdbCacheLoadRawFp(pTsdb, pTables[t].uid, pLastArrays[t], tableCols, pr, ltype);
+    taosThreadMutexUnlock(&pTsdb->lruMutex);
+  }
+  if (tableCols == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  taosArrayDestroy(tableCols);
+  taosArrayDestroy(remainCols);
+
   return code;
 }
 
@@ -1664,11 +1849,13 @@ int32_t tsdbCacheDel(STsdb *pTsdb, tb_uid_t suid, tb_uid_t uid, TSKEY sKey, TSKE
 
   taosThreadMutexLock(&pTsdb->lruMutex);
 
-  taosThreadMutexLock(&pTsdb->rCache.rMutex);
-  // rocksMayWrite(pTsdb, true, false, false);
-  rocksdb_multi_get(pTsdb->rCache.db, pTsdb->rCache.readoptions, num_keys * 2, (const char *const *)keys_list,
-                    keys_list_sizes, values_list, values_list_sizes, errs);
-  taosThreadMutexUnlock(&pTsdb->rCache.rMutex);
+  if (!TSDB_CACHE_IN_MEM(pTsdb->pVnode->config)) {
+    taosThreadMutexLock(&pTsdb->rCache.rMutex);
+    // rocksMayWrite(pTsdb, true, false, false);
+    rocksdb_multi_get(pTsdb->rCache.db, pTsdb->rCache.readoptions, num_keys * 2, (const char *const *)keys_list,
+                      keys_list_sizes, values_list, values_list_sizes, errs);
+    taosThreadMutexUnlock(&pTsdb->rCache.rMutex);
+  }
 
   for (int i = 0; i < num_keys * 2; ++i) {
     if (errs[i]) {
@@ -1749,6 +1936,271 @@ _exit:
   return code;
 }
 
+/*
+ * The memory backend keeps the last/last_row values only in the lru. At each commit they are written to a snapshot
+ * file, which is loaded back when the vnode opens at the same committed version. Values that are not in the snapshot,
+ * or are evicted later, are loaded from tsdb when they are read.
+ *
+ * Writes go on while a commit runs, so the values may be of versions after the committed one, up to the applied
+ * version when they are copied. The snapshot is tagged with both, and is loaded only if the wal still holds the
+ * versions in between, which the replay then applies to the cache again.
+ *
+ * SCacheSnapHdr | (SLastKey, uint32_t size, serialized SLastCol) ... | int64_t nEntry | TSCKSUM
+ */
+#define TSDB_CACHE_SNAP_MAGIC    0x4C415354  // "LAST"
+#define TSDB_CACHE_SNAP_FMT      2
+#define TSDB_CACHE_SNAP_BUF_SIZE (1024 * 1024)
+
+typedef struct {
+  uint32_t magic;
+  int32_t  fmt;
+  int64_t  committed;  // committed version of the vnode
+  int64_t  applied;    // the values are of versions not after it
+} SCacheSnapHdr;
+
+typedef struct {
+  SBuffer buffer;
+  int64_t nEntry;
+  int32_t code;
+} SCacheSnapWriter;
+
+static void tsdbGetCacheSnapPath(STsdb *pTsdb, char *path, const char *suffix) {
+  SVnode *pVnode = pTsdb->pVnode;
+  vnodeGetPrimaryDir(pTsdb->path, pVnode->diskPrimary, pVnode->pTfs, path, TSDB_FILENAME_LEN);
+
+  int32_t offset = strlen(path);
+  snprintf(path + offset, TSDB_FILENAME_LEN - offset - 1, "%scache.snap%s", TD_DIRSEP, suffix);
+}
+
+static TSCKSUM tsdbCacheSnapCksum(const uint8_t *buf, int64_t size) {
+  TSCKSUM cksm = 0;
+  for (int64_t offset = 0; offset < size; offset += TSDB_CACHE_SNAP_BUF_SIZE) {
+    cksm = taosCalcChecksum(cksm, buf + offset, TMIN(TSDB_CACHE_SNAP_BUF_SIZE, size - offset));
+  }
+  return cksm;
+}
+
+static int tsdbCacheSnapEntry(const void *key, size_t klen, void *value, void *ud) {
+  SCacheSnapWriter *writer = (SCacheSnapWriter *)ud;
+  char             *data = NULL;
+  size_t            size = 0;
+
+  if (writer->code) return 0;
+
+  tsdbCacheSerialize((SLastCol *)value, &data, &size);
+  if (data == NULL) {
+    writer->code = TSDB_CODE_OUT_OF_MEMORY;
+    return 0;
+  }
+
+  uint32_t vlen = (uint32_t)size;
+  if ((writer->code = tBufferPut(&writer->buffer, key, ROCKS_KEY_LEN)) == 0 &&
+      (writer->code = tBufferPut(&writer->buffer, &vlen, sizeof(vlen))) == 0 &&
+      (writer->code = tBufferPut(&writer->buffer, data, vlen)) == 0) {
+    writer->nEntry++;
+  }
+
+  taosMemoryFree(data);
+  return 0;
+}
+
+/**
+ * @brief write the last/last_row values of the memory backend to the snapshot of a committed version
+ *
+ * The values are copied out under the lock of the lru, and written to the file after it is released.
+ */
+int32_t tsdbCacheSnapshot(STsdb *pTsdb, int64_t committed) {
+  int32_t          code = 0;
+  int32_t          lino = 0;
+  char             fname[TSDB_FILENAME_LEN] = {0};
+  char             tname[TSDB_FILENAME_LEN] = {0};
+  TdFilePtr        fd = NULL;
+  SCacheSnapWriter writer = {.buffer = BUFFER_INITIALIZER};
+  SCacheSnapHdr    hdr = {.magic = TSDB_CACHE_SNAP_MAGIC, .fmt = TSDB_CACHE_SNAP_FMT, .committed = committed};
+  int64_t          st = taosGetTimestampMs();
+
+  if (!TSDB_CACHE_IN_MEM(pTsdb->pVnode->config)) {
+    return code;
+  }
+
+  tsdbGetCacheSnapPath(pTsdb, fname, "");
+  tsdbGetCacheSnapPath(pTsdb, tname, ".t");
+
+  // the header is filled once the applied version is known
+  code = tBufferPut(&writer.buffer, &hdr, sizeof(hdr));
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  taosThreadMutexLock(&pTsdb->lruMutex);
+  // the applied version is set before a write is applied, and the lru is updated under the lock
+  hdr.applied = TMAX(committed, atomic_load_64(&pTsdb->pVnode->state.applied));
+  taosLRUCacheApply(pTsdb->lruCache, tsdbCacheSnapEntry, &writer);
+  taosThreadMutexUnlock(&pTsdb->lruMutex);
+  TSDB_CHECK_CODE(code = writer.code, lino, _exit);
+
+  memcpy(tBufferGetData(&writer.buffer), &hdr, sizeof(hdr));
+  code = tBufferPut(&writer.buffer, &writer.nEntry, sizeof(writer.nEntry));
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  TSCKSUM cksm = tsdbCacheSnapCksum(tBufferGetData(&writer.buffer), tBufferGetSize(&writer.buffer));
+  code = tBufferPut(&writer.buffer, &cksm, sizeof(cksm));
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  fd = taosOpenFile(tname, TD_FILE_CREATE | TD_FILE_WRITE | TD_FILE_TRUNC);
+  if (fd == NULL) {
+    TSDB_CHECK_CODE(code = TAOS_SYSTEM_ERROR(errno), lino, _exit);
+  }
+  if (taosWriteFile(fd, tBufferGetData(&writer.buffer), tBufferGetSize(&writer.buffer)) !=
+      tBufferGetSize(&writer.buffer)) {
+    TSDB_CHECK_CODE(code = TAOS_SYSTEM_ERROR(errno), lino, _exit);
+  }
+  if (taosFsyncFile(fd) < 0) {
+    TSDB_CHECK_CODE(code = TAOS_SYSTEM_ERROR(errno), lino, _exit);
+  }
+  taosCloseFile(&fd);
+
+  if (taosRenameFile(tname, fname) < 0) {
+    TSDB_CHECK_CODE(code = TAOS_SYSTEM_ERROR(errno), lino, _exit);
+  }
+
+_exit:
+  if (fd) {
+    taosCloseFile(&fd);
+  }
+  tBufferDestroy(&writer.buffer);
+  if (code) {
+    (void)taosRemoveFile(tname);
+    tsdbError("vgId:%d %s failed at line %d since %s", TD_VID(pTsdb->pVnode), __func__, lino, tstrerror(code));
+  } else {
+    tsdbInfo("vgId:%d, last cache snapshot at committed version:%" PRId64 " applied version:%" PRId64
+             ", entries:%" PRId64 " usage:%" PRId64 " capacity:%" PRId64 " elapsed:%" PRId64 "ms",
+             TD_VID(pTsdb->pVnode), committed, hdr.applied, writer.nEntry,
+             (int64_t)taosLRUCacheGetUsage(pTsdb->lruCache), (int64_t)taosLRUCacheGetCapacity(pTsdb->lruCache),
+             taosGetTimestampMs() - st);
+  }
+  return code;
+}
+
+/**
+ * @brief load the snapshot of the memory backend into the lru, called once the wal is opened
+ *
+ * @param lastVer the last version of the wal
+ */
+int32_t tsdbCacheLoadSnapshot(STsdb *pTsdb, int64_t lastVer) {
+  int32_t   code = 0;
+  int32_t   lino = 0;
+  char      fname[TSDB_FILENAME_LEN] = {0};
+  TdFilePtr fd = NULL;
+  uint8_t  *buf = NULL;
+  int64_t   size = 0;
+  int64_t   nEntry = 0;
+  int64_t   committed = pTsdb->pVnode->state.committed;
+
+  if (!TSDB_CACHE_IN_MEM(pTsdb->pVnode->config)) {
+    return code;
+  }
+
+  tsdbGetCacheSnapPath(pTsdb, fname, "");
+  if (!taosCheckExistFile(fname)) {
+    return code;
+  }
+
+  fd = taosOpenFile(fname, TD_FILE_READ);
+  if (fd == NULL || taosFStatFile(fd, &size, NULL) < 0) {
+    TSDB_CHECK_CODE(code = TAOS_SYSTEM_ERROR(errno), lino, _exit);
+  }
+
+  int64_t tail = sizeof(int64_t) + sizeof(TSCKSUM);
+  if (size < sizeof(SCacheSnapHdr) + tail) {
+    TSDB_CHECK_CODE(code = TSDB_CODE_FILE_CORRUPTED, lino, _exit);
+  }
+
+  buf = taosMemoryMalloc(size);
+  if (buf == NULL) {
+    TSDB_CHECK_CODE(code = TSDB_CODE_OUT_OF_MEMORY, lino, _exit);
+  }
+  if (taosReadFile(fd, buf, size) != size) {
+    TSDB_CHECK_CODE(code = TAOS_SYSTEM_ERROR(errno), lino, _exit);
+  }
+
+  SCacheSnapHdr *hdr = (SCacheSnapHdr *)buf;
+  if (hdr->magic != TSDB_CACHE_SNAP_MAGIC || hdr->fmt != TSDB_CACHE_SNAP_FMT ||
+      tsdbCacheSnapCksum(buf, size - sizeof(TSCKSUM)) != *(TSCKSUM *)(buf + size - sizeof(TSCKSUM))) {
+    TSDB_CHECK_CODE(code = TSDB_CODE_FILE_CORRUPTED, lino, _exit);
+  }
+
+  // the snapshot is of another version, the vnode was rolled back or replaced since, or the wal does not hold all the
+  // versions the values may be of any more, so the replay cannot make the values up to date
+  if (hdr->committed != committed || (hdr->applied > hdr->committed && hdr->applied > lastVer)) {
+    tsdbInfo("vgId:%d, last cache snapshot of committed version:%" PRId64 " applied version:%" PRId64
+             " is discarded, committed version:%" PRId64 " wal last version:%" PRId64,
+             TD_VID(pTsdb->pVnode), hdr->committed, hdr->applied, committed, lastVer);
+    goto _exit;
+  }
+
+  int64_t offset = sizeof(SCacheSnapHdr);
+  int64_t end = size - tail;
+  while (offset < end) {
+    if (offset + ROCKS_KEY_LEN + sizeof(uint32_t) > end) {
+      TSDB_CHECK_CODE(code = TSDB_CODE_FILE_CORRUPTED, lino, _exit);
+    }
+
+    SLastKey key = {0};
+    uint32_t vlen = 0;
+    memcpy(&key, buf + offset, ROCKS_KEY_LEN);
+    offset += ROCKS_KEY_LEN;
+    memcpy(&vlen, buf + offset, sizeof(vlen));
+    offset += sizeof(vlen);
+    if (offset + vlen > end) {
+      TSDB_CHECK_CODE(code = TSDB_CODE_FILE_CORRUPTED, lino, _exit);
+    }
+
+    SLastCol *pLastCol = tsdbCacheDeserialize((char *)buf + offset, vlen);
+    offset += vlen;
+    if (pLastCol == NULL) {
+      TSDB_CHECK_CODE(code = TSDB_CODE_FILE_CORRUPTED, lino, _exit);
+    }
+
+    pLastCol->dirty = 0;
+    size_t charge = sizeof(*pLastCol);
+    for (int8_t i = 0; i < pLastCol->rowKey.numOfPKs; i++) {
+      SValue *pValue = &pLastCol->rowKey.pks[i];
+      if (IS_VAR_DATA_TYPE(pValue->type)) {
+        reallocVarDataVal(pValue);
+        charge += pValue->nData;
+      }
+    }
+    if (IS_VAR_DATA_TYPE(pLastCol->colVal.value.type)) {
+      reallocVarData(&pLastCol->colVal);
+      charge += pLastCol->colVal.value.nData;
+    }
+
+    LRUStatus status = taosLRUCacheInsert(pTsdb->lruCache, &key, ROCKS_KEY_LEN, pLastCol, charge, tsdbCacheDeleter,
+                                          NULL, TAOS_LRU_PRIORITY_LOW, &pTsdb->flushState);
+    if (status != TAOS_LRU_STATUS_OK) {
+      TSDB_CHECK_CODE(code = TSDB_CODE_OUT_OF_MEMORY, lino, _exit);
+    }
+    nEntry++;
+  }
+  if (nEntry != *(int64_t *)(buf + end)) {
+    TSDB_CHECK_CODE(code = TSDB_CODE_FILE_CORRUPTED, lino, _exit);
+  }
+
+  tsdbInfo("vgId:%d, last cache snapshot of committed version:%" PRId64 " applied version:%" PRId64
+           " is loaded, entries:%" PRId64,
+           TD_VID(pTsdb->pVnode), hdr->committed, hdr->applied, nEntry);
+
+_exit:
+  taosCloseFile(&fd);
+  taosMemoryFree(buf);
+  if (code) {
+    // a snapshot partly loaded is dropped, the values are loaded from tsdb when they are read
+    taosLRUCacheEraseUnrefEntries(pTsdb->lruCache);
+    tsdbWarn("vgId:%d %s failed at line %d since %s, entries dropped:%" PRId64, TD_VID(pTsdb->pVnode), __func__, lino,
+             tstrerror(code), nEntry);
+  }
+  return 0;
+}
+
 int32_t tsdbOpenCache(STsdb *pTsdb) {
   int32_t    code = 0;
   SLRUCache *pCache = NULL;
@@ -1780,12 +2232,22 @@ int32_t tsdbOpenCache(STsdb *pTsdb) {
     goto _err;
   }
 
-  code = tsdbOpenRocksCache(pTsdb);
+  code = tsdbOpenCDCache(pTsdb);
   if (code != TSDB_CODE_SUCCESS) {
     code = TSDB_CODE_OUT_OF_MEMORY;
     goto _err;
   }
 
+  if (TSDB_CACHE_IN_MEM(pTsdb->pVnode->config)) {
+    taosThreadMutexInit(&pTsdb->rCache.rMutex, NULL);
+  } else {
+    code = tsdbOpenRocksCache(pTsdb);
+    if (code != TSDB_CODE_SUCCESS) {
+      code = TSDB_CODE_OUT_OF_MEMORY;
+      goto _err;
+    }
+  }
+
   taosLRUCacheSetStrictCapacity(pCache, false);
 
   taosThreadMutexInit(&pTsdb->lruMutex, NULL);
@@ -1813,7 +2275,12 @@ void tsdbCloseCache(STsdb *pTsdb) {
 #endif
   tsdbCloseBCache(pTsdb);
   tsdbClosePgCache(pTsdb);
-  tsdbCloseRocksCache(pTsdb);
+  tsdbCloseCDCache(pTsdb);
+  if (TSDB_CACHE_IN_MEM(pTsdb->pVnode->config)) {
+    taosThreadMutexDestroy(&pTsdb->rCache.rMutex);
+  } else {
+    tsdbCloseRocksCache(pTsdb);
+  }
 }
 
 static void getTableCacheKey(tb_uid_t uid, int cacheType, char *key, int *len) {
@@ -3810,3 +4277,182 @@ int32_t tsdbCacheSetPageS3(SLRUCache *pCache, STsdbFD *pFD, int64_t pgno, uint8_
 
   return code;
 }
+
+// decompressed column data cache ==============================================================================
+// The data of a file block never changes once written, and a rewritten data file gets a new commit id. So the cached
+// column data is keyed by the data file (fid, commit id), the block offset and the column id.
+typedef struct {
+  int32_t fid;
+  int16_t colId;
+  int16_t reserved;
+  int64_t cid;
+  int64_t blockOffset;
+} SColDataCacheKey;
+
+typedef struct {
+  int32_t fid;
+  int64_t cid;
+  SArray *pKeys;
+} SColDataCacheInvalidator;
+
+static int32_t tsdbColDataBitmapSize(const SColData *pColData) {
+  switch (pColData->flag) {
+    case (HAS_NULL | HAS_NONE):
+    case (HAS_VALUE | HAS_NONE):
+    case (HAS_VALUE | HAS_NULL):
+      return BIT1_SIZE(pColData->nVal);
+    case (HAS_VALUE | HAS_NULL | HAS_NONE):
+      return BIT2_SIZE(pColData->nVal);
+    default:
+      return 0;
+  }
+}
+
+// copy the content of pFrom into pTo, the buffers of pTo are allocated by tRealloc
+static int32_t tsdbColDataCacheCopy(const SColData *pFrom, SColData *pTo) {
+  int32_t code = 0;
+  int32_t szBitmap = tsdbColDataBitmapSize(pFrom);
+
+  pTo->numOfNone = pFrom->numOfNone;
+  pTo->numOfNull = pFrom->numOfNull;
+  pTo->numOfValue = pFrom->numOfValue;
+  pTo->nVal = pFrom->nVal;
+  pTo->flag = pFrom->flag;
+  pTo->nData = pFrom->nData;
+
+  if (szBitmap > 0) {
+    code = tRealloc(&pTo->pBitMap, szBitmap);
+    if (code) return code;
+    memcpy(pTo->pBitMap, pFrom->pBitMap, szBitmap);
+  }
+
+  if (IS_VAR_DATA_TYPE(pFrom->type) && (pFrom->flag & HAS_VALUE)) {
+    code = tRealloc((uint8_t **)&pTo->aOffset, pFrom->nVal << 2);
+    if (code) return code;
+    memcpy(pTo->aOffset, pFrom->aOffset, pFrom->nVal << 2);
+  }
+
+  if (pFrom->nData > 0) {
+    code = tRealloc(&pTo->pData, pFrom->nData);
+    if (code) return code;
+    memcpy(pTo->pData, pFrom->pData, pFrom->nData);
+  }
+
+  return code;
+}
+
+static void deleteCDCache(const void *key, size_t keyLen, void *value, void *ud) {
+  (void)ud;
+  SColData *pColData = (SColData *)value;
+
+  tColDataDestroy(pColData);
+  taosMemoryFree(pColData);
+}
+
+int32_t tsdbColDataCacheGet(STsdb *pTsdb, int32_t fid, int64_t cid, int64_t blockOffset, int16_t colId,
+                            SBlockData *pBlockData, bool *hit) {
+  int32_t    code = 0;
+  SLRUCache *pCache = pTsdb->cdCache;
+
+  *hit = false;
+  if (pCache == NULL) {
+    return code;
+  }
+
+  SColDataCacheKey key = {.fid = fid, .colId = colId, .cid = cid, .blockOffset = blockOffset};
+  LRUHandle       *h = taosLRUCacheLookup(pCache, &key, sizeof(key));
+  if (h == NULL) {
+    atomic_add_fetch_64(&pTsdb->cdCacheMiss, 1);
+    return code;
+  }
+
+  SColData *pCached = (SColData *)taosLRUCacheValue(pCache, h);
+  SColData *pColData = NULL;
+
+  code = tBlockDataAddColData(pBlockData, pCached->cid, pCached->type, pCached->cflag, &pColData);
+  if (code == 0) {
+    code = tsdbColDataCacheCopy(pCached, pColData);
+  }
+
+  taosLRUCacheRelease(pCache, h, false);
+
+  if (code == 0) {
+    atomic_add_fetch_64(&pTsdb->cdCacheHit, 1);
+    *hit = true;
+  }
+  return code;
+}
+
+int32_t tsdbColDataCachePut(STsdb *pTsdb, int32_t fid, int64_t cid, int64_t blockOffset, const SColData *pColData) {
+  SLRUCache *pCache = pTsdb->cdCache;
+  if (pCache == NULL) {
+    return 0;
+  }
+
+  SColData *pCached = taosMemoryCalloc(1, sizeof(SColData));
+  if (pCached == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  tColDataInit(pCached, pColData->cid, pColData->type, pColData->cflag);
+  int32_t code = tsdbColDataCacheCopy(pColData, pCached);
+  if (code) {
+    deleteCDCache(NULL, 0, pCached, NULL);
+    return code;
+  }
+
+  size_t charge = sizeof(SColData) + tsdbColDataBitmapSize(pCached) + pCached->nData;
+  if (IS_VAR_DATA_TYPE(pCached->type) && (pCached->flag & HAS_VALUE)) {
+    charge += pCached->nVal << 2;
+  }
+
+  SColDataCacheKey key = {.fid = fid, .colId = pColData->cid, .cid = cid, .blockOffset = blockOffset};
+  LRUStatus status =
+      taosLRUCacheInsert(pCache, &key, sizeof(key), pCached, charge, deleteCDCache, NULL, TAOS_LRU_PRIORITY_LOW, NULL);
+  if (status != TAOS_LRU_STATUS_OK) {
+    // ignore cache updating if not ok
+  }
+
+  return 0;
+}
+
+static int tsdbColDataCacheCollectKeys(const void *key, size_t keyLen, void *value, void *ud) {
+  SColDataCacheInvalidator *pInvalidator = ud;
+  const SColDataCacheKey   *pKey = key;
+
+  if (keyLen == sizeof(SColDataCacheKey) && pKey->fid == pInvalidator->fid && pKey->cid == pInvalidator->cid) {
+    if (taosArrayPush(pInvalidator->pKeys, pKey) == NULL) {
+      return -1;
+    }
+  }
+
+  return 0;
+}
+
+// drop the column data of a data file removed by commit, compaction or retention
+void tsdbColDataCacheInvalidate(STsdb *pTsdb, int32_t fid, int64_t cid) {
+  SLRUCache *pCache = pTsdb->cdCache;
+  if (pCache == NULL || taosLRUCacheGetElems(pCache) == 0) {
+    return;
+  }
+
+  SColDataCacheInvalidator invalidator = {.fid = fid, .cid = cid, .pKeys = taosArrayInit(16, sizeof(SColDataCacheKey))};
+  if (invalidator.pKeys == NULL) {
+    return;
+  }
+
+  taosLRUCacheApply(pCache, tsdbColDataCacheCollectKeys, &invalidator);
+  for (int32_t i = 0; i < taosArrayGetSize(invalidator.pKeys); ++i) {
+    taosLRUCacheErase(pCache, taosArrayGet(invalidator.pKeys, i), sizeof(SColDataCacheKey));
+  }
+
+  tsdbDebug("vgId:%d, %d cached column data of file fid:%d, cid:%" PRId64 " are invalidated", TD_VID(pTsdb->pVnode),
+            (int32_t)taosArrayGetSize(invalidator.pKeys), fid, cid);
+  taosArrayDestroy(invalidator.pKeys);
+}
+
+void tsdbColDataCacheGetStat(STsdb *pTsdb, int64_t *hit, int64_t *miss, size_t *usage) {
+  *hit = atomic_load_64(&pTsdb->cdCacheHit);
+  *miss = atomic_load_64(&pTsdb->cdCacheMiss);
+  *usage = (pTsdb->cdCache != NULL) ? taosLRUCacheGetUsage(pTsdb->cdCache) : 0;
+}
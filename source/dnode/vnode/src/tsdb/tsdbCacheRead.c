@@ -23,6 +23,8 @@
 
 #define HASTYPE(_type, _t) (((_type) & (_t)) == (_t))
 
+#define CACHE_ROWS_BATCH_TABLES 1024  // tables whose cached rows are fetched together
+
 static void setFirstLastResColToNull(SColumnInfoData* pCol, int32_t row) {
   char*          buf = taosMemoryCalloc(1, pCol->info.bytes);
   SFirstLastRes* pRes = (SFirstLastRes*)((char*)buf + VARSTR_HEADER_SIZE);
@@ -373,6 +375,60 @@ static int32_t tsdbCacheQueryReseek(void* pQHandle) {
   }
 }
 
+/**
+ * @brief load the cached columns of all tables of the reader into the last cache, without returning any row
+ */
+int32_t tsdbCacherowsReaderLoad(void* pReader) {
+  SCacheRowsReader* pr = pReader;
+  int32_t           code = TSDB_CODE_SUCCESS;
+  int32_t           nBatch = TMIN(pr->numOfTables, CACHE_ROWS_BATCH_TABLES);
+  int8_t            ltype = (pr->type & CACHESCAN_RETRIEVE_LAST) >> 3;
+
+  if (nBatch <= 0) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  SArray** pRows = taosMemoryCalloc(nBatch, POINTER_BYTES);
+  if (pRows == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  for (int32_t i = 0; i < nBatch; ++i) {
+    pRows[i] = taosArrayInit(TARRAY_SIZE(pr->pCidList), sizeof(SLastCol));
+    if (pRows[i] == NULL) {
+      code = TSDB_CODE_OUT_OF_MEMORY;
+      goto _end;
+    }
+  }
+
+  taosThreadMutexLock(&pr->readerMutex);
+  code = tsdbTakeReadSnap2((STsdbReader*)pr, tsdbCacheQueryReseek, &pr->pReadSnap);
+  if (code == TSDB_CODE_SUCCESS) {
+    for (int32_t start = 0; start < pr->numOfTables; start += nBatch) {
+      int32_t num = TMIN(nBatch, pr->numOfTables - start);
+      code = tsdbCacheGetTablesBatch(pr->pTsdb, pr->pTableList + start, num, pRows, pr, ltype);
+      for (int32_t i = 0; i < num; ++i) {
+        taosArrayClearEx(pRows[i], freeItemOfRow);
+      }
+      if (code != TSDB_CODE_SUCCESS) {
+        break;
+      }
+    }
+  }
+
+  tsdbUntakeReadSnap2((STsdbReader*)pr, pr->pReadSnap, true);
+  pr->pCurFileSet = NULL;
+  taosThreadMutexUnlock(&pr->readerMutex);
+
+_end:
+  for (int32_t i = 0; i < nBatch; ++i) {
+    taosArrayDestroyEx(pRows[i], freeItemOfRow);
+  }
+  taosMemoryFree(pRows);
+
+  return code;
+}
+
 int32_t tsdbRetrieveCacheRows(void* pReader, SSDataBlock* pResBlock, const int32_t* slotIds, const int32_t* dstSlotIds,
                               SArray* pTableUidList) {
   if (pReader == NULL || pResBlock == NULL) {
@@ -381,15 +437,24 @@ int32_t tsdbRetrieveCacheRows(void* pReader, SSDataBlock* pResBlock, const int32
 
   SCacheRowsReader* pr = pReader;
   int32_t           code = TSDB_CODE_SUCCESS;
-  SArray*           pRow = taosArrayInit(TARRAY_SIZE(pr->pCidList), sizeof(SLastCol));
+  int32_t           nBatch = TMIN(pr->numOfTables, CACHE_ROWS_BATCH_TABLES);
+  SArray**          pRows = taosMemoryCalloc(TMAX(nBatch, 1), POINTER_BYTES);
   bool              hasRes = false;
 
   void** pRes = taosMemoryCalloc(pr->numOfCols, POINTER_BYTES);
-  if (pRes == NULL) {
+  if (pRes == NULL || pRows == NULL) {
     code = TSDB_CODE_OUT_OF_MEMORY;
     goto _end;
   }
 
+  for (int32_t i = 0; i < nBatch; ++i) {
+    pRows[i] = taosArrayInit(TARRAY_SIZE(pr->pCidList), sizeof(SLastCol));
+    if (pRows[i] == NULL) {
+      code = TSDB_CODE_OUT_OF_MEMORY;
+      goto _end;
+    }
+  }
+
   int32_t pkBufLen = (pr->rowKey.numOfPKs > 0)? pr->pkColumn.bytes:0;
   for (int32_t j = 0; j < pr->numOfCols; ++j) {
     int32_t bytes = (slotIds[j] == -1) ? 1 : pr->pSchema->columns[slotIds[j]].bytes;
@@ -445,84 +510,88 @@ int32_t tsdbRetrieveCacheRows(void* pReader, SSDataBlock* pResBlock, const int32
 
     int64_t st = taosGetTimestampUs();
     int64_t totalLastTs = INT64_MAX;
-    for (int32_t i = 0; i < pr->numOfTables; ++i) {
-      tb_uid_t uid = pTableList[i].uid;
+    for (int32_t start = 0; start < pr->numOfTables; start += nBatch) {
+      int32_t num = TMIN(nBatch, pr->numOfTables - start);
+      tsdbCacheGetTablesBatch(pr->pTsdb, pTableList + start, num, pRows, pr, ltype);
+
+      for (int32_t i = start; i < start + num; ++i) {
+        tb_uid_t uid = pTableList[i].uid;
+        SArray*  pRow = pRows[i - start];
+        if (TARRAY_SIZE(pRow) <= 0 || COL_VAL_IS_NONE(&((SLastCol*)TARRAY_DATA(pRow))[0].colVal)) {
+          taosArrayClearEx(pRow, freeItemOfRow);
+          continue;
+        }
 
-      tsdbCacheGetBatch(pr->pTsdb, uid, pRow, pr, ltype);
-      if (TARRAY_SIZE(pRow) <= 0 || COL_VAL_IS_NONE(&((SLastCol*)TARRAY_DATA(pRow))[0].colVal)) {
-        taosArrayClearEx(pRow, freeItemOfRow);
-        continue;
-      }
+        {
+          bool    hasNotNullRow = true;
+          int64_t singleTableLastTs = INT64_MAX;
+          for (int32_t k = 0; k < pr->numOfCols; ++k) {
+            if (slotIds[k] == -1) continue;
+            SLastCol* p = taosArrayGet(pLastCols, k);
+            SLastCol* pColVal = (SLastCol*)taosArrayGet(pRow, k);
+
+            if (tRowKeyCompare(&pColVal->rowKey, &p->rowKey) > 0) {
+              if (!COL_VAL_IS_VALUE(&pColVal->colVal) && HASTYPE(pr->type, CACHESCAN_RETRIEVE_LAST)) {
+                if (!COL_VAL_IS_VALUE(&p->colVal)) {
+                  hasNotNullRow = false;
+                }
+                // For all of cols is null, the last null col of last table will be save
+                if (i != pr->numOfTables - 1 || k != pr->numOfCols - 1 || hasRes) {
+                  continue;
+                }
+              }
 
-      {
-        bool    hasNotNullRow = true;
-        int64_t singleTableLastTs = INT64_MAX;
-        for (int32_t k = 0; k < pr->numOfCols; ++k) {
-          if (slotIds[k] == -1) continue;
-          SLastCol* p = taosArrayGet(pLastCols, k);
-          SLastCol* pColVal = (SLastCol*)taosArrayGet(pRow, k);
-
-          if (tRowKeyCompare(&pColVal->rowKey, &p->rowKey) > 0) {
-            if (!COL_VAL_IS_VALUE(&pColVal->colVal) && HASTYPE(pr->type, CACHESCAN_RETRIEVE_LAST)) {
-              if (!COL_VAL_IS_VALUE(&p->colVal)) {
-                hasNotNullRow = false;
+              hasRes = true;
+              p->rowKey.ts = pColVal->rowKey.ts;
+              for (int32_t j = 0; j < p->rowKey.numOfPKs; j++) {
+                if (IS_VAR_DATA_TYPE(p->rowKey.pks[j].type)) {
+                  memcpy(p->rowKey.pks[j].pData, pColVal->rowKey.pks[j].pData, pColVal->rowKey.pks[j].nData);
+                  p->rowKey.pks[j].nData = pColVal->rowKey.pks[j].nData;
+                } else {
+                  p->rowKey.pks[j].val = pColVal->rowKey.pks[j].val;
+                }
               }
-              // For all of cols is null, the last null col of last table will be save
-              if (i != pr->numOfTables - 1 || k != pr->numOfCols - 1 || hasRes) {
-                continue;
+
+              if (k == 0) {
+                if (TARRAY_SIZE(pTableUidList) == 0) {
+                  taosArrayPush(pTableUidList, &uid);
+                } else {
+                  taosArraySet(pTableUidList, 0, &uid);
+                }
               }
-            }
 
-            hasRes = true;
-            p->rowKey.ts = pColVal->rowKey.ts;
-            for (int32_t j = 0; j < p->rowKey.numOfPKs; j++) {
-              if (IS_VAR_DATA_TYPE(p->rowKey.pks[j].type)) {
-                memcpy(p->rowKey.pks[j].pData, pColVal->rowKey.pks[j].pData, pColVal->rowKey.pks[j].nData);
-                p->rowKey.pks[j].nData = pColVal->rowKey.pks[j].nData;
-              } else {
-                p->rowKey.pks[j].val = pColVal->rowKey.pks[j].val;
+              if (pColVal->rowKey.ts < singleTableLastTs && HASTYPE(pr->type, CACHESCAN_RETRIEVE_LAST)) {
+                singleTableLastTs = pColVal->rowKey.ts;
               }
-            }
 
-            if (k == 0) {
-              if (TARRAY_SIZE(pTableUidList) == 0) {
-                taosArrayPush(pTableUidList, &uid);
+              if (!IS_VAR_DATA_TYPE(pColVal->colVal.value.type)) {
+                p->colVal = pColVal->colVal;
               } else {
-                taosArraySet(pTableUidList, 0, &uid);
+                if (COL_VAL_IS_VALUE(&pColVal->colVal)) {
+                  memcpy(p->colVal.value.pData, pColVal->colVal.value.pData, pColVal->colVal.value.nData);
+                }
+
+                p->colVal.value.nData = pColVal->colVal.value.nData;
+                p->colVal.value.type = pColVal->colVal.value.type;
+                p->colVal.flag = pColVal->colVal.flag;
+                p->colVal.cid = pColVal->colVal.cid;
               }
             }
+          }
 
-            if (pColVal->rowKey.ts < singleTableLastTs && HASTYPE(pr->type, CACHESCAN_RETRIEVE_LAST)) {
-              singleTableLastTs = pColVal->rowKey.ts;
+          if (hasNotNullRow) {
+            if (INT64_MAX == totalLastTs || (INT64_MAX != singleTableLastTs && totalLastTs < singleTableLastTs)) {
+              totalLastTs = singleTableLastTs;
             }
-
-            if (!IS_VAR_DATA_TYPE(pColVal->colVal.value.type)) {
-              p->colVal = pColVal->colVal;
-            } else {
-              if (COL_VAL_IS_VALUE(&pColVal->colVal)) {
-                memcpy(p->colVal.value.pData, pColVal->colVal.value.pData, pColVal->colVal.value.nData);
-              }
-
-              p->colVal.value.nData = pColVal->colVal.value.nData;
-              p->colVal.value.type = pColVal->colVal.value.type;
-              p->colVal.flag = pColVal->colVal.flag;
-              p->colVal.cid = pColVal->colVal.cid;
+            double cost = (taosGetTimestampUs() - st) / 1000.0;
+            if (cost > tsCacheLazyLoadThreshold) {
+              pr->lastTs = totalLastTs;
             }
           }
         }
 
-        if (hasNotNullRow) {
-          if (INT64_MAX == totalLastTs || (INT64_MAX != singleTableLastTs && totalLastTs < singleTableLastTs)) {
-            totalLastTs = singleTableLastTs;
-          }
-          double cost = (taosGetTimestampUs() - st) / 1000.0;
-          if (cost > tsCacheLazyLoadThreshold) {
-            pr->lastTs = totalLastTs;
-          }
-        }
+        taosArrayClearEx(pRow, freeItemOfRow);
       }
-
-      taosArrayClearEx(pRow, freeItemOfRow);
     }
 
     if (hasRes) {
@@ -531,24 +600,32 @@ int32_t tsdbRetrieveCacheRows(void* pReader, SSDataBlock* pResBlock, const int32
 
     taosArrayDestroyEx(pLastCols, freeItemWithPk);
   } else if (HASTYPE(pr->type, CACHESCAN_RETRIEVE_TYPE_ALL)) {
-    for (int32_t i = pr->tableIndex; i < pr->numOfTables; ++i) {
-      tb_uid_t uid = pTableList[i].uid;
+    for (int32_t start = pr->tableIndex; start < pr->numOfTables;) {
+      // no more tables than the rows left in the block, the rest of a batch would be fetched again by the next call
+      int32_t num = TMIN(nBatch, pr->numOfTables - start);
+      num = TMAX(1, TMIN(num, pResBlock->info.capacity - pResBlock->info.rows));
+      tsdbCacheGetTablesBatch(pr->pTsdb, pTableList + start, num, pRows, pr, ltype);
+
+      for (int32_t i = start; i < start + num; ++i) {
+        tb_uid_t uid = pTableList[i].uid;
+        SArray*  pRow = pRows[i - start];
+
+        if (TARRAY_SIZE(pRow) <= 0 || COL_VAL_IS_NONE(&((SLastCol*)TARRAY_DATA(pRow))[0].colVal)) {
+          taosArrayClearEx(pRow, freeItemOfRow);
+          continue;
+        }
 
-      tsdbCacheGetBatch(pr->pTsdb, uid, pRow, pr, ltype);
-      if (TARRAY_SIZE(pRow) <= 0 || COL_VAL_IS_NONE(&((SLastCol*)TARRAY_DATA(pRow))[0].colVal)) {
+        saveOneRow(pRow, pResBlock, pr, slotIds, dstSlotIds, pRes, pr->idstr);
         taosArrayClearEx(pRow, freeItemOfRow);
-        continue;
-      }
 
-      saveOneRow(pRow, pResBlock, pr, slotIds, dstSlotIds, pRes, pr->idstr);
-      taosArrayClearEx(pRow, freeItemOfRow);
+        taosArrayPush(pTableUidList, &uid);
 
-      taosArrayPush(pTableUidList, &uid);
-
-      ++pr->tableIndex;
-      if (pResBlock->info.rows >= pResBlock->info.capacity) {
-        goto _end;
+        ++pr->tableIndex;
+        if (pResBlock->info.rows >= pResBlock->info.capacity) {
+          goto _end;
+        }
       }
+      start += num;
     }
   } else {
     code = TSDB_CODE_INVALID_PARA;
@@ -569,7 +646,12 @@ _end:
   }
 
   taosMemoryFree(pRes);
-  taosArrayDestroy(pRow);
+  if (pRows != NULL) {
+    for (int32_t i = 0; i < nBatch; ++i) {
+      taosArrayDestroyEx(pRows[i], freeItemOfRow);
+    }
+  }
+  taosMemoryFree(pRows);
 
   return code;
 }
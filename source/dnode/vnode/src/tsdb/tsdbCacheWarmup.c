@@ -0,0 +1,438 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tsdb.h"
+#include "tsdbFS2.h"
+#include "tsdbReadUtil.h"
+#include "tsdbSttFileRW.h"
+#include "vnd.h"
+
+#define TSDB_CACHE_WARMUP_SLICE 1024  // tables loaded by one run of the warm-up task
+
+/*
+ * The warm-up task loads the last/last_row cache of the most recently written tables after the vnode is opened, so
+ * the first cache queries do not have to read them from the files. The candidates are the tables in the memtables
+ * and in the stt files of the newest file set, ordered by their max key. The task runs in the merge pool with low
+ * priority and loads a slice of tables each run, then enqueues itself again, so it never holds a worker for long and
+ * can be stopped between two slices.
+ */
+typedef struct {
+  tb_uid_t suid;
+  tb_uid_t uid;
+  TSKEY    maxKey;
+} SWarmupTable;
+
+struct SCacheWarmup {
+  STsdb          *tsdb;
+  SVAChannelID    channel;
+  volatile int8_t stop;
+
+  bool    prepared;
+  SArray *aTable;  // SArray<SWarmupTable>
+  int32_t nTable;
+  int32_t cursor;
+  int64_t nLoaded;
+  int64_t startUs;
+};
+
+static int32_t tsdbWarmupTableCmprFn(const void *p1, const void *p2) {
+  const SWarmupTable *pTable1 = p1;
+  const SWarmupTable *pTable2 = p2;
+
+  if (pTable1->maxKey > pTable2->maxKey) {
+    return -1;
+  } else if (pTable1->maxKey < pTable2->maxKey) {
+    return 1;
+  }
+  return 0;
+}
+
+static int32_t tsdbWarmupTableGroupCmprFn(const void *p1, const void *p2) {
+  const SWarmupTable *pTable1 = p1;
+  const SWarmupTable *pTable2 = p2;
+
+  if (pTable1->suid < pTable2->suid) {
+    return -1;
+  } else if (pTable1->suid > pTable2->suid) {
+    return 1;
+  }
+
+  if (pTable1->uid < pTable2->uid) {
+    return -1;
+  } else if (pTable1->uid > pTable2->uid) {
+    return 1;
+  }
+  return 0;
+}
+
+static int32_t tsdbWarmupAddTable(SCacheWarmup *warmup, SSHashObj *uidMap, tb_uid_t suid, tb_uid_t uid, TSKEY maxKey) {
+  int32_t *pIdx = tSimpleHashGet(uidMap, &uid, sizeof(uid));
+  if (pIdx) {
+    SWarmupTable *pTable = taosArrayGet(warmup->aTable, *pIdx);
+    pTable->maxKey = TMAX(pTable->maxKey, maxKey);
+    return 0;
+  }
+
+  int32_t      idx = taosArrayGetSize(warmup->aTable);
+  SWarmupTable table = {.suid = suid, .uid = uid, .maxKey = maxKey};
+  if (taosArrayPush(warmup->aTable, &table) == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+  return tSimpleHashPut(uidMap, &uid, sizeof(uid), &idx, sizeof(idx));
+}
+
+// the caller holds tsdb->mutex, so the memtable can not be released
+static int32_t tsdbWarmupCollectMem(SCacheWarmup *warmup, SMemTable *pMemTable, SSHashObj *uidMap) {
+  int32_t code = 0;
+
+  if (pMemTable == NULL) return 0;
+
+  taosRLockLatch(&pMemTable->latch);
+  for (int32_t iBucket = 0; iBucket < pMemTable->nBucket && code == 0; iBucket++) {
+    for (STbData *pTbData = pMemTable->aBucket[iBucket]; pTbData && code == 0; pTbData = pTbData->next) {
+      code = tsdbWarmupAddTable(warmup, uidMap, pTbData->suid, pTbData->uid, pTbData->maxKey);
+    }
+  }
+  taosRUnLockLatch(&pMemTable->latch);
+
+  return code;
+}
+
+static int32_t tsdbWarmupCollectStt(SCacheWarmup *warmup, SSHashObj *uidMap) {
+  int32_t         code = 0;
+  int32_t         lino = 0;
+  STsdb          *tsdb = warmup->tsdb;
+  TFileSetArray  *fsetArr = NULL;
+  SSttFileReader *reader = NULL;
+  STbStatisBlock  block;
+
+  tStatisBlockInit(&block);
+
+  code = tsdbFSCreateRefSnapshot(tsdb->pFS, &fsetArr);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  if (TARRAY2_SIZE(fsetArr) == 0) goto _exit;
+
+  const STFileSet *fset = TARRAY2_LAST(fsetArr);
+  const SSttLvl   *lvl;
+  TARRAY2_FOREACH(fset->lvlArr, lvl) {
+    STFileObj *fobj;
+    TARRAY2_FOREACH(lvl->fobjArr, fobj) {
+      if (atomic_load_8(&warmup->stop)) goto _exit;
+
+      SSttFileReaderConfig config = {
+          .tsdb = tsdb,
+          .szPage = tsdb->pVnode->config.tsdbPageSize,
+          .file[0] = fobj->f[0],
+      };
+      code = tsdbSttFileReaderOpen(fobj->fname, &config, &reader);
+      TSDB_CHECK_CODE(code, lino, _exit);
+
+      const TStatisBlkArray *statisBlkArray = NULL;
+      code = tsdbSttFileReadStatisBlk(reader, &statisBlkArray);
+      TSDB_CHECK_CODE(code, lino, _exit);
+
+      for (int32_t i = 0; i < TARRAY2_SIZE(statisBlkArray); i++) {
+        code = tsdbSttFileReadStatisBlock(reader, TARRAY2_GET_PTR(statisBlkArray, i), &block);
+        TSDB_CHECK_CODE(code, lino, _exit);
+
+        const int64_t *suids = (const int64_t *)block.suids.data;
+        const int64_t *uids = (const int64_t *)block.uids.data;
+        const int64_t *lastKeys = (const int64_t *)block.lastKeyTimestamps.data;
+        for (int32_t j = 0; j < block.numOfRecords; j++) {
+          code = tsdbWarmupAddTable(warmup, uidMap, suids[j], uids[j], lastKeys[j]);
+          TSDB_CHECK_CODE(code, lino, _exit);
+        }
+      }
+
+      tsdbSttFileReaderClose(&reader);
+    }
+  }
+
+_exit:
+  if (code) {
+    TSDB_ERROR_LOG(TD_VID(tsdb->pVnode), lino, code);
+  }
+  tsdbSttFileReaderClose(&reader);
+  tStatisBlockDestroy(&block);
+  tsdbFSDestroyRefSnapshot(&fsetArr);
+  return code;
+}
+
+static int32_t tsdbWarmupPrepare(SCacheWarmup *warmup) {
+  int32_t    code = 0;
+  int32_t    lino = 0;
+  STsdb     *tsdb = warmup->tsdb;
+  SSHashObj *uidMap = tSimpleHashInit(1024, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BIGINT));
+
+  warmup->aTable = taosArrayInit(1024, sizeof(SWarmupTable));
+  if (uidMap == NULL || warmup->aTable == NULL) {
+    TSDB_CHECK_CODE(code = TSDB_CODE_OUT_OF_MEMORY, lino, _exit);
+  }
+
+  taosThreadMutexLock(&tsdb->mutex);
+  code = tsdbWarmupCollectMem(warmup, tsdb->mem, uidMap);
+  if (code == 0) {
+    code = tsdbWarmupCollectMem(warmup, tsdb->imem, uidMap);
+  }
+  taosThreadMutexUnlock(&tsdb->mutex);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  code = tsdbWarmupCollectStt(warmup, uidMap);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  taosArraySort(warmup->aTable, tsdbWarmupTableCmprFn);
+  if (taosArrayGetSize(warmup->aTable) > tsLastCacheWarmupTables) {
+    taosArrayPopTailBatch(warmup->aTable, taosArrayGetSize(warmup->aTable) - tsLastCacheWarmupTables);
+  }
+
+  warmup->nTable = taosArrayGetSize(warmup->aTable);
+  warmup->prepared = true;
+
+_exit:
+  if (code) {
+    TSDB_ERROR_LOG(TD_VID(tsdb->pVnode), lino, code);
+  }
+  tSimpleHashCleanup(uidMap);
+  return code;
+}
+
+static int32_t tsdbWarmupLoadTables(SCacheWarmup *warmup, tb_uid_t suid, STableKeyInfo *pTables, int32_t numOfTables) {
+  int32_t  code = 0;
+  SVnode  *pVnode = warmup->tsdb->pVnode;
+  SArray  *pCidList = NULL;
+  int32_t *pSlotIds = NULL;
+
+  STSchema *pSchema = metaGetTbTSchema(pVnode->pMeta, suid ? suid : pTables[0].uid, -1, 1);
+  if (pSchema == NULL) {
+    // dropped after the slice was resolved
+    return 0;
+  }
+
+  int32_t numOfCols = pSchema->numOfCols;
+  pCidList = taosArrayInit(numOfCols, sizeof(int16_t));
+  pSlotIds = taosMemoryMalloc(numOfCols * sizeof(int32_t));
+  if (pCidList == NULL || pSlotIds == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _exit;
+  }
+
+  for (int32_t i = 0; i < numOfCols; i++) {
+    int16_t cid = pSchema->columns[i].colId;
+    taosArrayPush(pCidList, &cid);
+    pSlotIds[i] = i;
+  }
+
+  SColumnInfo pkCol = {0};
+  int32_t     numOfPks = 0;
+  if (numOfCols > 1 && (pSchema->columns[1].flags & COL_IS_KEY)) {
+    pkCol.colId = pSchema->columns[1].colId;
+    pkCol.type = pSchema->columns[1].type;
+    pkCol.bytes = pSchema->columns[1].bytes;
+    pkCol.pk = 1;
+    numOfPks = 1;
+  }
+
+  int32_t types[2];
+  int32_t numOfTypes = 0;
+  if (TSDB_CACHE_LAST_ROW(pVnode->config)) {
+    types[numOfTypes++] = CACHESCAN_RETRIEVE_TYPE_ALL | CACHESCAN_RETRIEVE_LAST_ROW;
+  }
+  if (TSDB_CACHE_LAST(pVnode->config)) {
+    types[numOfTypes++] = CACHESCAN_RETRIEVE_TYPE_ALL | CACHESCAN_RETRIEVE_LAST;
+  }
+
+  for (int32_t i = 0; i < numOfTypes && !atomic_load_8(&warmup->stop); i++) {
+    void *pReader = NULL;
+    code = tsdbCacherowsReaderOpen(pVnode, types[i], pTables, numOfTables, numOfCols, pCidList, pSlotIds, suid,
+                                   &pReader, "cache warm-up", NULL, numOfPks > 0 ? &pkCol : NULL, numOfPks);
+    if (code == TSDB_CODE_PAR_TABLE_NOT_EXIST) {
+      code = 0;
+      break;
+    } else if (code) {
+      break;
+    }
+
+    code = tsdbCacherowsReaderLoad(pReader);
+    tsdbCacherowsReaderClose(pReader);
+    if (code) break;
+  }
+
+_exit:
+  taosArrayDestroy(pCidList);
+  taosMemoryFree(pSlotIds);
+  taosMemoryFree(pSchema);
+  return code;
+}
+
+static int32_t tsdbWarmupLoadSlice(SCacheWarmup *warmup) {
+  int32_t  code = 0;
+  int32_t  lino = 0;
+  SMeta   *pMeta = warmup->tsdb->pVnode->pMeta;
+  int32_t  end = TMIN(warmup->cursor + TSDB_CACHE_WARMUP_SLICE, warmup->nTable);
+  SArray  *aSlice = taosArrayInit(end - warmup->cursor, sizeof(SWarmupTable));
+  SArray  *aKeyInfo = taosArrayInit(end - warmup->cursor, sizeof(STableKeyInfo));
+  int32_t  nLoaded = 0;
+
+  if (aSlice == NULL || aKeyInfo == NULL) {
+    TSDB_CHECK_CODE(code = TSDB_CODE_OUT_OF_MEMORY, lino, _exit);
+  }
+
+  // skip the dropped tables and take the super table from meta, the memtable may keep a dropped table
+  for (int32_t i = warmup->cursor; i < end; i++) {
+    SWarmupTable *pTable = taosArrayGet(warmup->aTable, i);
+    SMetaInfo     info;
+    if (metaGetInfo(pMeta, pTable->uid, &info, NULL) != 0) continue;
+
+    SWarmupTable table = {.suid = info.suid, .uid = pTable->uid, .maxKey = pTable->maxKey};
+    if (taosArrayPush(aSlice, &table) == NULL) {
+      TSDB_CHECK_CODE(code = TSDB_CODE_OUT_OF_MEMORY, lino, _exit);
+    }
+  }
+  taosArraySort(aSlice, tsdbWarmupTableGroupCmprFn);
+
+  // the child tables of a super table are loaded by one reader, a normal table by its own
+  for (int32_t i = 0; i < taosArrayGetSize(aSlice) && !atomic_load_8(&warmup->stop);) {
+    SWarmupTable *pFirst = taosArrayGet(aSlice, i);
+
+    taosArrayClear(aKeyInfo);
+    int32_t j = i;
+    do {
+      SWarmupTable *pTable = taosArrayGet(aSlice, j);
+      if (pTable->suid != pFirst->suid) break;
+
+      STableKeyInfo keyInfo = {.uid = pTable->uid, .groupId = 0};
+      taosArrayPush(aKeyInfo, &keyInfo);
+      j++;
+    } while (j < taosArrayGetSize(aSlice) && pFirst->suid != 0);
+
+    code = tsdbWarmupLoadTables(warmup, pFirst->suid, TARRAY_DATA(aKeyInfo), j - i);
+    TSDB_CHECK_CODE(code, lino, _exit);
+
+    nLoaded += j - i;
+    i = j;
+  }
+
+  tsdbDebug("vgId:%d, last cache warm-up loaded tables:%d in slice:[%d, %d)", TD_VID(warmup->tsdb->pVnode), nLoaded,
+            warmup->cursor, end);
+  warmup->nLoaded += nLoaded;
+  warmup->cursor = end;
+
+_exit:
+  if (code) {
+    TSDB_ERROR_LOG(TD_VID(warmup->tsdb->pVnode), lino, code);
+  }
+  taosArrayDestroy(aSlice);
+  taosArrayDestroy(aKeyInfo);
+  return code;
+}
+
+static int32_t tsdbCacheWarmupRun(void *arg) {
+  int32_t       code = 0;
+  int32_t       lino = 0;
+  SCacheWarmup *warmup = arg;
+  STsdb        *tsdb = warmup->tsdb;
+
+  if (atomic_load_8(&warmup->stop)) return 0;
+
+  if (!warmup->prepared) {
+    code = tsdbWarmupPrepare(warmup);
+    TSDB_CHECK_CODE(code, lino, _exit);
+
+    tsdbInfo("vgId:%d, last cache warm-up started, tables:%d", TD_VID(tsdb->pVnode), warmup->nTable);
+  }
+
+  code = tsdbWarmupLoadSlice(warmup);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  if (warmup->cursor < warmup->nTable) {
+    if (atomic_load_8(&warmup->stop)) return 0;
+
+    code = vnodeAsync(&warmup->channel, EVA_PRIORITY_LOW, tsdbCacheWarmupRun, NULL, warmup, NULL);
+    if (code && atomic_load_8(&warmup->stop)) {
+      // the channel is destroyed by the stop
+      code = 0;
+    }
+    TSDB_CHECK_CODE(code, lino, _exit);
+  } else {
+    tsdbInfo("vgId:%d, last cache warm-up finished, tables:%d loaded:%" PRId64 " elapsed:%" PRId64 "ms",
+             TD_VID(tsdb->pVnode), warmup->nTable, warmup->nLoaded, (taosGetTimestampUs() - warmup->startUs) / 1000);
+    warmup->aTable = taosArrayDestroy(warmup->aTable);
+  }
+
+_exit:
+  if (code) {
+    tsdbError("vgId:%d, last cache warm-up stopped at table:%d/%d since %s, line:%d", TD_VID(tsdb->pVnode),
+              warmup->cursor, warmup->nTable, tstrerror(code), lino);
+  }
+  return code;
+}
+
+/**
+ * @brief start to warm up the last cache of the vnode in background if lastCacheWarmupTables is set
+ */
+int32_t tsdbCacheWarmupStart(STsdb *pTsdb) {
+  int32_t code = 0;
+
+  if (tsLastCacheWarmupTables <= 0 || TSDB_CACHE_NO(pTsdb->pVnode->config)) return 0;
+
+  SCacheWarmup *warmup = taosMemoryCalloc(1, sizeof(*warmup));
+  if (warmup == NULL) return TSDB_CODE_OUT_OF_MEMORY;
+
+  warmup->tsdb = pTsdb;
+  warmup->startUs = taosGetTimestampUs();
+  if ((code = vnodeAChannelInit(2, &warmup->channel))) {
+    taosMemoryFree(warmup);
+    return code;
+  }
+
+  taosThreadMutexLock(&pTsdb->mutex);
+  if (pTsdb->pCacheWarmup == NULL && !pTsdb->bgTaskDisabled) {
+    code = vnodeAsync(&warmup->channel, EVA_PRIORITY_LOW, tsdbCacheWarmupRun, NULL, warmup, NULL);
+    if (code == 0) {
+      pTsdb->pCacheWarmup = warmup;
+      warmup = NULL;
+    }
+  }
+  taosThreadMutexUnlock(&pTsdb->mutex);
+
+  if (warmup) {
+    vnodeAChannelDestroy(&warmup->channel, false);
+    taosMemoryFree(warmup);
+  }
+  return code;
+}
+
+/**
+ * @brief stop the warm-up of the last cache and wait for its running slice
+ */
+void tsdbCacheWarmupStop(STsdb *pTsdb) {
+  taosThreadMutexLock(&pTsdb->mutex);
+  SCacheWarmup *warmup = pTsdb->pCacheWarmup;
+  pTsdb->pCacheWarmup = NULL;
+  taosThreadMutexUnlock(&pTsdb->mutex);
+
+  if (warmup == NULL) return;
+
+  atomic_store_8(&warmup->stop, 1);
+  vnodeAChannelDestroy(&warmup->channel, true);
+
+  if (warmup->aTable) {
+    tsdbInfo("vgId:%d, last cache warm-up is stopped, tables:%d loaded:%" PRId64, TD_VID(pTsdb->pVnode),
+             warmup->nTable, warmup->nLoaded);
+  }
+  taosArrayDestroy(warmup->aTable);
+  taosMemoryFree(warmup);
+}
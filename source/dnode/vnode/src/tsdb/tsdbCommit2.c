@@ -14,6 +14,7 @@
  */
 
 #include "tsdbCommit2.h"
+#include "vnd.h"
 
 // extern dependencies
 typedef struct {
@@ -435,6 +436,98 @@ _exit:
   return code;
 }
 
+#define TSDB_COMMIT_FSET_ASYNC_ID 4
+
+// Commit the file sets by the vnode-commit-fset workers together with the commit thread. File sets do not overlap,
+// so each one is committed by its own committer, and the file ops are collected in file set order afterwards.
+typedef struct {
+  SCommitter2     *aCommitter;
+  int32_t          nFSet;
+  volatile int32_t next;
+  volatile int32_t code;
+} SCommitFSetJob;
+
+static int32_t tsdbCommitFileSetWorker(void *arg) {
+  SCommitFSetJob *job = (SCommitFSetJob *)arg;
+
+  for (;;) {
+    int32_t i = atomic_fetch_add_32(&job->next, 1);
+    if (i >= job->nFSet || atomic_load_32(&job->code) != 0) break;
+
+    int32_t code = tsdbCommitFileSet(&job->aCommitter[i]);
+    if (code) {
+      atomic_val_compare_exchange_32(&job->code, 0, code);
+      break;
+    }
+  }
+  return 0;
+}
+
+static void tsdbCommitFileSetJobClear(SCommitter2 *committer) {
+  TARRAY2_DESTROY(committer->dataIterArray, NULL);
+  TARRAY2_DESTROY(committer->tombIterArray, NULL);
+  TARRAY2_DESTROY(committer->sttReaderArray, NULL);
+  TARRAY2_DESTROY(committer->fopArray, NULL);
+}
+
+static int32_t tsdbCommitFileSetsInParallel(SCommitter2 *committer) {
+  int32_t         code = 0;
+  int32_t         lino = 0;
+  STsdb          *tsdb = committer->tsdb;
+  SCommitFSetJob  job = {.nFSet = taosArrayGetSize(tsdb->commitInfo->arr)};
+  int32_t         nWorker = TMIN(tsCommitFileSetConcurrency, job.nFSet) - 1;
+  SVATaskID      *aTask = NULL;
+  SVAChannelID    channelID = {.async = TSDB_COMMIT_FSET_ASYNC_ID, .id = 0};
+
+  job.aCommitter = taosMemoryCalloc(job.nFSet, sizeof(SCommitter2));
+  aTask = taosMemoryCalloc(TMAX(nWorker, 1), sizeof(SVATaskID));
+  if (job.aCommitter == NULL || aTask == NULL) {
+    TSDB_CHECK_CODE(code = TSDB_CODE_OUT_OF_MEMORY, lino, _exit);
+  }
+
+  for (int32_t i = 0; i < job.nFSet; i++) {
+    job.aCommitter[i] = *committer;
+    job.aCommitter[i].ctx->info = *(SFileSetCommitInfo **)taosArrayGet(tsdb->commitInfo->arr, i);
+  }
+
+  for (int32_t i = 0; i < nWorker; i++) {
+    if (vnodeAsync(&channelID, EVA_PRIORITY_HIGH, tsdbCommitFileSetWorker, NULL, &job, &aTask[i]) != 0) {
+      break;  // the rest is done by the commit thread
+    }
+  }
+  tsdbCommitFileSetWorker(&job);
+
+  for (int32_t i = 0; i < nWorker; i++) {
+    if (aTask[i].id > 0 && vnodeACancel(&aTask[i]) != 0) {
+      vnodeAWait(&aTask[i]);
+    }
+  }
+
+  code = job.code;
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  for (int32_t i = 0; i < job.nFSet; i++) {
+    TFileOpArray *fopArray = job.aCommitter[i].fopArray;
+    code = TARRAY2_APPEND_BATCH(committer->fopArray, TARRAY2_DATA(fopArray), TARRAY2_SIZE(fopArray));
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
+_exit:
+  if (job.aCommitter) {
+    for (int32_t i = 0; i < job.nFSet; i++) {
+      tsdbCommitFileSetJobClear(&job.aCommitter[i]);
+    }
+  }
+  taosMemoryFree(job.aCommitter);
+  taosMemoryFree(aTask);
+  if (code) {
+    TSDB_ERROR_LOG(TD_VID(tsdb->pVnode), lino, code);
+  } else {
+    tsdbDebug("vgId:%d %s done, nFSet:%d nWorker:%d", TD_VID(tsdb->pVnode), __func__, job.nFSet, nWorker);
+  }
+  return code;
+}
+
 static int32_t tFileSetCommitInfoCompare(const void *arg1, const void *arg2) {
   SFileSetCommitInfo *info1 = (SFileSetCommitInfo *)arg1;
   SFileSetCommitInfo *info2 = (SFileSetCommitInfo *)arg2;
@@ -733,18 +826,32 @@ int32_t tsdbCommitBegin(STsdb *tsdb, SCommitInfo *info) {
     tsdbUnrefMemTable(imem, NULL, true);
   } else {
     SCommitter2 committer = {0};
+    int64_t     st = taosGetTimestampUs();
+    int64_t     et;
 
     code = tsdbOpenCommitter(tsdb, info, &committer);
     TSDB_CHECK_CODE(code, lino, _exit);
+    et = taosGetTimestampUs();
+    info->cost[VND_COMMIT_PHASE_TSDB_BUILD] += et - st;
+    st = et;
 
-    for (int32_t i = 0; i < taosArrayGetSize(tsdb->commitInfo->arr); i++) {
-      committer.ctx->info = *(SFileSetCommitInfo **)taosArrayGet(tsdb->commitInfo->arr, i);
-      code = tsdbCommitFileSet(&committer);
+    if (tsCommitFileSetConcurrency > 1 && taosArrayGetSize(tsdb->commitInfo->arr) > 1) {
+      code = tsdbCommitFileSetsInParallel(&committer);
       TSDB_CHECK_CODE(code, lino, _exit);
+    } else {
+      for (int32_t i = 0; i < taosArrayGetSize(tsdb->commitInfo->arr); i++) {
+        committer.ctx->info = *(SFileSetCommitInfo **)taosArrayGet(tsdb->commitInfo->arr, i);
+        code = tsdbCommitFileSet(&committer);
+        TSDB_CHECK_CODE(code, lino, _exit);
+      }
     }
+    et = taosGetTimestampUs();
+    info->cost[VND_COMMIT_PHASE_TSDB_WRITE] += et - st;
+    st = et;
 
     code = tsdbCloseCommitter(&committer, code);
     TSDB_CHECK_CODE(code, lino, _exit);
+    info->cost[VND_COMMIT_PHASE_TSDB_EDIT] += taosGetTimestampUs() - st;
   }
 
 _exit:
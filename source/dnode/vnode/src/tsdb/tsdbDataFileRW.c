@@ -36,6 +36,9 @@ struct SDataFileReader {
   STombFooter   tombFooter[1];
   TBrinBlkArray brinBlkArray[1];
   TTombBlkArray tombBlkArray[1];
+
+  int16_t       dictCid;  // the column whose dictionary codes are kept in pDict, 0 if none
+  SColDataDict *pDict;
 };
 
 static int32_t tsdbDataFileReadHeadFooter(SDataFileReader *reader) {
@@ -324,6 +327,10 @@ _exit:
   return code;
 }
 
+int32_t tsdbDataFilePrefetchBlockData(SDataFileReader *reader, const SBrinRecord *record) {
+  return tsdbPrefetchFile(reader->fd[TSDB_FTYPE_DATA], record->blockOffset, record->blockSize);
+}
+
 int32_t tsdbDataFileReadBlockDataByColumn(SDataFileReader *reader, const SBrinRecord *record, SBlockData *bData,
                                           STSchema *pTSchema, int16_t cids[], int32_t ncid) {
   int32_t code = 0;
@@ -353,6 +360,9 @@ int32_t tsdbDataFileReadBlockDataByColumn(SDataFileReader *reader, const SBrinRe
   bData->suid = hdr.suid;
   bData->uid = hdr.uid;
   bData->nRow = hdr.nRow;
+  if (reader->pDict) {
+    reader->pDict->nEntry = 0;
+  }
 
   // Key part
   code = tBlockDataDecompressKeyPart(&hdr, &br, bData, assist);
@@ -448,7 +458,9 @@ int32_t tsdbDataFileReadBlockDataByColumn(SDataFileReader *reader, const SBrinRe
   SBlockCol blockCol = {
       .cid = 0,
   };
-  bool firstRead = true;
+  bool          firstRead = true;
+  STsdb        *tsdb = reader->config->tsdb;
+  const STFile *dataFile = &reader->config->files[TSDB_FTYPE_DATA].file;
   br = BUFFER_READER_INITIALIZER(0, buffer0);
   for (int32_t i = 0; i < ncid; i++) {
     int16_t cid = cids[i];
@@ -457,6 +469,13 @@ int32_t tsdbDataFileReadBlockDataByColumn(SDataFileReader *reader, const SBrinRe
       continue;
     }
 
+    if (tsdb->cdCache) {  // decompressed by others before
+      bool hit = false;
+      code = tsdbColDataCacheGet(tsdb, dataFile->fid, dataFile->cid, record->blockOffset, cid, bData, &hit);
+      TSDB_CHECK_CODE(code, lino, _exit);
+      if (hit) continue;
+    }
+
     while (cid > blockCol.cid) {
       if (br.offset >= buffer0->size) {
         blockCol.cid = INT16_MAX;
@@ -498,8 +517,15 @@ int32_t tsdbDataFileReadBlockDataByColumn(SDataFileReader *reader, const SBrinRe
 
       // decode the buffer
       SBufferReader br1 = BUFFER_READER_INITIALIZER(0, buffer1);
-      code = tBlockDataDecompressColData(&hdr, &blockCol, &br1, bData, assist);
+      SColDataDict *pDict = (cid == reader->dictCid) ? reader->pDict : NULL;
+      code = tBlockDataDecompressColDataDict(&hdr, &blockCol, &br1, bData, pDict, assist);
       TSDB_CHECK_CODE(code, lino, _exit);
+
+      if (tsdb->cdCache) {
+        code = tsdbColDataCachePut(tsdb, dataFile->fid, dataFile->cid, record->blockOffset,
+                                   &bData->aColData[bData->nColData - 1]);
+        TSDB_CHECK_CODE(code, lino, _exit);
+      }
     }
   }
 
@@ -510,6 +536,11 @@ _exit:
   return code;
 }
 
+void tsdbDataFileReaderSetDict(SDataFileReader *reader, int16_t cid, SColDataDict *pDict) {
+  reader->dictCid = pDict ? cid : 0;
+  reader->pDict = pDict;
+}
+
 int32_t tsdbDataFileReadBlockSma(SDataFileReader *reader, const SBrinRecord *record,
                                  TColumnDataAggArray *columnDataAggArray) {
   int32_t  code = 0;
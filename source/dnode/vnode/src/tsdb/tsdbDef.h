@@ -38,6 +38,7 @@ extern int32_t tsdbWriteFile(STsdbFD *pFD, int64_t offset, const uint8_t *pBuf,
                             int32_t encryptAlgorithm, char* encryptKey);
 extern int32_t tsdbReadFile(STsdbFD *pFD, int64_t offset, uint8_t *pBuf, int64_t size, int64_t szHint,
                             int32_t encryptAlgorithm, char* encryptKey);
+extern int32_t tsdbPrefetchFile(STsdbFD *pFD, int64_t offset, int64_t size);
 extern int32_t tsdbReadFileToBuffer(STsdbFD *pFD, int64_t offset, int64_t size, SBuffer *buffer, int64_t szHint,
                                     int32_t encryptAlgorithm, char* encryptKey);
 extern int32_t tsdbFsyncFile(STsdbFD *pFD, int32_t encryptAlgorithm, char* encryptKey);
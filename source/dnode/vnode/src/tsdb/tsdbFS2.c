@@ -232,6 +232,16 @@ _exit:
   return code;
 }
 
+// the cached column data of a data file is useless once the file is removed or replaced
+static void tsdbFSInvalidateColDataCache(STsdb *pTsdb, const STFileSet *fsetOld, const STFileSet *fsetNew) {
+  STFileObj *fobjOld = fsetOld->farr[TSDB_FTYPE_DATA];
+  STFileObj *fobjNew = fsetNew ? fsetNew->farr[TSDB_FTYPE_DATA] : NULL;
+
+  if (fobjOld != NULL && (fobjNew == NULL || fobjNew->f->cid != fobjOld->f->cid)) {
+    tsdbColDataCacheInvalidate(pTsdb, fobjOld->f->fid, fobjOld->f->cid);
+  }
+}
+
 static int32_t apply_commit(STFileSystem *fs) {
   int32_t        code = 0;
   TFileSetArray *fsetArray1 = fs->fSetArr;
@@ -245,6 +255,7 @@ static int32_t apply_commit(STFileSystem *fs) {
     if (fset1 && fset2) {
       if (fset1->fid < fset2->fid) {
         // delete fset1
+        tsdbFSInvalidateColDataCache(fs->tsdb, fset1, NULL);
         tsdbTFileSetRemove(fset1);
         i1++;
       } else if (fset1->fid > fset2->fid) {
@@ -257,6 +268,7 @@ static int32_t apply_commit(STFileSystem *fs) {
         i2++;
       } else {
         // edit
+        tsdbFSInvalidateColDataCache(fs->tsdb, fset1, fset2);
         code = tsdbTFileSetApplyEdit(fs->tsdb, fset2, fset1);
         if (code) return code;
         i1++;
@@ -264,6 +276,7 @@ static int32_t apply_commit(STFileSystem *fs) {
       }
     } else if (fset1) {
       // delete fset1
+      tsdbFSInvalidateColDataCache(fs->tsdb, fset1, NULL);
       tsdbTFileSetRemove(fset1);
       i1++;
     } else {
@@ -764,6 +777,8 @@ int32_t tsdbDisableAndCancelAllBgTask(STsdb *pTsdb) {
     return TSDB_CODE_OUT_OF_MEMORY;
   }
 
+  tsdbCacheWarmupStop(pTsdb);
+
   taosThreadMutexLock(&pTsdb->mutex);
 
   // disable
@@ -825,6 +840,32 @@ void tsdbFSUpdateEid(STFileSystem *fs, int64_t cid) {
   taosThreadMutexUnlock(&fs->tsdb->mutex);
 }
 
+// bytes an edit writes, the created files and the growth of the appended data files
+int64_t tsdbFSOpWrittenBytes(const TFileOpArray *opArray) {
+  int64_t         size = 0;
+  const STFileOp *op;
+  TARRAY2_FOREACH_PTR(opArray, op) {
+    if (op->optype == TSDB_FOP_CREATE) {
+      size += op->nf.size;
+    } else if (op->optype == TSDB_FOP_MODIFY && op->nf.size > op->of.size) {
+      size += op->nf.size - op->of.size;
+    }
+  }
+  return size;
+}
+
+// bytes written by all edits over bytes written by commit since the file system is opened
+double tsdbFSWriteAmp(STFileSystem *fs) {
+  int64_t commitBytes = atomic_load_64(&fs->wBytes[TSDB_FEDIT_COMMIT]);
+  if (commitBytes == 0) return 0;
+
+  int64_t totalBytes = 0;
+  for (int32_t etype = TSDB_FEDIT_COMMIT; etype <= TSDB_FEDIT_RETENTION; ++etype) {
+    totalBytes += atomic_load_64(&fs->wBytes[etype]);
+  }
+  return (double)totalBytes / commitBytes;
+}
+
 int32_t tsdbFSEditBegin(STFileSystem *fs, const TFileOpArray *opArray, EFEditT etype) {
   int32_t code = 0;
   int32_t lino;
@@ -847,6 +888,8 @@ int32_t tsdbFSEditBegin(STFileSystem *fs, const TFileOpArray *opArray, EFEditT e
   code = save_fs(fs->fSetArrTmp, current_t);
   TSDB_CHECK_CODE(code, lino, _exit);
 
+  atomic_add_fetch_64(&fs->wBytes[etype], tsdbFSOpWrittenBytes(opArray));
+
 _exit:
   if (code) {
     tsdbError("vgId:%d %s failed at line %d since %s, etype:%d", TD_VID(fs->tsdb->pVnode), __func__, lino,
@@ -56,6 +56,8 @@ int32_t tsdbFSDestroyRefRangedSnapshot(TFileSetRangeArray **fsrArr);
 int64_t tsdbFSAllocEid(STFileSystem *fs);
 void    tsdbFSUpdateEid(STFileSystem *fs, int64_t cid);
 int32_t tsdbFSEditBegin(STFileSystem *fs, const TFileOpArray *opArray, EFEditT etype);
+int64_t tsdbFSOpWrittenBytes(const TFileOpArray *opArray);
+double  tsdbFSWriteAmp(STFileSystem *fs);
 int32_t tsdbFSEditCommit(STFileSystem *fs);
 int32_t tsdbFSEditAbort(STFileSystem *fs);
 // other
@@ -74,6 +76,7 @@ struct STFileSystem {
   int32_t       fsstate;
   int64_t       neid;
   EFEditT       etype;
+  int64_t       wBytes[TSDB_FEDIT_RETENTION + 1];  // bytes written by each kind of edit
   TFileSetArray fSetArr[1];
   TFileSetArray fSetArrTmp[1];
 };
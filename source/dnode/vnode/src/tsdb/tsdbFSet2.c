@@ -46,6 +46,7 @@ static int32_t tsdbSttLvlInitEx(STsdb *pTsdb, const SSttLvl *lvl1, SSttLvl **lvl
       tsdbSttLvlClear(lvl);
       return code;
     }
+    fobj->nRead = atomic_load_32((int32_t *)&fobj1->nRead);
 
     code = TARRAY2_APPEND(lvl[0]->fobjArr, fobj);
     if (code) return code;
@@ -79,6 +79,7 @@ struct STFileObj {
   int32_t       state;
   int32_t       ref;
   int32_t       nlevel;
+  int32_t       nRead;  // times a query opened this stt file, a hint for merge
   char          fname[TSDB_FILENAME_LEN];
 };
 
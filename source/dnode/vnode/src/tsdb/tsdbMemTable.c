@@ -31,8 +31,14 @@
 #define SL_MOVE_BACKWARD 0x1
 #define SL_MOVE_FROM_POS 0x2
 
+#define SEG_MIN_CHUNK_ROWS 8
+#define SEG_MAX_CHUNK_ROWS 1024
+
 static void    tbDataMovePosTo(STbData *pTbData, SMemSkipListNode **pos, STsdbRowKey *pKey, int32_t flags);
+static void    tbDataSegMoveTo(STbData *pTbData, STsdbRowKey *pKey, int8_t backward, STbDataIter *pIter);
 static int32_t tsdbGetOrCreateTbData(SMemTable *pMemTable, tb_uid_t suid, tb_uid_t uid, STbData **ppTbData);
+static void    tsdbMemTableUpdateStat(SMemTable *pMemTable, TSKEY minKey, TSKEY maxKey, int64_t nRow);
+static void    tsdbMemTableUpdateVer(SMemTable *pMemTable, int64_t version);
 static int32_t tsdbInsertRowDataToTable(SMemTable *pMemTable, STbData *pTbData, int64_t version,
                                         SSubmitTbData *pSubmitTbData, int32_t *affectedRows);
 static int32_t tsdbInsertColDataToTable(SMemTable *pMemTable, STbData *pTbData, int64_t version,
@@ -137,8 +143,7 @@ int32_t tsdbInsertTableData(STsdb *pTsdb, int64_t version, SSubmitTbData *pSubmi
   if (code) goto _err;
 
   // update
-  pMemTable->minVer = TMIN(pMemTable->minVer, version);
-  pMemTable->maxVer = TMAX(pMemTable->maxVer, version);
+  tsdbMemTableUpdateVer(pMemTable, version);
 
   return code;
 
@@ -191,9 +196,8 @@ int32_t tsdbDeleteTableData(STsdb *pTsdb, int64_t version, tb_uid_t suid, tb_uid
   }
   taosWUnLockLatch(&pTbData->lock);
 
-  pMemTable->nDel++;
-  pMemTable->minVer = TMIN(pMemTable->minVer, version);
-  pMemTable->maxVer = TMAX(pMemTable->maxVer, version);
+  atomic_add_fetch_64(&pMemTable->nDel, 1);
+  tsdbMemTableUpdateVer(pMemTable, version);
 
   tsdbCacheDel(pTsdb, suid, uid, sKey, eKey);
 
@@ -258,9 +262,93 @@ void tsdbTbDataIterOpen(STbData *pTbData, STsdbRowKey *pFrom, int8_t backward, S
       pIter->pNode = SL_GET_NODE_FORWARD(pos[0], 0);
     }
   }
+
+  tbDataSegMoveTo(pTbData, pFrom, backward, pIter);
+}
+
+static TSDBROW *tbDataIterSegRow(STbDataIter *pIter) {
+  if (pIter->backward) {
+    return (pIter->iSegRow >= 0) ? &pIter->pChunk->aRow[pIter->iSegRow] : NULL;
+  }
+
+  if (pIter->iSegRow >= pIter->pChunk->capacity) {
+    SMemSegChunk *pNext = (SMemSegChunk *)atomic_load_ptr(&pIter->pChunk->next);
+    if (pNext == NULL) {
+      return NULL;
+    }
+
+    pIter->pChunk = pNext;
+    pIter->iSegRow = 0;
+  }
+
+  return (pIter->iSegRow < atomic_load_32(&pIter->pChunk->nRow)) ? &pIter->pChunk->aRow[pIter->iSegRow] : NULL;
+}
+
+// merge the rows of the skip list and the append segment, a row of the skip list comes first in case of the same key
+// and version, which is the newer one.
+TSDBROW *tsdbTbDataIterMergeGet(STbDataIter *pIter) {
+  TSDBROW *pSlRow = NULL;
+  TSDBROW *pSegRow = tbDataIterSegRow(pIter);
+
+  if (pIter->backward) {
+    if (pIter->pNode != pIter->pTbData->sl.pHead) pSlRow = &pIter->pNode->row;
+  } else {
+    if (pIter->pNode != pIter->pTbData->sl.pTail) pSlRow = &pIter->pNode->row;
+  }
+
+  if (pSlRow && pSegRow) {
+    STsdbRowKey slKey, segKey;
+    tsdbRowGetKey(pSlRow, &slKey);
+    tsdbRowGetKey(pSegRow, &segKey);
+
+    int32_t c = tsdbRowKeyCmpr(&slKey, &segKey);
+    pIter->fromSeg = pIter->backward ? (c <= 0) : (c > 0);
+  } else if (pSegRow) {
+    pIter->fromSeg = 1;
+  } else if (pSlRow) {
+    pIter->fromSeg = 0;
+  } else {
+    return NULL;
+  }
+
+  pIter->pRow = &pIter->row;
+  pIter->row = pIter->fromSeg ? *pSegRow : *pSlRow;
+
+  return pIter->pRow;
+}
+
+static bool tbDataIterMergeNext(STbDataIter *pIter) {
+  if (tsdbTbDataIterGet(pIter) == NULL) {
+    return false;
+  }
+
+  pIter->pRow = NULL;
+  if (pIter->fromSeg) {
+    if (pIter->backward) {
+      pIter->iSegRow--;
+      if (pIter->iSegRow < 0 && pIter->pChunk->prev != NULL) {
+        pIter->pChunk = pIter->pChunk->prev;
+        pIter->iSegRow = pIter->pChunk->nRow - 1;
+      }
+    } else {
+      pIter->iSegRow++;
+    }
+  } else {
+    if (pIter->backward) {
+      pIter->pNode = SL_GET_NODE_BACKWARD(pIter->pNode, 0);
+    } else {
+      pIter->pNode = SL_GET_NODE_FORWARD(pIter->pNode, 0);
+    }
+  }
+
+  return tsdbTbDataIterGet(pIter) != NULL;
 }
 
 bool tsdbTbDataIterNext(STbDataIter *pIter) {
+  if (pIter->pChunk) {
+    return tbDataIterMergeNext(pIter);
+  }
+
   pIter->pRow = NULL;
   if (pIter->backward) {
     ASSERT(pIter->pNode != pIter->pTbData->sl.pTail);
@@ -291,7 +379,7 @@ bool tsdbTbDataIterNext(STbDataIter *pIter) {
 
 int64_t tsdbCountTbDataRows(STbData *pTbData) {
   SMemSkipListNode *pNode = pTbData->sl.pHead;
-  int64_t           rowsNum = 0;
+  int64_t           rowsNum = pTbData->seg.size;
 
   while (NULL != pNode) {
     pNode = SL_GET_NODE_FORWARD(pNode, 0);
@@ -358,8 +446,8 @@ _exit:
 static int32_t tsdbGetOrCreateTbData(SMemTable *pMemTable, tb_uid_t suid, tb_uid_t uid, STbData **ppTbData) {
   int32_t code = 0;
 
-  // get
-  STbData *pTbData = tsdbGetTbDataFromMemTableImpl(pMemTable, suid, uid);
+  // get, the read latch is needed since the tables of a submit may be applied by several threads
+  STbData *pTbData = tsdbGetTbDataFromMemTable(pMemTable, suid, uid);
   if (pTbData) goto _exit;
 
   // create
@@ -384,6 +472,9 @@ static int32_t tsdbGetOrCreateTbData(SMemTable *pMemTable, tb_uid_t suid, tb_uid
   pTbData->sl.level = 0;
   pTbData->sl.pHead = (SMemSkipListNode *)&pTbData[1];
   pTbData->sl.pTail = (SMemSkipListNode *)POINTER_SHIFT(pTbData->sl.pHead, SL_NODE_SIZE(maxLevel));
+  pTbData->seg.size = 0;
+  pTbData->seg.pHead = NULL;
+  pTbData->seg.pTail = NULL;
   pTbData->sl.pHead->level = maxLevel;
   pTbData->sl.pTail->level = maxLevel;
   for (int8_t iLevel = 0; iLevel < maxLevel; iLevel++) {
@@ -397,6 +488,14 @@ static int32_t tsdbGetOrCreateTbData(SMemTable *pMemTable, tb_uid_t suid, tb_uid
 
   taosWLockLatch(&pMemTable->latch);
 
+  // another applier may have created it, the STbData allocated above is then left in the pool
+  STbData *pExist = tsdbGetTbDataFromMemTableImpl(pMemTable, suid, uid);
+  if (pExist) {
+    taosWUnLockLatch(&pMemTable->latch);
+    pTbData = pExist;
+    goto _exit;
+  }
+
   if (pMemTable->nTbData >= pMemTable->nBucket) {
     code = tsdbMemTableRehash(pMemTable);
     if (code) {
@@ -574,6 +673,169 @@ _exit:
   return code;
 }
 
+static int32_t tbDataSegRowCmpr(TSDBROW *pRow, STsdbRowKey *pKey) {
+  STsdbRowKey key;
+  tsdbRowGetKey(pRow, &key);
+  return tsdbRowKeyCmpr(&key, pKey);
+}
+
+// position the iterator of the append segment at the first row not less than the key, or the last row not greater than
+// the key in case of backward, the same as the skip list does.
+static void tbDataSegMoveTo(STbData *pTbData, STsdbRowKey *pKey, int8_t backward, STbDataIter *pIter) {
+  SMemSegChunk *pChunk = (SMemSegChunk *)atomic_load_ptr(&pTbData->seg.pHead);
+
+  pIter->pChunk = NULL;
+  pIter->iSegRow = 0;
+  pIter->fromSeg = 0;
+  if (pChunk == NULL) {
+    return;
+  }
+
+  if (backward) {
+    pChunk = (SMemSegChunk *)atomic_load_ptr(&pTbData->seg.pTail);
+    while (pChunk->prev != NULL && atomic_load_32(&pChunk->nRow) == 0) {
+      pChunk = pChunk->prev;
+    }
+
+    if (pKey != NULL) {
+      while (pChunk->prev != NULL && tbDataSegRowCmpr(&pChunk->aRow[0], pKey) > 0) {
+        pChunk = pChunk->prev;
+      }
+    }
+
+    // the last row not greater than the key
+    int32_t lo = 0, hi = atomic_load_32(&pChunk->nRow) - 1;
+    if (pKey != NULL) {
+      while (lo <= hi) {
+        int32_t mid = (lo + hi) >> 1;
+        if (tbDataSegRowCmpr(&pChunk->aRow[mid], pKey) <= 0) {
+          lo = mid + 1;
+        } else {
+          hi = mid - 1;
+        }
+      }
+    }
+
+    pIter->pChunk = pChunk;
+    pIter->iSegRow = hi;
+  } else {
+    if (pKey != NULL) {
+      for (;;) {
+        int32_t       nRow = atomic_load_32(&pChunk->nRow);
+        SMemSegChunk *pNext = (SMemSegChunk *)atomic_load_ptr(&pChunk->next);
+        if (pNext == NULL || (nRow > 0 && tbDataSegRowCmpr(&pChunk->aRow[nRow - 1], pKey) >= 0)) {
+          break;
+        }
+        pChunk = pNext;
+      }
+    }
+
+    // the first row not less than the key
+    int32_t lo = 0, hi = atomic_load_32(&pChunk->nRow) - 1;
+    if (pKey != NULL) {
+      while (lo <= hi) {
+        int32_t mid = (lo + hi) >> 1;
+        if (tbDataSegRowCmpr(&pChunk->aRow[mid], pKey) < 0) {
+          lo = mid + 1;
+        } else {
+          hi = mid - 1;
+        }
+      }
+    }
+
+    pIter->pChunk = pChunk;
+    pIter->iSegRow = lo;
+  }
+}
+
+static bool tbDataSegAppendable(STbData *pTbData, STsdbRowKey *pKey) {
+  SMemSegChunk *pChunk = pTbData->seg.pTail;
+  if (pChunk == NULL) {
+    return true;
+  }
+
+  return tbDataSegRowCmpr(&pChunk->aRow[pChunk->nRow - 1], pKey) < 0;
+}
+
+static int32_t tbDataSegAppend(SMemTable *pMemTable, STbData *pTbData, TSDBROW *pRow) {
+  SVBufPool    *pPool = pMemTable->pTsdb->pVnode->inUse;
+  SMemSegChunk *pChunk = pTbData->seg.pTail;
+  SRow         *pTSRow = NULL;
+
+  if (pRow->type == TSDBROW_ROW_FMT) {
+    pTSRow = (SRow *)vnodeBufPoolMallocAligned(pPool, pRow->pTSRow->len);
+    if (pTSRow == NULL) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+    memcpy(pTSRow, pRow->pTSRow, pRow->pTSRow->len);
+  }
+
+  if (pChunk == NULL || pChunk->nRow >= pChunk->capacity) {
+    int32_t capacity = pChunk ? TMIN(pChunk->capacity << 1, SEG_MAX_CHUNK_ROWS) : SEG_MIN_CHUNK_ROWS;
+
+    SMemSegChunk *pNew =
+        (SMemSegChunk *)vnodeBufPoolMallocAligned(pPool, sizeof(SMemSegChunk) + sizeof(TSDBROW) * capacity);
+    if (pNew == NULL) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+    pNew->prev = pChunk;
+    pNew->next = NULL;
+    pNew->capacity = capacity;
+    pNew->nRow = 0;
+
+    if (pChunk) {
+      atomic_store_ptr(&pChunk->next, pNew);
+    } else {
+      atomic_store_ptr(&pTbData->seg.pHead, pNew);
+    }
+    atomic_store_ptr(&pTbData->seg.pTail, pNew);
+    pChunk = pNew;
+  }
+
+  TSDBROW *pDst = &pChunk->aRow[pChunk->nRow];
+  *pDst = *pRow;
+  if (pTSRow != NULL) {
+    pDst->pTSRow = pTSRow;
+  }
+
+  // make the row visible to the iterators
+  atomic_store_32(&pChunk->nRow, pChunk->nRow + 1);
+  pTbData->seg.size++;
+  return 0;
+}
+
+// Rows in key order are appended to the segment, the out-of-order ones are put into the skip list. The pos is
+// initialized by the first row put into the skip list, and the rows put later must be greater than it.
+static int32_t tbDataPutRow(SMemTable *pMemTable, STbData *pTbData, SMemSkipListNode **pos, bool *hasPos,
+                            TSDBROW *pRow, STsdbRowKey *pKey) {
+  int32_t code = 0;
+
+  if (tbDataSegAppendable(pTbData, pKey)) {
+    return tbDataSegAppend(pMemTable, pTbData, pRow);
+  }
+
+  if (!(*hasPos)) {
+    // backward put first data
+    tbDataMovePosTo(pTbData, pos, pKey, SL_MOVE_BACKWARD);
+    code = tbDataDoPut(pMemTable, pTbData, pos, pRow, 0);
+    if (code) return code;
+
+    for (int8_t iLevel = pos[0]->level; iLevel < pTbData->sl.maxLevel; iLevel++) {
+      pos[iLevel] = SL_NODE_BACKWARD(pos[iLevel], iLevel);
+    }
+    *hasPos = true;
+  } else {
+    // forward put rest data
+    if (SL_NODE_FORWARD(pos[0], 0) != pTbData->sl.pTail) {
+      tbDataMovePosTo(pTbData, pos, pKey, SL_MOVE_FROM_POS);
+    }
+
+    code = tbDataDoPut(pMemTable, pTbData, pos, pRow, 1);
+  }
+
+  return code;
+}
+
 static int32_t tsdbInsertColDataToTable(SMemTable *pMemTable, STbData *pTbData, int64_t version,
                                         SSubmitTbData *pSubmitTbData, int32_t *affectedRows) {
   int32_t code = 0;
@@ -625,35 +887,23 @@ static int32_t tsdbInsertColDataToTable(SMemTable *pMemTable, STbData *pTbData,
     if (code) goto _exit;
   }
 
-  // loop to add each row to the skiplist
+  // loop to add each row to the append segment or the skiplist
   SMemSkipListNode *pos[SL_MAX_LEVEL];
+  bool              hasPos = false;
   TSDBROW           tRow = tsdbRowFromBlockData(pBlockData, 0);
   STsdbRowKey       key;
 
   // first row
   tsdbRowGetKey(&tRow, &key);
-  tbDataMovePosTo(pTbData, pos, &key, SL_MOVE_BACKWARD);
-  if ((code = tbDataDoPut(pMemTable, pTbData, pos, &tRow, 0))) goto _exit;
+  if ((code = tbDataPutRow(pMemTable, pTbData, pos, &hasPos, &tRow, &key))) goto _exit;
   pTbData->minKey = TMIN(pTbData->minKey, key.key.ts);
 
   // remain row
   ++tRow.iRow;
-  if (tRow.iRow < pBlockData->nRow) {
-    for (int8_t iLevel = pos[0]->level; iLevel < pTbData->sl.maxLevel; iLevel++) {
-      pos[iLevel] = SL_NODE_BACKWARD(pos[iLevel], iLevel);
-    }
-
-    while (tRow.iRow < pBlockData->nRow) {
-      tsdbRowGetKey(&tRow, &key);
-
-      if (SL_NODE_FORWARD(pos[0], 0) != pTbData->sl.pTail) {
-        tbDataMovePosTo(pTbData, pos, &key, SL_MOVE_FROM_POS);
-      }
-
-      if ((code = tbDataDoPut(pMemTable, pTbData, pos, &tRow, 1))) goto _exit;
-
-      ++tRow.iRow;
-    }
+  while (tRow.iRow < pBlockData->nRow) {
+    tsdbRowGetKey(&tRow, &key);
+    if ((code = tbDataPutRow(pMemTable, pTbData, pos, &hasPos, &tRow, &key))) goto _exit;
+    ++tRow.iRow;
   }
 
   if (key.key.ts >= pTbData->maxKey) {
@@ -665,9 +915,7 @@ static int32_t tsdbInsertColDataToTable(SMemTable *pMemTable, STbData *pTbData,
   }
 
   // SMemTable
-  pMemTable->minKey = TMIN(pMemTable->minKey, pTbData->minKey);
-  pMemTable->maxKey = TMAX(pMemTable->maxKey, pTbData->maxKey);
-  pMemTable->nRow += pBlockData->nRow;
+  tsdbMemTableUpdateStat(pMemTable, pTbData->minKey, pTbData->maxKey, pBlockData->nRow);
 
   if (affectedRows) *affectedRows = pBlockData->nRow;
 
@@ -683,37 +931,27 @@ static int32_t tsdbInsertRowDataToTable(SMemTable *pMemTable, STbData *pTbData,
   SRow            **aRow = (SRow **)TARRAY_DATA(pSubmitTbData->aRowP);
   STsdbRowKey       key;
   SMemSkipListNode *pos[SL_MAX_LEVEL];
+  bool              hasPos = false;
   TSDBROW           tRow = {.type = TSDBROW_ROW_FMT, .version = version};
   int32_t           iRow = 0;
 
-  // backward put first data
+  // put first data
   tRow.pTSRow = aRow[iRow++];
   tsdbRowGetKey(&tRow, &key);
-  tbDataMovePosTo(pTbData, pos, &key, SL_MOVE_BACKWARD);
-  code = tbDataDoPut(pMemTable, pTbData, pos, &tRow, 0);
+  code = tbDataPutRow(pMemTable, pTbData, pos, &hasPos, &tRow, &key);
   if (code) goto _exit;
 
   pTbData->minKey = TMIN(pTbData->minKey, key.key.ts);
 
-  // forward put rest data
-  if (iRow < nRow) {
-    for (int8_t iLevel = pos[0]->level; iLevel < pTbData->sl.maxLevel; iLevel++) {
-      pos[iLevel] = SL_NODE_BACKWARD(pos[iLevel], iLevel);
-    }
-
-    while (iRow < nRow) {
-      tRow.pTSRow = aRow[iRow];
-      tsdbRowGetKey(&tRow, &key);
-
-      if (SL_NODE_FORWARD(pos[0], 0) != pTbData->sl.pTail) {
-        tbDataMovePosTo(pTbData, pos, &key, SL_MOVE_FROM_POS);
-      }
+  // put rest data
+  while (iRow < nRow) {
+    tRow.pTSRow = aRow[iRow];
+    tsdbRowGetKey(&tRow, &key);
 
-      code = tbDataDoPut(pMemTable, pTbData, pos, &tRow, 1);
-      if (code) goto _exit;
+    code = tbDataPutRow(pMemTable, pTbData, pos, &hasPos, &tRow, &key);
+    if (code) goto _exit;
 
-      iRow++;
-    }
+    iRow++;
   }
 
   if (key.key.ts >= pTbData->maxKey) {
@@ -724,9 +962,7 @@ static int32_t tsdbInsertRowDataToTable(SMemTable *pMemTable, STbData *pTbData,
   }
 
   // SMemTable
-  pMemTable->minKey = TMIN(pMemTable->minKey, pTbData->minKey);
-  pMemTable->maxKey = TMAX(pMemTable->maxKey, pTbData->maxKey);
-  pMemTable->nRow += nRow;
+  tsdbMemTableUpdateStat(pMemTable, pTbData->minKey, pTbData->maxKey, nRow);
 
   if (affectedRows) *affectedRows = nRow;
 
@@ -734,7 +970,38 @@ _exit:
   return code;
 }
 
-int32_t tsdbGetNRowsInTbData(STbData *pTbData) { return pTbData->sl.size; }
+// The tables of a submit may be applied by several threads (numOfApplyThreads), so the SMemTable statistics are
+// updated atomically.
+static void tsdbAtomicMin64(int64_t volatile *ptr, int64_t val) {
+  int64_t old = atomic_load_64(ptr);
+  while (val < old) {
+    int64_t cur = atomic_val_compare_exchange_64(ptr, old, val);
+    if (cur == old) break;
+    old = cur;
+  }
+}
+
+static void tsdbAtomicMax64(int64_t volatile *ptr, int64_t val) {
+  int64_t old = atomic_load_64(ptr);
+  while (val > old) {
+    int64_t cur = atomic_val_compare_exchange_64(ptr, old, val);
+    if (cur == old) break;
+    old = cur;
+  }
+}
+
+static void tsdbMemTableUpdateStat(SMemTable *pMemTable, TSKEY minKey, TSKEY maxKey, int64_t nRow) {
+  tsdbAtomicMin64(&pMemTable->minKey, minKey);
+  tsdbAtomicMax64(&pMemTable->maxKey, maxKey);
+  atomic_add_fetch_64(&pMemTable->nRow, nRow);
+}
+
+static void tsdbMemTableUpdateVer(SMemTable *pMemTable, int64_t version) {
+  tsdbAtomicMin64(&pMemTable->minVer, version);
+  tsdbAtomicMax64(&pMemTable->maxVer, version);
+}
+
+int32_t tsdbGetNRowsInTbData(STbData *pTbData) { return pTbData->sl.size + pTbData->seg.size; }
 
 int32_t tsdbRefMemTable(SMemTable *pMemTable, SQueryNode *pQNode) {
   int32_t code = 0;
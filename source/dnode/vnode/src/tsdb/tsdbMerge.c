@@ -95,7 +95,42 @@ static int32_t tsdbMergeFileSetEndCloseReader(SMerger *merger) {
   return 0;
 }
 
-static int32_t tsdbMergeFileSetBeginOpenReader(SMerger *merger) {
+static int32_t tsdbMergerAddFile(SMerger *merger, STFileObj *fobj, SSttFileReader *reader) {
+  int32_t code = 0;
+  int32_t lino = 0;
+
+  STFileOp op = {
+      .optype = TSDB_FOP_REMOVE,
+      .fid = merger->ctx->fset->fid,
+      .of = fobj->f[0],
+  };
+  code = TARRAY2_APPEND(merger->fopArr, op);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  if (reader == NULL) {
+    SSttFileReaderConfig config = {
+        .tsdb = merger->tsdb,
+        .szPage = merger->szPage,
+        .file[0] = fobj->f[0],
+    };
+
+    code = tsdbSttFileReaderOpen(fobj->fname, &config, &reader);
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
+  if ((code = TARRAY2_APPEND(merger->sttReaderArr, reader))) {
+    tsdbSttFileReaderClose(&reader);
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
+_exit:
+  if (code) {
+    TSDB_ERROR_LOG(TD_VID(merger->tsdb->pVnode), lino, code);
+  }
+  return code;
+}
+
+static int32_t tsdbMergePickByLevel(SMerger *merger) {
   int32_t  code = 0;
   int32_t  lino = 0;
   SSttLvl *lvl;
@@ -119,27 +154,7 @@ static int32_t tsdbMergeFileSetBeginOpenReader(SMerger *merger) {
       int32_t numMergeFile = TARRAY2_SIZE(lvl->fobjArr);
 
       for (int32_t i = 0; i < numMergeFile; ++i) {
-        STFileObj *fobj = TARRAY2_GET(lvl->fobjArr, i);
-
-        STFileOp op = {
-            .optype = TSDB_FOP_REMOVE,
-            .fid = merger->ctx->fset->fid,
-            .of = fobj->f[0],
-        };
-        code = TARRAY2_APPEND(merger->fopArr, op);
-        TSDB_CHECK_CODE(code, lino, _exit);
-
-        SSttFileReader      *reader;
-        SSttFileReaderConfig config = {
-            .tsdb = merger->tsdb,
-            .szPage = merger->szPage,
-            .file[0] = fobj->f[0],
-        };
-
-        code = tsdbSttFileReaderOpen(fobj->fname, &config, &reader);
-        TSDB_CHECK_CODE(code, lino, _exit);
-
-        code = TARRAY2_APPEND(merger->sttReaderArr, reader);
+        code = tsdbMergerAddFile(merger, TARRAY2_GET(lvl->fobjArr, i), NULL);
         TSDB_CHECK_CODE(code, lino, _exit);
       }
     }
@@ -205,43 +220,232 @@ static int32_t tsdbMergeFileSetBeginOpenReader(SMerger *merger) {
       }
 
       for (int32_t i = 0; i < numMergeFile; ++i) {
-        STFileObj *fobj = TARRAY2_GET(lvl->fobjArr, i);
-
-        STFileOp op = {
-            .optype = TSDB_FOP_REMOVE,
-            .fid = merger->ctx->fset->fid,
-            .of = fobj->f[0],
-        };
-        code = TARRAY2_APPEND(merger->fopArr, op);
+        code = tsdbMergerAddFile(merger, TARRAY2_GET(lvl->fobjArr, i), NULL);
         TSDB_CHECK_CODE(code, lino, _exit);
+      }
+    }
 
-        SSttFileReader      *reader;
-        SSttFileReaderConfig config = {
-            .tsdb = merger->tsdb,
-            .szPage = merger->szPage,
-            .file[0] = fobj->f[0],
-        };
+    if (merger->ctx->level > TSDB_MAX_LEVEL) {
+      merger->ctx->level = TSDB_MAX_LEVEL;
+    }
+  }
 
-        code = tsdbSttFileReaderOpen(fobj->fname, &config, &reader);
-        TSDB_CHECK_CODE(code, lino, _exit);
+_exit:
+  if (code) {
+    TSDB_ERROR_LOG(TD_VID(merger->tsdb->pVnode), lino, code);
+  }
+  return code;
+}
+
+static int32_t tsdbMergeCandAgeCmprFn(const void *p1, const void *p2) {
+  const SMergeCand *cand1 = (const SMergeCand *)p1;
+  const SMergeCand *cand2 = (const SMergeCand *)p2;
+  if (cand1->level > cand2->level) return -1;
+  if (cand1->level < cand2->level) return 1;
+  if (cand1->fobj->f->minVer < cand2->fobj->f->minVer) return -1;
+  if (cand1->fobj->f->minVer > cand2->fobj->f->minVer) return 1;
+  if (cand1->fobj->f->cid < cand2->fobj->f->cid) return -1;
+  if (cand1->fobj->f->cid > cand2->fobj->f->cid) return 1;
+  return 0;
+}
+
+void tsdbMergeCandScore(SMergeCand *aCand, int32_t nCand) {
+  int64_t maxSize = 1;
+  int32_t maxRead = 0;
+  int64_t minCid = INT64_MAX;
+  int64_t maxCid = INT64_MIN;
+  for (int32_t i = 0; i < nCand; ++i) {
+    maxSize = TMAX(maxSize, aCand[i].fobj->f->size);
+    maxRead = TMAX(maxRead, aCand[i].fobj->nRead);
+    minCid = TMIN(minCid, aCand[i].fobj->f->cid);
+    maxCid = TMAX(maxCid, aCand[i].fobj->f->cid);
+  }
 
-        if ((code = TARRAY2_APPEND(merger->sttReaderArr, reader))) {
-          tsdbSttFileReaderClose(&reader);
-          TSDB_CHECK_CODE(code, lino, _exit);
+  for (int32_t i = 0; i < nCand; ++i) {
+    SMergeCand *cand = &aCand[i];
+
+    // share of the key range of the file covered by other stt files
+    double overlap = 0;
+    if (nCand > 1) {
+      double range = (double)cand->maxKey - cand->minKey + 1;
+      for (int32_t j = 0; j < nCand; ++j) {
+        if (j == i) continue;
+        TSKEY skey = TMAX(cand->minKey, aCand[j].minKey);
+        TSKEY ekey = TMIN(cand->maxKey, aCand[j].maxKey);
+        if (skey <= ekey) {
+          overlap += ((double)ekey - skey + 1) / range;
         }
       }
+      overlap /= (nCand - 1);
     }
 
-    if (merger->ctx->level > TSDB_MAX_LEVEL) {
-      merger->ctx->level = TSDB_MAX_LEVEL;
+    double read = maxRead > 0 ? (double)cand->fobj->nRead / maxRead : 0;
+    double age = maxCid > minCid ? (double)(maxCid - cand->fobj->f->cid) / (maxCid - minCid) : 0;
+    double bytes = (double)cand->fobj->f->size / maxSize;
+
+    // overlapped, hot and old files are worth merging, large ones cost the most to rewrite
+    cand->score = overlap + read + age - bytes;
+  }
+}
+
+/**
+ * Pick the sttTrigger scored candidates to merge, return the index of the first one after aCand is sorted from the
+ * oldest to the newest, or -1 if none can be picked.
+ *
+ * A higher level holds older data, and the files of a level are ordered by version, so the candidates are sorted by
+ * version this way. Only a run of adjacent candidates is picked, so no file left out has a version between two picked
+ * ones and the rows of the same key still merge in version order. The run must also start at the oldest file of its
+ * level, for the merged file goes to the level above, which must not hold data newer than the levels below it.
+ */
+int32_t tsdbMergeCandPick(SMergeCand *aCand, int32_t nCand, int32_t sttTrigger, int32_t *level) {
+  int32_t start = -1;
+  double  maxScore = 0;
+
+  if (sttTrigger <= 0 || nCand < sttTrigger) {
+    return -1;
+  }
+
+  taosSort(aCand, nCand, sizeof(SMergeCand), tsdbMergeCandAgeCmprFn);
+
+  for (int32_t i = 0; i + sttTrigger <= nCand; ++i) {
+    int32_t toLevel = TMIN(aCand[i].level + 1, TSDB_MAX_LEVEL);
+    if (i > 0 && aCand[i - 1].level < toLevel) {
+      continue;
+    }
+
+    double score = 0;
+    for (int32_t j = i; j < i + sttTrigger; ++j) {
+      score += aCand[j].score;
+    }
+
+    if (start < 0 || score > maxScore) {
+      start = i;
+      maxScore = score;
+      *level = toLevel;
+    }
+  }
+
+  return start;
+}
+
+/**
+ * Merge sttTrigger adjacent stt files which are the most worth merging into one stt file one level above the oldest
+ * picked, and leave the others in place. Falls back to the level policy once a level is full, so the levels stay
+ * bounded and the data file still receives the stt data.
+ */
+static int32_t tsdbMergePickByCost(SMerger *merger) {
+  int32_t     code = 0;
+  int32_t     lino = 0;
+  int32_t     nCand = 0;
+  SMergeCand *aCand = NULL;
+  SSttLvl    *lvl;
+
+  TARRAY2_FOREACH(merger->ctx->fset->lvlArr, lvl) {
+    if (lvl->level > TSDB_MAX_LEVEL || (lvl->level > 0 && TARRAY2_SIZE(lvl->fobjArr) >= merger->sttTrigger - 1)) {
+      return tsdbMergePickByLevel(merger);
+    }
+    nCand += TARRAY2_SIZE(lvl->fobjArr);
+  }
+
+  if (nCand < merger->sttTrigger) {
+    return tsdbMergePickByLevel(merger);
+  }
+
+  aCand = taosMemoryCalloc(nCand, sizeof(SMergeCand));
+  if (aCand == NULL) {
+    TSDB_CHECK_CODE(code = TSDB_CODE_OUT_OF_MEMORY, lino, _exit);
+  }
+
+  // get the key range of each stt file
+  int32_t iCand = 0;
+  TARRAY2_FOREACH(merger->ctx->fset->lvlArr, lvl) {
+    STFileObj *fobj;
+    TARRAY2_FOREACH(lvl->fobjArr, fobj) {
+      SMergeCand *cand = &aCand[iCand++];
+      cand->fobj = fobj;
+      cand->level = lvl->level;
+      cand->minKey = TSKEY_MAX;
+      cand->maxKey = TSKEY_MIN;
+
+      SSttFileReaderConfig config = {
+          .tsdb = merger->tsdb,
+          .szPage = merger->szPage,
+          .file[0] = fobj->f[0],
+      };
+      code = tsdbSttFileReaderOpen(fobj->fname, &config, &cand->reader);
+      TSDB_CHECK_CODE(code, lino, _exit);
+
+      const TSttBlkArray *sttBlkArray;
+      code = tsdbSttFileReadSttBlk(cand->reader, &sttBlkArray);
+      TSDB_CHECK_CODE(code, lino, _exit);
+
+      const SSttBlk *sttBlk;
+      TARRAY2_FOREACH_PTR(sttBlkArray, sttBlk) {
+        cand->minKey = TMIN(cand->minKey, sttBlk->minKey);
+        cand->maxKey = TMAX(cand->maxKey, sttBlk->maxKey);
+      }
+      if (cand->minKey > cand->maxKey) {
+        cand->minKey = cand->maxKey = 0;
+      }
     }
   }
 
+  tsdbMergeCandScore(aCand, nCand);
+
+  int32_t start = tsdbMergeCandPick(aCand, nCand, merger->sttTrigger, &merger->ctx->level);
+  if (start < 0) {
+    code = tsdbMergePickByLevel(merger);
+    TSDB_CHECK_CODE(code, lino, _exit);
+    goto _exit;
+  }
+
+  merger->ctx->toData = false;
+  for (int32_t i = start; i < start + merger->sttTrigger; ++i) {
+    SSttFileReader *reader = aCand[i].reader;
+    aCand[i].reader = NULL;
+    code = tsdbMergerAddFile(merger, aCand[i].fobj, reader);
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
+  tsdbDebug("vgId:%d fid:%d pick %d of %d stt files by cost to level %d", TD_VID(merger->tsdb->pVnode),
+            merger->ctx->fset->fid, merger->sttTrigger, nCand, merger->ctx->level);
+
 _exit:
   if (code) {
-    tsdbMergeFileSetEndCloseReader(merger);
     TSDB_ERROR_LOG(TD_VID(merger->tsdb->pVnode), lino, code);
   }
+  for (int32_t i = 0; aCand && i < nCand; ++i) {
+    if (aCand[i].reader) {
+      tsdbSttFileReaderClose(&aCand[i].reader);
+    }
+  }
+  taosMemoryFree(aCand);
+  return code;
+}
+
+typedef struct {
+  const char *name;
+  int32_t (*pick)(SMerger *merger);
+} SMergePolicy;
+
+// indexed by sttMergePolicy
+static const SMergePolicy tsdbMergePolicies[] = {
+    {"level", tsdbMergePickByLevel},
+    {"cost", tsdbMergePickByCost},
+};
+
+static int32_t tsdbMergeFileSetBeginOpenReader(SMerger *merger) {
+  int32_t policy = tsSttMergePolicy;
+  if (policy < 0 || policy >= tListLen(tsdbMergePolicies)) {
+    policy = 0;
+  }
+
+  int32_t code = tsdbMergePolicies[policy].pick(merger);
+  if (code) {
+    tsdbMergeFileSetEndCloseReader(merger);
+    tsdbError("vgId:%d fid:%d failed to pick stt files by %s policy since %s", TD_VID(merger->tsdb->pVnode),
+              merger->ctx->fset->fid, tsdbMergePolicies[policy].name, tstrerror(code));
+  }
   return code;
 }
 
@@ -585,7 +789,8 @@ int32_t tsdbMerge(void *arg) {
   // do merge
   tsdbInfo("vgId:%d merge begin, fid:%d", TD_VID(tsdb->pVnode), merger->fid);
   code = tsdbDoMerge(merger);
-  tsdbInfo("vgId:%d merge done, fid:%d", TD_VID(tsdb->pVnode), mergeArg->fid);
+  tsdbInfo("vgId:%d merge done, fid:%d, write amplification:%.2f", TD_VID(tsdb->pVnode), mergeArg->fid,
+           tsdbFSWriteAmp(tsdb->pFS));
   TSDB_CHECK_CODE(code, lino, _exit);
 
 _exit:
@@ -28,8 +28,19 @@ extern "C" {
 #endif
 
 /* Exposed Handle */
+typedef struct {
+  STFileObj      *fobj;
+  int32_t         level;
+  SSttFileReader *reader;
+  TSKEY           minKey;
+  TSKEY           maxKey;
+  double          score;
+} SMergeCand;
 
 /* Exposed APIs */
+// pick stt files by cost
+void    tsdbMergeCandScore(SMergeCand *aCand, int32_t nCand);
+int32_t tsdbMergeCandPick(SMergeCand *aCand, int32_t nCand, int32_t sttTrigger, int32_t *level);
 
 /* Exposed Structs */
 
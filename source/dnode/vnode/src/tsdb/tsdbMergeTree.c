@@ -910,6 +910,8 @@ int32_t tMergeTreeOpen2(SMergeTree *pMTree, SMergeTreeConf *pConf, SSttDataInfoF
         if (code != TSDB_CODE_SUCCESS) {
           tsdbError("open stt file reader error. file name %s, code %s, %s", pSttLevel->fobjArr->data[i]->fname,
                     tstrerror(code), pMTree->idStr);
+        } else {
+          atomic_add_fetch_32(&pSttLevel->fobjArr->data[i]->nRead, 1);
         }
       }
 
@@ -371,6 +371,7 @@ void resetDataBlockIterator(SDataBlockIter* pIter, int32_t order, bool needFree)
   pIter->order = order;
   pIter->index = -1;
   pIter->numOfBlocks = 0;
+  pIter->numOfPrefetched = 0;
   if (pIter->blockList == NULL) {
     pIter->blockList = taosArrayInit(4, sizeof(SFileDataBlockInfo));
   } else {
@@ -450,6 +451,7 @@ static int32_t tsdbReleaseReader(STsdbReader* pReader) {
 
 void tsdbReleaseDataBlock2(STsdbReader* pReader) {
   SReaderStatus* pStatus = &pReader->status;
+  pStatus->partialLoad.pending = false;
   if (!pStatus->composedDataBlock) {
     tsdbReleaseReader(pReader);
   }
@@ -543,6 +545,12 @@ static int32_t tsdbReaderCreate(SVnode* pVnode, SQueryTableDataCond* pCond, void
     goto _end;
   }
 
+  code = tBlockDataCreate(&pReader->status.remainBlockData);
+  if (code != TSDB_CODE_SUCCESS) {
+    terrno = code;
+    goto _end;
+  }
+
   if (pReader->suppInfo.colId[0] != PRIMARYKEY_TIMESTAMP_COL_ID) {
     tsdbError("the first column isn't primary timestamp, %d, %s", pReader->suppInfo.colId[0], pReader->idStr);
     code = TSDB_CODE_INVALID_PARA;
@@ -1103,6 +1111,54 @@ static void blockInfoToRecord(SBrinRecord* record, SFileDataBlockInfo* pBlockInf
   record->count = pBlockInfo->count;
 }
 
+static int32_t copyColDataToSDataBlock(SColData* pData, SFileBlockDumpInfo* pDumpInfo, SColumnInfoData* pColData,
+                                       int32_t dumpedRows, int32_t colIndex, SBlockLoadSuppInfo* pSupInfo, bool asc) {
+  int32_t step = asc ? 1 : -1;
+  int32_t rowIndex = 0;
+  SColVal cv = {0};
+
+  if (pData->flag == HAS_NONE || pData->flag == HAS_NULL || pData->flag == (HAS_NULL | HAS_NONE)) {
+    colDataSetNNULL(pColData, 0, dumpedRows);
+  } else {
+    if (IS_MATHABLE_TYPE(pColData->info.type)) {
+      copyNumericCols(pData, pDumpInfo, pColData, dumpedRows, asc);
+    } else {  // varchar/nchar type
+      for (int32_t j = pDumpInfo->rowIndex; rowIndex < dumpedRows; j += step) {
+        tColDataGetValue(pData, j, &cv);
+        int32_t code = doCopyColVal(pColData, rowIndex++, colIndex, &cv, pSupInfo);
+        if (code) {
+          return code;
+        }
+      }
+    }
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+// Give the buffers back to the columns of the result block that refer to the data of the file block, which is about to
+// be overwritten or released.
+static void resetZeroCopyColumns(STsdbReader* pReader) {
+  SResultBlockInfo*   pResBlockInfo = &pReader->resBlockInfo;
+  SBlockLoadSuppInfo* pSupInfo = &pReader->suppInfo;
+  if (pResBlockInfo->pOrigData == NULL) {
+    return;
+  }
+
+  for (int32_t i = 0; i < pSupInfo->numOfCols; ++i) {
+    if (pResBlockInfo->pOrigData[i] != NULL) {
+      SColumnInfoData* pColData = taosArrayGet(pResBlockInfo->pResBlock->pDataBlock, pSupInfo->slotId[i]);
+      pColData->pData = pResBlockInfo->pOrigData[i];
+      pResBlockInfo->pOrigData[i] = NULL;
+    }
+  }
+}
+
+static void refFileBlockColData(STsdbReader* pReader, SColumnInfoData* pColData, int32_t colIndex, void* pData) {
+  pReader->resBlockInfo.pOrigData[colIndex] = pColData->pData;
+  pColData->pData = pData;
+}
+
 static int32_t copyBlockDataToSDataBlock(STsdbReader* pReader, SRowKey* pLastProcKey) {
   SReaderStatus*      pStatus = &pReader->status;
   SDataBlockIter*     pBlockIter = &pStatus->blockIter;
@@ -1118,11 +1174,12 @@ static int32_t copyBlockDataToSDataBlock(STsdbReader* pReader, SRowKey* pLastPro
   bool                asc = ASCENDING_TRAVERSE(pReader->info.order);
   int32_t             step = asc ? 1 : -1;
 
-  SColVal     cv = {0};
   SBrinRecord tmp;
   blockInfoToRecord(&tmp, pBlockInfo, pSupInfo);
   SBrinRecord* pRecord = &tmp;
 
+  resetZeroCopyColumns(pReader);
+
   // no data exists, return directly.
   if (pBlockData->nRow == 0 || pBlockData->aTSKEY == 0) {
     tsdbWarn("%p no need to copy since no data in blockData, table uid:%" PRIu64 " has been dropped, %s", pReader,
@@ -1196,39 +1253,44 @@ static int32_t copyBlockDataToSDataBlock(STsdbReader* pReader, SRowKey* pLastPro
     return TSDB_CODE_SUCCESS;
   }
 
+  // keep the dumped range, in case the remained columns are loaded later
+  pStatus->partialLoad.rowIndex = pDumpInfo->rowIndex;
+  pStatus->partialLoad.rows = dumpedRows;
+
+  // the whole block is dumped in the same order as it is stored, so the columns without null value are not copied but
+  // refer to the file block data, which is kept until the next block is requested.
+  bool zeroCopy = pReader->resBlockInfo.zeroCopy && asc && pDumpInfo->rowIndex == 0 && dumpedRows == pBlockData->nRow;
+  if (zeroCopy) {
+    pReader->cost.zeroCopyBlocks += 1;
+  }
+
   int32_t i = 0;
-  int32_t rowIndex = 0;
 
   SColumnInfoData* pColData = taosArrayGet(pResBlock->pDataBlock, pSupInfo->slotId[i]);
   if (pSupInfo->colId[i] == PRIMARYKEY_TIMESTAMP_COL_ID) {
-    copyPrimaryTsCol(pBlockData, pDumpInfo, pColData, dumpedRows, asc);
+    if (zeroCopy) {
+      refFileBlockColData(pReader, pColData, i, pBlockData->aTSKEY);
+    } else {
+      copyPrimaryTsCol(pBlockData, pDumpInfo, pColData, dumpedRows, asc);
+    }
     i += 1;
   }
 
   int32_t colIndex = 0;
   int32_t num = pBlockData->nColData;
   while (i < numOfOutputCols && colIndex < num) {
-    rowIndex = 0;
-
     SColData* pData = tBlockDataGetColDataByIdx(pBlockData, colIndex);
     if (pData->cid < pSupInfo->colId[i]) {
       colIndex += 1;
     } else if (pData->cid == pSupInfo->colId[i]) {
       pColData = taosArrayGet(pResBlock->pDataBlock, pSupInfo->slotId[i]);
-
-      if (pData->flag == HAS_NONE || pData->flag == HAS_NULL || pData->flag == (HAS_NULL | HAS_NONE)) {
-        colDataSetNNULL(pColData, 0, dumpedRows);
+      if (zeroCopy && pData->flag == HAS_VALUE && IS_MATHABLE_TYPE(pColData->info.type) &&
+          tDataTypes[pData->type].bytes == pColData->info.bytes) {
+        refFileBlockColData(pReader, pColData, i, pData->pData);
       } else {
-        if (IS_MATHABLE_TYPE(pColData->info.type)) {
-          copyNumericCols(pData, pDumpInfo, pColData, dumpedRows, asc);
-        } else {  // varchar/nchar type
-          for (int32_t j = pDumpInfo->rowIndex; rowIndex < dumpedRows; j += step) {
-            tColDataGetValue(pData, j, &cv);
-            code = doCopyColVal(pColData, rowIndex++, i, &cv, pSupInfo);
-            if (code) {
-              return code;
-            }
-          }
+        code = copyColDataToSDataBlock(pData, pDumpInfo, pColData, dumpedRows, i, pSupInfo, asc);
+        if (code) {
+          return code;
         }
       }
 
@@ -1299,13 +1361,48 @@ static FORCE_INLINE STSchema* getTableSchemaImpl(STsdbReader* pReader, uint64_t
   return pReader->info.pSchema;
 }
 
+// issue the reads of the next blocks in access order, so they are in flight while the current one is decoded and merged
+static void doPrefetchFileBlocks(STsdbReader* pReader, SDataBlockIter* pBlockIter) {
+  int32_t depth = tsQueryPrefetchBlocks;
+  if (depth <= 0 || pReader->pFileReader == NULL) {
+    return;
+  }
+
+  bool    asc = ASCENDING_TRAVERSE(pBlockIter->order);
+  int32_t pos = asc ? pBlockIter->index : (pBlockIter->numOfBlocks - 1 - pBlockIter->index);
+  int32_t end = TMIN(pos + depth + 1, pBlockIter->numOfBlocks);
+  int32_t num = 0;
+  int64_t st = taosGetTimestampUs();
+
+  for (int32_t i = TMAX(pos + 1, pBlockIter->numOfPrefetched); i < end; ++i) {
+    SFileDataBlockInfo* pBlockInfo = taosArrayGet(pBlockIter->blockList, asc ? i : (pBlockIter->numOfBlocks - 1 - i));
+    SBrinRecord         record = {.blockOffset = pBlockInfo->blockOffset, .blockSize = pBlockInfo->blockSize};
+
+    int32_t code = tsdbDataFilePrefetchBlockData(pReader->pFileReader, &record);
+    if (code != TSDB_CODE_SUCCESS) {
+      // prefetch is only a hint, the block will be read when it is accessed
+      tsdbDebug("%p failed to prefetch file block, global index:%d, code:%s %s", pReader, i, tstrerror(code),
+                pReader->idStr);
+      break;
+    }
+    num += 1;
+  }
+
+  pBlockIter->numOfPrefetched = TMAX(pBlockIter->numOfPrefetched, end);
+  if (num > 0) {
+    pReader->cost.prefetchBlocks += num;
+    pReader->cost.prefetchTime += (taosGetTimestampUs() - st) / 1000.0;
+  }
+}
+
 static int32_t doLoadFileBlockData(STsdbReader* pReader, SDataBlockIter* pBlockIter, SBlockData* pBlockData,
-                                   uint64_t uid) {
+                                   uint64_t uid, int16_t* cids, int32_t numOfCids) {
   int32_t   code = 0;
   STSchema* pSchema = pReader->info.pSchema;
   int64_t   st = taosGetTimestampUs();
 
   tBlockDataReset(pBlockData);
+  pReader->dict.nEntry = 0;
 
   if (pReader->info.pSchema == NULL) {
     pSchema = getTableSchemaImpl(pReader, uid);
@@ -1319,11 +1416,14 @@ static int32_t doLoadFileBlockData(STsdbReader* pReader, SDataBlockIter* pBlockI
   SFileDataBlockInfo* pBlockInfo = getCurrentBlockInfo(pBlockIter);
   SFileBlockDumpInfo* pDumpInfo = &pReader->status.fBlockDumpInfo;
 
+  doPrefetchFileBlocks(pReader, pBlockIter);
+
   SBrinRecord tmp;
   blockInfoToRecord(&tmp, pBlockInfo, pSup);
   SBrinRecord* pRecord = &tmp;
-  code = tsdbDataFileReadBlockDataByColumn(pReader->pFileReader, pRecord, pBlockData, pSchema, &pSup->colId[1],
-                                           pSup->numOfCols - 1);
+  tsdbDataFileReaderSetDict(pReader->pFileReader, pReader->dictFilterColId,
+                            (pReader->pDictFilterInfo != NULL) ? &pReader->dict : NULL);
+  code = tsdbDataFileReadBlockDataByColumn(pReader->pFileReader, pRecord, pBlockData, pSchema, cids, numOfCids);
   if (code != TSDB_CODE_SUCCESS) {
     tsdbError("%p error occurs in loading file block, global index:%d, table index:%d, brange:%" PRId64 "-%" PRId64
               ", rows:%d, code:%s %s",
@@ -2476,7 +2576,8 @@ static int32_t loadNeighborIfOverlap(SFileDataBlockInfo* pBlockInfo, STableBlock
     setFileBlockActiveInBlockIter(pReader, pBlockIter, neighborIndex, step);
 
     // 3. load the neighbor block, and set it to be the currently accessed file data block
-    code = doLoadFileBlockData(pReader, pBlockIter, &pStatus->fileBlockData, pBlockInfo->uid);
+    code = doLoadFileBlockData(pReader, pBlockIter, &pStatus->fileBlockData, pBlockInfo->uid, &pReader->suppInfo.colId[1],
+                               pReader->suppInfo.numOfCols - 1);
     if (code != TSDB_CODE_SUCCESS) {
       return code;
     }
@@ -2504,6 +2605,88 @@ void updateComposedBlockInfo(STsdbReader* pReader, double el, STableBlockScanInf
   pReader->cost.buildComposedBlockTime += el;
 }
 
+// The number of rows of the file block from start, at most remain, that can be copied as a run: the rows before the
+// bound, the first key in the buffer or stt files if hasBound. A row of a run must have a successor in the same block
+// with a different timestamp, so neither a duplicated timestamp nor the border row of the block that may be overlapped
+// with the neighbor block is included.
+int32_t getFileBlockRunLength(STsdbReader* pReader, STableBlockScanInfo* pBlockScanInfo, SBlockData* pBlockData,
+                              int32_t start, int32_t remain, bool hasBound, int64_t bound) {
+  bool    asc = ASCENDING_TRAVERSE(pReader->info.order);
+  int32_t step = asc ? 1 : -1;
+  int32_t num = 0;
+
+  for (int32_t i = start; num < remain; i += step) {
+    int32_t next = i + step;
+    if (next < 0 || next >= pBlockData->nRow) {
+      break;
+    }
+
+    int64_t ts = pBlockData->aTSKEY[i];
+    if (hasBound && ((asc && ts >= bound) || ((!asc) && ts <= bound))) {
+      break;
+    }
+
+    if (pBlockData->aTSKEY[next] == ts) {
+      break;
+    }
+
+    if (num > 0 && !isValidFileBlockRow(pBlockData, i, pBlockScanInfo, asc, &pReader->info, pReader)) {
+      break;
+    }
+
+    num += 1;
+  }
+
+  return num;
+}
+
+// Copy the rows of the file block that start from the current position and are not overlapped with any key in the
+// buffer or stt files in a batch, instead of merging them one-by-one.
+static int32_t doCopyFileBlockRun(STsdbReader* pReader, STableBlockScanInfo* pBlockScanInfo, SBlockData* pBlockData,
+                                  bool* copied) {
+  SFileBlockDumpInfo* pDumpInfo = &pReader->status.fBlockDumpInfo;
+  SSttBlockReader*    pSttBlockReader = pReader->status.fileIter.pSttBlockReader;
+  SSDataBlock*        pResBlock = pReader->resBlockInfo.pResBlock;
+  bool                asc = ASCENDING_TRAVERSE(pReader->info.order);
+  int32_t             step = asc ? 1 : -1;
+
+  *copied = false;
+
+  int32_t remain = pReader->resBlockInfo.capacity - pResBlock->info.rows;
+  if (remain < 2) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  // the first key that has to be merged with the rows in the file block
+  TSDBKEY keyInBuf = getCurrentKeyInBuf(pBlockScanInfo, pReader);
+  bool    hasBound = (keyInBuf.ts != TSKEY_INITIAL_VAL);
+  int64_t bound = keyInBuf.ts;
+  if (hasDataInSttBlock(pBlockScanInfo)) {
+    int64_t sttKey = getCurrentKeyInSttBlock(pSttBlockReader)->ts;
+    bound = (!hasBound) ? sttKey : (asc ? TMIN(bound, sttKey) : TMAX(bound, sttKey));
+    hasBound = true;
+  }
+
+  int32_t start = pDumpInfo->rowIndex;
+  int32_t num = getFileBlockRunLength(pReader, pBlockScanInfo, pBlockData, start, remain, hasBound, bound);
+  if (num < 2) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  int32_t code = doAppendRowsFromFileBlock(pResBlock, pReader, pBlockData, start, num, asc);
+  if (code) {
+    return code;
+  }
+
+  int32_t lastIndex = start + step * (num - 1);
+  tColRowGetKeyDeepCopy(pBlockData, lastIndex, pReader->suppInfo.pkSrcSlot, &pBlockScanInfo->lastProcKey);
+  pDumpInfo->rowIndex = lastIndex + step;
+  pReader->cost.composedRunRows += num;
+
+  *copied = true;
+  return code;
+}
+
 static int32_t buildComposedDataBlock(STsdbReader* pReader) {
   int32_t             code = TSDB_CODE_SUCCESS;
   bool                asc = ASCENDING_TRAVERSE(pReader->info.order);
@@ -2578,11 +2761,19 @@ static int32_t buildComposedDataBlock(STsdbReader* pReader) {
       break;
     }
 
-    code = buildComposedDataBlockImpl(pReader, pBlockScanInfo, pBlockData, pSttBlockReader);
+    bool copied = false;
+    code = doCopyFileBlockRun(pReader, pBlockScanInfo, pBlockData, &copied);
     if (code) {
       goto _end;
     }
 
+    if (!copied) {
+      code = buildComposedDataBlockImpl(pReader, pBlockScanInfo, pBlockData, pSttBlockReader);
+      if (code) {
+        goto _end;
+      }
+    }
+
     // currently loaded file data block is consumed
     if ((pBlockData->nRow > 0) && (pDumpInfo->rowIndex >= pBlockData->nRow || pDumpInfo->rowIndex < 0)) {
       setBlockAllDumped(pDumpInfo, pBlockInfo->lastKey, pReader->info.order);
@@ -3003,6 +3194,52 @@ static bool notOverlapWithFiles(SFileDataBlockInfo* pBlockInfo, STableBlockScanI
   }
 }
 
+// A file block that overlaps with no other data (neighbor blocks, stt blocks, in-memory rows or duplicated timestamps)
+// contributes its own rows only, so it can be skipped if the column SMA shows no row may satisfy the filter.
+static int32_t fileBlockFilteredOutBySma(STsdbReader* pReader, SFileDataBlockInfo* pBlockInfo,
+                                         STableBlockScanInfo* pScanInfo, TSDBKEY keyInBuf, bool* filteredOut) {
+  SBlockLoadSuppInfo* pSup = &pReader->suppInfo;
+  bool                asc = ASCENDING_TRAVERSE(pReader->info.order);
+
+  *filteredOut = false;
+  if (pReader->pFilterInfo == NULL || pReader->type == TIMEWINDOW_RANGE_EXTERNAL) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  if (bufferDataInFileBlockGap(keyInBuf, pBlockInfo, pScanInfo, pReader->info.order)) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  if (hasDataInSttBlock(pScanInfo)) {
+    int64_t keyInStt = pScanInfo->sttKeyInfo.nextProcKey.ts;
+    if ((asc && pBlockInfo->lastKey >= keyInStt) || (!asc && pBlockInfo->firstKey <= keyInStt)) {
+      return TSDB_CODE_SUCCESS;
+    }
+  }
+
+  SDataBlockToLoadInfo info = {0};
+  getBlockToLoadInfo(&info, pBlockInfo, pScanInfo, keyInBuf, pReader);
+  if (info.overlapWithNeighborBlock || info.hasDupTs || info.overlapWithKeyInBuf) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  SBrinRecord record;
+  blockInfoToRecord(&record, pBlockInfo, pSup);
+
+  TARRAY2_CLEAR(&pSup->colAggArray, 0);
+  int32_t code = tsdbDataFileReadBlockSma(pReader->pFileReader, &record, &pSup->colAggArray);
+  if (code != TSDB_CODE_SUCCESS) {
+    return code;
+  }
+
+  if (pSup->colAggArray.size > 0) {
+    *filteredOut =
+        !filterRangeExecute(pReader->pFilterInfo, pSup->colAggArray.data, pSup->colAggArray.size, pBlockInfo->numRow);
+  }
+
+  return code;
+}
+
 static int32_t doBuildDataBlock(STsdbReader* pReader) {
   SReaderStatus*       pStatus = &pReader->status;
   SDataBlockIter*      pBlockIter = &pStatus->blockIter;
@@ -3031,8 +3268,29 @@ static int32_t doBuildDataBlock(STsdbReader* pReader) {
   }
 
   TSDBKEY keyInBuf = getCurrentKeyInBuf(pScanInfo, pReader);
+
+  bool filteredOut = false;
+  code = fileBlockFilteredOutBySma(pReader, pBlockInfo, pScanInfo, keyInBuf, &filteredOut);
+  if (code != TSDB_CODE_SUCCESS) {
+    return code;
+  }
+
+  if (filteredOut) {
+    SDataBlockInfo info = {.window = {.skey = pBlockInfo->firstKey, .ekey = pBlockInfo->lastKey}};
+    setBlockAllDumped(&pStatus->fBlockDumpInfo, pBlockInfo->lastKey, pReader->info.order);
+    updateLastKeyInfo(&pScanInfo->lastProcKey, pBlockInfo, &info, pReader->suppInfo.numOfPks, asc);
+    pReader->cost.smaFilterOutBlocks += 1;
+
+    tsdbDebug("%p uid:%" PRIu64 " file block filtered out by SMA, global index:%d, rows:%d, brange:%" PRId64
+              "-%" PRId64 ", %s",
+              pReader, pScanInfo->uid, pBlockIter->index, pBlockInfo->numRow, pBlockInfo->firstKey,
+              pBlockInfo->lastKey, pReader->idStr);
+    return code;
+  }
+
   if (fileBlockShouldLoad(pReader, pBlockInfo, pScanInfo, keyInBuf)) {
-    code = doLoadFileBlockData(pReader, pBlockIter, &pStatus->fileBlockData, pScanInfo->uid);
+    code = doLoadFileBlockData(pReader, pBlockIter, &pStatus->fileBlockData, pScanInfo->uid, &pReader->suppInfo.colId[1],
+                               pReader->suppInfo.numOfCols - 1);
     if (code != TSDB_CODE_SUCCESS) {
       return code;
     }
@@ -4089,6 +4347,88 @@ int32_t doAppendRowFromFileBlock(SSDataBlock* pResBlock, STsdbReader* pReader, S
   return TSDB_CODE_SUCCESS;
 }
 
+int32_t doAppendRowsFromFileBlock(SSDataBlock* pResBlock, STsdbReader* pReader, SBlockData* pBlockData, int32_t rowIndex,
+                                  int32_t numOfRows, bool asc) {
+  int32_t i = 0, j = 0;
+  int32_t outputRowIndex = pResBlock->info.rows;
+  int32_t step = asc ? 1 : -1;
+  int32_t code = TSDB_CODE_SUCCESS;
+
+  SBlockLoadSuppInfo* pSupInfo = &pReader->suppInfo;
+  int64_t*            pts = (int64_t*)pReader->status.pPrimaryTsCol->pData + outputRowIndex;
+  if (asc) {
+    memcpy(pts, &pBlockData->aTSKEY[rowIndex], numOfRows * sizeof(int64_t));
+  } else {
+    for (int32_t k = 0; k < numOfRows; ++k) {
+      pts[k] = pBlockData->aTSKEY[rowIndex - k];
+    }
+  }
+  i += 1;
+
+  SColVal cv = {0};
+  int32_t numOfInputCols = pBlockData->nColData;
+  int32_t numOfOutputCols = pSupInfo->numOfCols;
+
+  while (i < numOfOutputCols && j < numOfInputCols) {
+    SColData* pData = tBlockDataGetColDataByIdx(pBlockData, j);
+    if (pData->cid < pSupInfo->colId[i]) {
+      j += 1;
+      continue;
+    }
+
+    SColumnInfoData* pCol = TARRAY_GET_ELEM(pResBlock->pDataBlock, pSupInfo->slotId[i]);
+    if (pData->cid == pSupInfo->colId[i]) {
+      if (pData->flag == HAS_NONE || pData->flag == HAS_NULL || pData->flag == (HAS_NULL | HAS_NONE)) {
+        colDataSetNNULL(pCol, outputRowIndex, numOfRows);
+      } else if (IS_MATHABLE_TYPE(pCol->info.type)) {
+        int32_t  bytes = tDataTypes[pData->type].bytes;
+        uint8_t* pDst = (uint8_t*)pCol->pData + outputRowIndex * bytes;
+        if (asc) {
+          memcpy(pDst, pData->pData + rowIndex * bytes, numOfRows * bytes);
+        } else {
+          for (int32_t k = 0; k < numOfRows; ++k) {
+            memcpy(pDst + k * bytes, pData->pData + (rowIndex - k) * bytes, bytes);
+          }
+        }
+
+        if (pData->flag != HAS_VALUE) {
+          for (int32_t k = 0; k < numOfRows; ++k) {
+            uint8_t v = tColDataGetBitValue(pData, rowIndex + step * k);
+            if (v == 0 || v == 1) {
+              colDataSetNull_f(pCol->nullbitmap, outputRowIndex + k);
+              pCol->hasNull = true;
+            }
+          }
+        }
+      } else {
+        for (int32_t k = 0; k < numOfRows; ++k) {
+          tColDataGetValue(pData, rowIndex + step * k, &cv);
+          code = doCopyColVal(pCol, outputRowIndex + k, i, &cv, pSupInfo);
+          if (code) {
+            return code;
+          }
+        }
+      }
+      j += 1;
+    } else if (pData->cid > pCol->info.colId) {
+      // the specified column does not exist in file block, fill with null data
+      colDataSetNNULL(pCol, outputRowIndex, numOfRows);
+    }
+
+    i += 1;
+  }
+
+  while (i < numOfOutputCols) {
+    SColumnInfoData* pCol = taosArrayGet(pResBlock->pDataBlock, pSupInfo->slotId[i]);
+    colDataSetNNULL(pCol, outputRowIndex, numOfRows);
+    i += 1;
+  }
+
+  pResBlock->info.dataLoad = 1;
+  pResBlock->info.rows += numOfRows;
+  return TSDB_CODE_SUCCESS;
+}
+
 int32_t buildDataBlockFromBufImpl(STableBlockScanInfo* pBlockScanInfo, int64_t endKey, int32_t capacity,
                                   STsdbReader* pReader) {
   SSDataBlock* pBlock = pReader->resBlockInfo.pResBlock;
@@ -4402,12 +4742,18 @@ void tsdbReaderClose2(STsdbReader* pReader) {
     }
   }
 
+  resetZeroCopyColumns(pReader);
+  taosMemoryFreeClear(pReader->resBlockInfo.pOrigData);
+
   if (pReader->resBlockInfo.freeBlock) {
     pReader->resBlockInfo.pResBlock = blockDataDestroy(pReader->resBlockInfo.pResBlock);
   }
 
   taosMemoryFree(pSupInfo->colId);
   tBlockDataDestroy(&pReader->status.fileBlockData);
+  tFree(pReader->dict.aCode);
+  tBlockDataDestroy(&pReader->status.remainBlockData);
+  taosMemoryFreeClear(pReader->status.partialLoad.loadColId);
   cleanupDataBlockIterator(&pReader->status.blockIter, shouldFreePkBuf(&pReader->suppInfo));
 
   size_t numOfTables = tSimpleHashGetSize(pReader->status.pTableMap);
@@ -4447,15 +4793,16 @@ void tsdbReaderClose2(STsdbReader* pReader) {
   tsdbDebug(
       "%p :io-cost summary: head-file:%" PRIu64 ", head-file time:%.2f ms, SMA:%" PRId64
       " SMA-time:%.2f ms, fileBlocks:%" PRId64
-      ", fileBlocks-load-time:%.2f ms, "
-      "build in-memory-block-time:%.2f ms, sttBlocks:%" PRId64 ", sttBlocks-time:%.2f ms, sttStatisBlock:%" PRId64
-      ", stt-statis-Block-time:%.2f ms, composed-blocks:%" PRId64
+      ", fileBlocks-load-time:%.2f ms, prefetchBlocks:%" PRId64 ", prefetch-time:%.2f ms, "
+      "smaFilterOutBlocks:%" PRId64 ", dictFilterOutBlocks:%" PRId64 ", lateLoadBlocks:%" PRId64 ", lateSkipBlocks:%" PRId64 ", zeroCopyBlocks:%" PRId64 ", build in-memory-block-time:%.2f ms, sttBlocks:%" PRId64 ", sttBlocks-time:%.2f ms, sttStatisBlock:%" PRId64
+      ", stt-statis-Block-time:%.2f ms, composed-blocks:%" PRId64 ", composed-run-rows:%" PRId64
       ", composed-blocks-time:%.2fms, STableBlockScanInfo size:%.2f Kb, createTime:%.2f ms,createSkylineIterTime:%.2f "
       "ms, initSttBlockReader:%.2fms, %s",
       pReader, pCost->headFileLoad, pCost->headFileLoadTime, pCost->smaDataLoad, pCost->smaLoadTime, pCost->numOfBlocks,
-      pCost->blockLoadTime, pCost->buildmemBlock, pCost->sttCost.loadBlocks, pCost->sttCost.blockElapsedTime,
+      pCost->blockLoadTime, pCost->prefetchBlocks, pCost->prefetchTime, pCost->smaFilterOutBlocks, pCost->dictFilterOutBlocks, pCost->lateLoadBlocks,
+      pCost->lateSkipBlocks, pCost->zeroCopyBlocks, pCost->buildmemBlock, pCost->sttCost.loadBlocks, pCost->sttCost.blockElapsedTime,
       pCost->sttCost.loadStatisBlocks, pCost->sttCost.statisElapsedTime, pCost->composedBlocks,
-      pCost->buildComposedBlockTime, numOfTables * sizeof(STableBlockScanInfo) / 1000.0, pCost->createScanInfoList,
+      pCost->composedRunRows, pCost->buildComposedBlockTime, numOfTables * sizeof(STableBlockScanInfo) / 1000.0, pCost->createScanInfoList,
       pCost->createSkylineIterTime, pCost->initSttBlockReader, pReader->idStr);
 
   taosMemoryFree(pReader->idStr);
@@ -4718,6 +5065,7 @@ static int32_t doTsdbNextDataBlock2(STsdbReader* pReader, bool* hasNext) {
 
   // cleanup the data that belongs to the previous data block
   SSDataBlock* pBlock = pReader->resBlockInfo.pResBlock;
+  resetZeroCopyColumns(pReader);
   blockDataCleanup(pBlock);
 
   *hasNext = false;
@@ -4993,8 +5341,128 @@ int32_t tsdbRetrieveDatablockSMA2(STsdbReader* pReader, SSDataBlock* pDataBlock,
   return code;
 }
 
-static SSDataBlock* doRetrieveDataBlock(STsdbReader* pReader) {
+// A clean file block contributes its own rows only, so it is skipped if no entry in the dictionary of the filter column
+// satisfies the filter. Each distinct value is compared once, and the rows of the column are not built at all.
+static int32_t fileBlockFilteredOutByDict(STsdbReader* pReader, bool* filteredOut) {
+  SBlockLoadSuppInfo* pSup = &pReader->suppInfo;
+  SBlockData*         pBlockData = &pReader->status.fileBlockData;
+  SSDataBlock*        pResBlock = pReader->resBlockInfo.pResBlock;
+  SColDataDict*       pDict = &pReader->dict;
+  int32_t             code = TSDB_CODE_SUCCESS;
+
+  *filteredOut = false;
+  if (pReader->pDictFilterInfo == NULL || pReader->type == TIMEWINDOW_RANGE_EXTERNAL || pDict->nEntry <= 0) {
+    return code;
+  }
+
+  SColData* pData = tBlockDataGetColData(pBlockData, pReader->dictFilterColId);
+  if (pData == NULL) {
+    return code;
+  }
+
+  int32_t colIndex = 1;
+  while (colIndex < pSup->numOfCols && pSup->colId[colIndex] != pData->cid) {
+    colIndex += 1;
+  }
+  if (colIndex >= pSup->numOfCols) {
+    return code;
+  }
+
+  // one more entry for the empty string, which is a value without dictionary code
+  int32_t         nEntry = pDict->nEntry;
+  int32_t*        aFirstRow = taosMemoryMalloc(sizeof(int32_t) * (nEntry + 1));
+  int8_t*         pRes = taosMemoryMalloc(nEntry + 1);
+  SColumnInfoData dict = {.info = ((SColumnInfoData*)taosArrayGet(pResBlock->pDataBlock, pSup->slotId[colIndex]))->info};
+  if (aFirstRow == NULL || pRes == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _end;
+  }
+
+  for (int32_t k = 0; k <= nEntry; ++k) {
+    aFirstRow[k] = -1;
+  }
+
+  for (int32_t j = 0; j < pData->nVal; ++j) {
+    int32_t dictCode = pDict->aCode[j];
+    if (dictCode >= 0 && dictCode < nEntry) {
+      if (aFirstRow[dictCode] < 0) aFirstRow[dictCode] = j;
+    } else if (aFirstRow[nEntry] < 0 && tColDataGetBitValue(pData, j) == 2) {
+      aFirstRow[nEntry] = j;
+    }
+  }
+
+  code = colInfoDataEnsureCapacity(&dict, nEntry + 1, false);
+  if (code != TSDB_CODE_SUCCESS) {
+    goto _end;
+  }
+
+  for (int32_t k = 0; k <= nEntry; ++k) {
+    SColVal cv = COL_VAL_NULL(pData->cid, pData->type);
+    if (aFirstRow[k] >= 0) {
+      tColDataGetValue(pData, aFirstRow[k], &cv);
+    }
+
+    code = doCopyColVal(&dict, k, colIndex, &cv, pSup);
+    if (code != TSDB_CODE_SUCCESS) {
+      goto _end;
+    }
+  }
+
+  int32_t numOfQualified = 0;
+  code = filterExecuteOnDict(pReader->pDictFilterInfo, &dict, nEntry + 1, pRes, &numOfQualified);
+  if (code == TSDB_CODE_SUCCESS) {
+    *filteredOut = (numOfQualified == 0);
+  }
+
+_end:
+  colDataDestroy(&dict);
+  taosMemoryFree(aFirstRow);
+  taosMemoryFree(pRes);
+  return code;
+}
+
+// split the required columns into the ones needed by the caller right now (pIdList) and the remained ones, which are
+// loaded by tsdbRetrieveRemainCols2 after the caller has checked if any row of this block qualifies.
+static int32_t splitLoadColumns(STsdbReader* pReader, SArray* pIdList) {
+  SBlockLoadSuppInfo* pSup = &pReader->suppInfo;
+  SPartialLoadInfo*   pLoad = &pReader->status.partialLoad;
+
+  pLoad->numOfLoadCols = 0;
+  pLoad->numOfRemainCols = 0;
+
+  if (pLoad->loadColId == NULL) {
+    pLoad->loadColId = taosMemoryMalloc(sizeof(int16_t) * pSup->numOfCols * 2);
+    if (pLoad->loadColId == NULL) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+    pLoad->remainColId = pLoad->loadColId + pSup->numOfCols;
+  }
+
+  int32_t num = taosArrayGetSize(pIdList);
+  for (int32_t i = 1; i < pSup->numOfCols; ++i) {
+    // the primary key column is always loaded along with the timestamp column
+    bool required = (pSup->numOfPks > 0 && pSup->colId[i] == pSup->pk.colId);
+    for (int32_t j = 0; j < num && !required; ++j) {
+      if (*(int16_t*)taosArrayGet(pIdList, j) == pSup->colId[i]) {
+        required = true;
+        break;
+      }
+    }
+
+    if (required) {
+      pLoad->loadColId[pLoad->numOfLoadCols++] = pSup->colId[i];
+    } else {
+      pLoad->remainColId[pLoad->numOfRemainCols++] = pSup->colId[i];
+    }
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+static SSDataBlock* doRetrieveDataBlock(STsdbReader* pReader, SArray* pIdList) {
   SReaderStatus*      pStatus = &pReader->status;
+  SBlockLoadSuppInfo* pSup = &pReader->suppInfo;
+  SPartialLoadInfo*   pLoad = &pStatus->partialLoad;
   int32_t             code = TSDB_CODE_SUCCESS;
   SFileDataBlockInfo* pBlockInfo = getCurrentBlockInfo(&pStatus->blockIter);
 
@@ -5007,13 +5475,59 @@ static SSDataBlock* doRetrieveDataBlock(STsdbReader* pReader) {
     return NULL;
   }
 
-  code = doLoadFileBlockData(pReader, &pStatus->blockIter, &pStatus->fileBlockData, pBlockScanInfo->uid);
+  int16_t* cids = &pSup->colId[1];
+  int32_t  numOfCids = pSup->numOfCols - 1;
+
+  pLoad->pending = false;
+  if (pIdList != NULL) {
+    code = splitLoadColumns(pReader, pIdList);
+    if (code != TSDB_CODE_SUCCESS) {
+      terrno = code;
+      return NULL;
+    }
+
+    // only the blocks that can be dumped into the result block at once are loaded in two phases, since the remained
+    // rows of a partially dumped block are merged from the fileBlockData directly.
+    if (pLoad->numOfRemainCols > 0 && pBlockInfo->numRow <= pReader->resBlockInfo.capacity) {
+      cids = pLoad->loadColId;
+      numOfCids = pLoad->numOfLoadCols;
+    }
+  }
+
+  code = doLoadFileBlockData(pReader, &pStatus->blockIter, &pStatus->fileBlockData, pBlockScanInfo->uid, cids,
+                             numOfCids);
   if (code != TSDB_CODE_SUCCESS) {
     tBlockDataReset(&pStatus->fileBlockData);
     terrno = code;
     return NULL;
   }
 
+  bool filteredOut = false;
+  code = fileBlockFilteredOutByDict(pReader, &filteredOut);
+  if (code != TSDB_CODE_SUCCESS) {
+    tBlockDataReset(&pStatus->fileBlockData);
+    terrno = code;
+    return NULL;
+  }
+
+  if (filteredOut) {
+    SSDataBlock*   pResBlock = pReader->resBlockInfo.pResBlock;
+    SDataBlockInfo info = {.window = {.skey = pBlockInfo->firstKey, .ekey = pBlockInfo->lastKey}};
+    bool           asc = ASCENDING_TRAVERSE(pReader->info.order);
+
+    resetZeroCopyColumns(pReader);
+    pResBlock->info.rows = 0;
+    setBlockAllDumped(&pStatus->fBlockDumpInfo, pBlockInfo->lastKey, pReader->info.order);
+    updateLastKeyInfo(&pBlockScanInfo->lastProcKey, pBlockInfo, &info, pReader->suppInfo.numOfPks, asc);
+    pReader->cost.dictFilterOutBlocks += 1;
+
+    tsdbDebug("%p uid:%" PRIu64 " file block filtered out by dictionary, rows:%d, brange:%" PRId64 "-%" PRId64 ", %s",
+              pReader, pBlockInfo->uid, pBlockInfo->numRow, pBlockInfo->firstKey, pBlockInfo->lastKey,
+              pReader->idStr);
+    return pResBlock;
+  }
+
+  pLoad->rows = 0;
   code = copyBlockDataToSDataBlock(pReader, &pBlockScanInfo->lastProcKey);
   if (code != TSDB_CODE_SUCCESS) {
     tBlockDataReset(&pStatus->fileBlockData);
@@ -5021,9 +5535,129 @@ static SSDataBlock* doRetrieveDataBlock(STsdbReader* pReader) {
     return NULL;
   }
 
+  if (cids == pLoad->loadColId && !pStatus->fBlockDumpInfo.allDumped) {
+    // not expected to happen, load all columns and dump the same rows again
+    tsdbDebug("%p block not all dumped, load all columns instead, uid:%" PRIu64 " %s", pReader, pBlockInfo->uid,
+              pReader->idStr);
+    pStatus->fBlockDumpInfo.rowIndex = pLoad->rowIndex;
+    pLoad->numOfRemainCols = 0;
+
+    code = doLoadFileBlockData(pReader, &pStatus->blockIter, &pStatus->fileBlockData, pBlockScanInfo->uid,
+                               &pSup->colId[1], pSup->numOfCols - 1);
+    if (code == TSDB_CODE_SUCCESS) {
+      code = copyBlockDataToSDataBlock(pReader, &pBlockScanInfo->lastProcKey);
+    }
+
+    if (code != TSDB_CODE_SUCCESS) {
+      tBlockDataReset(&pStatus->fileBlockData);
+      terrno = code;
+      return NULL;
+    }
+  }
+
+  // the remained columns are filled with NULL so far
+  pLoad->pending = (cids == pLoad->loadColId && pLoad->numOfRemainCols > 0);
   return pReader->resBlockInfo.pResBlock;
 }
 
+static int32_t doRetrieveRemainCols(STsdbReader* pReader) {
+  SReaderStatus*      pStatus = &pReader->status;
+  SBlockLoadSuppInfo* pSup = &pReader->suppInfo;
+  SPartialLoadInfo*   pLoad = &pStatus->partialLoad;
+  SBlockData*         pBlockData = &pStatus->remainBlockData;
+  SSDataBlock*        pResBlock = pReader->resBlockInfo.pResBlock;
+  SFileDataBlockInfo* pBlockInfo = getCurrentBlockInfo(&pStatus->blockIter);
+  bool                asc = ASCENDING_TRAVERSE(pReader->info.order);
+  int64_t             st = taosGetTimestampUs();
+  int32_t             code = TSDB_CODE_SUCCESS;
+
+  STSchema* pSchema = pReader->info.pSchema;
+  if (pSchema == NULL) {
+    pSchema = getTableSchemaImpl(pReader, pBlockInfo->uid);
+    if (pSchema == NULL) {
+      return code;
+    }
+  }
+
+  SBrinRecord record;
+  blockInfoToRecord(&record, pBlockInfo, pSup);
+
+  tBlockDataReset(pBlockData);
+  code = tsdbDataFileReadBlockDataByColumn(pReader->pFileReader, &record, pBlockData, pSchema, pLoad->remainColId,
+                                           pLoad->numOfRemainCols);
+  if (code != TSDB_CODE_SUCCESS) {
+    tsdbError("%p failed to load remained columns of file block, uid:%" PRIu64 ", code:%s %s", pReader,
+              pBlockInfo->uid, tstrerror(code), pReader->idStr);
+    return code;
+  }
+
+  SFileBlockDumpInfo dumpInfo = {.rowIndex = pLoad->rowIndex};
+
+  int32_t colIndex = 0;
+  int32_t num = pBlockData->nColData;
+  for (int32_t i = 1, j = 0; i < pSup->numOfCols && j < pLoad->numOfRemainCols; ++i) {
+    if (pSup->colId[i] != pLoad->remainColId[j]) {
+      continue;
+    }
+
+    j += 1;
+    while (colIndex < num && tBlockDataGetColDataByIdx(pBlockData, colIndex)->cid < pSup->colId[i]) {
+      colIndex += 1;
+    }
+
+    // the column does not exist in file block, it has been filled with null value already
+    SColData* pData = (colIndex < num) ? tBlockDataGetColDataByIdx(pBlockData, colIndex) : NULL;
+    if (pData == NULL || pData->cid != pSup->colId[i]) {
+      continue;
+    }
+
+    // the column has been filled with null value in the first phase, copyNumericCols only sets the null bits of the
+    // rows, so clear them first.
+    SColumnInfoData* pColData = taosArrayGet(pResBlock->pDataBlock, pSup->slotId[i]);
+    if (!IS_VAR_DATA_TYPE(pColData->info.type)) {
+      memset(pColData->nullbitmap, 0, BitmapLen(pLoad->rows));
+    }
+    pColData->hasNull = false;
+
+    code = copyColDataToSDataBlock(pData, &dumpInfo, pColData, pLoad->rows, i, pSup, asc);
+    if (code != TSDB_CODE_SUCCESS) {
+      return code;
+    }
+  }
+
+  pReader->cost.blockLoadTime += (taosGetTimestampUs() - st) / 1000.0;
+  return code;
+}
+
+int32_t tsdbRetrieveRemainCols2(STsdbReader* pReader, bool load) {
+  STsdbReader* pTReader = pReader;
+  if (pReader->type == TIMEWINDOW_RANGE_EXTERNAL) {
+    if (pReader->step == EXTERNAL_ROWS_PREV) {
+      pTReader = pReader->innerReader[0];
+    } else if (pReader->step == EXTERNAL_ROWS_NEXT) {
+      pTReader = pReader->innerReader[1];
+    }
+  }
+
+  int32_t           code = TSDB_CODE_SUCCESS;
+  SPartialLoadInfo* pLoad = &pTReader->status.partialLoad;
+  if (!pLoad->pending) {
+    return code;
+  }
+
+  pLoad->pending = false;
+  if (load && pLoad->rows > 0) {
+    code = doRetrieveRemainCols(pTReader);
+    pTReader->cost.lateLoadBlocks += 1;
+  } else {
+    pTReader->cost.lateSkipBlocks += 1;
+  }
+
+  qTrace("tsdb/read-retrieve-remain: %p, unlock read mutex", pReader);
+  tsdbReleaseReader(pReader);
+  return code;
+}
+
 SSDataBlock* tsdbRetrieveDataBlock2(STsdbReader* pReader, SArray* pIdList) {
   STsdbReader* pTReader = pReader;
   if (pReader->type == TIMEWINDOW_RANGE_EXTERNAL) {
@@ -5042,7 +5676,11 @@ SSDataBlock* tsdbRetrieveDataBlock2(STsdbReader* pReader, SArray* pIdList) {
     return pTReader->resBlockInfo.pResBlock;
   }
 
-  SSDataBlock* ret = doRetrieveDataBlock(pTReader);
+  SSDataBlock* ret = doRetrieveDataBlock(pTReader, pIdList);
+  if (ret != NULL && pStatus->partialLoad.pending) {
+    // the read mutex is kept until the remained columns are retrieved, see tsdbRetrieveRemainCols2
+    return ret;
+  }
 
   qTrace("tsdb/read-retrieve: %p, unlock read mutex", pReader);
   tsdbReleaseReader(pReader);
@@ -5076,6 +5714,8 @@ int32_t tsdbReaderReset2(STsdbReader* pReader, SQueryTableDataCond* pCond) {
   SReaderStatus*  pStatus = &pReader->status;
   SDataBlockIter* pBlockIter = &pStatus->blockIter;
 
+  resetZeroCopyColumns(pReader);
+
   pReader->info.order = pCond->order;
   pReader->type = TIMEWINDOW_RANGE_CONTAINED;
   pReader->info.window = updateQueryTimeWindow(pReader->pTsdb, &pCond->twindows);
@@ -5476,3 +6116,33 @@ void tsdbReaderSetNotifyCb(STsdbReader* pReader, TsdReaderNotifyCbFn notifyFn, v
   pReader->notifyFn = notifyFn;
   pReader->notifyParam = param;
 }
+
+void tsdbReaderSetFilterInfo(STsdbReader* pReader, SFilterInfo* pFilterInfo) {
+  pReader->pFilterInfo = filterHasColRange(pFilterInfo) ? pFilterInfo : NULL;
+  pReader->pDictFilterInfo = filterGetDictColId(pFilterInfo, &pReader->dictFilterColId) ? pFilterInfo : NULL;
+}
+
+// The result block must not be resized, compacted in place (e.g. by a filter) or destroyed while the reader is alive,
+// since its columns may refer to the file block data until the next block is requested.
+int32_t tsdbReaderSetZeroCopy(STsdbReader* pReader, bool zeroCopy) {
+  SResultBlockInfo* pResBlockInfo = &pReader->resBlockInfo;
+
+  // the result block is shared with the inner readers for the external rows
+  if (pReader->type == TIMEWINDOW_RANGE_EXTERNAL) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  if (zeroCopy && pResBlockInfo->pOrigData == NULL) {
+    pResBlockInfo->pOrigData = taosMemoryCalloc(pReader->suppInfo.numOfCols, POINTER_BYTES);
+    if (pResBlockInfo->pOrigData == NULL) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+  }
+
+  if (!zeroCopy) {
+    resetZeroCopyColumns(pReader);
+  }
+
+  pResBlockInfo->zeroCopy = zeroCopy;
+  return TSDB_CODE_SUCCESS;
+}
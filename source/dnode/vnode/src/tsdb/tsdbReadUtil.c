@@ -504,6 +504,7 @@ static void freePkItem(void* pItem) {
 void clearDataBlockIterator(SDataBlockIter* pIter, bool needFree) {
   pIter->index = -1;
   pIter->numOfBlocks = 0;
+  pIter->numOfPrefetched = 0;
 
   if (needFree) {
     taosArrayClearEx(pIter->blockList, freePkItem);
@@ -515,6 +516,7 @@ void clearDataBlockIterator(SDataBlockIter* pIter, bool needFree) {
 void cleanupDataBlockIterator(SDataBlockIter* pIter, bool needFree) {
   pIter->index = -1;
   pIter->numOfBlocks = 0;
+  pIter->numOfPrefetched = 0;
   if (needFree) {
     taosArrayDestroyEx(pIter->blockList, freePkItem);
   } else {
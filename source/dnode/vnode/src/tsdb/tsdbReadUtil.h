@@ -135,11 +135,20 @@ typedef struct SResultBlockInfo {
   SSDataBlock* pResBlock;
   bool         freeBlock;
   int64_t      capacity;
+  bool         zeroCopy;   // columns of a clean block refer to the buffer of the file block data instead of a copy
+  char**       pOrigData;  // own buffers of the result block columns that refer to the file block data, by load index
 } SResultBlockInfo;
 
 typedef struct SReadCostSummary {
   int64_t numOfBlocks;
   double  blockLoadTime;
+  int64_t prefetchBlocks;
+  double  prefetchTime;
+  int64_t smaFilterOutBlocks;  // blocks skipped since the column SMA does not satisfy the filter
+  int64_t dictFilterOutBlocks;  // blocks skipped since no dictionary entry of the column satisfies the filter
+  int64_t lateLoadBlocks;  // blocks whose non-filter columns are loaded after the filter columns
+  int64_t lateSkipBlocks;  // blocks whose non-filter columns are skipped, since no row survives the filter
+  int64_t zeroCopyBlocks;  // blocks handed to the result block without copying the column data
   double  buildmemBlock;
   int64_t headFileLoad;
   double  headFileLoadTime;
@@ -147,6 +156,7 @@ typedef struct SReadCostSummary {
   double  smaLoadTime;
   SSttBlockLoadCostInfo sttCost;
   int64_t composedBlocks;
+  int64_t composedRunRows;  // rows of composed blocks copied as runs of non-overlapping keys
   double  buildComposedBlockTime;
   double  createScanInfoList;
   double  createSkylineIterTime;
@@ -239,6 +249,7 @@ typedef struct SFileDataBlockInfo {
 typedef struct SDataBlockIter {
   int32_t    numOfBlocks;
   int32_t    index;
+  int32_t    numOfPrefetched;  // blocks in access order whose data have been prefetched
   SArray*    blockList;  // SArray<SFileDataBlockInfo>
   int32_t    order;
   SDataBlk   block;  // current SDataBlk data
@@ -251,6 +262,16 @@ typedef struct SFileBlockDumpInfo {
   bool    allDumped;
 } SFileBlockDumpInfo;
 
+typedef struct SPartialLoadInfo {
+  bool     pending;  // only part of the columns of the current block are retrieved, the others are to be loaded
+  int32_t  rowIndex;  // first row of the file block dumped into the result block
+  int32_t  rows;      // number of rows dumped into the result block
+  int16_t* loadColId;
+  int32_t  numOfLoadCols;
+  int16_t* remainColId;
+  int32_t  numOfRemainCols;
+} SPartialLoadInfo;
+
 typedef struct SReaderStatus {
   bool                  suspendInvoked;
   bool                  loadFromFile;       // check file stage
@@ -261,6 +282,8 @@ typedef struct SReaderStatus {
   SFileBlockDumpInfo    fBlockDumpInfo;
   STFileSet*            pCurrentFileset;  // current opened file set
   SBlockData            fileBlockData;
+  SBlockData            remainBlockData;  // the remained columns of a partially retrieved file block
+  SPartialLoadInfo      partialLoad;
   SFilesetIter          fileIter;
   SDataBlockIter        blockIter;
   SArray*               pLDataIterArray;
@@ -302,6 +325,10 @@ struct STsdbReader {
   bool                 bFilesetDelimited;   // duration by duration output
   TsdReaderNotifyCbFn  notifyFn;
   void*                notifyParam;
+  SFilterInfo*         pFilterInfo;  // not owned, used to skip file blocks by column SMA
+  SFilterInfo*         pDictFilterInfo;  // not owned, used to skip file blocks by the dictionary of a column
+  int16_t              dictFilterColId;  // the only column referred by pDictFilterInfo
+  SColDataDict         dict;             // the dictionary codes of dictFilterColId in the loaded file block
 };
 
 typedef struct SBrinRecordIter {
@@ -363,6 +390,11 @@ void resetDataBlockIterator(SDataBlockIter* pIter, int32_t order, bool hasPk);
 void clearDataBlockIterator(SDataBlockIter* pIter, bool needFree);
 void cleanupDataBlockIterator(SDataBlockIter* pIter, bool hasPk);
 
+int32_t getFileBlockRunLength(STsdbReader* pReader, STableBlockScanInfo* pBlockScanInfo, SBlockData* pBlockData,
+                              int32_t start, int32_t remain, bool hasBound, int64_t bound);
+int32_t doAppendRowsFromFileBlock(SSDataBlock* pResBlock, STsdbReader* pReader, SBlockData* pBlockData, int32_t rowIndex,
+                                  int32_t numOfRows, bool asc);
+
 typedef struct {
   SArray* pTombData;
 } STableLoadInfo;
@@ -400,6 +432,13 @@ typedef struct SCacheRowsReader {
 } SCacheRowsReader;
 
 int32_t tsdbCacheGetBatch(STsdb* pTsdb, tb_uid_t uid, SArray* pLastArray, SCacheRowsReader* pr, int8_t ltype);
+int32_t tsdbCacheGetTablesBatch(STsdb* pTsdb, const STableKeyInfo* pTables, int32_t numOfTables, SArray** pLastArrays,
+                                SCacheRowsReader* pr, int8_t ltype);
+int32_t tsdbCacherowsReaderLoad(void* pReader);
+
+typedef int32_t (*FTsdbCacheLoadRaw)(STsdb* pTsdb, tb_uid_t uid, SArray* pLastArray, SArray* remainCols,
+                                     SCacheRowsReader* pr, int8_t ltype);
+FTsdbCacheLoadRaw tsdbCacheSetLoadRaw(FTsdbCacheLoadRaw fp);
 
 #ifdef __cplusplus
 }
@@ -151,6 +151,7 @@ int32_t tsdbOpenFile(const char *path, STsdb *pTsdb, int32_t flag, STsdbFD **ppF
   pFD->pgno = 0;
   pFD->lcn = lcn;
   pFD->pTsdb = pTsdb;
+  pFD->ioDisk = vnodeIoGetDisk(pTsdb->pVnode->pTfs, path);
 
   *ppFD = pFD;
 
@@ -221,6 +222,7 @@ static int32_t tsdbWriteFilePage(STsdbFD *pFD, int32_t encryptAlgorithm, char *e
       // tsdbDebug("CBC_Encrypt count:%d %s", count, __FUNCTION__);
     }
 
+    vnodeIoAcquire(pFD->pTsdb->pVnode, pFD->ioDisk, pFD->szPage);
     n = taosWriteFile(pFD->pFD, pFD->pBuf, pFD->szPage);
     if (n < 0) {
       code = TAOS_SYSTEM_ERROR(errno);
@@ -287,6 +289,7 @@ static int32_t tsdbReadFilePage(STsdbFD *pFD, int64_t pgno, int32_t encryptAlgor
   }
 
   // read
+  vnodeIoAcquire(pFD->pTsdb->pVnode, pFD->ioDisk, pFD->szPage);
   n = taosReadFile(pFD->pFD, pFD->pBuf, pFD->szPage);
   if (n < 0) {
     code = TAOS_SYSTEM_ERROR(errno);
@@ -395,6 +398,19 @@ _exit:
   return code;
 }
 
+static int32_t tsdbGetS3ObjectPrefix(STsdbFD *pFD, char *object_name_prefix, char **ppDot) {
+  char   *object_name = taosDirEntryBaseName(pFD->path);
+  int32_t node_id = vnodeNodeId(pFD->pTsdb->pVnode);
+  snprintf(object_name_prefix, TSDB_FQDN_LEN, "%d/%s", node_id, object_name);
+
+  *ppDot = strrchr(object_name_prefix, '.');
+  if (!*ppDot) {
+    tsdbError("unexpected path: %s", object_name_prefix);
+    return TAOS_SYSTEM_ERROR(ENOENT);
+  }
+  return 0;
+}
+
 static int32_t tsdbReadFileBlock(STsdbFD *pFD, int64_t offset, int64_t size, bool check, uint8_t **ppBlock) {
   int32_t    code = 0;
   SVnodeCfg *pCfg = &pFD->pTsdb->pVnode->config;
@@ -402,15 +418,10 @@ static int32_t tsdbReadFileBlock(STsdbFD *pFD, int64_t offset, int64_t size, boo
   int64_t    cOffset = offset % chunksize;
   int64_t    n = 0;
 
-  char   *object_name = taosDirEntryBaseName(pFD->path);
-  char    object_name_prefix[TSDB_FILENAME_LEN];
-  int32_t node_id = vnodeNodeId(pFD->pTsdb->pVnode);
-  snprintf(object_name_prefix, TSDB_FQDN_LEN, "%d/%s", node_id, object_name);
-
-  char *dot = strrchr(object_name_prefix, '.');
-  if (!dot) {
-    tsdbError("unexpected path: %s", object_name_prefix);
-    code = TAOS_SYSTEM_ERROR(ENOENT);
+  char  object_name_prefix[TSDB_FILENAME_LEN];
+  char *dot = NULL;
+  code = tsdbGetS3ObjectPrefix(pFD, object_name_prefix, &dot);
+  if (code) {
     goto _exit;
   }
 
@@ -428,6 +439,7 @@ static int32_t tsdbReadFileBlock(STsdbFD *pFD, int64_t offset, int64_t size, boo
         goto _exit;
       }
 
+      vnodeIoAcquire(pFD->pTsdb->pVnode, pFD->ioDisk, nRead);
       ret = taosReadFile(pFD->pFD, buf + n, nRead);
       if (ret < 0) {
         code = TAOS_SYSTEM_ERROR(errno);
@@ -443,7 +455,7 @@ static int32_t tsdbReadFileBlock(STsdbFD *pFD, int64_t offset, int64_t size, boo
 
       snprintf(dot + 1, TSDB_FQDN_LEN - (dot + 1 - object_name_prefix), "%d.data", chunkno);
 
-      code = s3GetObjectBlock(object_name_prefix, cOffset, nRead, check, &pBlock);
+      code = vnodeS3CacheGet(object_name_prefix, chunksize, cOffset, nRead, check, &pBlock);
       if (code != TSDB_CODE_SUCCESS) {
         taosMemoryFree(buf);
         goto _exit;
@@ -591,6 +603,57 @@ _exit:
   return code;
 }
 
+static int32_t tsdbPrefetchFileS3(STsdbFD *pFD, int64_t offset, int64_t size) {
+  SVnodeCfg *pCfg = &pFD->pTsdb->pVnode->config;
+  int64_t    chunksize = (int64_t)pCfg->tsdbPageSize * pCfg->s3ChunkSize;
+  int64_t    cOffset = offset % chunksize;
+  char       object_name_prefix[TSDB_FILENAME_LEN];
+  char      *dot = NULL;
+
+  int32_t code = tsdbGetS3ObjectPrefix(pFD, object_name_prefix, &dot);
+  if (code) return code;
+
+  // the last chunk is local
+  for (int64_t chunkno = offset / chunksize + 1, n = 0; n < size && chunkno < pFD->lcn; ++chunkno) {
+    int64_t nRead = TMIN(chunksize - cOffset, size - n);
+
+    snprintf(dot + 1, TSDB_FQDN_LEN - (dot + 1 - object_name_prefix), "%" PRId64 ".data", chunkno);
+    vnodeS3CachePrefetch(object_name_prefix, chunksize, cOffset, nRead);
+
+    n += nRead;
+    cOffset = 0;
+  }
+  return 0;
+}
+
+int32_t tsdbPrefetchFile(STsdbFD *pFD, int64_t offset, int64_t size) {
+  int32_t code = 0;
+
+  if (size <= 0) return code;
+  if (!pFD->pFD) {
+    code = tsdbOpenFileImpl(pFD);
+    if (code) return code;
+  }
+
+  int64_t pgnoStart = OFFSET_PGNO(LOGIC_TO_FILE_OFFSET(offset, pFD->szPage), pFD->szPage);
+  int64_t pgnoEnd = OFFSET_PGNO(LOGIC_TO_FILE_OFFSET(offset + size - 1, pFD->szPage), pFD->szPage);
+  int64_t fOffset = PAGE_OFFSET(pgnoStart, pFD->szPage);
+
+  // pages on s3 are read ahead into the s3 cache in background
+  if (pFD->s3File) return tsdbPrefetchFileS3(pFD, fOffset, (pgnoEnd - pgnoStart + 1) * pFD->szPage);
+  if (pFD->lcn > 1) {
+    SVnodeCfg *pCfg = &pFD->pTsdb->pVnode->config;
+    int64_t    chunksize = (int64_t)pCfg->tsdbPageSize * pCfg->s3ChunkSize;
+
+    fOffset -= chunksize * (pFD->lcn - 1);
+  }
+
+  if (taosPrefetchFile(pFD->pFD, fOffset, (pgnoEnd - pgnoStart + 1) * pFD->szPage) < 0) {
+    code = TAOS_SYSTEM_ERROR(errno);
+  }
+  return code;
+}
+
 int32_t tsdbReadFileToBuffer(STsdbFD *pFD, int64_t offset, int64_t size, SBuffer *buffer, int64_t szHint,
                              int32_t encryptAlgorithm, char *encryptKey) {
   int32_t code;
@@ -38,22 +38,34 @@ static int32_t tsdbDoRemoveFileObject(SRTNer *rtner, const STFileObj *fobj) {
   return TARRAY2_APPEND(&rtner->fopArr, op);
 }
 
-static int64_t tsdbCopyFileWithLimitedSpeed(TdFilePtr from, TdFilePtr to, int64_t size, uint32_t limitMB) {
+#define TSDB_COPY_CHUNK_SIZE (4 * 1024 * 1024)
+
+// copy in chunks drawn from the vnode I/O scheduler, at most limitMB per second
+static int64_t tsdbCopyFileWithLimitedSpeed(SRTNer *rtner, TdFilePtr from, int32_t fromDisk, TdFilePtr to,
+                                            int32_t toDisk, int64_t offset, int64_t size, uint32_t limitMB) {
   int64_t total = 0;
   int64_t interval = 1000;  // 1s
   int64_t limit = limitMB ? limitMB * 1024 * 1024 : INT64_MAX;
-  int64_t offset = 0;
   int64_t remain = size;
 
   while (remain > 0) {
     int64_t n;
     int64_t last = taosGetTimestampMs();
-    if ((n = taosFSendFile(to, from, &offset, TMIN(limit, remain))) < 0) {
-      return -1;
-    }
+    for (int64_t quota = TMIN(limit, remain); quota > 0 && remain > 0;) {
+      int64_t chunk = TMIN(quota, TSDB_COPY_CHUNK_SIZE);
+      vnodeIoAcquire(rtner->tsdb->pVnode, fromDisk, chunk);
+      if (toDisk != fromDisk) {
+        vnodeIoAcquire(rtner->tsdb->pVnode, toDisk, chunk);
+      }
 
-    total += n;
-    remain -= n;
+      if ((n = taosFSendFile(to, from, &offset, chunk)) < 0) {
+        return -1;
+      }
+
+      total += n;
+      remain -= n;
+      quota -= chunk;
+    }
 
     if (remain > 0) {
       int64_t elapsed = taosGetTimestampMs() - last;
@@ -89,7 +101,8 @@ static int32_t tsdbDoCopyFileLC(SRTNer *rtner, const STFileObj *from, const STFi
   SVnodeCfg *pCfg = &rtner->tsdb->pVnode->config;
   int64_t    chunksize = (int64_t)pCfg->tsdbPageSize * pCfg->s3ChunkSize;
   int64_t    lc_size = tsdbLogicToFileSize(to->size, rtner->szPage) - chunksize * (to->lcn - 1);
-  int64_t    n = taosFSendFile(fdTo, fdFrom, 0, lc_size);
+  int64_t    n = tsdbCopyFileWithLimitedSpeed(rtner, fdFrom, VNODE_IO_DISK(from->f->did), fdTo, VNODE_IO_DISK(to->did), 0,
+                                              lc_size, tsRetentionSpeedLimitMB);
   if (n < 0) {
     code = TAOS_SYSTEM_ERROR(errno);
     TSDB_CHECK_CODE(code, lino, _exit);
@@ -126,8 +139,8 @@ static int32_t tsdbDoCopyFile(SRTNer *rtner, const STFileObj *from, const STFile
   if (fdTo == NULL) code = terrno;
   TSDB_CHECK_CODE(code, lino, _exit);
 
-  int64_t n = tsdbCopyFileWithLimitedSpeed(fdFrom, fdTo, tsdbLogicToFileSize(from->f->size, rtner->szPage),
-                                           tsRetentionSpeedLimitMB);
+  int64_t n = tsdbCopyFileWithLimitedSpeed(rtner, fdFrom, VNODE_IO_DISK(from->f->did), fdTo, VNODE_IO_DISK(to->did), 0,
+                                           tsdbLogicToFileSize(from->f->size, rtner->szPage), tsRetentionSpeedLimitMB);
   if (n < 0) {
     code = TAOS_SYSTEM_ERROR(errno);
     TSDB_CHECK_CODE(code, lino, _exit);
@@ -319,6 +332,7 @@ static int32_t tsdbRetention(void *arg) {
   STsdb     *pTsdb = rtnArg->tsdb;
   SVnode    *pVnode = pTsdb->pVnode;
   STFileSet *fset = NULL;
+  EVIoClass  ioClass = vnodeIoSetClass(EVIO_CLASS_RETENTION);
   SRTNer     rtner = {
           .tsdb = pTsdb,
           .szPage = pVnode->config.tsdbPageSize,
@@ -363,6 +377,7 @@ _exit:
   if (code) {
     tsdbError("vgId:%d, %s failed, code:%d, line:%d", TD_VID(pTsdb->pVnode), __func__, code, lino);
   }
+  vnodeIoSetClass(ioClass);
   return code;
 }
 
@@ -450,6 +465,7 @@ static int32_t tsdbCopyFileS3(SRTNer *rtner, const STFileObj *from, const STFile
   TSDB_CHECK_CODE(code, lino, _exit);
 
   char *object_name = taosDirEntryBaseName(fname);
+  vnodeIoAcquire(rtner->tsdb->pVnode, VNODE_IO_DISK(from->f->did), tsdbLogicToFileSize(from->f->size, rtner->szPage));
   code = s3PutObjectFromFile2(from->fname, object_name, 1);
   TSDB_CHECK_CODE(code, lino, _exit);
 
@@ -529,6 +545,7 @@ static int32_t tsdbMigrateDataFileLCS3(SRTNer *rtner, const STFileObj *fobj, int
     snprintf(dot + 1, TSDB_FQDN_LEN - (dot + 1 - object_name_prefix), "%d.data", cn);
     int64_t c_offset = chunksize * (cn - fobj->f->lcn);
 
+    vnodeIoAcquire(rtner->tsdb->pVnode, VNODE_IO_DISK(fobj->f->did), chunksize);
     code = s3PutObjectFromFileOffset(fname, object_name_prefix, c_offset, chunksize);
     TSDB_CHECK_CODE(code, lino, _exit);
   }
@@ -550,7 +567,8 @@ static int32_t tsdbMigrateDataFileLCS3(SRTNer *rtner, const STFileObj *fobj, int
   if (fdTo == NULL) code = terrno;
   TSDB_CHECK_CODE(code, lino, _exit);
 
-  int64_t n = taosFSendFile(fdTo, fdFrom, &lc_offset, lc_size);
+  int64_t n = tsdbCopyFileWithLimitedSpeed(rtner, fdFrom, VNODE_IO_DISK(fobj->f->did), fdTo, VNODE_IO_DISK(fobj->f->did),
+                                           lc_offset, lc_size, tsRetentionSpeedLimitMB);
   if (n < 0) {
     code = TAOS_SYSTEM_ERROR(errno);
     TSDB_CHECK_CODE(code, lino, _exit);
@@ -626,6 +644,7 @@ static int32_t tsdbMigrateDataFileS3(SRTNer *rtner, const STFileObj *fobj, int64
     snprintf(dot + 1, TSDB_FQDN_LEN - (dot + 1 - object_name_prefix), "%d.data", cn);
     int64_t c_offset = chunksize * (cn - 1);
 
+    vnodeIoAcquire(rtner->tsdb->pVnode, VNODE_IO_DISK(fobj->f->did), chunksize);
     code = s3PutObjectFromFileOffset(fobj->fname, object_name_prefix, c_offset, chunksize);
     TSDB_CHECK_CODE(code, lino, _exit);
   }
@@ -651,7 +670,8 @@ static int32_t tsdbMigrateDataFileS3(SRTNer *rtner, const STFileObj *fobj, int64
   if (fdTo == NULL) code = terrno;
   TSDB_CHECK_CODE(code, lino, _exit);
 
-  int64_t n = taosFSendFile(fdTo, fdFrom, &lc_offset, lc_size);
+  int64_t n = tsdbCopyFileWithLimitedSpeed(rtner, fdFrom, VNODE_IO_DISK(fobj->f->did), fdTo, VNODE_IO_DISK(fobj->f->did),
+                                           lc_offset, lc_size, tsRetentionSpeedLimitMB);
   if (n < 0) {
     code = TAOS_SYSTEM_ERROR(errno);
     TSDB_CHECK_CODE(code, lino, _exit);
@@ -1701,6 +1701,11 @@ _exit:
 
 int32_t tBlockDataDecompressColData(const SDiskDataHdr *hdr, const SBlockCol *blockCol, SBufferReader *br,
                                     SBlockData *blockData, SBuffer *assist) {
+  return tBlockDataDecompressColDataDict(hdr, blockCol, br, blockData, NULL, assist);
+}
+
+int32_t tBlockDataDecompressColDataDict(const SDiskDataHdr *hdr, const SBlockCol *blockCol, SBufferReader *br,
+                                        SBlockData *blockData, SColDataDict *pDict, SBuffer *assist) {
   int32_t code = 0;
   int32_t lino = 0;
 
@@ -1737,7 +1742,7 @@ int32_t tBlockDataDecompressColData(const SDiskDataHdr *hdr, const SBlockCol *bl
       break;
   }
 
-  code = tColDataDecompress(BR_PTR(br), &info, colData, assist);
+  code = tColDataDecompressWithDict(BR_PTR(br), &info, colData, pDict, assist);
   TSDB_CHECK_CODE(code, lino, _exit);
   br->offset += blockCol->szBitmap + blockCol->szOffset + blockCol->szValue;
 
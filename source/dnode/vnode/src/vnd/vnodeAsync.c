@@ -94,6 +94,7 @@ struct SVAChannel {
 // async handle
 struct SVAsync {
   const char *label;
+  EVIoClass   ioClass;  // I/O class of the tasks run by the workers
 
   TdThreadMutex mutex;
   TdThreadCond  hasTask;
@@ -118,7 +119,7 @@ struct SVAsync {
   SVHashTable *taskTable;
 };
 
-SVAsync *vnodeAsyncs[3];
+SVAsync *vnodeAsyncs[6];
 #define MIN_ASYNC_ID 1
 #define MAX_ASYNC_ID (sizeof(vnodeAsyncs) / sizeof(vnodeAsyncs[0]) - 1)
 
@@ -268,6 +269,7 @@ static void *vnodeAsyncLoop(void *arg) {
     taosThreadMutexUnlock(&async->mutex);
 
     // do run the task
+    vnodeIoSetClass(async->ioClass);
     worker->runningTask->execute(worker->runningTask->arg);
   }
 
@@ -458,13 +460,39 @@ int32_t vnodeAsyncOpen(int32_t numOfThreads) {
   // vnode-commit
   code = vnodeAsyncInit(&vnodeAsyncs[1], "vnode-commit");
   TSDB_CHECK_CODE(code, lino, _exit);
+  vnodeAsyncs[1]->ioClass = EVIO_CLASS_COMMIT;
   vnodeAsyncSetWorkers(1, numOfThreads);
 
   // vnode-merge
   code = vnodeAsyncInit(&vnodeAsyncs[2], "vnode-merge");
   TSDB_CHECK_CODE(code, lino, _exit);
+  vnodeAsyncs[2]->ioClass = EVIO_CLASS_MERGE;
   vnodeAsyncSetWorkers(2, numOfThreads);
 
+  // vnode-apply
+  if (tsNumOfApplyThreads > 0) {
+    code = vnodeAsyncInit(&vnodeAsyncs[3], "vnode-apply");
+    TSDB_CHECK_CODE(code, lino, _exit);
+    vnodeAsyncs[3]->ioClass = EVIO_CLASS_COMMIT;
+    vnodeAsyncSetWorkers(3, tsNumOfApplyThreads);
+  }
+
+  // vnode-commit-fset, the commit thread itself writes a file set too
+  if (tsCommitFileSetConcurrency > 1) {
+    code = vnodeAsyncInit(&vnodeAsyncs[4], "vnode-commit-fset");
+    TSDB_CHECK_CODE(code, lino, _exit);
+    vnodeAsyncs[4]->ioClass = EVIO_CLASS_COMMIT;
+    vnodeAsyncSetWorkers(4, TMIN(numOfThreads * (tsCommitFileSetConcurrency - 1), VNODE_ASYNC_MAX_WORKERS));
+  }
+
+  // vnode-replay
+  if (tsNumOfReplayThreads > 0) {
+    code = vnodeAsyncInit(&vnodeAsyncs[5], "vnode-replay");
+    TSDB_CHECK_CODE(code, lino, _exit);
+    vnodeAsyncs[5]->ioClass = EVIO_CLASS_COMMIT;
+    vnodeAsyncSetWorkers(5, tsNumOfReplayThreads);
+  }
+
 _exit:
   return 0;
 }
@@ -472,6 +500,9 @@ _exit:
 int32_t vnodeAsyncClose() {
   vnodeAsyncDestroy(&vnodeAsyncs[1]);
   vnodeAsyncDestroy(&vnodeAsyncs[2]);
+  if (vnodeAsyncs[3]) vnodeAsyncDestroy(&vnodeAsyncs[3]);
+  if (vnodeAsyncs[4]) vnodeAsyncDestroy(&vnodeAsyncs[4]);
+  if (vnodeAsyncs[5]) vnodeAsyncDestroy(&vnodeAsyncs[5]);
   return 0;
 }
 
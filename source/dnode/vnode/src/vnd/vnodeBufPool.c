@@ -16,15 +16,55 @@
 #include "vnd.h"
 
 /* ------------------------ STRUCTURES ------------------------ */
+static SVBufPool *vnodeBufPoolAlloc(SVnode *pVnode, int64_t size) {
+  SVBufPool *pPool = NULL;
+  int64_t    mapSize = 0;
+
+  if (tsBufPoolHugePage != TD_HUGE_PAGE_NONE || tsBufPoolNumaNode >= 0) {
+    pPool = taosMemoryMapHuge(sizeof(SVBufPool) + size, tsBufPoolHugePage, &mapSize);
+    if (pPool == NULL) {
+      vWarn("vgId:%d, failed to map buffer pool of size %" PRId64 " since %s, malloc it instead", TD_VID(pVnode), size,
+            strerror(errno));
+    }
+  }
+
+  // bind once before the pages are touched, so the writer never waits for the pages to migrate
+  if (pPool != NULL && tsBufPoolNumaNode >= 0) {
+    int32_t rc = taosMemoryBindNode(pPool, mapSize, tsBufPoolNumaNode);
+    if (rc) {
+      vWarn("vgId:%d, failed to bind buffer pool to numa node %d since %s", TD_VID(pVnode), tsBufPoolNumaNode,
+            strerror(rc));
+    } else {
+      vDebug("vgId:%d, buffer pool is bound to numa node %d", TD_VID(pVnode), tsBufPoolNumaNode);
+    }
+  }
+
+  if (pPool == NULL) {
+    pPool = taosMemoryMalloc(sizeof(SVBufPool) + size);
+    if (pPool == NULL) return NULL;
+  }
+
+  memset(pPool, 0, sizeof(SVBufPool));
+  pPool->mapSize = mapSize;
+  return pPool;
+}
+
+static void vnodeBufPoolFreeRegion(SVBufPool *pPool) {
+  if (pPool->mapSize) {
+    taosMemoryUnmap(pPool, pPool->mapSize);
+  } else {
+    taosMemoryFree(pPool);
+  }
+}
+
 static int vnodeBufPoolCreate(SVnode *pVnode, int32_t id, int64_t size, SVBufPool **ppPool) {
   SVBufPool *pPool;
 
-  pPool = taosMemoryMalloc(sizeof(SVBufPool) + size);
+  pPool = vnodeBufPoolAlloc(pVnode, size);
   if (pPool == NULL) {
     terrno = TSDB_CODE_OUT_OF_MEMORY;
     return -1;
   }
-  memset(pPool, 0, sizeof(SVBufPool));
 
   // query handle list
   taosThreadMutexInit(&pPool->mutex, NULL);
@@ -40,16 +80,16 @@ static int vnodeBufPoolCreate(SVnode *pVnode, int32_t id, int64_t size, SVBufPoo
   pPool->node.pnext = &pPool->pTail;
   pPool->node.size = size;
 
-  if (VND_IS_RSMA(pVnode)) {
+  if (VND_IS_RSMA(pVnode) || tsNumOfApplyThreads > 0) {
     pPool->lock = taosMemoryMalloc(sizeof(TdThreadSpinlock));
     if (!pPool->lock) {
-      taosMemoryFree(pPool);
+      vnodeBufPoolFreeRegion(pPool);
       terrno = TSDB_CODE_OUT_OF_MEMORY;
       return -1;
     }
     if (taosThreadSpinInit(pPool->lock, 0) != 0) {
       taosMemoryFree((void *)pPool->lock);
-      taosMemoryFree(pPool);
+      vnodeBufPoolFreeRegion(pPool);
       terrno = TAOS_SYSTEM_ERROR(errno);
       return -1;
     }
@@ -68,7 +108,7 @@ static int vnodeBufPoolDestroy(SVBufPool *pPool) {
     taosMemoryFree((void *)pPool->lock);
   }
   taosThreadMutexDestroy(&pPool->mutex);
-  taosMemoryFree(pPool);
+  vnodeBufPoolFreeRegion(pPool);
   return 0;
 }
 
@@ -93,6 +133,11 @@ int vnodeOpenBufPool(SVnode *pVnode) {
 }
 
 int vnodeCloseBufPool(SVnode *pVnode) {
+  SVBufPoolStat *pStat = &pVnode->poolStat;
+  vInfo("vgId:%d, buffer pool stat, reuse:%" PRId64 " overflow:%" PRId64 " max used:%" PRId64 " wait:%" PRId64
+        " wait time:%" PRId64 "ms",
+        TD_VID(pVnode), pStat->nReuse, pStat->nOverflow, pStat->maxUsed, pStat->nWait, pStat->waitTime);
+
   for (int32_t i = 0; i < VNODE_BUFPOOL_SEGMENTS; i++) {
     if (pVnode->aBufPool[i]) {
       vnodeBufPoolDestroy(pVnode->aBufPool[i]);
@@ -213,7 +258,13 @@ void vnodeBufPoolRef(SVBufPool *pPool) {
 }
 
 void vnodeBufPoolAddToFreeList(SVBufPool *pPool) {
-  SVnode *pVnode = pPool->pVnode;
+  SVnode        *pVnode = pPool->pVnode;
+  SVBufPoolStat *pStat = &pVnode->poolStat;
+
+  // statistics for sizing the buffer, a pool overflows if it has nodes malloced beyond its region
+  pStat->nReuse++;
+  if (pPool->pTail != &pPool->node) pStat->nOverflow++;
+  pStat->maxUsed = TMAX(pStat->maxUsed, pPool->size);
 
   int64_t size = pVnode->config.szBuf / VNODE_BUFPOOL_SEGMENTS;
   if (pPool->node.size != size) {
@@ -232,7 +283,9 @@ void vnodeBufPoolAddToFreeList(SVBufPool *pPool) {
   }
 
   // add to free list
-  vDebug("vgId:%d, buffer pool %p of id %d is added to free list", TD_VID(pVnode), pPool, pPool->id);
+  vDebug("vgId:%d, buffer pool %p of id %d is added to free list, reuse:%" PRId64 " overflow:%" PRId64
+         " max used:%" PRId64,
+         TD_VID(pVnode), pPool, pPool->id, pStat->nReuse, pStat->nOverflow, pStat->maxUsed);
   vnodeBufPoolReset(pPool);
   pPool->freeNext = pVnode->freeList;
   pVnode->freeList = pPool;
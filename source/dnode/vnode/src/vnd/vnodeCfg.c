@@ -95,6 +95,7 @@ int vnodeEncodeConfig(const void *pObj, SJson *pJson) {
   if (tjsonAddIntegerToObject(pJson, "szCache", pCfg->szCache) < 0) return -1;
   if (tjsonAddIntegerToObject(pJson, "cacheLast", pCfg->cacheLast) < 0) return -1;
   if (tjsonAddIntegerToObject(pJson, "cacheLastSize", pCfg->cacheLastSize) < 0) return -1;
+  if (tjsonAddIntegerToObject(pJson, "cacheBackend", pCfg->cacheBackend) < 0) return -1;
   if (tjsonAddIntegerToObject(pJson, "szBuf", pCfg->szBuf) < 0) return -1;
   if (tjsonAddIntegerToObject(pJson, "isHeap", pCfg->isHeap) < 0) return -1;
   if (tjsonAddIntegerToObject(pJson, "isWeak", pCfg->isWeak) < 0) return -1;
@@ -379,6 +380,10 @@ int vnodeDecodeConfig(const SJson *pJson, void *pObj) {
   if (code < 0) {
     pCfg->s3Compact = TSDB_DEFAULT_S3_COMPACT;
   }
+  tjsonGetNumberValue(pJson, "cacheBackend", pCfg->cacheBackend, code);
+  if (code < 0) {
+    pCfg->cacheBackend = TSDB_CACHE_BACKEND_ROCKSDB;
+  }
 
   return 0;
 }
@@ -68,6 +68,7 @@ static int32_t vnodeGetBufPoolToUse(SVnode *pVnode) {
   taosThreadMutexLock(&pVnode->mutex);
 
   int32_t nTry = 0;
+  int64_t waitStart = 0;
   for (;;) {
     ++nTry;
 
@@ -79,9 +80,15 @@ static int32_t vnodeGetBufPoolToUse(SVnode *pVnode) {
       pVnode->inUse->nRef = 1;
       pVnode->freeList = pVnode->inUse->freeNext;
       pVnode->inUse->freeNext = NULL;
+
+      if (waitStart) {
+        pVnode->poolStat.nWait++;
+        pVnode->poolStat.waitTime += taosGetTimestampMs() - waitStart;
+      }
       break;
     } else {
       vDebug("vgId:%d, no free buffer pool on %d try, try to recycle...", TD_VID(pVnode), nTry);
+      if (waitStart == 0) waitStart = taosGetTimestampMs();
 
       code = vnodeTryRecycleBufPool(pVnode);
       TSDB_CHECK_CODE(code, lino, _exit);
@@ -425,12 +432,35 @@ int vnodeSyncCommit(SVnode *pVnode) {
   return 0;
 }
 
+static const char *vnodeCommitPhaseStr[VND_COMMIT_PHASE_MAX] = {"wal",       "tsdb_build", "tsdb_write",
+                                                                  "tsdb_edit", "cache",      "finish"};
+
+static void vnodeReportCommitCost(SCommitInfo *pInfo) {
+  SVnode  *pVnode = pInfo->pVnode;
+  int64_t *cost = pInfo->cost;
+
+  vInfo("vgId:%d, commit cost, wal:%" PRId64 "us tsdb build:%" PRId64 "us tsdb write:%" PRId64
+        "us tsdb edit:%" PRId64 "us cache:%" PRId64 "us finish:%" PRId64 "us",
+        TD_VID(pVnode), cost[VND_COMMIT_PHASE_WAL], cost[VND_COMMIT_PHASE_TSDB_BUILD], cost[VND_COMMIT_PHASE_TSDB_WRITE],
+        cost[VND_COMMIT_PHASE_TSDB_EDIT], cost[VND_COMMIT_PHASE_CACHE], cost[VND_COMMIT_PHASE_FINISH]);
+
+  if (!tsEnableMonitor || pVnode->monitor.commitCounter == NULL) return;
+
+  for (int32_t phase = 0; phase < VND_COMMIT_PHASE_MAX; phase++) {
+    const char *sample_labels[] = {pVnode->monitor.strClusterId, pVnode->monitor.strDnodeId, tsLocalEp,
+                                   pVnode->monitor.strVgId, vnodeCommitPhaseStr[phase]};
+    taos_counter_add(pVnode->monitor.commitCounter, cost[phase] / 1000, sample_labels);
+  }
+}
+
 static int vnodeCommitImpl(SCommitInfo *pInfo) {
   int32_t code = 0;
   int32_t lino = 0;
 
   char    dir[TSDB_FILENAME_LEN] = {0};
   SVnode *pVnode = pInfo->pVnode;
+  int64_t st = taosGetTimestampUs();
+  int64_t et;
 
   vInfo("vgId:%d, start to commit, commitId:%" PRId64 " version:%" PRId64 " term: %" PRId64, TD_VID(pVnode),
         pInfo->info.state.commitID, pInfo->info.state.committed, pInfo->info.state.commitTerm);
@@ -440,6 +470,8 @@ static int vnodeCommitImpl(SCommitInfo *pInfo) {
     vError("vgId:%d, failed to persist wal since %s", TD_VID(pVnode), terrstr());
     return -1;
   }
+  et = taosGetTimestampUs();
+  pInfo->cost[VND_COMMIT_PHASE_WAL] += et - st;
 
   vnodeGetPrimaryDir(pVnode->path, pVnode->diskPrimary, pVnode->pTfs, dir, TSDB_FILENAME_LEN);
 
@@ -448,10 +480,19 @@ static int vnodeCommitImpl(SCommitInfo *pInfo) {
   code = tsdbCommitBegin(pVnode->pTsdb, pInfo);
   TSDB_CHECK_CODE(code, lino, _exit);
 
+  st = taosGetTimestampUs();
   if (!TSDB_CACHE_NO(pVnode->config)) {
-    code = tsdbCacheCommit(pVnode->pTsdb);
-    TSDB_CHECK_CODE(code, lino, _exit);
+    if (TSDB_CACHE_IN_MEM(pVnode->config)) {
+      // the snapshot only saves loading the cache from tsdb again, it does not fail the commit
+      (void)tsdbCacheSnapshot(pVnode->pTsdb, pInfo->info.state.committed);
+    } else {
+      code = tsdbCacheCommit(pVnode->pTsdb);
+      TSDB_CHECK_CODE(code, lino, _exit);
+    }
   }
+  et = taosGetTimestampUs();
+  pInfo->cost[VND_COMMIT_PHASE_CACHE] += et - st;
+  st = et;
 
   if (VND_IS_RSMA(pVnode)) {
     code = smaCommit(pVnode->pSma, pInfo);
@@ -490,12 +531,14 @@ static int vnodeCommitImpl(SCommitInfo *pInfo) {
   }
 
   syncEndSnapshot(pVnode->sync);
+  pInfo->cost[VND_COMMIT_PHASE_FINISH] += taosGetTimestampUs() - st;
 
 _exit:
   if (code) {
     vError("vgId:%d, %s failed at line %d since %s", TD_VID(pVnode), __func__, lino, tstrerror(code));
   } else {
     vInfo("vgId:%d, commit end", TD_VID(pVnode));
+    vnodeReportCommitCost(pInfo);
   }
   return 0;
 }
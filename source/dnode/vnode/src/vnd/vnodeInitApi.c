@@ -48,6 +48,7 @@ void initTsdbReaderAPI(TsdReader* pReader) {
   pReader->tsdNextDataBlock = tsdbNextDataBlock2;
 
   pReader->tsdReaderRetrieveDataBlock = tsdbRetrieveDataBlock2;
+  pReader->tsdReaderRetrieveRemainCols = (int32_t(*)(void*, bool))tsdbRetrieveRemainCols2;
   pReader->tsdReaderReleaseDataBlock = tsdbReleaseDataBlock2;
 
   pReader->tsdReaderRetrieveBlockSMAInfo = tsdbRetrieveDatablockSMA2;
@@ -63,6 +64,8 @@ void initTsdbReaderAPI(TsdReader* pReader) {
 
   pReader->tsdSetFilesetDelimited = (void (*)(void*))tsdbSetFilesetDelimited;
   pReader->tsdSetSetNotifyCb = (void (*)(void*, TsdReaderNotifyCbFn, void*))tsdbReaderSetNotifyCb;
+  pReader->tsdSetFilterInfo = (void (*)(void*, struct SFilterInfo*))tsdbReaderSetFilterInfo;
+  pReader->tsdSetZeroCopy = (int32_t (*)(void*, bool))tsdbReaderSetZeroCopy;
 }
 
 void initMetadataAPI(SStoreMeta* pMeta) {
@@ -0,0 +1,172 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "vnd.h"
+
+#define VNODE_IO_MIN_WAIT_US 1000
+#define VNODE_IO_MAX_WAIT_US 100000
+
+/*
+ * The dnode I/O scheduler keeps a token bucket for each disk of the tfs, refilled at ioRateLimitMB per second and
+ * holding one second of tokens at most. All classes take tokens for what they read or write, but a class starts its
+ * I/O only while the bucket is above the floor of the class. Commit never waits, queries wait only when the bucket
+ * is one second in debt, merge waits for an empty bucket to refill and retention for a half full one, so the lower
+ * classes back off first when the disk is busy.
+ */
+typedef struct {
+  TdThreadSpinlock lock;
+  int64_t          tokens;
+  int64_t          refillUs;
+} SVIoBucket;
+
+static struct {
+  int64_t    rate;  // bytes per second of each disk, 0 means unlimited
+  SVIoBucket buckets[TFS_MAX_DISKS];
+  int64_t    waitUs[EVIO_CLASS_MAX];
+} vnodeIo;
+
+static threadlocal EVIoClass vnodeIoClass = EVIO_CLASS_QUERY;
+
+static const char *vnodeIoClassStr[EVIO_CLASS_MAX] = {"commit", "query", "merge", "retention"};
+
+int32_t vnodeIoOpen() {
+  vnodeIo.rate = (int64_t)tsIoRateLimitMB * 1024 * 1024;
+
+  int64_t now = taosGetTimestampUs();
+  for (int32_t i = 0; i < TFS_MAX_DISKS; i++) {
+    taosThreadSpinInit(&vnodeIo.buckets[i].lock, 0);
+    vnodeIo.buckets[i].tokens = vnodeIo.rate;
+    vnodeIo.buckets[i].refillUs = now;
+  }
+
+  vInfo("vnode io scheduler is opened, rate limit:%dMB/s per disk", tsIoRateLimitMB);
+  return 0;
+}
+
+void vnodeIoClose() {
+  for (int32_t i = 0; i < TFS_MAX_DISKS; i++) {
+    taosThreadSpinDestroy(&vnodeIo.buckets[i].lock);
+  }
+
+  for (int32_t i = 0; i < EVIO_CLASS_MAX; i++) {
+    vInfo("vnode io scheduler, class:%s wait:%" PRId64 "ms", vnodeIoClassStr[i], vnodeIo.waitUs[i] / 1000);
+  }
+}
+
+/**
+ * @brief set the I/O class of the calling thread
+ *
+ * @return the I/O class before
+ */
+EVIoClass vnodeIoSetClass(EVIoClass ioClass) {
+  EVIoClass prev = vnodeIoClass;
+  vnodeIoClass = ioClass;
+  return prev;
+}
+
+/**
+ * @brief get the scheduler disk of a file in the tfs
+ *
+ * @return the disk, or -1 if the file is not in any disk of the tfs
+ */
+int32_t vnodeIoGetDisk(STfs *pTfs, const char *path) {
+  int32_t disk = -1;
+  size_t  len = 0;
+
+  if (pTfs == NULL) return -1;
+
+  for (int32_t level = 0; level < tfsGetLevel(pTfs); level++) {
+    for (int32_t id = 0; id < tfsGetDisksAtLevel(pTfs, level); id++) {
+      SDiskID     did = {.level = level, .id = id};
+      const char *dir = tfsGetDiskPath(pTfs, did);
+      size_t      dirLen = dir ? strlen(dir) : 0;
+      if (dirLen > len && strncmp(path, dir, dirLen) == 0) {
+        disk = VNODE_IO_DISK(did);
+        len = dirLen;
+      }
+    }
+  }
+
+  return disk;
+}
+
+static int64_t vnodeIoFloor(EVIoClass ioClass, int64_t rate) {
+  switch (ioClass) {
+    case EVIO_CLASS_COMMIT:
+      return INT64_MIN;
+    case EVIO_CLASS_QUERY:
+      return -rate;
+    case EVIO_CLASS_MERGE:
+      return 0;
+    default:
+      return rate / 2;
+  }
+}
+
+/**
+ * @brief take tokens for the I/O of the calling thread on a disk, wait if its class has to back off
+ */
+void vnodeIoAcquire(SVnode *pVnode, int32_t disk, int64_t bytes) {
+  EVIoClass ioClass = vnodeIoClass;
+  int64_t   rate = vnodeIo.rate;
+
+  if (pVnode) {
+    atomic_add_fetch_64(&pVnode->monitor.ioBytes[ioClass], bytes);
+  }
+
+  if (rate <= 0 || disk < 0 || disk >= TFS_MAX_DISKS) return;
+
+  SVIoBucket *bucket = &vnodeIo.buckets[disk];
+  int64_t     minTokens = vnodeIoFloor(ioClass, rate);
+  for (;;) {
+    taosThreadSpinLock(&bucket->lock);
+    int64_t now = taosGetTimestampUs();
+    int64_t elapsed = TMIN(now - bucket->refillUs, 1000000);
+    int64_t refill = elapsed * rate / 1000000;
+    if (refill > 0) {
+      bucket->tokens = TMIN(bucket->tokens + refill, rate);
+      bucket->refillUs = now;
+    }
+
+    if (bucket->tokens > minTokens) {
+      bucket->tokens -= bytes;
+      taosThreadSpinUnlock(&bucket->lock);
+      break;
+    }
+
+    int64_t waitUs = (int64_t)((double)(minTokens - bucket->tokens + 1) * 1000000 / rate);
+    taosThreadSpinUnlock(&bucket->lock);
+
+    TRANGE(waitUs, VNODE_IO_MIN_WAIT_US, VNODE_IO_MAX_WAIT_US);
+    taosUsleep(waitUs);
+    atomic_add_fetch_64(&vnodeIo.waitUs[ioClass], waitUs);
+  }
+}
+
+/**
+ * @brief add the tsdb I/O of the vnode since last report to its metric
+ */
+void vnodeIoReport(SVnode *pVnode) {
+  if (pVnode->monitor.ioCounter == NULL) return;
+
+  for (int32_t i = 0; i < EVIO_CLASS_MAX; i++) {
+    int64_t bytes = atomic_exchange_64(&pVnode->monitor.ioBytes[i], 0);
+    if (bytes == 0) continue;
+
+    const char *sample_labels[] = {pVnode->monitor.strClusterId, pVnode->monitor.strDnodeId, tsLocalEp,
+                                   pVnode->monitor.strVgId, vnodeIoClassStr[i]};
+    taos_counter_add(pVnode->monitor.ioCounter, bytes, sample_labels);
+  }
+}
@@ -26,10 +26,18 @@ int vnodeInit(int nthreads) {
     return 0;
   }
 
+  if (vnodeIoOpen() != 0) {
+    return -1;
+  }
+
   if (vnodeAsyncOpen(nthreads) != 0) {
     return -1;
   }
 
+  if (vnodeS3CacheOpen() != 0) {
+    return -1;
+  }
+
   if (walInit() < 0) {
     return -1;
   }
@@ -43,6 +51,8 @@ void vnodeCleanup() {
 
   // set stop
   vnodeAsyncClose();
+  vnodeS3CacheClose();
+  vnodeIoClose();
 
   walCleanUp();
   smaCleanUp();
@@ -441,12 +441,19 @@ SVnode *vnodeOpen(const char *path, int32_t diskPrimary, STfs *pTfs, SMsgCb msgC
   sprintf(tdir, "%s%s%s", dir, TD_DIRSEP, VNODE_WAL_DIR);
   taosRealPath(tdir, NULL, sizeof(tdir));
 
+  // the records compressed or not are both readable, so the compressor is taken from the dnode on each open
+  pVnode->config.walCfg.compressor = walGetCompressor(tsWalCompressor);
   pVnode->pWal = walOpen(tdir, &(pVnode->config.walCfg));
   if (pVnode->pWal == NULL) {
     vError("vgId:%d, failed to open vnode wal since %s. wal:%s", TD_VID(pVnode), tstrerror(terrno), tdir);
     goto _err;
   }
 
+  // the last cache snapshot is loaded once it is known which versions the wal replays
+  if (pVnode->pTsdb && !TSDB_CACHE_NO(pVnode->config)) {
+    (void)tsdbCacheLoadSnapshot(pVnode->pTsdb, walGetLastVer(pVnode->pWal));
+  }
+
   // open tq
   sprintf(tdir, "%s%s%s", dir, TD_DIRSEP, VNODE_TQ_DIR);
   taosRealPath(tdir, NULL, sizeof(tdir));
@@ -478,6 +485,11 @@ SVnode *vnodeOpen(const char *path, int32_t diskPrimary, STfs *pTfs, SMsgCb msgC
     goto _err;
   }
 
+  // decode the wal to replay ahead, before the sync restore sends it to apply
+  if (vnodeReplayOpen(pVnode) != 0) {
+    vWarn("vgId:%d, failed to open wal replay, replayed by the apply thread alone", TD_VID(pVnode));
+  }
+
   // open sync
   vInfo("vgId:%d, start to open sync, changeVersion:%d", TD_VID(pVnode), info.config.syncCfg.changeVersion);
   if (vnodeSyncOpen(pVnode, dir, info.config.syncCfg.changeVersion)) {
@@ -511,9 +523,77 @@ SVnode *vnodeOpen(const char *path, int32_t diskPrimary, STfs *pTfs, SMsgCb msgC
     vInfo("vgId:%d, succeed to set metric:%p", TD_VID(pVnode), counter);
   }
 
+  if (tsEnableMonitor && pVnode->monitor.commitCounter == NULL) {
+    taos_counter_t *counter = NULL;
+    const char     *sample_labels[] = {VNODE_METRIC_TAG_NAME_CLUSTER_ID, VNODE_METRIC_TAG_NAME_DNODE_ID,
+                                       VNODE_METRIC_TAG_NAME_DNODE_EP, VNODE_METRIC_TAG_NAME_VGROUP_ID,
+                                       VNODE_METRIC_TAG_NAME_PHASE};
+    counter = taos_counter_new(VNODE_METRIC_COMMIT_TIME, "counter for commit time in ms by phase", 5, sample_labels);
+    if (taos_collector_registry_register_metric(counter) == 1) {
+      taos_counter_destroy(counter);
+      counter = taos_collector_registry_get_metric(VNODE_METRIC_COMMIT_TIME);
+    }
+    pVnode->monitor.commitCounter = counter;
+  }
+
+  if (tsEnableMonitor && pVnode->monitor.ioCounter == NULL) {
+    taos_counter_t *counter = NULL;
+    const char     *sample_labels[] = {VNODE_METRIC_TAG_NAME_CLUSTER_ID, VNODE_METRIC_TAG_NAME_DNODE_ID,
+                                       VNODE_METRIC_TAG_NAME_DNODE_EP, VNODE_METRIC_TAG_NAME_VGROUP_ID,
+                                       VNODE_METRIC_TAG_NAME_IO_CLASS};
+    counter = taos_counter_new(VNODE_METRIC_IO_BYTES, "counter for tsdb io bytes by io class", 5, sample_labels);
+    if (taos_collector_registry_register_metric(counter) == 1) {
+      taos_counter_destroy(counter);
+      counter = taos_collector_registry_get_metric(VNODE_METRIC_IO_BYTES);
+    }
+    pVnode->monitor.ioCounter = counter;
+  }
+
+  if (tsEnableMonitor && pVnode->monitor.cdCacheCounter == NULL) {
+    taos_counter_t *counter = NULL;
+    const char     *sample_labels[] = {VNODE_METRIC_TAG_NAME_CLUSTER_ID, VNODE_METRIC_TAG_NAME_DNODE_ID,
+                                       VNODE_METRIC_TAG_NAME_DNODE_EP, VNODE_METRIC_TAG_NAME_VGROUP_ID,
+                                       VNODE_METRIC_TAG_NAME_RESULT};
+    counter = taos_counter_new(VNODE_METRIC_CD_CACHE, "counter for column data cache lookups by result", 5,
+                               sample_labels);
+    if (taos_collector_registry_register_metric(counter) == 1) {
+      taos_counter_destroy(counter);
+      counter = taos_collector_registry_get_metric(VNODE_METRIC_CD_CACHE);
+    }
+    pVnode->monitor.cdCacheCounter = counter;
+  }
+
+  if (tsEnableMonitor && pVnode->monitor.bufPoolCounter == NULL) {
+    taos_counter_t *counter = NULL;
+    const char     *sample_labels[] = {VNODE_METRIC_TAG_NAME_CLUSTER_ID, VNODE_METRIC_TAG_NAME_DNODE_ID,
+                                       VNODE_METRIC_TAG_NAME_DNODE_EP, VNODE_METRIC_TAG_NAME_VGROUP_ID,
+                                       VNODE_METRIC_TAG_NAME_EVENT};
+    counter = taos_counter_new(VNODE_METRIC_BUF_POOL, "counter for buffer pool reuses, overflows and waits", 5,
+                               sample_labels);
+    if (taos_collector_registry_register_metric(counter) == 1) {
+      taos_counter_destroy(counter);
+      counter = taos_collector_registry_get_metric(VNODE_METRIC_BUF_POOL);
+    }
+    pVnode->monitor.bufPoolCounter = counter;
+  }
+
+  if (tsEnableMonitor && pVnode->monitor.bufWaitCounter == NULL) {
+    taos_counter_t *counter = NULL;
+    const char     *sample_labels[] = {VNODE_METRIC_TAG_NAME_CLUSTER_ID, VNODE_METRIC_TAG_NAME_DNODE_ID,
+                                       VNODE_METRIC_TAG_NAME_DNODE_EP, VNODE_METRIC_TAG_NAME_VGROUP_ID};
+    counter = taos_counter_new(VNODE_METRIC_BUF_WAIT, "counter for time in ms the writer waits for a buffer pool", 4,
+                               sample_labels);
+    if (taos_collector_registry_register_metric(counter) == 1) {
+      taos_counter_destroy(counter);
+      counter = taos_collector_registry_get_metric(VNODE_METRIC_BUF_WAIT);
+    }
+    pVnode->monitor.bufWaitCounter = counter;
+  }
+
   return pVnode;
 
 _err:
+  vnodeReplayClose(pVnode);
   if (pVnode->pQuery) vnodeQueryClose(pVnode);
   if (pVnode->pTq) tqClose(pVnode->pTq);
   if (pVnode->pWal) walClose(pVnode->pWal);
@@ -538,6 +618,7 @@ void vnodeClose(SVnode *pVnode) {
     vnodeAWait(&pVnode->commitTask);
     vnodeAChannelDestroy(&pVnode->commitChannel, true);
     vnodeSyncClose(pVnode);
+    vnodeReplayClose(pVnode);
     vnodeQueryClose(pVnode);
     tqClose(pVnode->pTq);
     walClose(pVnode->pWal);
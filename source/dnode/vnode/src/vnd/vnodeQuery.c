@@ -422,6 +422,69 @@ _exit:
   return code;
 }
 
+/**
+ * @brief add the lookups of the column data cache since last report to its metric
+ */
+static void vnodeColDataCacheReport(SVnode *pVnode) {
+  if (pVnode->monitor.cdCacheCounter == NULL || pVnode->pTsdb == NULL) return;
+
+  int64_t hit = 0, miss = 0;
+  size_t  usage = 0;
+  tsdbColDataCacheGetStat(pVnode->pTsdb, &hit, &miss, &usage);
+
+  // the counters of tsdb start from zero again once it is reopened
+  if (hit < pVnode->monitor.cdCacheHit || miss < pVnode->monitor.cdCacheMiss) {
+    pVnode->monitor.cdCacheHit = 0;
+    pVnode->monitor.cdCacheMiss = 0;
+  }
+
+  const char *hit_labels[] = {pVnode->monitor.strClusterId, pVnode->monitor.strDnodeId, tsLocalEp,
+                              pVnode->monitor.strVgId, VNODE_METRIC_TAG_VALUE_CACHE_HIT};
+  const char *miss_labels[] = {pVnode->monitor.strClusterId, pVnode->monitor.strDnodeId, tsLocalEp,
+                               pVnode->monitor.strVgId, VNODE_METRIC_TAG_VALUE_CACHE_MISS};
+  if (hit > pVnode->monitor.cdCacheHit) {
+    taos_counter_add(pVnode->monitor.cdCacheCounter, hit - pVnode->monitor.cdCacheHit, hit_labels);
+  }
+  if (miss > pVnode->monitor.cdCacheMiss) {
+    taos_counter_add(pVnode->monitor.cdCacheCounter, miss - pVnode->monitor.cdCacheMiss, miss_labels);
+  }
+
+  pVnode->monitor.cdCacheHit = hit;
+  pVnode->monitor.cdCacheMiss = miss;
+}
+
+static void vnodeBufPoolCounterAdd(SVnode *pVnode, int64_t value, int64_t *pReported, const char *event) {
+  if (value <= *pReported) return;
+
+  const char *sample_labels[] = {pVnode->monitor.strClusterId, pVnode->monitor.strDnodeId, tsLocalEp,
+                                 pVnode->monitor.strVgId, event};
+  taos_counter_add(pVnode->monitor.bufPoolCounter, value - *pReported, sample_labels);
+  *pReported = value;
+}
+
+/**
+ * @brief add the buffer pool reuses, overflows and waits since last report to their metrics
+ */
+static void vnodeBufPoolReport(SVnode *pVnode) {
+  if (pVnode->monitor.bufPoolCounter == NULL || pVnode->monitor.bufWaitCounter == NULL) return;
+
+  SVBufPoolStat *pStat = &pVnode->poolStat;
+  SVBufPoolStat *pReported = &pVnode->monitor.bufPoolStat;
+
+  vnodeBufPoolCounterAdd(pVnode, atomic_load_64(&pStat->nReuse), &pReported->nReuse, VNODE_METRIC_TAG_VALUE_POOL_REUSE);
+  vnodeBufPoolCounterAdd(pVnode, atomic_load_64(&pStat->nOverflow), &pReported->nOverflow,
+                         VNODE_METRIC_TAG_VALUE_POOL_OVERFLOW);
+  vnodeBufPoolCounterAdd(pVnode, atomic_load_64(&pStat->nWait), &pReported->nWait, VNODE_METRIC_TAG_VALUE_POOL_WAIT);
+
+  int64_t waitTime = atomic_load_64(&pStat->waitTime);
+  if (waitTime > pReported->waitTime) {
+    const char *sample_labels[] = {pVnode->monitor.strClusterId, pVnode->monitor.strDnodeId, tsLocalEp,
+                                   pVnode->monitor.strVgId};
+    taos_counter_add(pVnode->monitor.bufWaitCounter, waitTime - pReported->waitTime, sample_labels);
+    pReported->waitTime = waitTime;
+  }
+}
+
 int32_t vnodeGetLoad(SVnode *pVnode, SVnodeLoad *pLoad) {
   SSyncState state = syncGetState(pVnode->sync);
 
@@ -445,6 +508,9 @@ int32_t vnodeGetLoad(SVnode *pVnode, SVnodeLoad *pLoad) {
   pLoad->numOfInsertSuccessReqs = atomic_load_64(&pVnode->statis.nInsertSuccess);
   pLoad->numOfBatchInsertReqs = atomic_load_64(&pVnode->statis.nBatchInsert);
   pLoad->numOfBatchInsertSuccessReqs = atomic_load_64(&pVnode->statis.nBatchInsertSuccess);
+  vnodeIoReport(pVnode);
+  vnodeColDataCacheReport(pVnode);
+  vnodeBufPoolReport(pVnode);
   return 0;
 }
 
@@ -0,0 +1,279 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "vnd.h"
+
+#define VNODE_REPLAY_ASYNC_ID     5
+#define VNODE_REPLAY_BATCH_SIZE   64    // versions decoded by one task
+#define VNODE_REPLAY_MIN_VERSIONS 1024  // a shorter wal is replayed by the apply thread alone
+#define VNODE_REPLAY_REPORT_US    5000000
+
+/*
+ * On restore, the committed wal beyond the applied version goes through the apply thread again. The replay decodes
+ * and scans the submits of it ahead, by the vnode-replay workers in batches of versions read with their own wal
+ * readers. The apply thread takes the requests decoded in version order, and schedules the next batch when it leaves
+ * one, so the batches in flight are bounded. The messages decoded and not taken yet are bounded by replayBufferSizeMB
+ * as well, a worker leaves the rest of its batch to the apply thread beyond that. A request is taken only if it is
+ * decoded from the very message applied, any other message is decoded by the apply thread as before.
+ */
+typedef struct {
+  int64_t     ver;  // -1 if the version is not a submit decoded
+  int32_t     code;
+  int32_t     len;
+  void       *pBuf;  // the message decoded, referred by the request
+  SSubmitReq2 submitReq;
+} SVReplayEntry;
+
+typedef struct {
+  SVReplay     *pReplay;
+  int64_t       startVer;
+  int32_t       nEntry;
+  SVATaskID     taskID;
+  SVReplayEntry aEntry[VNODE_REPLAY_BATCH_SIZE];
+} SVReplayBatch;
+
+struct SVReplay {
+  SVnode        *pVnode;
+  int64_t        startVer;
+  int64_t        endVer;
+  int32_t        nBatch;
+  int64_t        curBatch;  // the batch the apply thread is in
+  SVReplayBatch *aBatch;    // batch i is in aBatch[i % nBatch]
+  int64_t        maxBytes;     // replayBufferSizeMB
+  int64_t        nBytesAhead;  // bytes of the messages decoded and not taken
+
+  // progress
+  int64_t startUs;
+  int64_t reportUs;
+  int64_t nTaken;
+  int64_t nBytes;
+};
+
+static void vnodeReplayEntryClear(SVReplay *pReplay, SVReplayEntry *pEntry) {
+  if (pEntry->pBuf) {
+    tDestroySubmitReq(&pEntry->submitReq, TSDB_MSG_FLG_DECODE);
+    taosMemoryFreeClear(pEntry->pBuf);
+    atomic_sub_fetch_64(&pReplay->nBytesAhead, pEntry->len);
+  }
+  pEntry->ver = -1;
+}
+
+static int32_t vnodeReplayDecode(void *arg) {
+  SVReplayBatch *pBatch = (SVReplayBatch *)arg;
+  SVReplay      *pReplay = pBatch->pReplay;
+  SVnode        *pVnode = pReplay->pVnode;
+
+  SWalReader *pReader = walOpenReader(pVnode->pWal, NULL, 0);
+  if (pReader == NULL) {
+    vWarn("vgId:%d, failed to open wal reader to replay since %s", TD_VID(pVnode), terrstr());
+    return terrno;
+  }
+
+  for (int32_t i = 0; i < pBatch->nEntry; i++) {
+    SVReplayEntry *pEntry = &pBatch->aEntry[i];
+    int64_t        ver = pBatch->startVer + i;
+
+    // the rest is decoded by the apply thread
+    if (walReadVer(pReader, ver) < 0) break;
+
+    SWalCont *pHead = &pReader->pHead->head;
+    if (pHead->msgType != TDMT_VND_SUBMIT || pHead->bodyLen < (int32_t)sizeof(SSubmitReq2Msg) ||
+        ((SSubmitReq2Msg *)pHead->body)->version == 0) {
+      continue;
+    }
+
+    if (atomic_add_fetch_64(&pReplay->nBytesAhead, pHead->bodyLen) > pReplay->maxBytes) {
+      atomic_sub_fetch_64(&pReplay->nBytesAhead, pHead->bodyLen);
+      break;
+    }
+    pEntry->pBuf = taosMemoryMalloc(pHead->bodyLen);
+    if (pEntry->pBuf == NULL) {
+      atomic_sub_fetch_64(&pReplay->nBytesAhead, pHead->bodyLen);
+      break;
+    }
+    memcpy(pEntry->pBuf, pHead->body, pHead->bodyLen);
+    pEntry->len = pHead->bodyLen;
+    pEntry->ver = ver;
+
+    SDecoder dc = {0};
+    tDecoderInit(&dc, POINTER_SHIFT(pEntry->pBuf, sizeof(SSubmitReq2Msg)), pEntry->len - sizeof(SSubmitReq2Msg));
+    if (tDecodeSubmitReq(&dc, &pEntry->submitReq) < 0) {
+      pEntry->code = TSDB_CODE_INVALID_MSG;
+    } else {
+      pEntry->code = vnodeScanSubmitReq(pVnode, ver, &pEntry->submitReq);
+    }
+    tDecoderClear(&dc);
+  }
+
+  walCloseReader(pReader);
+  return 0;
+}
+
+static void vnodeReplaySchedule(SVReplay *pReplay, int64_t iBatch) {
+  SVReplayBatch *pBatch = &pReplay->aBatch[iBatch % pReplay->nBatch];
+  int64_t        startVer = pReplay->startVer + iBatch * VNODE_REPLAY_BATCH_SIZE;
+
+  pBatch->nEntry = 0;
+  pBatch->taskID = (SVATaskID){0};
+  if (startVer > pReplay->endVer) return;
+
+  pBatch->pReplay = pReplay;
+  pBatch->startVer = startVer;
+  pBatch->nEntry = TMIN(VNODE_REPLAY_BATCH_SIZE, pReplay->endVer - startVer + 1);
+  for (int32_t i = 0; i < pBatch->nEntry; i++) {
+    pBatch->aEntry[i] = (SVReplayEntry){.ver = -1};
+  }
+
+  SVAChannelID channelID = {.async = VNODE_REPLAY_ASYNC_ID, .id = 0};
+  if (vnodeAsync(&channelID, EVA_PRIORITY_HIGH, vnodeReplayDecode, NULL, pBatch, &pBatch->taskID) != 0) {
+    pBatch->nEntry = 0;
+  }
+}
+
+static void vnodeReplayRelease(SVReplay *pReplay, int64_t iBatch) {
+  SVReplayBatch *pBatch = &pReplay->aBatch[iBatch % pReplay->nBatch];
+
+  if (pBatch->taskID.id > 0) {
+    (void)vnodeACancel(&pBatch->taskID);
+    (void)vnodeAWait(&pBatch->taskID);
+  }
+  for (int32_t i = 0; i < pBatch->nEntry; i++) {
+    vnodeReplayEntryClear(pReplay, &pBatch->aEntry[i]);
+  }
+  pBatch->nEntry = 0;
+  pBatch->taskID = (SVATaskID){0};
+}
+
+/**
+ * @brief start to decode the committed wal to replay ahead, if it is long enough
+ */
+int32_t vnodeReplayOpen(SVnode *pVnode) {
+  if (tsNumOfReplayThreads <= 0) return 0;
+
+  int64_t startVer = pVnode->state.applied + 1;
+  int64_t endVer = walGetCommittedVer(pVnode->pWal);
+  if (endVer - startVer + 1 < VNODE_REPLAY_MIN_VERSIONS) return 0;
+
+  SVReplay *pReplay = taosMemoryCalloc(1, sizeof(SVReplay));
+  if (pReplay == NULL) return TSDB_CODE_OUT_OF_MEMORY;
+
+  // keep each worker busy with two batches, while the apply thread is in one
+  pReplay->nBatch = tsNumOfReplayThreads * 2 + 1;
+  pReplay->aBatch = taosMemoryCalloc(pReplay->nBatch, sizeof(SVReplayBatch));
+  if (pReplay->aBatch == NULL) {
+    taosMemoryFree(pReplay);
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  pReplay->pVnode = pVnode;
+  pReplay->maxBytes = (int64_t)tsReplayBufferSizeMB * 1024 * 1024;
+  pReplay->startVer = startVer;
+  pReplay->endVer = endVer;
+  pReplay->startUs = taosGetTimestampUs();
+  pReplay->reportUs = pReplay->startUs;
+  for (int64_t i = 0; i < pReplay->nBatch; i++) {
+    vnodeReplaySchedule(pReplay, i);
+  }
+
+  pVnode->pReplay = pReplay;
+  vInfo("vgId:%d, replay wal from ver:%" PRId64 " to ver:%" PRId64 " by %d threads", TD_VID(pVnode), startVer, endVer,
+        tsNumOfReplayThreads);
+  return 0;
+}
+
+void vnodeReplayClose(SVnode *pVnode) {
+  SVReplay *pReplay = pVnode->pReplay;
+  if (pReplay == NULL) return;
+
+  for (int64_t i = 0; i < pReplay->nBatch; i++) {
+    vnodeReplayRelease(pReplay, pReplay->curBatch + i);
+  }
+
+  int64_t elapsedUs = TMAX(taosGetTimestampUs() - pReplay->startUs, 1);
+  vInfo("vgId:%d, replay is closed, %" PRId64 " submits taken in %" PRId64 "ms, %.1fMB/s", TD_VID(pVnode),
+        pReplay->nTaken, elapsedUs / 1000, (double)pReplay->nBytes / elapsedUs);
+
+  taosMemoryFree(pReplay->aBatch);
+  taosMemoryFree(pReplay);
+  pVnode->pReplay = NULL;
+}
+
+static void vnodeReplayReport(SVReplay *pReplay, int64_t ver) {
+  int64_t now = taosGetTimestampUs();
+  if (now - pReplay->reportUs < VNODE_REPLAY_REPORT_US) return;
+  pReplay->reportUs = now;
+
+  int64_t elapsedUs = TMAX(now - pReplay->startUs, 1);
+  int64_t nVer = ver - pReplay->startVer + 1;
+  vInfo("vgId:%d, replay progress, ver:%" PRId64 " of %" PRId64 "-%" PRId64 ", %.1f%%, %.0f versions/s, %.1fMB/s",
+        TD_VID(pReplay->pVnode), ver, pReplay->startVer, pReplay->endVer,
+        nVer * 100.0 / (pReplay->endVer - pReplay->startVer + 1), nVer * 1000000.0 / elapsedUs,
+        (double)pReplay->nBytes / elapsedUs);
+}
+
+/**
+ * @brief take the submit decoded ahead for the message applied, called by the apply thread only
+ *
+ * @return true if taken, with the code of decode and scan, and the buffer to free after the request is destroyed
+ */
+bool vnodeReplayTake(SVnode *pVnode, int64_t ver, const void *pMsg, int32_t len, SSubmitReq2 *pSubmitReq,
+                     void **ppBuf, int32_t *code) {
+  SVReplay *pReplay = pVnode->pReplay;
+  if (pReplay == NULL) return false;
+
+  if (ver < pReplay->startVer || ver > pReplay->endVer) {
+    vnodeReplayClose(pVnode);
+    return false;
+  }
+
+  // leave the batches behind, and schedule the ones after in their slots
+  int64_t iBatch = (ver - pReplay->startVer) / VNODE_REPLAY_BATCH_SIZE;
+  for (; pReplay->curBatch < iBatch; pReplay->curBatch++) {
+    vnodeReplayRelease(pReplay, pReplay->curBatch);
+    vnodeReplaySchedule(pReplay, pReplay->curBatch + pReplay->nBatch);
+  }
+
+  bool           taken = false;
+  SVReplayBatch *pBatch = &pReplay->aBatch[iBatch % pReplay->nBatch];
+  if (pBatch->taskID.id > 0) {
+    (void)vnodeAWait(&pBatch->taskID);
+    pBatch->taskID = (SVATaskID){0};
+  }
+
+  int32_t idx = ver - pBatch->startVer;
+  if (idx < pBatch->nEntry) {
+    SVReplayEntry *pEntry = &pBatch->aEntry[idx];
+    if (pEntry->ver == ver && pEntry->len == len && memcmp(pEntry->pBuf, pMsg, len) == 0) {
+      *pSubmitReq = pEntry->submitReq;
+      *ppBuf = pEntry->pBuf;
+      *code = pEntry->code;
+      pEntry->pBuf = NULL;
+      pEntry->ver = -1;
+      atomic_sub_fetch_64(&pReplay->nBytesAhead, len);
+      taken = true;
+    }
+  }
+
+  if (taken) {
+    pReplay->nTaken++;
+    pReplay->nBytes += len;
+  }
+  vnodeReplayReport(pReplay, ver);
+
+  if (ver == pReplay->endVer) {
+    vnodeReplayClose(pVnode);
+  }
+  return taken;
+}
@@ -0,0 +1,598 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "cos.h"
+#include "tchecksum.h"
+#include "vnd.h"
+
+#define VNODE_S3_CACHE_SEG_SIZE     (1024 * 1024)  // bytes of an object cached by one file
+#define VNODE_S3_CACHE_MAX_PREFETCH 32             // segments being read ahead at most
+#define VNODE_S3_CACHE_TMP_SUFFIX   ".t"
+
+/*
+ * The s3 cache keeps the segments of the s3 objects read by queries as files under s3CacheDir, one file for each
+ * segment with the checksum of the segment at its end. The objects are immutable, so a cached segment never goes
+ * stale. The segments are evicted by a segmented LRU: a new segment enters the probation list, a segment hit again
+ * moves to the protected list, which holds 80% of the capacity at most, and the victims are taken from the tail of
+ * the probation list first. So a large scan does not flush the segments queried again and again. The index is
+ * rebuilt from the files when the dnode starts, with the modify time as the LRU order.
+ */
+typedef struct SVS3CacheEntry SVS3CacheEntry;
+struct SVS3CacheEntry {
+  TD_DLIST_NODE(SVS3CacheEntry);
+  int64_t size;  // bytes of the file
+  int32_t nRef;
+  bool    loading;
+  bool    protect;
+  char    key[TSDB_FILENAME_LEN];
+};
+
+typedef TD_DLIST(SVS3CacheEntry) SVS3CacheList;
+
+typedef struct {
+  char    object[TSDB_FILENAME_LEN];
+  int64_t objSize;
+  int64_t segno;
+} SVS3CachePrefetch;
+
+static struct {
+  bool          enabled;
+  int64_t       capacity;
+  TdThreadMutex mutex;
+  TdThreadCond  loaded;
+  SHashObj     *index;  // key -> SVS3CacheEntry *
+  SVS3CacheList probation;
+  SVS3CacheList protect;
+  int64_t       size;
+  int64_t       protectSize;
+  int32_t       nPrefetch;
+  int64_t       nHit;
+  int64_t       nMiss;
+  int64_t       nEvict;
+  int64_t       nReadAhead;
+} vnodeS3Cache;
+
+static FVS3CacheRead vnodeS3CacheReadFp = s3GetObjectBlock;
+
+/**
+ * @brief replace the read of the s3 objects, for the tests
+ *
+ * @return the previous one
+ */
+FVS3CacheRead vnodeS3CacheSetRead(FVS3CacheRead fp) {
+  FVS3CacheRead old = vnodeS3CacheReadFp;
+  vnodeS3CacheReadFp = fp ? fp : s3GetObjectBlock;
+  return old;
+}
+
+static void vnodeS3CacheKey(const char *object, int64_t segno, char *key) {
+  snprintf(key, TSDB_FILENAME_LEN, "%s.%" PRId64, object, segno);
+  for (char *p = key; *p; p++) {
+    if (*p == '/' || *p == '\\') *p = '_';
+  }
+}
+
+static void vnodeS3CachePath(const char *key, const char *suffix, char *path) {
+  snprintf(path, PATH_MAX, "%s%s%s%s", tsS3CacheDir, TD_DIRSEP, key, suffix);
+}
+
+static void vnodeS3CacheRemoveEntry(SVS3CacheEntry *pEntry) {
+  char path[PATH_MAX];
+
+  if (pEntry->protect) {
+    TD_DLIST_POP(&vnodeS3Cache.protect, pEntry);
+    vnodeS3Cache.protectSize -= pEntry->size;
+  } else {
+    TD_DLIST_POP(&vnodeS3Cache.probation, pEntry);
+  }
+  vnodeS3Cache.size -= pEntry->size;
+  taosHashRemove(vnodeS3Cache.index, pEntry->key, strlen(pEntry->key));
+
+  vnodeS3CachePath(pEntry->key, "", path);
+  taosRemoveFile(path);
+  taosMemoryFree(pEntry);
+}
+
+static SVS3CacheEntry *vnodeS3CacheVictim(SVS3CacheList *pList) {
+  for (SVS3CacheEntry *pEntry = TD_DLIST_TAIL(pList); pEntry; pEntry = TD_DLIST_NODE_PREV(pEntry)) {
+    if (pEntry->nRef == 0) return pEntry;
+  }
+  return NULL;
+}
+
+// must be called with the mutex held
+static void vnodeS3CacheEvict() {
+  while (vnodeS3Cache.size > vnodeS3Cache.capacity) {
+    SVS3CacheEntry *pEntry = vnodeS3CacheVictim(&vnodeS3Cache.probation);
+    if (pEntry == NULL) {
+      pEntry = vnodeS3CacheVictim(&vnodeS3Cache.protect);
+    }
+    if (pEntry == NULL) break;
+
+    vnodeS3CacheRemoveEntry(pEntry);
+    vnodeS3Cache.nEvict++;
+  }
+}
+
+// must be called with the mutex held
+static void vnodeS3CacheTouch(SVS3CacheEntry *pEntry) {
+  if (pEntry->protect) {
+    TD_DLIST_POP(&vnodeS3Cache.protect, pEntry);
+    TD_DLIST_PREPEND(&vnodeS3Cache.protect, pEntry);
+    return;
+  }
+
+  TD_DLIST_POP(&vnodeS3Cache.probation, pEntry);
+  TD_DLIST_PREPEND(&vnodeS3Cache.protect, pEntry);
+  pEntry->protect = true;
+  vnodeS3Cache.protectSize += pEntry->size;
+
+  // demote the protected tail back to the probation list
+  int64_t protectCapacity = vnodeS3Cache.capacity / 10 * 8;
+  while (vnodeS3Cache.protectSize > protectCapacity) {
+    SVS3CacheEntry *pTail = TD_DLIST_TAIL(&vnodeS3Cache.protect);
+    if (pTail == pEntry) break;
+
+    TD_DLIST_POP(&vnodeS3Cache.protect, pTail);
+    TD_DLIST_PREPEND(&vnodeS3Cache.probation, pTail);
+    pTail->protect = false;
+    vnodeS3Cache.protectSize -= pTail->size;
+  }
+}
+
+static int32_t vnodeS3CacheReadFile(const char *key, int64_t segSize, uint8_t **ppSeg) {
+  int32_t   code = 0;
+  char      path[PATH_MAX];
+  uint8_t  *pSeg = NULL;
+  TdFilePtr pFile = NULL;
+  int64_t   size = segSize + sizeof(TSCKSUM);
+
+  vnodeS3CachePath(key, "", path);
+  pFile = taosOpenFile(path, TD_FILE_READ);
+  if (pFile == NULL) {
+    code = TAOS_SYSTEM_ERROR(errno);
+    goto _exit;
+  }
+
+  pSeg = taosMemoryMalloc(size);
+  if (pSeg == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _exit;
+  }
+
+  if (taosReadFile(pFile, pSeg, size) != size || !taosCheckChecksumWhole(pSeg, size)) {
+    code = TSDB_CODE_FILE_CORRUPTED;
+    goto _exit;
+  }
+
+_exit:
+  taosCloseFile(&pFile);
+  if (code) {
+    taosMemoryFree(pSeg);
+  } else {
+    *ppSeg = pSeg;
+  }
+  return code;
+}
+
+static int32_t vnodeS3CacheWriteFile(const char *key, uint8_t *pSeg, int64_t segSize) {
+  int32_t   code = 0;
+  char      tpath[PATH_MAX];
+  char      path[PATH_MAX];
+  TSCKSUM   cksum = taosCalcChecksum(0, pSeg, segSize);
+  TdFilePtr pFile = NULL;
+
+  vnodeS3CachePath(key, VNODE_S3_CACHE_TMP_SUFFIX, tpath);
+  vnodeS3CachePath(key, "", path);
+
+  pFile = taosOpenFile(tpath, TD_FILE_CREATE | TD_FILE_WRITE | TD_FILE_TRUNC);
+  if (pFile == NULL) {
+    code = TAOS_SYSTEM_ERROR(errno);
+    goto _exit;
+  }
+
+  if (taosWriteFile(pFile, pSeg, segSize) != segSize || taosWriteFile(pFile, &cksum, sizeof(cksum)) != sizeof(cksum)) {
+    code = TAOS_SYSTEM_ERROR(errno);
+    goto _exit;
+  }
+  taosCloseFile(&pFile);
+
+  if (taosRenameFile(tpath, path) < 0) {
+    code = TAOS_SYSTEM_ERROR(errno);
+    goto _exit;
+  }
+
+_exit:
+  if (code) {
+    taosCloseFile(&pFile);
+    taosRemoveFile(tpath);
+  }
+  return code;
+}
+
+/*
+ * Get a segment of an object through the cache. With ppSeg NULL the segment is only loaded into the cache, and
+ * nothing is done if it is cached or being loaded already.
+ */
+static int32_t vnodeS3CacheGetSeg(const char *object, int64_t objSize, int64_t segno, bool check, uint8_t **ppSeg,
+                                  bool *hit) {
+  int32_t         code = 0;
+  char            key[TSDB_FILENAME_LEN];
+  int64_t         segOffset = segno * VNODE_S3_CACHE_SEG_SIZE;
+  int64_t         segSize = TMIN(VNODE_S3_CACHE_SEG_SIZE, objSize - segOffset);
+  uint8_t        *pSeg = NULL;
+  SVS3CacheEntry *pEntry = NULL;
+
+  vnodeS3CacheKey(object, segno, key);
+
+  taosThreadMutexLock(&vnodeS3Cache.mutex);
+  for (;;) {
+    SVS3CacheEntry **ppEntry = taosHashGet(vnodeS3Cache.index, key, strlen(key));
+    if (ppEntry == NULL) {
+      pEntry = taosMemoryCalloc(1, sizeof(*pEntry));
+      if (pEntry == NULL) {
+        taosThreadMutexUnlock(&vnodeS3Cache.mutex);
+        return TSDB_CODE_OUT_OF_MEMORY;
+      }
+      tstrncpy(pEntry->key, key, TSDB_FILENAME_LEN);
+      pEntry->loading = true;
+      pEntry->nRef = 1;
+      if (taosHashPut(vnodeS3Cache.index, key, strlen(key), &pEntry, POINTER_BYTES) != 0) {
+        taosThreadMutexUnlock(&vnodeS3Cache.mutex);
+        taosMemoryFree(pEntry);
+        return TSDB_CODE_OUT_OF_MEMORY;
+      }
+      *hit = false;
+      break;
+    }
+
+    if (ppSeg == NULL) {
+      taosThreadMutexUnlock(&vnodeS3Cache.mutex);
+      *hit = true;
+      return 0;
+    }
+
+    if ((*ppEntry)->loading) {
+      taosThreadCondWait(&vnodeS3Cache.loaded, &vnodeS3Cache.mutex);
+      continue;
+    }
+
+    pEntry = *ppEntry;
+    pEntry->nRef++;
+    vnodeS3CacheTouch(pEntry);
+    *hit = true;
+    break;
+  }
+  if (ppSeg && *hit) {
+    vnodeS3Cache.nHit++;
+  } else if (ppSeg) {
+    vnodeS3Cache.nMiss++;
+  }
+  taosThreadMutexUnlock(&vnodeS3Cache.mutex);
+
+  if (*hit) {
+    code = vnodeS3CacheReadFile(key, segSize, &pSeg);
+
+    taosThreadMutexLock(&vnodeS3Cache.mutex);
+    pEntry->nRef--;
+    if (code && pEntry->nRef == 0) {
+      vnodeS3CacheRemoveEntry(pEntry);
+    }
+    taosThreadMutexUnlock(&vnodeS3Cache.mutex);
+
+    if (code) {
+      vWarn("s3 cache, failed to read %s since %s, read from s3", key, tstrerror(code));
+      code = vnodeS3CacheReadFp(object, segOffset, segSize, check, &pSeg);
+    }
+  } else {
+    code = vnodeS3CacheReadFp(object, segOffset, segSize, check, &pSeg);
+    int32_t wcode = code ? code : vnodeS3CacheWriteFile(key, pSeg, segSize);
+    if (code == 0 && wcode) {
+      vWarn("s3 cache, failed to write %s since %s", key, tstrerror(wcode));
+    }
+
+    taosThreadMutexLock(&vnodeS3Cache.mutex);
+    pEntry->nRef--;
+    pEntry->loading = false;
+    if (wcode) {
+      taosHashRemove(vnodeS3Cache.index, key, strlen(key));
+      taosMemoryFree(pEntry);
+    } else {
+      pEntry->size = segSize + sizeof(TSCKSUM);
+      TD_DLIST_PREPEND(&vnodeS3Cache.probation, pEntry);
+      vnodeS3Cache.size += pEntry->size;
+      vnodeS3CacheEvict();
+    }
+    taosThreadCondBroadcast(&vnodeS3Cache.loaded);
+    taosThreadMutexUnlock(&vnodeS3Cache.mutex);
+  }
+
+  if (code || ppSeg == NULL) {
+    taosMemoryFree(pSeg);
+  } else {
+    *ppSeg = pSeg;
+  }
+  return code;
+}
+
+static int32_t vnodeS3CachePrefetchTask(void *arg) {
+  SVS3CachePrefetch *pPrefetch = arg;
+  bool               hit = false;
+
+  int32_t code = vnodeS3CacheGetSeg(pPrefetch->object, pPrefetch->objSize, pPrefetch->segno, true, NULL, &hit);
+  if (code) {
+    vDebug("s3 cache, failed to read ahead %s segment:%" PRId64 " since %s", pPrefetch->object, pPrefetch->segno,
+           tstrerror(code));
+  } else if (!hit) {
+    atomic_add_fetch_64(&vnodeS3Cache.nReadAhead, 1);
+  }
+
+  atomic_sub_fetch_32(&vnodeS3Cache.nPrefetch, 1);
+  taosMemoryFree(pPrefetch);
+  return 0;
+}
+
+static void vnodeS3CachePrefetchCancel(void *arg) {
+  atomic_sub_fetch_32(&vnodeS3Cache.nPrefetch, 1);
+  taosMemoryFree(arg);
+}
+
+static bool vnodeS3CacheExists(const char *object, int64_t segno) {
+  char key[TSDB_FILENAME_LEN];
+  vnodeS3CacheKey(object, segno, key);
+
+  taosThreadMutexLock(&vnodeS3Cache.mutex);
+  bool exists = taosHashGet(vnodeS3Cache.index, key, strlen(key)) != NULL;
+  taosThreadMutexUnlock(&vnodeS3Cache.mutex);
+  return exists;
+}
+
+static void vnodeS3CacheSchedule(const char *object, int64_t objSize, int64_t segno) {
+  if (segno * VNODE_S3_CACHE_SEG_SIZE >= objSize || vnodeS3CacheExists(object, segno)) return;
+
+  if (atomic_add_fetch_32(&vnodeS3Cache.nPrefetch, 1) > VNODE_S3_CACHE_MAX_PREFETCH) {
+    atomic_sub_fetch_32(&vnodeS3Cache.nPrefetch, 1);
+    return;
+  }
+
+  SVS3CachePrefetch *pPrefetch = taosMemoryMalloc(sizeof(*pPrefetch));
+  if (pPrefetch == NULL) {
+    atomic_sub_fetch_32(&vnodeS3Cache.nPrefetch, 1);
+    return;
+  }
+  tstrncpy(pPrefetch->object, object, TSDB_FILENAME_LEN);
+  pPrefetch->objSize = objSize;
+  pPrefetch->segno = segno;
+
+  // read ahead in the merge pool with low priority, behind the merge tasks
+  SVAChannelID channel = {.async = 2, .id = 0};
+  if (vnodeAsync(&channel, EVA_PRIORITY_LOW, vnodeS3CachePrefetchTask, vnodeS3CachePrefetchCancel, pPrefetch, NULL)) {
+    vnodeS3CachePrefetchCancel(pPrefetch);
+  }
+}
+
+typedef struct {
+  int32_t         mtime;
+  SVS3CacheEntry *pEntry;
+} SVS3CacheFile;
+
+static int32_t vnodeS3CacheFileCmprFn(const void *p1, const void *p2) {
+  const SVS3CacheFile *pFile1 = p1;
+  const SVS3CacheFile *pFile2 = p2;
+
+  if (pFile1->mtime < pFile2->mtime) {
+    return -1;
+  } else if (pFile1->mtime > pFile2->mtime) {
+    return 1;
+  }
+  return 0;
+}
+
+static int32_t vnodeS3CacheLoad() {
+  int32_t  code = 0;
+  int32_t  suffixLen = strlen(VNODE_S3_CACHE_TMP_SUFFIX);
+  TdDirPtr pDir = taosOpenDir(tsS3CacheDir);
+  SArray  *aFile = taosArrayInit(1024, sizeof(SVS3CacheFile));
+
+  if (pDir == NULL) {
+    code = TAOS_SYSTEM_ERROR(errno);
+    goto _exit;
+  }
+  if (aFile == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _exit;
+  }
+
+  TdDirEntryPtr pDirEntry;
+  while ((pDirEntry = taosReadDir(pDir)) != NULL) {
+    if (taosDirEntryIsDir(pDirEntry)) continue;
+
+    char   *name = taosGetDirEntryName(pDirEntry);
+    int32_t len = strlen(name);
+    char    path[PATH_MAX];
+    vnodeS3CachePath(name, "", path);
+
+    // a segment not written completely
+    if (len >= TSDB_FILENAME_LEN ||
+        (len > suffixLen && strcmp(name + len - suffixLen, VNODE_S3_CACHE_TMP_SUFFIX) == 0)) {
+      taosRemoveFile(path);
+      continue;
+    }
+
+    SVS3CacheFile file = {0};
+    int64_t       size = 0;
+    if (taosStatFile(path, &size, &file.mtime, NULL) < 0) continue;
+
+    file.pEntry = taosMemoryCalloc(1, sizeof(SVS3CacheEntry));
+    if (file.pEntry == NULL) {
+      code = TSDB_CODE_OUT_OF_MEMORY;
+      goto _exit;
+    }
+    tstrncpy(file.pEntry->key, name, TSDB_FILENAME_LEN);
+    file.pEntry->size = size;
+    if (taosArrayPush(aFile, &file) == NULL) {
+      taosMemoryFree(file.pEntry);
+      code = TSDB_CODE_OUT_OF_MEMORY;
+      goto _exit;
+    }
+  }
+
+  // the newest file goes to the head
+  taosArraySort(aFile, vnodeS3CacheFileCmprFn);
+  for (int32_t i = 0; i < taosArrayGetSize(aFile); i++) {
+    SVS3CacheFile *pFile = taosArrayGet(aFile, i);
+    if (taosHashPut(vnodeS3Cache.index, pFile->pEntry->key, strlen(pFile->pEntry->key), &pFile->pEntry,
+                    POINTER_BYTES) != 0) {
+      code = TSDB_CODE_OUT_OF_MEMORY;
+      goto _exit;
+    }
+    TD_DLIST_PREPEND(&vnodeS3Cache.probation, pFile->pEntry);
+    vnodeS3Cache.size += pFile->pEntry->size;
+    pFile->pEntry = NULL;
+  }
+
+  vnodeS3CacheEvict();
+
+_exit:
+  for (int32_t i = 0; i < taosArrayGetSize(aFile); i++) {
+    taosMemoryFree(((SVS3CacheFile *)taosArrayGet(aFile, i))->pEntry);
+  }
+  taosArrayDestroy(aFile);
+  taosCloseDir(&pDir);
+  return code;
+}
+
+int32_t vnodeS3CacheOpen() {
+  int32_t code = 0;
+
+  if (!tsS3Enabled || tsS3CacheDir[0] == '\0' || tsS3CacheSizeMB <= 0) {
+    return 0;
+  }
+
+  if (taosMulMkDir(tsS3CacheDir) < 0) {
+    code = TAOS_SYSTEM_ERROR(errno);
+    vError("failed to create s3 cache dir:%s since %s", tsS3CacheDir, tstrerror(code));
+    return code;
+  }
+
+  vnodeS3Cache.capacity = (int64_t)tsS3CacheSizeMB * 1024 * 1024;
+  vnodeS3Cache.index = taosHashInit(1024, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY), true, HASH_NO_LOCK);
+  if (vnodeS3Cache.index == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+  TD_DLIST_INIT(&vnodeS3Cache.probation);
+  TD_DLIST_INIT(&vnodeS3Cache.protect);
+  taosThreadMutexInit(&vnodeS3Cache.mutex, NULL);
+  taosThreadCondInit(&vnodeS3Cache.loaded, NULL);
+
+  code = vnodeS3CacheLoad();
+  if (code) {
+    vError("failed to load s3 cache from dir:%s since %s", tsS3CacheDir, tstrerror(code));
+    vnodeS3CacheClose();
+    return code;
+  }
+
+  vnodeS3Cache.enabled = true;
+  vInfo("vnode s3 cache is opened, dir:%s segments:%d size:%" PRId64 "MB capacity:%dMB read ahead:%d", tsS3CacheDir,
+        taosHashGetSize(vnodeS3Cache.index), vnodeS3Cache.size / 1024 / 1024, tsS3CacheSizeMB, tsS3CacheReadAhead);
+  return 0;
+}
+
+void vnodeS3CacheClose() {
+  if (vnodeS3Cache.index == NULL) return;
+
+  if (vnodeS3Cache.enabled) {
+    vInfo("vnode s3 cache is closed, hit:%" PRId64 " miss:%" PRId64 " evict:%" PRId64 " read ahead:%" PRId64,
+          vnodeS3Cache.nHit, vnodeS3Cache.nMiss, vnodeS3Cache.nEvict, vnodeS3Cache.nReadAhead);
+  }
+  vnodeS3Cache.enabled = false;
+
+  void *pIter = taosHashIterate(vnodeS3Cache.index, NULL);
+  while (pIter) {
+    taosMemoryFree(*(SVS3CacheEntry **)pIter);
+    pIter = taosHashIterate(vnodeS3Cache.index, pIter);
+  }
+  taosHashCleanup(vnodeS3Cache.index);
+  vnodeS3Cache.index = NULL;
+  TD_DLIST_INIT(&vnodeS3Cache.probation);
+  TD_DLIST_INIT(&vnodeS3Cache.protect);
+  vnodeS3Cache.size = 0;
+  vnodeS3Cache.protectSize = 0;
+
+  taosThreadCondDestroy(&vnodeS3Cache.loaded);
+  taosThreadMutexDestroy(&vnodeS3Cache.mutex);
+}
+
+/**
+ * @brief read a range of an s3 object through the s3 cache
+ *
+ * @param objSize the size of the object, all segments but the last one are full
+ */
+int32_t vnodeS3CacheGet(const char *object, int64_t objSize, int64_t offset, int64_t size, bool check,
+                        uint8_t **ppBlock) {
+  int32_t code = 0;
+
+  if (!vnodeS3Cache.enabled) {
+    return vnodeS3CacheReadFp(object, offset, size, check, ppBlock);
+  }
+
+  uint8_t *pBlock = taosMemoryMalloc(size);
+  if (pBlock == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  int64_t segStart = offset / VNODE_S3_CACHE_SEG_SIZE;
+  int64_t segEnd = (offset + size - 1) / VNODE_S3_CACHE_SEG_SIZE;
+  bool    missed = false;
+  for (int64_t segno = segStart; segno <= segEnd; segno++) {
+    uint8_t *pSeg = NULL;
+    bool     hit = false;
+
+    code = vnodeS3CacheGetSeg(object, objSize, segno, check, &pSeg, &hit);
+    if (code) {
+      taosMemoryFree(pBlock);
+      return code;
+    }
+    missed = missed || !hit;
+
+    int64_t segOffset = segno * VNODE_S3_CACHE_SEG_SIZE;
+    int64_t start = TMAX(offset, segOffset);
+    int64_t end = TMIN(offset + size, segOffset + VNODE_S3_CACHE_SEG_SIZE);
+    memcpy(pBlock + start - offset, pSeg + start - segOffset, end - start);
+    taosMemoryFree(pSeg);
+  }
+
+  // a miss right after the previous segment is a sequential scan, read the next segments ahead
+  if (missed && segStart > 0 && tsS3CacheReadAhead > 0 && vnodeS3CacheExists(object, segStart - 1)) {
+    for (int64_t segno = segEnd + 1; segno <= segEnd + tsS3CacheReadAhead; segno++) {
+      vnodeS3CacheSchedule(object, objSize, segno);
+    }
+  }
+
+  *ppBlock = pBlock;
+  return code;
+}
+
+/**
+ * @brief load the segments of a range of an s3 object into the s3 cache in background
+ */
+void vnodeS3CachePrefetch(const char *object, int64_t objSize, int64_t offset, int64_t size) {
+  if (!vnodeS3Cache.enabled || size <= 0) return;
+
+  for (int64_t segno = offset / VNODE_S3_CACHE_SEG_SIZE; segno <= (offset + size - 1) / VNODE_S3_CACHE_SEG_SIZE;
+       segno++) {
+    vnodeS3CacheSchedule(object, objSize, segno);
+  }
+}
@@ -1618,46 +1618,100 @@ static int32_t vnodeRebuildSubmitReqMsg(SSubmitReq2 *pSubmitReq, void **ppMsg) {
   return code;
 }
 
-static int32_t vnodeProcessSubmitReq(SVnode *pVnode, int64_t ver, void *pReq, int32_t len, SRpcMsg *pRsp,
-                                     SRpcMsg *pOriginalMsg) {
-  int32_t code = 0;
-  terrno = 0;
+#define VNODE_APPLY_ASYNC_ID   3
+#define VNODE_APPLY_MIN_TABLES 16  // a submit with fewer tables is applied serially
 
-  SSubmitReq2 *pSubmitReq = &(SSubmitReq2){0};
-  SSubmitRsp2 *pSubmitRsp = &(SSubmitRsp2){0};
-  SArray      *newTbUids = NULL;
-  int32_t      ret;
-  SEncoder     ec = {0};
+typedef struct {
+  SVnode      *pVnode;
+  int64_t      ver;
+  SSubmitReq2 *pSubmitReq;
+  int32_t      nSlice;
+  int32_t      iSlice;
+  int64_t      affectedRows;
+  int32_t      code;
+} SVApplySlice;
 
-  pRsp->code = TSDB_CODE_SUCCESS;
+// The tables of a submit are split into slices by uid, so all rows of a table are applied by one slice in submit order.
+static int32_t vnodeApplySubmitSlice(void *arg) {
+  SVApplySlice *pSlice = (SVApplySlice *)arg;
 
-  void           *pAllocMsg = NULL;
-  SSubmitReq2Msg *pMsg = (SSubmitReq2Msg *)pReq;
-  if (0 == pMsg->version) {
-    code = vnodeSubmitReqConvertToSubmitReq2(pVnode, (SSubmitReq *)pMsg, pSubmitReq);
-    if (TSDB_CODE_SUCCESS == code) {
-      code = vnodeRebuildSubmitReqMsg(pSubmitReq, &pReq);
-    }
-    if (TSDB_CODE_SUCCESS == code) {
-      pAllocMsg = pReq;
+  pSlice->code = 0;
+  for (int32_t i = 0; i < TARRAY_SIZE(pSlice->pSubmitReq->aSubmitTbData); ++i) {
+    SSubmitTbData *pSubmitTbData = taosArrayGet(pSlice->pSubmitReq->aSubmitTbData, i);
+    if (TABS(pSubmitTbData->uid) % pSlice->nSlice != pSlice->iSlice) continue;
+
+    int32_t affectedRows = 0;
+    pSlice->code = tsdbInsertTableData(pSlice->pVnode->pTsdb, pSlice->ver, pSubmitTbData, &affectedRows);
+    if (pSlice->code) break;
+
+    pSlice->affectedRows += affectedRows;
+  }
+
+  return pSlice->code;
+}
+
+static bool vnodeShouldApplyInParallel(SSubmitReq2 *pSubmitReq) {
+  return tsNumOfApplyThreads > 0 && TARRAY_SIZE(pSubmitReq->aSubmitTbData) >= VNODE_APPLY_MIN_TABLES;
+}
+
+// Apply the tables of a submit by the vnode-apply workers together with the calling thread. A submit is one WAL
+// entry and the next one is not applied before this returns, so the apply order of the WAL is kept.
+int32_t vnodeApplySubmitInParallel(SVnode *pVnode, int64_t ver, SSubmitReq2 *pSubmitReq, int32_t *affectedRows) {
+  int32_t       code = 0;
+  int32_t       nSlice = TMIN(tsNumOfApplyThreads + 1, (int32_t)TARRAY_SIZE(pSubmitReq->aSubmitTbData));
+  SVApplySlice *aSlice = taosMemoryCalloc(nSlice, sizeof(SVApplySlice));
+  SVATaskID    *aTask = taosMemoryCalloc(nSlice, sizeof(SVATaskID));
+  SVAChannelID  channelID = {.async = VNODE_APPLY_ASYNC_ID, .id = 0};
+
+  if (aSlice == NULL || aTask == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _exit;
+  }
+
+  for (int32_t i = 0; i < nSlice; i++) {
+    aSlice[i] = (SVApplySlice){
+        .pVnode = pVnode,
+        .ver = ver,
+        .pSubmitReq = pSubmitReq,
+        .nSlice = nSlice,
+        .iSlice = i,
+        .code = TSDB_CODE_VND_STOPPED,  // kept if the task is cancelled before it runs
+    };
+  }
+
+  // slice 0 is applied by the calling thread, and a slice failed to schedule is applied in place
+  for (int32_t i = 1; i < nSlice; i++) {
+    if (vnodeAsync(&channelID, EVA_PRIORITY_HIGH, vnodeApplySubmitSlice, NULL, &aSlice[i], &aTask[i]) != 0) {
+      (void)vnodeApplySubmitSlice(&aSlice[i]);
     }
-    if (TSDB_CODE_SUCCESS != code) {
-      goto _exit;
+  }
+  (void)vnodeApplySubmitSlice(&aSlice[0]);
+
+  for (int32_t i = 1; i < nSlice; i++) {
+    if (aTask[i].id > 0) {
+      (void)vnodeAWait(&aTask[i]);
     }
-  } else {
-    // decode
-    pReq = POINTER_SHIFT(pReq, sizeof(SSubmitReq2Msg));
-    len -= sizeof(SSubmitReq2Msg);
-    SDecoder dc = {0};
-    tDecoderInit(&dc, pReq, len);
-    if (tDecodeSubmitReq(&dc, pSubmitReq) < 0) {
-      code = TSDB_CODE_INVALID_MSG;
-      goto _exit;
+  }
+
+  for (int32_t i = 0; i < nSlice; i++) {
+    if (aSlice[i].code && code == 0) {
+      code = aSlice[i].code;
     }
-    tDecoderClear(&dc);
+    *affectedRows += aSlice[i].affectedRows;
   }
 
-  // scan
+_exit:
+  taosMemoryFree(aSlice);
+  taosMemoryFree(aTask);
+  return code;
+}
+
+/**
+ * @brief check the rows of a submit decoded are in the keep range and sorted by key
+ */
+int32_t vnodeScanSubmitReq(SVnode *pVnode, int64_t ver, SSubmitReq2 *pSubmitReq) {
+  int32_t code = 0;
+
   TSKEY now = taosGetTimestamp(pVnode->config.tsdbCfg.precision);
   TSKEY minKey = now - tsTickPerMin[pVnode->config.tsdbCfg.precision] * pVnode->config.tsdbCfg.keep2;
   TSKEY maxKey = tsMaxKeyByPrecision[pVnode->config.tsdbCfg.precision];
@@ -1666,13 +1720,13 @@ static int32_t vnodeProcessSubmitReq(SVnode *pVnode, int64_t ver, void *pReq, in
 
     if (pSubmitTbData->pCreateTbReq && pSubmitTbData->pCreateTbReq->uid == 0) {
       code = TSDB_CODE_INVALID_MSG;
-      goto _exit;
+      return code;
     }
 
     if (pSubmitTbData->flags & SUBMIT_REQ_COLUMN_DATA_FORMAT) {
       if (TARRAY_SIZE(pSubmitTbData->aCol) <= 0) {
         code = TSDB_CODE_INVALID_MSG;
-        goto _exit;
+        return code;
       }
 
       SColData *colDataArr = TARRAY_DATA(pSubmitTbData->aCol);
@@ -1684,7 +1738,7 @@ static int32_t vnodeProcessSubmitReq(SVnode *pVnode, int64_t ver, void *pReq, in
         if (tRowKeyCompare(&lastKey, &key) >= 0) {
           code = TSDB_CODE_INVALID_MSG;
           vError("vgId:%d %s failed 1 since %s, version:%" PRId64, TD_VID(pVnode), __func__, tstrerror(terrno), ver);
-          goto _exit;
+          return code;
         }
       }
     } else {
@@ -1695,7 +1749,7 @@ static int32_t vnodeProcessSubmitReq(SVnode *pVnode, int64_t ver, void *pReq, in
         if (aRow[iRow]->ts < minKey || aRow[iRow]->ts > maxKey) {
           code = TSDB_CODE_INVALID_MSG;
           vError("vgId:%d %s failed 2 since %s, version:%" PRId64, TD_VID(pVnode), __func__, tstrerror(code), ver);
-          goto _exit;
+          return code;
         }
         if (iRow == 0) {
           tRowGetKey(aRow[iRow], &lastRowKey);
@@ -1706,7 +1760,7 @@ static int32_t vnodeProcessSubmitReq(SVnode *pVnode, int64_t ver, void *pReq, in
           if (tRowKeyCompare(&lastRowKey, &rowKey) >= 0) {
             code = TSDB_CODE_INVALID_MSG;
             vError("vgId:%d %s failed 3 since %s, version:%" PRId64, TD_VID(pVnode), __func__, tstrerror(code), ver);
-            goto _exit;
+            return code;
           }
           lastRowKey = rowKey;
         }
@@ -1714,6 +1768,59 @@ static int32_t vnodeProcessSubmitReq(SVnode *pVnode, int64_t ver, void *pReq, in
     }
   }
 
+  return code;
+}
+
+static int32_t vnodeProcessSubmitReq(SVnode *pVnode, int64_t ver, void *pReq, int32_t len, SRpcMsg *pRsp,
+                                     SRpcMsg *pOriginalMsg) {
+  int32_t code = 0;
+  terrno = 0;
+
+  SSubmitReq2 *pSubmitReq = &(SSubmitReq2){0};
+  SSubmitRsp2 *pSubmitRsp = &(SSubmitRsp2){0};
+  SArray      *newTbUids = NULL;
+  int32_t      ret;
+  SEncoder     ec = {0};
+
+  pRsp->code = TSDB_CODE_SUCCESS;
+
+  void           *pAllocMsg = NULL;
+  void           *pReplayBuf = NULL;
+  SSubmitReq2Msg *pMsg = (SSubmitReq2Msg *)pReq;
+  if (0 == pMsg->version) {
+    code = vnodeSubmitReqConvertToSubmitReq2(pVnode, (SSubmitReq *)pMsg, pSubmitReq);
+    if (TSDB_CODE_SUCCESS == code) {
+      code = vnodeRebuildSubmitReqMsg(pSubmitReq, &pReq);
+    }
+    if (TSDB_CODE_SUCCESS == code) {
+      pAllocMsg = pReq;
+    }
+    if (TSDB_CODE_SUCCESS != code) {
+      goto _exit;
+    }
+  } else if (vnodeReplayTake(pVnode, ver, pReq, len, pSubmitReq, &pReplayBuf, &code)) {
+    pReq = POINTER_SHIFT(pReq, sizeof(SSubmitReq2Msg));
+    len -= sizeof(SSubmitReq2Msg);
+    if (code) goto _exit;
+  } else {
+    // decode
+    pReq = POINTER_SHIFT(pReq, sizeof(SSubmitReq2Msg));
+    len -= sizeof(SSubmitReq2Msg);
+    SDecoder dc = {0};
+    tDecoderInit(&dc, pReq, len);
+    if (tDecodeSubmitReq(&dc, pSubmitReq) < 0) {
+      code = TSDB_CODE_INVALID_MSG;
+      goto _exit;
+    }
+    tDecoderClear(&dc);
+  }
+
+  // scan, done by the replay already if the request is taken from it
+  if (pReplayBuf == NULL) {
+    code = vnodeScanSubmitReq(pVnode, ver, pSubmitReq);
+  }
+  if (code) goto _exit;
+
   for (int32_t i = 0; i < TARRAY_SIZE(pSubmitReq->aSubmitTbData); ++i) {
     SSubmitTbData *pSubmitTbData = taosArrayGet(pSubmitReq->aSubmitTbData, i);
 
@@ -1771,7 +1878,8 @@ static int32_t vnodeProcessSubmitReq(SVnode *pVnode, int64_t ver, void *pReq, in
 
   vDebug("vgId:%d, submit block size %d", TD_VID(pVnode), (int32_t)taosArrayGetSize(pSubmitReq->aSubmitTbData));
 
-  // loop to handle
+  // loop to handle, in parallel apply the tables are created here and the data is inserted below
+  bool parallel = vnodeShouldApplyInParallel(pSubmitReq);
   for (int32_t i = 0; i < TARRAY_SIZE(pSubmitReq->aSubmitTbData); ++i) {
     SSubmitTbData *pSubmitTbData = taosArrayGet(pSubmitReq->aSubmitTbData, i);
 
@@ -1814,6 +1922,8 @@ static int32_t vnodeProcessSubmitReq(SVnode *pVnode, int64_t ver, void *pReq, in
       }
     }
 
+    if (parallel) continue;
+
     // insert data
     int32_t affectedRows;
     code = tsdbInsertTableData(pVnode->pTsdb, ver, pSubmitTbData, &affectedRows);
@@ -1825,6 +1935,18 @@ static int32_t vnodeProcessSubmitReq(SVnode *pVnode, int64_t ver, void *pReq, in
     pSubmitRsp->affectedRows += affectedRows;
   }
 
+  if (parallel) {
+    code = vnodeApplySubmitInParallel(pVnode, ver, pSubmitReq, &pSubmitRsp->affectedRows);
+    if (code) goto _exit;
+
+    for (int32_t i = 0; i < TARRAY_SIZE(pSubmitReq->aSubmitTbData); ++i) {
+      SSubmitTbData *pSubmitTbData = taosArrayGet(pSubmitReq->aSubmitTbData, i);
+
+      code = metaUpdateChangeTimeWithLock(pVnode->pMeta, pSubmitTbData->uid, pSubmitTbData->ctimeMs);
+      if (code) goto _exit;
+    }
+  }
+
   // update the affected table uid list
   if (taosArrayGetSize(newTbUids) > 0) {
     vDebug("vgId:%d, add %d table into query table list in handling submit", TD_VID(pVnode),
@@ -1883,6 +2005,7 @@ _exit:
   taosArrayDestroy(newTbUids);
   tDestroySubmitReq(pSubmitReq, 0 == pMsg->version ? TSDB_MSG_FLG_CMPT : TSDB_MSG_FLG_DECODE);
   tDestroySSubmitRsp2(pSubmitRsp, TSDB_MSG_FLG_ENCODE);
+  taosMemoryFree(pReplayBuf);
 
   if (code) terrno = code;
 
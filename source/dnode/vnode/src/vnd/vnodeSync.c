@@ -562,6 +562,10 @@ static void vnodeRestoreFinish(const SSyncFSM *pFsm, const SyncIndex commitIdx)
   walApplyVer(pVnode->pWal, commitIdx);
   pVnode->restored = true;
 
+  if (tsdbCacheWarmupStart(pVnode->pTsdb) != 0) {
+    vWarn("vgId:%d, failed to start last cache warm-up", vgId);
+  }
+
   SStreamMeta *pMeta = pVnode->pTq->pStreamMeta;
   streamMetaWLock(pMeta);
 
@@ -0,0 +1,282 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <utility>
+#include <vector>
+
+#include "vnodeTestUtil.h"
+
+#include "tsdbReadUtil.h"
+
+namespace {
+
+const char    *kDir = TD_TMP_DIR_PATH "tsdbCacheBatchTest";
+const int32_t  kTables = 12;
+const tb_uid_t kUid = 1000;
+const int8_t   kLast = 1;  // LFLAG_LAST
+
+// the key of a last/last_row value, as the cache lays it out
+typedef struct {
+  tb_uid_t uid;
+  int16_t  cid;
+  int8_t   lflag;
+} SKey;
+const size_t kKeyLen = sizeof(tb_uid_t) + sizeof(int16_t) + sizeof(int8_t);
+
+// a key to look up and the index of its column in the reader
+typedef struct {
+  int  idx;
+  SKey key;
+} SIdxKey;
+
+// where the value of a column of a table is when the lookup starts
+enum { IN_LRU = 0, IN_ROCKS, IN_TSDB };
+
+int32_t placeOf(tb_uid_t uid, int16_t cid) { return (int32_t)((uid + cid) % 3); }
+
+// the loads from tsdb, (uid, the column ids), and the table whose load fails
+std::vector<std::pair<tb_uid_t, std::vector<int16_t>>> rawLoads;
+tb_uid_t                                              failUid = 0;
+
+SLastCol lastCol(tb_uid_t uid, int16_t cid) {
+  SLastCol col = {0};
+  col.rowKey.ts = 1600000000000 + uid * 10 + cid;
+  if (cid == PRIMARYKEY_TIMESTAMP_COL_ID) {
+    SValue value = {.type = TSDB_DATA_TYPE_TIMESTAMP};
+    value.val = col.rowKey.ts;
+    col.colVal = COL_VAL_VALUE(cid, value);
+  } else {
+    SValue value = {.type = TSDB_DATA_TYPE_INT};
+    value.val = (int32_t)(uid * 100 + cid);
+    col.colVal = COL_VAL_VALUE(cid, value);
+  }
+  return col;
+}
+
+int32_t fakeLoadRaw(STsdb *pTsdb, tb_uid_t uid, SArray *pLastArray, SArray *remainCols, SCacheRowsReader *pr,
+                    int8_t ltype) {
+  std::vector<int16_t> cids;
+  for (int32_t i = 0; i < (int32_t)taosArrayGetSize(remainCols); i++) {
+    SIdxKey *pIdxKey = (SIdxKey *)taosArrayGet(remainCols, i);
+    cids.push_back(pIdxKey->key.cid);
+
+    SLastCol col = lastCol(uid, pIdxKey->key.cid);
+    taosArraySet(pLastArray, pIdxKey->idx, &col);
+  }
+  rawLoads.push_back(std::make_pair(uid, cids));
+  return uid == failUid ? TSDB_CODE_FAILED : 0;
+}
+
+void lastColDeleter(const void *key, size_t klen, void *value, void *ud) { taosMemoryFree(value); }
+
+class TsdbCacheBatchTest : public VnodeTestBase {
+ protected:
+  void SetUp() override {
+    taosRemoveDir(kDir);
+    ASSERT_EQ(taosMulMkDir(kDir), 0);
+
+    ASSERT_NO_FATAL_FAILURE(VnodeTestBase::SetUp());
+    pVnode->config.cacheLast = 1;
+    pVnode->config.cacheLastSize = 16;
+    pVnode->config.cacheBackend = TSDB_CACHE_BACKEND_ROCKSDB;
+    pTsdb->path = (char *)kDir;
+    ASSERT_EQ(tsdbOpenCache(pTsdb), 0);
+    cacheOpened = true;
+
+    pTSchema = buildSchema();
+    ASSERT_NE(pTSchema, nullptr);
+
+    // the last values of both columns of each table
+    memset(&reader, 0, sizeof(reader));
+    reader.pTsdb = pTsdb;
+    reader.pSchema = pTSchema;
+    reader.pCidList = taosArrayInit(2, sizeof(int16_t));
+    ASSERT_NE(reader.pCidList, nullptr);
+    for (int16_t i = 0; i < pTSchema->numOfCols; i++) {
+      taosArrayPush(reader.pCidList, &pTSchema->columns[i].colId);
+      aSlotId[i] = i;
+    }
+    reader.pSlotIds = aSlotId;
+
+    rawLoads.clear();
+    failUid = 0;
+    oldLoadRaw = tsdbCacheSetLoadRaw(fakeLoadRaw);
+
+    // the values of the rocks place are committed to rocksdb and dropped from the lru
+    ASSERT_NO_FATAL_FAILURE(fill(IN_ROCKS, 1));
+    ASSERT_EQ(tsdbCacheCommit(pTsdb), 0);
+    taosLRUCacheEraseUnrefEntries(pTsdb->lruCache);
+    ASSERT_EQ(taosLRUCacheGetElems(pTsdb->lruCache), 0);
+  }
+
+  void TearDown() override {
+    tsdbCacheSetLoadRaw(oldLoadRaw);
+    taosArrayDestroy(reader.pCidList);
+    tDestroyTSchema(pTSchema);
+    if (cacheOpened) tsdbCloseCache(pTsdb);
+    VnodeTestBase::TearDown();
+    taosRemoveDir(kDir);
+  }
+
+  // put the values of a place into the lru
+  void fill(int32_t place, int8_t dirty) {
+    for (tb_uid_t uid = kUid; uid < kUid + kTables; uid++) {
+      for (int16_t i = 0; i < pTSchema->numOfCols; i++) {
+        int16_t cid = pTSchema->columns[i].colId;
+        if (placeOf(uid, cid) != place) continue;
+
+        SLastCol *pLastCol = (SLastCol *)taosMemoryCalloc(1, sizeof(SLastCol));
+        ASSERT_NE(pLastCol, nullptr);
+        *pLastCol = lastCol(uid, cid);
+        pLastCol->dirty = dirty;
+
+        SKey key = {0};  // the padding is not a part of the key, zero it anyway
+        key.uid = uid;
+        key.cid = cid;
+        key.lflag = kLast;
+        ASSERT_EQ(taosLRUCacheInsert(pTsdb->lruCache, &key, kKeyLen, pLastCol, sizeof(SLastCol), lastColDeleter, NULL,
+                                     TAOS_LRU_PRIORITY_LOW, NULL),
+                  TAOS_LRU_STATUS_OK);
+      }
+    }
+  }
+
+  // the lru holds the values of the lru place only, rocksdb those of the rocks place
+  void reset() {
+    taosLRUCacheEraseUnrefEntries(pTsdb->lruCache);
+    ASSERT_NO_FATAL_FAILURE(fill(IN_LRU, 0));
+    rawLoads.clear();
+  }
+
+  std::vector<SArray *> newArrays() {
+    std::vector<SArray *> aLastArray;
+    for (int32_t t = 0; t < kTables; t++) {
+      aLastArray.push_back(taosArrayInit(2, sizeof(SLastCol)));
+    }
+    return aLastArray;
+  }
+
+  static void destroyArrays(std::vector<SArray *> &aLastArray) {
+    for (SArray *pLastArray : aLastArray) taosArrayDestroy(pLastArray);
+    aLastArray.clear();
+  }
+
+  // the last values of every table got are the ones put
+  void check(const std::vector<SArray *> &aLastArray) {
+    ASSERT_EQ((int32_t)aLastArray.size(), kTables);
+    for (int32_t t = 0; t < kTables; t++) {
+      ASSERT_EQ((int32_t)taosArrayGetSize(aLastArray[t]), pTSchema->numOfCols);
+      for (int32_t i = 0; i < pTSchema->numOfCols; i++) {
+        SLastCol *pLastCol = (SLastCol *)taosArrayGet(aLastArray[t], i);
+        SLastCol  expect = lastCol(kUid + t, pTSchema->columns[i].colId);
+        EXPECT_EQ(pLastCol->rowKey.ts, expect.rowKey.ts);
+        EXPECT_EQ(pLastCol->colVal.cid, expect.colVal.cid);
+        EXPECT_TRUE(COL_VAL_IS_VALUE(&pLastCol->colVal));
+        EXPECT_EQ(pLastCol->colVal.value.type, expect.colVal.value.type);
+        EXPECT_EQ(pLastCol->colVal.value.val, expect.colVal.value.val);
+      }
+    }
+  }
+
+  STSchema         *pTSchema = nullptr;
+  SCacheRowsReader  reader;
+  int32_t           aSlotId[2];
+  FTsdbCacheLoadRaw oldLoadRaw = NULL;
+  bool              cacheOpened = false;
+};
+
+}  // namespace
+
+TEST_F(TsdbCacheBatchTest, same_as_per_table) {
+  std::vector<STableKeyInfo> aTable;
+  for (tb_uid_t uid = kUid; uid < kUid + kTables; uid++) {
+    STableKeyInfo info = {(uint64_t)uid, 0};
+    aTable.push_back(info);
+  }
+
+  // a table at a time
+  ASSERT_NO_FATAL_FAILURE(reset());
+  std::vector<SArray *> aLastArray = newArrays();
+  for (int32_t t = 0; t < kTables; t++) {
+    ASSERT_EQ(tsdbCacheGetBatch(pTsdb, kUid + t, aLastArray[t], &reader, kLast), 0);
+  }
+  check(aLastArray);
+  destroyArrays(aLastArray);
+  auto expectLoads = rawLoads;
+
+  // only the columns in neither the lru nor rocksdb are loaded from tsdb, table by table
+  std::vector<std::pair<tb_uid_t, std::vector<int16_t>>> aLoad;
+  for (tb_uid_t uid = kUid; uid < kUid + kTables; uid++) {
+    std::vector<int16_t> cids;
+    for (int16_t i = 0; i < pTSchema->numOfCols; i++) {
+      if (placeOf(uid, pTSchema->columns[i].colId) == IN_TSDB) cids.push_back(pTSchema->columns[i].colId);
+    }
+    if (!cids.empty()) aLoad.push_back(std::make_pair(uid, cids));
+  }
+  EXPECT_EQ(expectLoads, aLoad);
+
+  // the tables together, from the same state
+  ASSERT_NO_FATAL_FAILURE(reset());
+  aLastArray = newArrays();
+  ASSERT_EQ(tsdbCacheGetTablesBatch(pTsdb, aTable.data(), kTables, aLastArray.data(), &reader, kLast), 0);
+  check(aLastArray);
+  destroyArrays(aLastArray);
+  EXPECT_EQ(rawLoads, expectLoads);
+
+  // the values read from rocksdb are in the lru now, only the ones from tsdb are missed again
+  rawLoads.clear();
+  aLastArray = newArrays();
+  ASSERT_EQ(tsdbCacheGetTablesBatch(pTsdb, aTable.data(), kTables, aLastArray.data(), &reader, kLast), 0);
+  check(aLastArray);
+  destroyArrays(aLastArray);
+  EXPECT_EQ(rawLoads, expectLoads);
+}
+
+TEST_F(TsdbCacheBatchTest, all_in_lru) {
+  ASSERT_NO_FATAL_FAILURE(reset());
+  ASSERT_NO_FATAL_FAILURE(fill(IN_ROCKS, 0));
+  ASSERT_NO_FATAL_FAILURE(fill(IN_TSDB, 0));
+
+  std::vector<STableKeyInfo> aTable;
+  for (tb_uid_t uid = kUid; uid < kUid + kTables; uid++) {
+    STableKeyInfo info = {(uint64_t)uid, 0};
+    aTable.push_back(info);
+  }
+
+  std::vector<SArray *> aLastArray = newArrays();
+  ASSERT_EQ(tsdbCacheGetTablesBatch(pTsdb, aTable.data(), kTables, aLastArray.data(), &reader, kLast), 0);
+  check(aLastArray);
+  destroyArrays(aLastArray);
+  EXPECT_TRUE(rawLoads.empty());
+}
+
+TEST_F(TsdbCacheBatchTest, load_error) {
+  std::vector<STableKeyInfo> aTable;
+  for (tb_uid_t uid = kUid; uid < kUid + kTables; uid++) {
+    STableKeyInfo info = {(uint64_t)uid, 0};
+    aTable.push_back(info);
+  }
+
+  // the load of a table in the middle fails, the ones after it would succeed
+  ASSERT_NO_FATAL_FAILURE(reset());
+  failUid = kUid + kTables / 2;
+  std::vector<SArray *> aLastArray = newArrays();
+  EXPECT_EQ(tsdbCacheGetTablesBatch(pTsdb, aTable.data(), kTables, aLastArray.data(), &reader, kLast),
+            TSDB_CODE_FAILED);
+  destroyArrays(aLastArray);
+
+  ASSERT_FALSE(rawLoads.empty());
+  EXPECT_EQ(rawLoads.back().first, failUid);
+}
@@ -0,0 +1,265 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string>
+
+#include "vnodeTestUtil.h"
+
+namespace {
+
+const char   *kDir = TD_TMP_DIR_PATH "tsdbCacheSnapTest";
+const int32_t kTables = 100;
+
+// the key of a last/last_row value, as the cache lays it out
+typedef struct {
+  tb_uid_t uid;
+  int16_t  cid;
+  int8_t   lflag;
+} SKey;
+const size_t kKeyLen = sizeof(tb_uid_t) + sizeof(int16_t) + sizeof(int8_t);
+
+void lastColDeleter(const void *key, size_t klen, void *value, void *ud) {
+  SLastCol *pLastCol = (SLastCol *)value;
+  if (IS_VAR_DATA_TYPE(pLastCol->colVal.value.type)) {
+    taosMemoryFree(pLastCol->colVal.value.pData);
+  }
+  taosMemoryFree(pLastCol);
+}
+
+class TsdbCacheSnapTest : public VnodeTestBase {
+ protected:
+  void SetUp() override {
+    taosRemoveDir(kDir);
+    ASSERT_EQ(taosMulMkDir(kDir), 0);
+
+    ASSERT_NO_FATAL_FAILURE(VnodeTestBase::SetUp());
+    pVnode->config.cacheLast = 1;
+    pVnode->config.cacheBackend = TSDB_CACHE_BACKEND_MEM;
+    pVnode->state.committed = 100;
+    pVnode->state.applied = 100;
+
+    pTsdb->path = (char *)kDir;
+    pTsdb->flushState.pTsdb = pTsdb;
+    taosThreadMutexInit(&pTsdb->lruMutex, NULL);
+    pTsdb->lruCache = taosLRUCacheInit(16 * 1024 * 1024, 0, .5);
+    ASSERT_NE(pTsdb->lruCache, nullptr);
+  }
+
+  void TearDown() override {
+    taosLRUCacheEraseUnrefEntries(pTsdb->lruCache);
+    taosLRUCacheCleanup(pTsdb->lruCache);
+    taosThreadMutexDestroy(&pTsdb->lruMutex);
+    VnodeTestBase::TearDown();
+    taosRemoveDir(kDir);
+  }
+
+  // the last row values of an INT and a VARCHAR column, and the last value of the INT column of each table
+  void fill() {
+    for (int32_t i = 0; i < kTables; i++) {
+      put({1000 + i, 2, 0}, 1600000000000 + i, i);
+      put({1000 + i, 2, 1}, 1600000000000 + i - 1, i - 1);
+      put({1000 + i, 3, 0}, 1600000000000 + i, "v" + std::to_string(i));
+    }
+  }
+
+  void put(SKey key, TSKEY ts, int32_t val) {
+    SLastCol *pLastCol = (SLastCol *)taosMemoryCalloc(1, sizeof(SLastCol));
+    SValue    value = {.type = TSDB_DATA_TYPE_INT};
+    value.val = val;
+    pLastCol->rowKey.ts = ts;
+    pLastCol->colVal = COL_VAL_VALUE(key.cid, value);
+    insert(key, pLastCol, sizeof(SLastCol));
+  }
+
+  void put(SKey key, TSKEY ts, const std::string &val) {
+    SLastCol *pLastCol = (SLastCol *)taosMemoryCalloc(1, sizeof(SLastCol));
+    SValue    value = {.type = TSDB_DATA_TYPE_VARCHAR};
+    value.nData = val.size();
+    value.pData = (uint8_t *)taosMemoryMalloc(val.size());
+    memcpy(value.pData, val.data(), val.size());
+    pLastCol->rowKey.ts = ts;
+    pLastCol->colVal = COL_VAL_VALUE(key.cid, value);
+    insert(key, pLastCol, sizeof(SLastCol) + val.size());
+  }
+
+  void insert(SKey key, SLastCol *pLastCol, size_t charge) {
+    SKey k = {0};  // the padding is not a part of the key, zero it anyway
+    k.uid = key.uid;
+    k.cid = key.cid;
+    k.lflag = key.lflag;
+    ASSERT_EQ(taosLRUCacheInsert(pTsdb->lruCache, &k, kKeyLen, pLastCol, charge, lastColDeleter, NULL,
+                                 TAOS_LRU_PRIORITY_LOW, NULL),
+              TAOS_LRU_STATUS_OK);
+  }
+
+  // drop the lru as a restart does, and load the snapshot
+  void reopen(int64_t lastVer) {
+    taosLRUCacheEraseUnrefEntries(pTsdb->lruCache);
+    taosLRUCacheCleanup(pTsdb->lruCache);
+    pTsdb->lruCache = taosLRUCacheInit(16 * 1024 * 1024, 0, .5);
+    ASSERT_NE(pTsdb->lruCache, nullptr);
+    EXPECT_EQ(tsdbCacheLoadSnapshot(pTsdb, lastVer), 0);
+  }
+
+  // the values put by fill
+  void check() {
+    ASSERT_EQ(taosLRUCacheGetElems(pTsdb->lruCache), kTables * 3);
+    for (int32_t i = 0; i < kTables; i++) {
+      SLastCol *pLastCol = NULL;
+
+      LRUHandle *h = lookup({1000 + i, 2, 0}, &pLastCol);
+      ASSERT_NE(h, nullptr);
+      EXPECT_EQ(pLastCol->rowKey.ts, 1600000000000 + i);
+      EXPECT_EQ(pLastCol->colVal.value.type, TSDB_DATA_TYPE_INT);
+      EXPECT_EQ((int32_t)pLastCol->colVal.value.val, i);
+      EXPECT_EQ(pLastCol->dirty, 0);
+      taosLRUCacheRelease(pTsdb->lruCache, h, false);
+
+      h = lookup({1000 + i, 2, 1}, &pLastCol);
+      ASSERT_NE(h, nullptr);
+      EXPECT_EQ(pLastCol->rowKey.ts, 1600000000000 + i - 1);
+      EXPECT_EQ((int32_t)pLastCol->colVal.value.val, i - 1);
+      taosLRUCacheRelease(pTsdb->lruCache, h, false);
+
+      h = lookup({1000 + i, 3, 0}, &pLastCol);
+      ASSERT_NE(h, nullptr);
+      std::string expect = "v" + std::to_string(i);
+      EXPECT_EQ(pLastCol->colVal.value.type, TSDB_DATA_TYPE_VARCHAR);
+      ASSERT_EQ(pLastCol->colVal.value.nData, expect.size());
+      EXPECT_EQ(memcmp(pLastCol->colVal.value.pData, expect.data(), expect.size()), 0);
+      taosLRUCacheRelease(pTsdb->lruCache, h, false);
+    }
+  }
+
+  LRUHandle *lookup(SKey key, SLastCol **ppLastCol) {
+    SKey k = {0};
+    k.uid = key.uid;
+    k.cid = key.cid;
+    k.lflag = key.lflag;
+    LRUHandle *h = taosLRUCacheLookup(pTsdb->lruCache, &k, kKeyLen);
+    *ppLastCol = h ? (SLastCol *)taosLRUCacheValue(pTsdb->lruCache, h) : NULL;
+    return h;
+  }
+
+  std::string snapFile() { return std::string(kDir) + TD_DIRSEP + "cache.snap"; }
+};
+
+}  // namespace
+
+TEST_F(TsdbCacheSnapTest, reload) {
+  fill();
+  ASSERT_EQ(tsdbCacheSnapshot(pTsdb, 100), 0);
+  EXPECT_TRUE(taosCheckExistFile(snapFile().c_str()));
+  EXPECT_FALSE(taosCheckExistFile((snapFile() + ".t").c_str()));
+
+  // the values stay in the lru
+  check();
+
+  reopen(100);
+  check();
+}
+
+TEST_F(TsdbCacheSnapTest, reload_empty) {
+  ASSERT_EQ(tsdbCacheSnapshot(pTsdb, 100), 0);
+  reopen(100);
+  EXPECT_EQ(taosLRUCacheGetElems(pTsdb->lruCache), 0);
+}
+
+TEST_F(TsdbCacheSnapTest, applied_after_committed) {
+  // writes of versions 101 - 120 are applied while the commit of version 100 runs
+  pVnode->state.applied = 120;
+  fill();
+  ASSERT_EQ(tsdbCacheSnapshot(pTsdb, 100), 0);
+
+  // the wal lost versions after 110, the values may be of them, discard
+  reopen(110);
+  EXPECT_EQ(taosLRUCacheGetElems(pTsdb->lruCache), 0);
+
+  // the wal replays versions up to 120 or after, load
+  reopen(120);
+  check();
+  reopen(150);
+  check();
+}
+
+TEST_F(TsdbCacheSnapTest, discard_other_version) {
+  fill();
+  ASSERT_EQ(tsdbCacheSnapshot(pTsdb, 100), 0);
+
+  // the vnode opens at another committed version, e.g. the commit after the snapshot failed, or it is replaced by a
+  // snapshot of the leader
+  pVnode->state.committed = 90;
+  reopen(200);
+  EXPECT_EQ(taosLRUCacheGetElems(pTsdb->lruCache), 0);
+
+  pVnode->state.committed = 200;
+  reopen(200);
+  EXPECT_EQ(taosLRUCacheGetElems(pTsdb->lruCache), 0);
+
+  pVnode->state.committed = 100;
+  reopen(200);
+  check();
+}
+
+TEST_F(TsdbCacheSnapTest, discard_corrupted) {
+  fill();
+  ASSERT_EQ(tsdbCacheSnapshot(pTsdb, 100), 0);
+
+  int64_t size = 0;
+  ASSERT_EQ(taosStatFile(snapFile().c_str(), &size, NULL, NULL), 0);
+  ASSERT_GT(size, 1024);
+
+  // flip a byte of a value
+  TdFilePtr fd = taosOpenFile(snapFile().c_str(), TD_FILE_READ | TD_FILE_WRITE);
+  ASSERT_NE(fd, nullptr);
+  uint8_t byte = 0;
+  ASSERT_EQ(taosLSeekFile(fd, size / 2, SEEK_SET), size / 2);
+  ASSERT_EQ(taosReadFile(fd, &byte, 1), 1);
+  byte ^= 0xff;
+  ASSERT_EQ(taosLSeekFile(fd, size / 2, SEEK_SET), size / 2);
+  ASSERT_EQ(taosWriteFile(fd, &byte, 1), 1);
+  taosCloseFile(&fd);
+
+  reopen(100);
+  EXPECT_EQ(taosLRUCacheGetElems(pTsdb->lruCache), 0);
+
+  // truncated
+  fill();
+  ASSERT_EQ(tsdbCacheSnapshot(pTsdb, 100), 0);
+  fd = taosOpenFile(snapFile().c_str(), TD_FILE_WRITE);
+  ASSERT_NE(fd, nullptr);
+  ASSERT_EQ(taosFtruncateFile(fd, size / 2), 0);
+  taosCloseFile(&fd);
+
+  reopen(100);
+  EXPECT_EQ(taosLRUCacheGetElems(pTsdb->lruCache), 0);
+}
+
+TEST_F(TsdbCacheSnapTest, rocks_backend) {
+  // a snapshot is for the memory backend only
+  pVnode->config.cacheBackend = TSDB_CACHE_BACKEND_ROCKSDB;
+  fill();
+  ASSERT_EQ(tsdbCacheSnapshot(pTsdb, 100), 0);
+  EXPECT_FALSE(taosCheckExistFile(snapFile().c_str()));
+
+  // and the memory backend commits nothing to rocksdb, which it does not open
+  pVnode->config.cacheBackend = TSDB_CACHE_BACKEND_MEM;
+  EXPECT_EQ(tsdbCacheCommit(pTsdb), 0);
+  ASSERT_EQ(tsdbCacheSnapshot(pTsdb, 100), 0);
+
+  pVnode->config.cacheBackend = TSDB_CACHE_BACKEND_ROCKSDB;
+  reopen(100);
+  EXPECT_EQ(taosLRUCacheGetElems(pTsdb->lruCache), 0);
+}
@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "vnodeTestUtil.h"
+
+namespace {
+
+const int32_t kRows = 1000;
+
+// an INT column whose 10th rows are NULL
+void makeColData(SColData *pColData, int16_t cid, int32_t base) {
+  tColDataInit(pColData, cid, TSDB_DATA_TYPE_INT, 0);
+  for (int32_t i = 0; i < kRows; i++) {
+    SValue value = {.type = TSDB_DATA_TYPE_INT};
+    value.val = base + i;
+    SColVal colVal = (i % 10 == 9) ? COL_VAL_NULL(cid, TSDB_DATA_TYPE_INT) : COL_VAL_VALUE(cid, value);
+    ASSERT_EQ(tColDataAppendValue(pColData, &colVal), 0);
+  }
+}
+
+class TsdbColDataCacheTest : public VnodeTestBase {
+ protected:
+  void SetUp() override {
+    ASSERT_NO_FATAL_FAILURE(VnodeTestBase::SetUp());
+    pTsdb->cdCache = taosLRUCacheInit(16 * 1024 * 1024, 0, .5);
+    ASSERT_NE(pTsdb->cdCache, nullptr);
+  }
+
+  void TearDown() override {
+    if (pTsdb->cdCache != NULL) {
+      taosLRUCacheEraseUnrefEntries(pTsdb->cdCache);
+      taosLRUCacheCleanup(pTsdb->cdCache);
+    }
+    VnodeTestBase::TearDown();
+  }
+
+  void put(int32_t fid, int64_t cid, int64_t blockOffset, int16_t colId) {
+    SColData colData;
+    makeColData(&colData, colId, (int32_t)(fid * 1000 + cid * 100 + blockOffset));
+    ASSERT_EQ(tsdbColDataCachePut(pTsdb, fid, cid, blockOffset, &colData), 0);
+    tColDataDestroy(&colData);
+  }
+
+  // look up a column, check its content if it is cached
+  bool get(int32_t fid, int64_t cid, int64_t blockOffset, int16_t colId) {
+    SBlockData bData = {0};
+    bool       hit = false;
+
+    EXPECT_EQ(tBlockDataCreate(&bData), 0);
+    EXPECT_EQ(tsdbColDataCacheGet(pTsdb, fid, cid, blockOffset, colId, &bData, &hit), 0);
+    if (hit) {
+      SColData expect;
+      makeColData(&expect, colId, (int32_t)(fid * 1000 + cid * 100 + blockOffset));
+
+      SColData *pColData = tBlockDataGetColData(&bData, colId);
+      EXPECT_NE(pColData, nullptr);
+      if (pColData != NULL) {
+        EXPECT_EQ(pColData->nVal, expect.nVal);
+        EXPECT_EQ(pColData->flag, expect.flag);
+        EXPECT_EQ(pColData->numOfNull, expect.numOfNull);
+        for (int32_t i = 0; i < pColData->nVal && i < expect.nVal; i++) {
+          SColVal cv, ecv;
+          tColDataGetValue(pColData, i, &cv);
+          tColDataGetValue(&expect, i, &ecv);
+          EXPECT_EQ(cv.flag, ecv.flag);
+          if (COL_VAL_IS_VALUE(&ecv)) {
+            EXPECT_EQ((int32_t)cv.value.val, (int32_t)ecv.value.val);
+          }
+        }
+      }
+      tColDataDestroy(&expect);
+    }
+
+    tBlockDataDestroy(&bData);
+    return hit;
+  }
+};
+
+}  // namespace
+
+TEST_F(TsdbColDataCacheTest, hit_and_miss) {
+  put(1, 10, 100, 2);
+
+  EXPECT_TRUE(get(1, 10, 100, 2));
+  EXPECT_TRUE(get(1, 10, 100, 2));
+  EXPECT_FALSE(get(1, 10, 100, 3));  // another column
+  EXPECT_FALSE(get(1, 10, 200, 2));  // another block
+  EXPECT_FALSE(get(1, 11, 100, 2));  // the data file is rewritten
+
+  int64_t hit = 0, miss = 0;
+  size_t  usage = 0;
+  tsdbColDataCacheGetStat(pTsdb, &hit, &miss, &usage);
+  EXPECT_EQ(hit, 2);
+  EXPECT_EQ(miss, 3);
+  EXPECT_GT(usage, kRows * sizeof(int32_t));
+}
+
+TEST_F(TsdbColDataCacheTest, invalidate_on_commit) {
+  put(1, 10, 100, 2);
+  put(1, 10, 200, 2);
+  put(1, 11, 100, 2);
+  put(2, 10, 100, 2);
+
+  // a commit replaces the data file of fid 1 with commit id 10, as apply_commit does
+  tsdbColDataCacheInvalidate(pTsdb, 1, 10);
+
+  EXPECT_FALSE(get(1, 10, 100, 2));
+  EXPECT_FALSE(get(1, 10, 200, 2));
+  EXPECT_TRUE(get(1, 11, 100, 2));
+  EXPECT_TRUE(get(2, 10, 100, 2));
+
+  int64_t hit = 0, miss = 0;
+  size_t  usage = 0;
+  tsdbColDataCacheGetStat(pTsdb, &hit, &miss, &usage);
+  EXPECT_EQ(hit, 2);
+  EXPECT_EQ(miss, 2);
+  EXPECT_EQ(taosLRUCacheGetElems(pTsdb->cdCache), 2);
+}
+
+TEST_F(TsdbColDataCacheTest, disabled) {
+  taosLRUCacheCleanup(pTsdb->cdCache);
+  pTsdb->cdCache = NULL;
+
+  put(1, 10, 100, 2);
+  EXPECT_FALSE(get(1, 10, 100, 2));
+  tsdbColDataCacheInvalidate(pTsdb, 1, 10);
+
+  int64_t hit = 0, miss = 0;
+  size_t  usage = 0;
+  tsdbColDataCacheGetStat(pTsdb, &hit, &miss, &usage);
+  EXPECT_EQ(hit, 0);
+  EXPECT_EQ(miss, 0);
+  EXPECT_EQ(usage, 0);
+}
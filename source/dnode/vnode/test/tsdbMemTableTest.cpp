@@ -0,0 +1,214 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <utility>
+#include <vector>
+
+#include "vnodeTestUtil.h"
+
+namespace {
+
+const tb_uid_t kSuid = 0;
+const tb_uid_t kUid = 1001;
+
+// (ts, version) of a row, the INT column of the row keeps ts * 100 + version
+typedef std::pair<TSKEY, int64_t> RowKey;
+
+class TsdbMemTableTest : public VnodeTestBase {
+ protected:
+  void SetUp() override {
+    ASSERT_NO_FATAL_FAILURE(VnodeTestBase::SetUp());
+    ASSERT_NO_FATAL_FAILURE(openMemTable());
+    pTSchema = buildSchema();
+    ASSERT_NE(pTSchema, nullptr);
+  }
+
+  void TearDown() override {
+    tDestroyTSchema(pTSchema);
+    VnodeTestBase::TearDown();
+  }
+
+  // insert the rows of a submit in the given (sorted) key order at a version
+  void insert(const std::vector<TSKEY> &keys, int64_t version) {
+    SSubmitTbData submitTbData = {0};
+    submitTbData.suid = kSuid;
+    submitTbData.uid = kUid;
+    submitTbData.sver = 1;
+    submitTbData.aRowP = taosArrayInit(keys.size(), sizeof(SRow *));
+    ASSERT_NE(submitTbData.aRowP, nullptr);
+
+    for (TSKEY ts : keys) {
+      SRow *pRow = buildRow(pTSchema, ts, (int32_t)(ts * 100 + version));
+      ASSERT_NE(pRow, nullptr);
+      taosArrayPush(submitTbData.aRowP, &pRow);
+    }
+
+    int32_t affectedRows = 0;
+    EXPECT_EQ(tsdbInsertTableData(pTsdb, version, &submitTbData, &affectedRows), 0);
+    EXPECT_EQ(affectedRows, (int32_t)keys.size());
+
+    destroyRows(submitTbData.aRowP);
+  }
+
+  // scan the table from a key, or the head/tail, and check the content of each row
+  std::vector<RowKey> scan(int8_t backward, STsdbRowKey *pFrom = NULL) {
+    std::vector<RowKey> rows;
+
+    STbData *pTbData = tsdbGetTbDataFromMemTable(pTsdb->mem, kSuid, kUid);
+    EXPECT_NE(pTbData, nullptr);
+    if (pTbData == NULL) return rows;
+
+    STbDataIter *pIter = NULL;
+    EXPECT_EQ(tsdbTbDataIterCreate(pTbData, pFrom, backward, &pIter), 0);
+    for (TSDBROW *pRow = tsdbTbDataIterGet(pIter); pRow != NULL;) {
+      TSKEY   ts = TSDBROW_TS(pRow);
+      int64_t version = TSDBROW_VERSION(pRow);
+
+      SColVal colVal;
+      tsdbRowGetColVal(pRow, pTSchema, 1, &colVal);
+      EXPECT_TRUE(COL_VAL_IS_VALUE(&colVal));
+      EXPECT_EQ((int32_t)colVal.value.val, (int32_t)(ts * 100 + version));
+
+      rows.push_back(RowKey(ts, version));
+      pRow = tsdbTbDataIterNext(pIter) ? tsdbTbDataIterGet(pIter) : NULL;
+    }
+    tsdbTbDataIterDestroy(pIter);
+
+    return rows;
+  }
+
+  STbData *tbData() { return tsdbGetTbDataFromMemTable(pTsdb->mem, kSuid, kUid); }
+
+  STSchema *pTSchema = nullptr;
+};
+
+std::vector<TSKEY> keyRange(TSKEY start, TSKEY end, TSKEY step) {
+  std::vector<TSKEY> keys;
+  for (TSKEY ts = start; ts < end; ts += step) keys.push_back(ts);
+  return keys;
+}
+
+STsdbRowKey rowKey(TSKEY ts, int64_t version) {
+  STsdbRowKey key = {0};
+  key.key.ts = ts;
+  key.key.numOfPKs = 0;
+  key.version = version;
+  return key;
+}
+
+}  // namespace
+
+TEST_F(TsdbMemTableTest, out_of_order_keys) {
+  insert(keyRange(0, 1000, 10), 1);  // in order, appended to the segment
+  insert(keyRange(5, 1000, 10), 2);  // out of order into the skip list, except 995 appended to the segment
+  insert(keyRange(1000, 1100, 1), 3);
+
+  STbData *pTbData = tbData();
+  ASSERT_NE(pTbData, nullptr);
+  EXPECT_EQ(pTbData->seg.size, 201);
+  EXPECT_EQ(pTbData->sl.size, 99);
+  EXPECT_EQ(tsdbGetNRowsInTbData(pTbData), 300);
+  EXPECT_EQ(pTbData->minKey, 0);
+  EXPECT_EQ(pTbData->maxKey, 1099);
+
+  std::vector<RowKey> expect;
+  for (TSKEY ts = 0; ts < 1000; ts += 5) expect.push_back(RowKey(ts, (ts % 10) ? 2 : 1));
+  for (TSKEY ts = 1000; ts < 1100; ts++) expect.push_back(RowKey(ts, 3));
+
+  EXPECT_EQ(scan(0), expect);
+  EXPECT_EQ(scan(1), std::vector<RowKey>(expect.rbegin(), expect.rend()));
+}
+
+TEST_F(TsdbMemTableTest, duplicate_keys) {
+  insert(keyRange(0, 100, 1), 1);
+  insert(keyRange(50, 150, 1), 2);   // 50 - 98 into the skip list, then appended from (99, 2)
+  insert(keyRange(0, 10, 1), 3);     // into the skip list, over the segment rows of version 1
+  insert(keyRange(149, 151, 1), 4);  // appended over the segment tail
+
+  STbData *pTbData = tbData();
+  ASSERT_NE(pTbData, nullptr);
+  EXPECT_EQ(tsdbGetNRowsInTbData(pTbData), 100 + 100 + 10 + 2);
+
+  // the versions of a key ascend in the forward scan, so the newest one is the last
+  std::vector<RowKey> expect;
+  for (TSKEY ts = 0; ts <= 150; ts++) {
+    if (ts < 100) expect.push_back(RowKey(ts, 1));
+    if (ts >= 50 && ts < 150) expect.push_back(RowKey(ts, 2));
+    if (ts < 10) expect.push_back(RowKey(ts, 3));
+    if (ts >= 149) expect.push_back(RowKey(ts, 4));
+  }
+
+  std::vector<RowKey> rows = scan(0);
+  EXPECT_EQ(rows, expect);
+
+  // and the newest one comes first in the backward scan
+  rows = scan(1);
+  EXPECT_EQ(rows, std::vector<RowKey>(expect.rbegin(), expect.rend()));
+  ASSERT_FALSE(rows.empty());
+  EXPECT_EQ(rows.front(), RowKey(150, 4));
+  EXPECT_EQ(rows.back(), RowKey(0, 1));
+}
+
+TEST_F(TsdbMemTableTest, scan_from_key) {
+  insert(keyRange(0, 1000, 10), 1);
+  insert(keyRange(5, 1000, 10), 2);
+  insert(keyRange(500, 510, 5), 3);  // 500 and 505 at a newer version, in the skip list
+
+  // forward from (500, 2): skips (500, 1) of the segment, and starts at (500, 3) of the skip list
+  STsdbRowKey from = rowKey(500, 2);
+  std::vector<RowKey> rows = scan(0, &from);
+  ASSERT_GE(rows.size(), 4);
+  EXPECT_EQ(rows[0], RowKey(500, 3));
+  EXPECT_EQ(rows[1], RowKey(505, 2));
+  EXPECT_EQ(rows[2], RowKey(505, 3));
+  EXPECT_EQ(rows[3], RowKey(510, 1));
+  EXPECT_EQ(rows.back(), RowKey(995, 2));
+
+  // backward from (505, 2): the last row not greater than it
+  from = rowKey(505, 2);
+  rows = scan(1, &from);
+  ASSERT_GE(rows.size(), 4);
+  EXPECT_EQ(rows[0], RowKey(505, 2));
+  EXPECT_EQ(rows[1], RowKey(500, 3));
+  EXPECT_EQ(rows[2], RowKey(500, 1));
+  EXPECT_EQ(rows[3], RowKey(495, 2));
+  EXPECT_EQ(rows.back(), RowKey(0, 1));
+
+  // beyond the both ends
+  from = rowKey(2000, 0);
+  EXPECT_TRUE(scan(0, &from).empty());
+  from = rowKey(-1, 0);
+  EXPECT_TRUE(scan(1, &from).empty());
+}
+
+TEST_F(TsdbMemTableTest, skip_list_only) {
+  insert(keyRange(500, 600, 1), 1);
+  insert(keyRange(0, 100, 1), 2);  // all before the segment
+
+  STbData *pTbData = tbData();
+  ASSERT_NE(pTbData, nullptr);
+  EXPECT_EQ(pTbData->seg.size, 100);
+  EXPECT_EQ(pTbData->sl.size, 100);
+
+  std::vector<RowKey> rows = scan(0);
+  ASSERT_EQ(rows.size(), 200);
+  EXPECT_EQ(rows[99], RowKey(99, 2));
+  EXPECT_EQ(rows[100], RowKey(500, 1));
+
+  rows = scan(1);
+  ASSERT_EQ(rows.size(), 200);
+  EXPECT_EQ(rows[99], RowKey(500, 1));
+  EXPECT_EQ(rows[100], RowKey(99, 2));
+}
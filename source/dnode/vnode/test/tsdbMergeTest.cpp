@@ -0,0 +1,242 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "tsdbMerge.h"
+
+namespace {
+
+struct SttFile {
+  int32_t level;
+  int64_t minVer;
+  int64_t maxVer;
+  int64_t size;
+  TSKEY   minKey;
+  TSKEY   maxKey;
+  int32_t nRead;
+};
+
+class TsdbMergeCandTest : public ::testing::Test {
+ protected:
+  void TearDown() override {
+    for (STFileObj *fobj : fobjs) taosMemoryFree(fobj);
+  }
+
+  // the candidates of the stt files, in the order of the file set: levels ascending, versions ascending in a level
+  std::vector<SMergeCand> cands(const std::vector<SttFile> &files) {
+    std::vector<SMergeCand> aCand;
+    for (const SttFile &file : files) {
+      STFileObj *fobj = (STFileObj *)taosMemoryCalloc(1, sizeof(STFileObj));
+      fobj->f->type = TSDB_FTYPE_STT;
+      fobj->f->cid = file.maxVer;  // commit ids grow with the versions
+      fobj->f->size = file.size;
+      fobj->f->minVer = file.minVer;
+      fobj->f->maxVer = file.maxVer;
+      fobj->f->stt->level = file.level;
+      fobj->nRead = file.nRead;
+      fobjs.push_back(fobj);
+
+      SMergeCand cand = {0};
+      cand.fobj = fobj;
+      cand.level = file.level;
+      cand.minKey = file.minKey;
+      cand.maxKey = file.maxKey;
+      aCand.push_back(cand);
+    }
+    return aCand;
+  }
+
+  std::vector<STFileObj *> fobjs;
+};
+
+// the version ranges of the picked files are adjacent, no other file has a version in between
+void checkAdjacent(const std::vector<SMergeCand> &aCand, int32_t start, int32_t sttTrigger) {
+  int64_t minVer = INT64_MAX, maxVer = INT64_MIN;
+  for (int32_t i = start; i < start + sttTrigger; i++) {
+    minVer = TMIN(minVer, aCand[i].fobj->f->minVer);
+    maxVer = TMAX(maxVer, aCand[i].fobj->f->maxVer);
+  }
+  for (int32_t i = 0; i < (int32_t)aCand.size(); i++) {
+    if (i >= start && i < start + sttTrigger) continue;
+    EXPECT_TRUE(aCand[i].fobj->f->maxVer < minVer || aCand[i].fobj->f->minVer > maxVer)
+        << "file of versions [" << aCand[i].fobj->f->minVer << ", " << aCand[i].fobj->f->maxVer
+        << "] is between the picked ones";
+  }
+}
+
+}  // namespace
+
+TEST_F(TsdbMergeCandTest, pick_adjacent_versions) {
+  // the oldest and the newest level-0 files overlap each other and score better than the large one in the middle
+  std::vector<SMergeCand> aCand = cands({
+      {0, 1, 10, 100, 0, 1000, 0},
+      {0, 11, 20, 200, 5000, 6000, 0},
+      {0, 21, 30, 100, 0, 1000, 0},
+  });
+  tsdbMergeCandScore(aCand.data(), aCand.size());
+  EXPECT_GT(aCand[0].score, aCand[1].score);
+  EXPECT_GT(aCand[2].score, aCand[1].score);
+
+  int32_t level = -1;
+  int32_t start = tsdbMergeCandPick(aCand.data(), aCand.size(), 2, &level);
+  ASSERT_EQ(start, 0);  // not the oldest and the newest, and a run of level 0 starts at its oldest file
+  EXPECT_EQ(level, 1);
+  EXPECT_EQ(aCand[0].fobj->f->minVer, 1);
+  EXPECT_EQ(aCand[1].fobj->f->minVer, 11);
+  checkAdjacent(aCand, start, 2);
+}
+
+TEST_F(TsdbMergeCandTest, pick_across_levels) {
+  // a level-1 file keeps the oldest data, level-0 files follow
+  std::vector<SMergeCand> aCand = cands({
+      {0, 41, 50, 100, 0, 100, 0},
+      {0, 51, 60, 100, 0, 100, 0},
+      {0, 61, 70, 100, 0, 100, 9},
+      {1, 1, 40, 400, 0, 100, 0},
+  });
+  tsdbMergeCandScore(aCand.data(), aCand.size());
+
+  int32_t level = -1;
+  int32_t start = tsdbMergeCandPick(aCand.data(), aCand.size(), 3, &level);
+
+  // sorted from the oldest: the level-1 file first
+  EXPECT_EQ(aCand[0].level, 1);
+  EXPECT_EQ(aCand[1].fobj->f->minVer, 41);
+  EXPECT_EQ(aCand[2].fobj->f->minVer, 51);
+  EXPECT_EQ(aCand[3].fobj->f->minVer, 61);
+
+  // the run of level-0 files from (41 - 50) puts newer data than the level-1 file to level 1, which is fine, but the
+  // run from (51 - 60) would leave (41 - 50) below the merged file, so only two runs are allowed
+  ASSERT_TRUE(start == 0 || start == 1);
+  EXPECT_EQ(level, start == 0 ? 2 : 1);
+  checkAdjacent(aCand, start, 3);
+}
+
+TEST_F(TsdbMergeCandTest, pick_each_start) {
+  // whatever scores the files have, the picked ones are adjacent and start at the oldest file of a level
+  for (int32_t hot = 0; hot < 6; hot++) {
+    std::vector<SttFile> files;
+    for (int32_t i = 0; i < 4; i++) {
+      files.push_back({0, 100 + i * 10, 109 + i * 10, 100, i * 10, i * 10 + 100, i == hot ? 100 : 0});
+    }
+    files.push_back({1, 50, 99, 200, 0, 1000, hot == 4 ? 100 : 0});
+    files.push_back({2, 1, 49, 800, 0, 1000, hot == 5 ? 100 : 0});
+
+    std::vector<SMergeCand> aCand = cands(files);
+    tsdbMergeCandScore(aCand.data(), aCand.size());
+
+    for (int32_t sttTrigger = 2; sttTrigger <= 4; sttTrigger++) {
+      std::vector<SMergeCand> sorted = aCand;
+      int32_t                 level = -1;
+      int32_t                 start = tsdbMergeCandPick(sorted.data(), sorted.size(), sttTrigger, &level);
+      ASSERT_GE(start, 0);
+      checkAdjacent(sorted, start, sttTrigger);
+      if (start > 0) {
+        EXPECT_GE(sorted[start - 1].level, level);
+      }
+      for (int32_t i = start; i < start + sttTrigger; i++) {
+        EXPECT_LE(sorted[i].level, level);
+      }
+    }
+  }
+}
+
+TEST_F(TsdbMergeCandTest, pick_none) {
+  std::vector<SMergeCand> aCand = cands({
+      {0, 1, 10, 100, 0, 1000, 0},
+      {0, 11, 20, 100, 0, 1000, 0},
+  });
+  tsdbMergeCandScore(aCand.data(), aCand.size());
+
+  int32_t level = -1;
+  EXPECT_EQ(tsdbMergeCandPick(aCand.data(), aCand.size(), 3, &level), -1);
+  EXPECT_EQ(tsdbMergeCandPick(aCand.data(), aCand.size(), 0, &level), -1);
+  EXPECT_EQ(level, -1);
+}
+
+TEST_F(TsdbMergeCandTest, score) {
+  std::vector<SMergeCand> aCand = cands({
+      {0, 1, 10, 100, 0, 999, 0},      // old and overlapped
+      {0, 11, 20, 100, 500, 1499, 0},  // half overlapped
+      {0, 21, 30, 100, 5000, 5999, 0}, // new and apart
+      {0, 31, 40, 400, 5000, 5999, 0}, // the same but large
+      {0, 41, 50, 100, 8000, 8999, 5}, // the newest but read
+  });
+  tsdbMergeCandScore(aCand.data(), aCand.size());
+
+  EXPECT_GT(aCand[0].score, aCand[1].score);
+  EXPECT_GT(aCand[2].score, aCand[3].score);
+  EXPECT_GT(aCand[4].score, aCand[3].score);
+}
+
+TEST(TsdbWriteAmpTest, edit_bytes) {
+  TFileOpArray opArr[1];
+  TARRAY2_INIT(opArr);
+
+  STFileOp op = {};
+
+  // a commit creates two stt files
+  op.optype = TSDB_FOP_CREATE;
+  op.nf.size = 1000;
+  ASSERT_EQ(TARRAY2_APPEND(opArr, op), 0);
+  op.nf.size = 500;
+  ASSERT_EQ(TARRAY2_APPEND(opArr, op), 0);
+  EXPECT_EQ(tsdbFSOpWrittenBytes(opArr), 1500);
+
+  STFileSystem *fs = (STFileSystem *)taosMemoryCalloc(1, sizeof(STFileSystem));
+  ASSERT_NE(fs, nullptr);
+  EXPECT_EQ(tsdbFSWriteAmp(fs), 0);  // nothing committed yet
+  fs->wBytes[TSDB_FEDIT_COMMIT] += tsdbFSOpWrittenBytes(opArr);
+  EXPECT_DOUBLE_EQ(tsdbFSWriteAmp(fs), 1.0);
+
+  // a merge removes them, creates a stt file and appends to the data file, removed files write nothing
+  TARRAY2_CLEAR(opArr, NULL);
+  memset(&op, 0, sizeof(op));
+  op.optype = TSDB_FOP_REMOVE;
+  op.of.size = 1000;
+  ASSERT_EQ(TARRAY2_APPEND(opArr, op), 0);
+  op.of.size = 500;
+  ASSERT_EQ(TARRAY2_APPEND(opArr, op), 0);
+
+  memset(&op, 0, sizeof(op));
+  op.optype = TSDB_FOP_CREATE;
+  op.nf.size = 600;
+  ASSERT_EQ(TARRAY2_APPEND(opArr, op), 0);
+
+  memset(&op, 0, sizeof(op));
+  op.optype = TSDB_FOP_MODIFY;
+  op.of.size = 4000;
+  op.nf.size = 4900;
+  ASSERT_EQ(TARRAY2_APPEND(opArr, op), 0);
+
+  // a data file shrunk by a modify writes nothing
+  op.of.size = 4000;
+  op.nf.size = 3000;
+  ASSERT_EQ(TARRAY2_APPEND(opArr, op), 0);
+
+  EXPECT_EQ(tsdbFSOpWrittenBytes(opArr), 1500);
+  fs->wBytes[TSDB_FEDIT_MERGE] += tsdbFSOpWrittenBytes(opArr);
+  EXPECT_DOUBLE_EQ(tsdbFSWriteAmp(fs), 2.0);
+
+  // a compact rewrites 1500 bytes more
+  fs->wBytes[TSDB_FEDIT_COMPACT] += 1500;
+  EXPECT_DOUBLE_EQ(tsdbFSWriteAmp(fs), 3.0);
+
+  taosMemoryFree(fs);
+  TARRAY2_DESTROY(opArr, NULL);
+}
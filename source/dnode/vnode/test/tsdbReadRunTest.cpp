@@ -0,0 +1,228 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "tdatablock.h"
+#include "tsdbReadUtil.h"
+
+namespace {
+
+const tb_uid_t kUid = 1001;
+const int32_t  kRows = 20;
+const int32_t  kCapacity = 64;
+const int32_t  kDupRow = 12;     // the row with the timestamp of the row before it
+const int32_t  kInvalidRow = 16;  // the row of a version out of the range of the reader
+const int64_t  kMaxVer = 50;
+
+TSKEY rowTs(int32_t iRow) { return 100 + 10 * (iRow < kDupRow ? iRow : iRow - 1); }
+
+// c1 is NULL on every 3rd row, c2 is NULL on all rows
+bool c1IsNull(int32_t iRow) { return iRow % 3 == 0; }
+int32_t c1Val(int32_t iRow) { return iRow * 7; }
+
+class TsdbReadRunTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    SSchema aSchema[3] = {0};
+    aSchema[0].type = TSDB_DATA_TYPE_TIMESTAMP;
+    aSchema[0].colId = PRIMARYKEY_TIMESTAMP_COL_ID;
+    aSchema[0].bytes = TYPE_BYTES[TSDB_DATA_TYPE_TIMESTAMP];
+    for (int32_t i = 1; i < 3; i++) {
+      aSchema[i].type = TSDB_DATA_TYPE_INT;
+      aSchema[i].colId = PRIMARYKEY_TIMESTAMP_COL_ID + i;
+      aSchema[i].bytes = TYPE_BYTES[TSDB_DATA_TYPE_INT];
+    }
+    pTSchema = tBuildTSchema(aSchema, 3, 1);
+    ASSERT_NE(pTSchema, nullptr);
+
+    // the file block of the table
+    TABLEID id = {0};
+    id.uid = kUid;
+    ASSERT_EQ(tBlockDataCreate(&blockData), 0);
+    ASSERT_EQ(tBlockDataInit(&blockData, &id, pTSchema, NULL, 0), 0);
+
+    SArray *aColVal = taosArrayInit(3, sizeof(SColVal));
+    ASSERT_NE(aColVal, nullptr);
+    for (int32_t iRow = 0; iRow < kRows; iRow++) {
+      SValue tsVal = {.type = TSDB_DATA_TYPE_TIMESTAMP};
+      SValue intVal = {.type = TSDB_DATA_TYPE_INT};
+      tsVal.val = rowTs(iRow);
+      intVal.val = c1Val(iRow);
+      SColVal colVal[] = {COL_VAL_VALUE(PRIMARYKEY_TIMESTAMP_COL_ID, tsVal),
+                          c1IsNull(iRow) ? COL_VAL_NULL(PRIMARYKEY_TIMESTAMP_COL_ID + 1, TSDB_DATA_TYPE_INT)
+                                         : COL_VAL_VALUE(PRIMARYKEY_TIMESTAMP_COL_ID + 1, intVal),
+                          COL_VAL_NULL(PRIMARYKEY_TIMESTAMP_COL_ID + 2, TSDB_DATA_TYPE_INT)};
+
+      taosArrayClear(aColVal);
+      for (int32_t i = 0; i < 3; i++) taosArrayPush(aColVal, &colVal[i]);
+
+      SRow *pRow = NULL;
+      ASSERT_EQ(tRowBuild(aColVal, pTSchema, &pRow), 0);
+
+      TSDBROW row = {0};
+      row.type = TSDBROW_ROW_FMT;
+      row.version = (iRow == kInvalidRow) ? kMaxVer + 1 : iRow + 1;
+      row.pTSRow = pRow;
+      EXPECT_EQ(tBlockDataAppendRow(&blockData, &row, pTSchema, kUid), 0);
+      tRowDestroy(pRow);
+    }
+    taosArrayDestroy(aColVal);
+    ASSERT_EQ(blockData.nRow, kRows);
+
+    // the result block of ts, c1, c2
+    pResBlock = createDataBlock();
+    ASSERT_NE(pResBlock, nullptr);
+    for (int32_t i = 0; i < 3; i++) {
+      SColumnInfoData colInfo = createColumnInfoData(aSchema[i].type, aSchema[i].bytes, aSchema[i].colId);
+      ASSERT_EQ(blockDataAppendColInfo(pResBlock, &colInfo), 0);
+      aColId[i] = aSchema[i].colId;
+      aSlotId[i] = i;
+    }
+    ASSERT_EQ(blockDataEnsureCapacity(pResBlock, kCapacity), 0);
+
+    pReader = (STsdbReader *)taosMemoryCalloc(1, sizeof(STsdbReader));
+    ASSERT_NE(pReader, nullptr);
+    pReader->info.order = TSDB_ORDER_ASC;
+    pReader->info.window.skey = INT64_MIN;
+    pReader->info.window.ekey = INT64_MAX;
+    pReader->info.verRange.minVer = 0;
+    pReader->info.verRange.maxVer = kMaxVer;
+    pReader->suppInfo.colId = aColId;
+    pReader->suppInfo.slotId = aSlotId;
+    pReader->suppInfo.numOfCols = 3;
+    pReader->status.pPrimaryTsCol = (SColumnInfoData *)taosArrayGet(pResBlock->pDataBlock, 0);
+
+    pScanInfo = (STableBlockScanInfo *)taosMemoryCalloc(1, sizeof(STableBlockScanInfo));
+    ASSERT_NE(pScanInfo, nullptr);
+    pScanInfo->uid = kUid;
+    pScanInfo->lastProcKey.ts = INT64_MIN;
+  }
+
+  void TearDown() override {
+    taosMemoryFree(pScanInfo);
+    taosMemoryFree(pReader);
+    blockDataDestroy(pResBlock);
+    tBlockDataDestroy(&blockData);
+    tDestroyTSchema(pTSchema);
+  }
+
+  void setDesc() {
+    pReader->info.order = TSDB_ORDER_DESC;
+    pScanInfo->lastProcKey.ts = INT64_MAX;
+  }
+
+  int32_t runLength(int32_t start, int32_t remain = kCapacity, bool hasBound = false, int64_t bound = 0) {
+    return getFileBlockRunLength(pReader, pScanInfo, &blockData, start, remain, hasBound, bound);
+  }
+
+  // the result rows from outRow are the num rows of the file block from start
+  void checkRows(int32_t outRow, int32_t start, int32_t num, bool asc) {
+    SColumnInfoData *pTs = (SColumnInfoData *)taosArrayGet(pResBlock->pDataBlock, 0);
+    SColumnInfoData *pC1 = (SColumnInfoData *)taosArrayGet(pResBlock->pDataBlock, 1);
+    SColumnInfoData *pC2 = (SColumnInfoData *)taosArrayGet(pResBlock->pDataBlock, 2);
+
+    for (int32_t k = 0; k < num; k++) {
+      int32_t iRow = asc ? start + k : start - k;
+      int32_t r = outRow + k;
+
+      EXPECT_EQ(*(int64_t *)colDataGetData(pTs, r), rowTs(iRow));
+      if (c1IsNull(iRow)) {
+        EXPECT_TRUE(colDataIsNull_s(pC1, r)) << "row " << iRow;
+      } else {
+        EXPECT_FALSE(colDataIsNull_s(pC1, r)) << "row " << iRow;
+        EXPECT_EQ(*(int32_t *)colDataGetData(pC1, r), c1Val(iRow));
+      }
+      EXPECT_TRUE(colDataIsNull_f(pC2->nullbitmap, r)) << "row " << iRow;
+    }
+  }
+
+  STSchema            *pTSchema = nullptr;
+  SBlockData           blockData = {0};
+  SSDataBlock         *pResBlock = nullptr;
+  STsdbReader         *pReader = nullptr;
+  STableBlockScanInfo *pScanInfo = nullptr;
+  int16_t              aColId[3];
+  int16_t              aSlotId[3];
+};
+
+}  // namespace
+
+TEST_F(TsdbReadRunTest, cut_by_key_to_merge) {
+  // the key in the buffer or stt files is 150, rows 100 - 140 go first
+  EXPECT_EQ(runLength(0, kCapacity, true, 150), 5);
+  EXPECT_EQ(runLength(0, kCapacity, true, 145), 5);
+  EXPECT_EQ(runLength(0, kCapacity, true, 100), 0);
+
+  setDesc();
+  EXPECT_EQ(runLength(10, kCapacity, true, 150), 5);
+  EXPECT_EQ(runLength(10, kCapacity, true, 200), 0);
+}
+
+TEST_F(TsdbReadRunTest, cut_by_duplicate_ts) {
+  // rows kDupRow - 1 and kDupRow have the same ts, the first one is merged with the other
+  EXPECT_EQ(runLength(0), kDupRow - 1);
+  EXPECT_EQ(runLength(kDupRow - 1), 0);
+
+  setDesc();
+  EXPECT_EQ(runLength(kDupRow + 3), 3);
+}
+
+TEST_F(TsdbReadRunTest, cut_by_invalid_row) {
+  // the row of a version out of range is skipped one by one
+  EXPECT_EQ(runLength(kDupRow), kInvalidRow - kDupRow);
+}
+
+TEST_F(TsdbReadRunTest, cut_by_block_end) {
+  // the last row may be overlapped with the next block
+  EXPECT_EQ(runLength(kInvalidRow + 1), kRows - kInvalidRow - 2);
+  EXPECT_EQ(runLength(kRows - 1), 0);
+
+  setDesc();
+  EXPECT_EQ(runLength(kDupRow - 1), kDupRow - 1);
+  EXPECT_EQ(runLength(0), 0);
+}
+
+TEST_F(TsdbReadRunTest, cut_by_capacity) {
+  EXPECT_EQ(runLength(0, 3), 3);
+  EXPECT_EQ(runLength(0, 0), 0);
+
+  setDesc();
+  EXPECT_EQ(runLength(10, 4), 4);
+}
+
+TEST_F(TsdbReadRunTest, append_asc) {
+  ASSERT_EQ(doAppendRowsFromFileBlock(pResBlock, pReader, &blockData, 0, 10, true), 0);
+  EXPECT_EQ(pResBlock->info.rows, 10);
+  checkRows(0, 0, 10, true);
+
+  // appended after the rows in the result block
+  ASSERT_EQ(doAppendRowsFromFileBlock(pResBlock, pReader, &blockData, kDupRow, 4, true), 0);
+  EXPECT_EQ(pResBlock->info.rows, 14);
+  checkRows(0, 0, 10, true);
+  checkRows(10, kDupRow, 4, true);
+}
+
+TEST_F(TsdbReadRunTest, append_desc) {
+  setDesc();
+  ASSERT_EQ(doAppendRowsFromFileBlock(pResBlock, pReader, &blockData, 10, 7, false), 0);
+  EXPECT_EQ(pResBlock->info.rows, 7);
+  checkRows(0, 10, 7, false);
+
+  ASSERT_EQ(doAppendRowsFromFileBlock(pResBlock, pReader, &blockData, 19, 2, false), 0);
+  EXPECT_EQ(pResBlock->info.rows, 9);
+  checkRows(0, 10, 7, false);
+  checkRows(7, 19, 2, false);
+}
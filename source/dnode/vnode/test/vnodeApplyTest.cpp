@@ -0,0 +1,247 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <map>
+#include <tuple>
+#include <vector>
+
+#include "vnodeTestUtil.h"
+
+#include "tglobal.h"
+
+namespace {
+
+const int32_t  kTables = 40;
+const tb_uid_t kSuid = 100;
+const tb_uid_t kUid = 1000;
+const int32_t  kRows = 50;
+
+// (ts, version, value) of a row of a table
+typedef std::tuple<TSKEY, int64_t, int32_t> Row;
+
+// the state of a memtable: the rows of each table, and (minKey, maxKey, minVer, maxVer, nRow, nTbData)
+struct MemState {
+  std::map<tb_uid_t, std::vector<Row>>                           rows;
+  std::map<tb_uid_t, std::pair<TSKEY, TSKEY>>                     keys;
+  std::tuple<TSKEY, TSKEY, int64_t, int64_t, int64_t, int32_t> mem;
+};
+
+class VnodeApplyTest : public VnodeTestBase {
+ protected:
+  static void SetUpTestCase() {
+    oldApplyThreads = tsNumOfApplyThreads;
+    tsNumOfApplyThreads = 3;
+    ASSERT_EQ(vnodeAsyncOpen(1), 0);
+  }
+
+  static void TearDownTestCase() {
+    vnodeAsyncClose();
+    tsNumOfApplyThreads = oldApplyThreads;
+  }
+
+  void SetUp() override {
+    ASSERT_NO_FATAL_FAILURE(VnodeTestBase::SetUp());
+    ASSERT_NO_FATAL_FAILURE(openMemTable());
+    pTSchema = buildSchema();
+    ASSERT_NE(pTSchema, nullptr);
+
+    // the tsdb the submits are applied to in parallel, on the same buffer pool as the one applied serially
+    pTsdb2 = (STsdb *)taosMemoryCalloc(1, sizeof(STsdb));
+    ASSERT_NE(pTsdb2, nullptr);
+    pTsdb2->pVnode = pVnode;
+    ASSERT_EQ(tsdbMemTableCreate(pTsdb2, &pTsdb2->mem), 0);
+    pVnode->pTsdb = pTsdb2;
+
+    aReq.reserve(4);  // the submits are pointed to
+  }
+
+  void TearDown() override {
+    for (SSubmitReq2 &req : aReq) {
+      for (int32_t i = 0; i < (int32_t)taosArrayGetSize(req.aSubmitTbData); i++) {
+        SSubmitTbData *pTbData = (SSubmitTbData *)taosArrayGet(req.aSubmitTbData, i);
+        destroyRows(pTbData->aRowP);
+        taosMemoryFree(pTbData->pCreateTbReq);
+      }
+      taosArrayDestroy(req.aSubmitTbData);
+    }
+    if (pTsdb2 != NULL) {
+      if (pTsdb2->mem != NULL) tsdbMemTableDestroy(pTsdb2->mem, false);
+      taosMemoryFree(pTsdb2);
+    }
+    tDestroyTSchema(pTSchema);
+    VnodeTestBase::TearDown();
+  }
+
+  // a submit of nRow rows from startTs to each table of aUid in turn, the tables of aCreate are created by it
+  SSubmitReq2 *newSubmit(const std::vector<tb_uid_t> &aUid, const std::vector<tb_uid_t> &aCreate, TSKEY startTs,
+                         int32_t nRow) {
+    SSubmitReq2 req = {0};
+    req.aSubmitTbData = taosArrayInit(aUid.size(), sizeof(SSubmitTbData));
+    EXPECT_NE(req.aSubmitTbData, nullptr);
+    if (req.aSubmitTbData == NULL) return NULL;
+    aReq.push_back(req);
+
+    for (tb_uid_t uid : aUid) {
+      SSubmitTbData tbData = {0};
+      tbData.suid = kSuid;
+      tbData.uid = uid;
+      tbData.sver = 1;
+      tbData.aRowP = taosArrayInit(nRow, sizeof(SRow *));
+      EXPECT_NE(tbData.aRowP, nullptr);
+
+      for (int32_t i = 0; i < nRow && tbData.aRowP; i++) {
+        TSKEY ts = startTs + i * 10 + uid % 7;
+        SRow *pRow = buildRow(pTSchema, ts, (int32_t)(uid * 1000 + i));
+        EXPECT_NE(pRow, nullptr);
+        if (pRow) taosArrayPush(tbData.aRowP, &pRow);
+      }
+
+      // the uid of a table created is the one of the create request, as vnodeProcessSubmitReq takes it
+      if (std::find(aCreate.begin(), aCreate.end(), uid) != aCreate.end()) {
+        tbData.pCreateTbReq = (SVCreateTbReq *)taosMemoryCalloc(1, sizeof(SVCreateTbReq));
+        EXPECT_NE(tbData.pCreateTbReq, nullptr);
+        if (tbData.pCreateTbReq) {
+          tbData.pCreateTbReq->uid = uid;
+          tbData.pCreateTbReq->type = TSDB_CHILD_TABLE;
+          tbData.pCreateTbReq->ctb.suid = kSuid;
+          tbData.uid = tbData.pCreateTbReq->uid;
+        }
+      }
+
+      taosArrayPush(aReq.back().aSubmitTbData, &tbData);
+    }
+    return &aReq.back();
+  }
+
+  // apply a submit serially, as vnodeProcessSubmitReq does with no apply threads
+  static int32_t applySerially(STsdb *pTsdb, int64_t ver, SSubmitReq2 *pReq, int32_t *affectedRows) {
+    for (int32_t i = 0; i < (int32_t)taosArrayGetSize(pReq->aSubmitTbData); i++) {
+      int32_t n = 0;
+      int32_t code = tsdbInsertTableData(pTsdb, ver, (SSubmitTbData *)taosArrayGet(pReq->aSubmitTbData, i), &n);
+      if (code) return code;
+      *affectedRows += n;
+    }
+    return 0;
+  }
+
+  MemState state(SMemTable *pMem) {
+    MemState s;
+    s.mem = std::make_tuple(pMem->minKey, pMem->maxKey, pMem->minVer, pMem->maxVer, pMem->nRow, pMem->nTbData);
+
+    for (tb_uid_t uid = kUid; uid < kUid + kTables; uid++) {
+      STbData *pTbData = tsdbGetTbDataFromMemTable(pMem, kSuid, uid);
+      if (pTbData == NULL) continue;
+
+      s.keys[uid] = std::make_pair(pTbData->minKey, pTbData->maxKey);
+
+      STbDataIter *pIter = NULL;
+      EXPECT_EQ(tsdbTbDataIterCreate(pTbData, NULL, 0, &pIter), 0);
+      for (TSDBROW *pRow = tsdbTbDataIterGet(pIter); pRow != NULL;) {
+        SColVal colVal;
+        tsdbRowGetColVal(pRow, pTSchema, 1, &colVal);
+        s.rows[uid].push_back(Row(TSDBROW_TS(pRow), TSDBROW_VERSION(pRow), (int32_t)colVal.value.val));
+        pRow = tsdbTbDataIterNext(pIter) ? tsdbTbDataIterGet(pIter) : NULL;
+      }
+      tsdbTbDataIterDestroy(pIter);
+      EXPECT_EQ((int32_t)s.rows[uid].size(), tsdbGetNRowsInTbData(pTbData));
+    }
+    return s;
+  }
+
+  void expectSame(const MemState &a, const MemState &b) {
+    EXPECT_EQ(a.mem, b.mem);
+    EXPECT_EQ(a.keys, b.keys);
+    EXPECT_EQ(a.rows, b.rows);
+  }
+
+  STSchema                *pTSchema = nullptr;
+  STsdb                   *pTsdb2 = nullptr;
+  std::vector<SSubmitReq2> aReq;
+
+  static int32_t oldApplyThreads;
+};
+
+int32_t VnodeApplyTest::oldApplyThreads = 0;
+
+std::vector<tb_uid_t> uidRange(tb_uid_t start, tb_uid_t end) {
+  std::vector<tb_uid_t> aUid;
+  for (tb_uid_t uid = start; uid < end; uid++) aUid.push_back(uid);
+  return aUid;
+}
+
+}  // namespace
+
+TEST_F(VnodeApplyTest, same_as_serial) {
+  // the first half of the tables exist, the submit appends to them and creates the other half
+  std::vector<tb_uid_t> aOld = uidRange(kUid, kUid + kTables / 2);
+  std::vector<tb_uid_t> aNew = uidRange(kUid + kTables / 2, kUid + kTables);
+
+  SSubmitReq2 *pOld = newSubmit(aOld, {}, 1000000, kRows);
+  SSubmitReq2 *pReq = newSubmit(uidRange(kUid, kUid + kTables), aNew, 500000, kRows * 2);
+  ASSERT_NE(pOld, nullptr);
+  ASSERT_NE(pReq, nullptr);
+
+  int32_t nSerial = 0, nParallel = 0;
+  ASSERT_EQ(applySerially(pTsdb, 10, pOld, &nSerial), 0);
+  ASSERT_EQ(applySerially(pTsdb2, 10, pOld, &nParallel), 0);
+
+  nSerial = nParallel = 0;
+  ASSERT_EQ(applySerially(pTsdb, 11, pReq, &nSerial), 0);
+  ASSERT_EQ(vnodeApplySubmitInParallel(pVnode, 11, pReq, &nParallel), 0);
+  EXPECT_EQ(nSerial, kTables * kRows * 2);
+  EXPECT_EQ(nParallel, nSerial);
+
+  MemState serial = state(pTsdb->mem);
+  MemState parallel = state(pTsdb2->mem);
+  EXPECT_EQ((int32_t)serial.rows.size(), kTables);
+  expectSame(serial, parallel);
+
+  // the keys of the submit span those written before, the memtable range is updated by both
+  EXPECT_EQ(std::get<0>(parallel.mem), 500000);
+  EXPECT_EQ(std::get<2>(parallel.mem), 10);
+  EXPECT_EQ(std::get<3>(parallel.mem), 11);
+}
+
+TEST_F(VnodeApplyTest, table_repeated) {
+  // a table can come more than once in a submit, its parts are applied in submit order
+  std::vector<tb_uid_t> aUid = uidRange(kUid, kUid + kTables);
+  aUid.push_back(kUid + 3);
+  aUid.push_back(kUid + 3);
+  aUid.push_back(kUid + kTables - 1);
+
+  SSubmitReq2 *pReq = newSubmit(aUid, {}, 2000000, kRows);
+  ASSERT_NE(pReq, nullptr);
+
+  int32_t nSerial = 0, nParallel = 0;
+  ASSERT_EQ(applySerially(pTsdb, 20, pReq, &nSerial), 0);
+  ASSERT_EQ(vnodeApplySubmitInParallel(pVnode, 20, pReq, &nParallel), 0);
+  EXPECT_EQ(nParallel, nSerial);
+
+  expectSame(state(pTsdb->mem), state(pTsdb2->mem));
+}
+
+TEST_F(VnodeApplyTest, few_tables) {
+  // fewer tables than the slices
+  SSubmitReq2 *pReq = newSubmit(uidRange(kUid, kUid + 2), {kUid + 1}, 3000000, kRows);
+  ASSERT_NE(pReq, nullptr);
+
+  int32_t nSerial = 0, nParallel = 0;
+  ASSERT_EQ(applySerially(pTsdb, 30, pReq, &nSerial), 0);
+  ASSERT_EQ(vnodeApplySubmitInParallel(pVnode, 30, pReq, &nParallel), 0);
+  EXPECT_EQ(nParallel, nSerial);
+
+  expectSame(state(pTsdb->mem), state(pTsdb2->mem));
+}
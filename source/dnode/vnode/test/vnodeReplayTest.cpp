@@ -0,0 +1,266 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <functional>
+#include <vector>
+
+#include "vnodeTestUtil.h"
+
+#include "tglobal.h"
+
+namespace {
+
+const char    *kDir = TD_TMP_DIR_PATH "vnodeReplayTest";
+const int64_t  kVersions = 1200;
+const tb_uid_t kUid = 1000;
+
+// a version is not a submit if ver % kOtherEvery == 1
+const int64_t kOtherEvery = 7;
+
+class VnodeReplayTest : public VnodeTestBase {
+ protected:
+  static void SetUpTestCase() {
+    tsNumOfReplayThreads = 2;
+    ASSERT_EQ(vnodeAsyncOpen(1), 0);
+    ASSERT_EQ(walInit(), 0);
+  }
+
+  static void TearDownTestCase() {
+    walCleanUp();
+    vnodeAsyncClose();
+    tsNumOfReplayThreads = 0;
+  }
+
+  void SetUp() override {
+    taosRemoveDir(kDir);
+    tsReplayBufferSizeMB = 256;
+
+    ASSERT_NO_FATAL_FAILURE(VnodeTestBase::SetUp());
+    pVnode->config.tsdbCfg.precision = TSDB_TIME_PRECISION_MILLI;
+    pVnode->config.tsdbCfg.keep2 = 3650 * 1440;
+    pVnode->state.applied = -1;
+
+    SWalCfg cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.vgId = kVgId;
+    cfg.rollPeriod = -1;
+    cfg.segSize = -1;
+    cfg.level = TAOS_WAL_WRITE;
+    pVnode->pWal = walOpen(kDir, &cfg);
+    ASSERT_NE(pVnode->pWal, nullptr);
+
+    pTSchema = buildSchema();
+    ASSERT_NE(pTSchema, nullptr);
+
+    baseTs = taosGetTimestampMs() - 3600 * 1000;
+  }
+
+  void TearDown() override {
+    vnodeReplayClose(pVnode);
+    tDestroyTSchema(pTSchema);
+    walClose(pVnode->pWal);
+    VnodeTestBase::TearDown();
+    taosRemoveDir(kDir);
+  }
+
+  static bool isSubmit(int64_t ver) { return ver % kOtherEvery != 1; }
+
+  TSKEY rowTs(int64_t ver, int32_t iRow) { return baseTs + ver * nRow + iRow; }
+
+  // writes a submit of nRow rows to table kUid + ver at each version, but a few other messages, and commits them all
+  void writeWal(bool unsorted = false) {
+    for (int64_t ver = 0; ver < kVersions; ver++) {
+      if (!isSubmit(ver)) {
+        char body[] = "not a submit";
+        ASSERT_EQ(walWrite(pVnode->pWal, ver, TDMT_VND_ALTER_CONFIG, body, sizeof(body)), 0);
+        continue;
+      }
+
+      SSubmitTbData tbData = {0};
+      tbData.uid = kUid + ver;
+      tbData.sver = 1;
+      tbData.aRowP = taosArrayInit(nRow, sizeof(SRow *));
+      ASSERT_NE(tbData.aRowP, nullptr);
+
+      for (int32_t iRow = 0; iRow < nRow; iRow++) {
+        SRow *pRow = buildRow(pTSchema, (unsorted && iRow == nRow - 1) ? rowTs(ver, 0) : rowTs(ver, iRow), iRow);
+        ASSERT_NE(pRow, nullptr);
+        taosArrayPush(tbData.aRowP, &pRow);
+      }
+
+      SSubmitReq2 req = {0};
+      req.aSubmitTbData = taosArrayInit(1, sizeof(SSubmitTbData));
+      ASSERT_NE(req.aSubmitTbData, nullptr);
+      taosArrayPush(req.aSubmitTbData, &tbData);
+
+      int32_t len = 0, ret = 0;
+      tEncodeSize(tEncodeSubmitReq, &req, len, ret);
+      ASSERT_EQ(ret, 0);
+      len += sizeof(SSubmitReq2Msg);
+
+      void *pMsg = taosMemoryCalloc(1, len);
+      ASSERT_NE(pMsg, nullptr);
+      ((SSubmitReq2Msg *)pMsg)->header.vgId = htonl(pVnode->config.vgId);
+      ((SSubmitReq2Msg *)pMsg)->header.contLen = htonl(len);
+      ((SSubmitReq2Msg *)pMsg)->version = htobe64(1);
+
+      SEncoder encoder = {0};
+      tEncoderInit(&encoder, (uint8_t *)POINTER_SHIFT(pMsg, sizeof(SSubmitReq2Msg)), len - sizeof(SSubmitReq2Msg));
+      ASSERT_GE(tEncodeSubmitReq(&encoder, &req), 0);
+      tEncoderClear(&encoder);
+      tDestroySubmitReq(&req, TSDB_MSG_FLG_ENCODE);
+
+      ASSERT_EQ(walWrite(pVnode->pWal, ver, TDMT_VND_SUBMIT, pMsg, len), 0);
+      taosMemoryFree(pMsg);
+    }
+    ASSERT_EQ(walCommit(pVnode->pWal, kVersions - 1), 0);
+  }
+
+  // applies the wal in version order as the apply thread does, with alter changing the message applied. Returns the
+  // versions taken.
+  std::vector<int64_t> apply(std::function<void(int64_t ver, std::vector<char> &msg)> alter = nullptr,
+                             int32_t expectCode = 0) {
+    std::vector<int64_t> aTaken;
+    SWalReader          *pReader = walOpenReader(pVnode->pWal, NULL, 0);
+    EXPECT_NE(pReader, nullptr);
+    if (pReader == NULL) return aTaken;
+
+    for (int64_t ver = 0; ver < kVersions; ver++) {
+      EXPECT_EQ(walReadVer(pReader, ver), 0);
+
+      SWalCont         *pHead = &pReader->pHead->head;
+      std::vector<char> msg(pHead->body, pHead->body + pHead->bodyLen);
+      if (alter) alter(ver, msg);
+
+      SSubmitReq2 req = {0};
+      void       *pBuf = NULL;
+      int32_t     code = -1;
+      if (!vnodeReplayTake(pVnode, ver, msg.data(), msg.size(), &req, &pBuf, &code)) continue;
+
+      EXPECT_TRUE(isSubmit(ver));
+      EXPECT_EQ(code, expectCode);
+      EXPECT_EQ(taosArrayGetSize(req.aSubmitTbData), 1);
+      SSubmitTbData *pTbData = (SSubmitTbData *)taosArrayGet(req.aSubmitTbData, 0);
+      EXPECT_EQ(pTbData->uid, kUid + ver);
+      EXPECT_EQ(taosArrayGetSize(pTbData->aRowP), nRow);
+      EXPECT_EQ((*(SRow **)taosArrayGet(pTbData->aRowP, 0))->ts, rowTs(ver, 0));
+      aTaken.push_back(ver);
+
+      tDestroySubmitReq(&req, TSDB_MSG_FLG_DECODE);
+      taosMemoryFree(pBuf);
+    }
+
+    walCloseReader(pReader);
+    return aTaken;
+  }
+
+  int32_t nSubmit() {
+    int32_t n = 0;
+    for (int64_t ver = 0; ver < kVersions; ver++) n += isSubmit(ver);
+    return n;
+  }
+
+  STSchema *pTSchema = NULL;
+  TSKEY     baseTs = 0;
+  int32_t   nRow = 4;
+};
+
+}  // namespace
+
+TEST_F(VnodeReplayTest, parallel) {
+  writeWal();
+  ASSERT_EQ(vnodeReplayOpen(pVnode), 0);
+  ASSERT_NE(pVnode->pReplay, nullptr);
+
+  // every submit is taken from the workers, in version order
+  std::vector<int64_t> aTaken = apply();
+  EXPECT_EQ(aTaken.size(), nSubmit());
+  for (size_t i = 1; i < aTaken.size(); i++) {
+    EXPECT_LT(aTaken[i - 1], aTaken[i]);
+  }
+
+  // closed at the end of the committed wal
+  EXPECT_EQ(pVnode->pReplay, nullptr);
+}
+
+TEST_F(VnodeReplayTest, scan_error) {
+  writeWal(true);
+  ASSERT_EQ(vnodeReplayOpen(pVnode), 0);
+
+  // the error of the scan on the workers goes to the apply thread
+  EXPECT_EQ(apply(nullptr, TSDB_CODE_INVALID_MSG).size(), nSubmit());
+}
+
+TEST_F(VnodeReplayTest, mismatch) {
+  writeWal();
+  ASSERT_EQ(vnodeReplayOpen(pVnode), 0);
+
+  // a message applied other than the one in the wal is decoded by the apply thread
+  std::vector<int64_t> aTaken = apply([](int64_t ver, std::vector<char> &msg) {
+    if (ver % 100 == 10) {
+      msg.back() ^= 0xff;
+    } else if (ver % 100 == 20) {
+      msg.push_back(0);
+    } else if (ver % 100 == 30) {
+      msg.pop_back();
+    }
+  });
+
+  int32_t nAltered = 0;
+  for (int64_t ver = 0; ver < kVersions; ver++) {
+    nAltered += isSubmit(ver) && (ver % 100 == 10 || ver % 100 == 20 || ver % 100 == 30);
+  }
+  EXPECT_EQ(aTaken.size(), nSubmit() - nAltered);
+  for (int64_t ver : aTaken) {
+    EXPECT_TRUE(ver % 100 != 10 && ver % 100 != 20 && ver % 100 != 30);
+  }
+}
+
+TEST_F(VnodeReplayTest, out_of_range) {
+  writeWal();
+  ASSERT_EQ(vnodeReplayOpen(pVnode), 0);
+
+  SSubmitReq2 req = {0};
+  void       *pBuf = NULL;
+  int32_t     code = 0;
+  char        msg[] = "beyond the committed wal";
+
+  // the apply thread goes beyond the wal replayed, back to the serial path
+  EXPECT_FALSE(vnodeReplayTake(pVnode, kVersions, msg, sizeof(msg), &req, &pBuf, &code));
+  EXPECT_EQ(pVnode->pReplay, nullptr);
+  EXPECT_TRUE(apply().empty());
+}
+
+TEST_F(VnodeReplayTest, byte_limit) {
+  // each submit takes about 20KB, the batches in flight take several MB
+  nRow = 1000;
+  tsReplayBufferSizeMB = 1;
+  writeWal();
+  ASSERT_EQ(vnodeReplayOpen(pVnode), 0);
+
+  // the submits beyond the limit are left to the apply thread, the rest are taken all the same
+  std::vector<int64_t> aTaken = apply();
+  EXPECT_GT(aTaken.size(), 0);
+  EXPECT_LT(aTaken.size(), nSubmit());
+  EXPECT_EQ(pVnode->pReplay, nullptr);
+}
+
+TEST_F(VnodeReplayTest, short_wal) {
+  // too short to replay ahead
+  writeWal();
+  pVnode->state.applied = kVersions - 100;
+  ASSERT_EQ(vnodeReplayOpen(pVnode), 0);
+  EXPECT_EQ(pVnode->pReplay, nullptr);
+}
@@ -0,0 +1,248 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "cos.h"
+#include "vnd.h"
+
+namespace {
+
+const char   *kDir = TD_TMP_DIR_PATH "vnodeS3CacheTest";
+const int64_t kSegSize = 1024 * 1024;  // VNODE_S3_CACHE_SEG_SIZE
+const int64_t kObjSize = 8 * kSegSize + 100;
+
+// the fake s3 backend: every object has the same content, the reads are counted
+int32_t nRead = 0;
+int32_t nFail = 0;
+
+uint8_t objByte(int64_t offset) { return (uint8_t)(offset * 31 + offset / 251); }
+
+int32_t fakeRead(const char *object, int64_t offset, int64_t size, bool check, uint8_t **ppBlock) {
+  nRead++;
+  if (nFail > 0) {
+    nFail--;
+    return TSDB_CODE_FAILED;
+  }
+  if (offset < 0 || size <= 0 || offset + size > kObjSize) {
+    return TSDB_CODE_INVALID_PARA;
+  }
+
+  uint8_t *pBlock = (uint8_t *)taosMemoryMalloc(size);
+  if (pBlock == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+  for (int64_t i = 0; i < size; i++) {
+    pBlock[i] = objByte(offset + i);
+  }
+  *ppBlock = pBlock;
+  return 0;
+}
+
+std::string segPath(const char *object, int64_t segno) {
+  return std::string(kDir) + TD_DIRSEP + object + "." + std::to_string(segno);
+}
+
+class VnodeS3CacheTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    taosRemoveDir(kDir);
+
+    tsS3Enabled = true;
+    tstrncpy(tsS3CacheDir, kDir, PATH_MAX);
+    tsS3CacheSizeMB = 5;  // 4 segments, 3 of them protected
+    tsS3CacheReadAhead = 0;
+    nRead = 0;
+    nFail = 0;
+    oldRead = vnodeS3CacheSetRead(fakeRead);
+    ASSERT_EQ(vnodeS3CacheOpen(), 0);
+  }
+
+  void TearDown() override {
+    vnodeS3CacheClose();
+    vnodeS3CacheSetRead(oldRead);
+    tsS3CacheDir[0] = '\0';
+    tsS3Enabled = false;
+    taosRemoveDir(kDir);
+  }
+
+  // reads a range and checks the content, returns the reads sent to s3
+  int32_t get(const char *object, int64_t offset, int64_t size) {
+    int32_t  n = nRead;
+    uint8_t *pBlock = NULL;
+    int32_t  code = vnodeS3CacheGet(object, kObjSize, offset, size, true, &pBlock);
+    EXPECT_EQ(code, 0);
+    if (code) return -1;
+
+    for (int64_t i = 0; i < size; i++) {
+      if (pBlock[i] != objByte(offset + i)) {
+        ADD_FAILURE() << "wrong byte at " << offset + i;
+        break;
+      }
+    }
+    taosMemoryFree(pBlock);
+    return nRead - n;
+  }
+
+  int32_t getSeg(const char *object, int64_t segno) { return get(object, segno * kSegSize, 100); }
+
+  int32_t nFile() {
+    int32_t  n = 0;
+    TdDirPtr pDir = taosOpenDir(kDir);
+    if (pDir == NULL) return -1;
+
+    TdDirEntryPtr pDirEntry;
+    while ((pDirEntry = taosReadDir(pDir)) != NULL) {
+      if (!taosDirEntryIsDir(pDirEntry)) n++;
+    }
+    taosCloseDir(&pDir);
+    return n;
+  }
+
+  FVS3CacheRead oldRead = NULL;
+};
+
+}  // namespace
+
+TEST_F(VnodeS3CacheTest, hit_miss) {
+  // a miss reads the whole segment from s3 and keeps it
+  EXPECT_EQ(get("v2/f1.data", 10, 1000), 1);
+  EXPECT_TRUE(taosCheckExistFile(segPath("v2_f1.data", 0).c_str()));
+
+  // any range of a cached segment is a hit
+  EXPECT_EQ(get("v2/f1.data", 5000, 20000), 0);
+  EXPECT_EQ(get("v2/f1.data", 0, kSegSize), 0);
+
+  // a range across segments misses the uncached ones only
+  EXPECT_EQ(get("v2/f1.data", kSegSize - 10, 2 * kSegSize), 2);
+  EXPECT_EQ(get("v2/f1.data", 0, 3 * kSegSize), 0);
+
+  // the last segment is a short one
+  EXPECT_EQ(get("v2/f1.data", kObjSize - 50, 50), 1);
+  EXPECT_EQ(get("v2/f1.data", kObjSize - 100, 100), 0);
+
+  // the segments of another object are not shared
+  EXPECT_EQ(get("v2/f2.data", 10, 1000), 1);
+
+  // a failed read from s3 fails the get and caches nothing
+  nFail = 1;
+  uint8_t *pBlock = NULL;
+  EXPECT_NE(vnodeS3CacheGet("v2/f3.data", kObjSize, 0, 100, true, &pBlock), 0);
+  EXPECT_FALSE(taosCheckExistFile(segPath("v2_f3.data", 0).c_str()));
+  EXPECT_EQ(get("v2/f3.data", 0, 100), 1);
+}
+
+TEST_F(VnodeS3CacheTest, segmented_lru) {
+  // the segment queried twice is protected
+  EXPECT_EQ(getSeg("obj", 0), 1);
+  EXPECT_EQ(getSeg("obj", 0), 0);
+
+  // a scan of more segments than the cache holds
+  for (int64_t segno = 1; segno <= 6; segno++) {
+    EXPECT_EQ(getSeg("obj", segno), 1);
+  }
+  EXPECT_EQ(nFile(), 4);
+
+  // the protected segment survives the scan, the oldest scanned ones are evicted
+  EXPECT_EQ(getSeg("obj", 0), 0);
+  EXPECT_FALSE(taosCheckExistFile(segPath("obj", 1).c_str()));
+  EXPECT_FALSE(taosCheckExistFile(segPath("obj", 3).c_str()));
+  EXPECT_EQ(getSeg("obj", 6), 0);
+  EXPECT_EQ(getSeg("obj", 5), 0);
+  EXPECT_EQ(getSeg("obj", 4), 0);
+
+  // 0, 6 and 5 fill the protected list, so the hit on 4 demotes 0, the least recent one, and a new segment evicts it
+  EXPECT_EQ(getSeg("obj", 7), 1);
+  EXPECT_EQ(nFile(), 4);
+  EXPECT_FALSE(taosCheckExistFile(segPath("obj", 0).c_str()));
+  EXPECT_EQ(getSeg("obj", 4), 0);
+  EXPECT_EQ(getSeg("obj", 5), 0);
+  EXPECT_EQ(getSeg("obj", 6), 0);
+  EXPECT_EQ(getSeg("obj", 7), 0);
+}
+
+TEST_F(VnodeS3CacheTest, rebuild) {
+  for (int64_t segno = 0; segno < 3; segno++) {
+    EXPECT_EQ(getSeg("obj", segno), 1);
+  }
+
+  // a segment not written completely is dropped at the restart
+  std::string tpath = segPath("obj", 5) + ".t";
+  TdFilePtr   pFile = taosOpenFile(tpath.c_str(), TD_FILE_CREATE | TD_FILE_WRITE | TD_FILE_TRUNC);
+  ASSERT_NE(pFile, nullptr);
+  ASSERT_EQ(taosWriteFile(pFile, "abc", 3), 3);
+  taosCloseFile(&pFile);
+
+  vnodeS3CacheClose();
+  ASSERT_EQ(vnodeS3CacheOpen(), 0);
+
+  EXPECT_FALSE(taosCheckExistFile(tpath.c_str()));
+  EXPECT_EQ(nFile(), 3);
+  for (int64_t segno = 0; segno < 3; segno++) {
+    EXPECT_EQ(getSeg("obj", segno), 0);
+  }
+  EXPECT_EQ(getSeg("obj", 5), 1);
+
+  // a smaller cache evicts the segments over the capacity at the restart
+  vnodeS3CacheClose();
+  tsS3CacheSizeMB = 2;
+  ASSERT_EQ(vnodeS3CacheOpen(), 0);
+  EXPECT_EQ(nFile(), 1);
+
+  int32_t nHit = 0;
+  for (int64_t segno : {0, 1, 2, 5}) {
+    if (taosCheckExistFile(segPath("obj", segno).c_str())) {
+      EXPECT_EQ(getSeg("obj", segno), 0);
+      nHit++;
+    }
+  }
+  EXPECT_EQ(nHit, 1);
+}
+
+TEST_F(VnodeS3CacheTest, corrupted_segment) {
+  EXPECT_EQ(getSeg("obj", 0), 1);
+  EXPECT_EQ(getSeg("obj", 1), 1);
+
+  // flip a byte of segment 0
+  std::string path = segPath("obj", 0);
+  TdFilePtr   pFile = taosOpenFile(path.c_str(), TD_FILE_READ | TD_FILE_WRITE);
+  ASSERT_NE(pFile, nullptr);
+  uint8_t b = objByte(1000) ^ 0xff;
+  ASSERT_EQ(taosLSeekFile(pFile, 1000, SEEK_SET), 1000);
+  ASSERT_EQ(taosWriteFile(pFile, &b, 1), 1);
+  taosCloseFile(&pFile);
+
+  // truncate segment 1
+  pFile = taosOpenFile(segPath("obj", 1).c_str(), TD_FILE_WRITE);
+  ASSERT_NE(pFile, nullptr);
+  ASSERT_EQ(taosFtruncateFile(pFile, kSegSize / 2), 0);
+  taosCloseFile(&pFile);
+
+  // the right content comes from s3, and the bad segments are dropped
+  EXPECT_EQ(get("obj", 0, 2000), 1);
+  EXPECT_FALSE(taosCheckExistFile(path.c_str()));
+  EXPECT_EQ(getSeg("obj", 1), 1);
+  EXPECT_FALSE(taosCheckExistFile(segPath("obj", 1).c_str()));
+
+  // and cached again by the next read
+  EXPECT_EQ(getSeg("obj", 0), 1);
+  EXPECT_EQ(getSeg("obj", 0), 0);
+
+  // a segment removed under the cache is read from s3 as well
+  ASSERT_EQ(taosRemoveFile(path.c_str()), 0);
+  EXPECT_EQ(getSeg("obj", 0), 1);
+}
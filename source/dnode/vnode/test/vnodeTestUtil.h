@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _TD_VNODE_TEST_UTIL_H_
+#define _TD_VNODE_TEST_UTIL_H_
+
+#include <gtest/gtest.h>
+
+#include "tsdb.h"
+#include "vnd.h"
+
+// A vnode and its tsdb, allocated but not opened. A test sets up the parts it uses on them.
+class VnodeTestBase : public testing::Test {
+ protected:
+  static const int32_t kVgId = 2;
+
+  void SetUp() override {
+    pVnode = (SVnode *)taosMemoryCalloc(1, sizeof(SVnode));
+    ASSERT_NE(pVnode, nullptr);
+    pVnode->config.vgId = kVgId;
+
+    pTsdb = (STsdb *)taosMemoryCalloc(1, sizeof(STsdb));
+    ASSERT_NE(pTsdb, nullptr);
+    pTsdb->pVnode = pVnode;
+  }
+
+  void TearDown() override {
+    if (memOpened) {
+      tsdbMemTableDestroy(pTsdb->mem, false);
+      vnodeCloseBufPool(pVnode);
+      taosThreadCondDestroy(&pVnode->poolNotEmpty);
+      taosThreadMutexDestroy(&pVnode->mutex);
+    }
+    taosMemoryFree(pTsdb);
+    taosMemoryFree(pVnode);
+  }
+
+  // open the buffer pools of the vnode, take one in use as vnodeBegin does and create the memtable of the tsdb on it
+  void openMemTable() {
+    pVnode->config.szBuf = VNODE_BUFPOOL_SEGMENTS * 4 * 1024 * 1024;
+    pVnode->config.tsdbCfg.slLevel = 5;
+    taosThreadMutexInit(&pVnode->mutex, NULL);
+    taosThreadCondInit(&pVnode->poolNotEmpty, NULL);
+    ASSERT_EQ(vnodeOpenBufPool(pVnode), 0);
+
+    pVnode->inUse = pVnode->freeList;
+    pVnode->freeList = pVnode->inUse->freeNext;
+    pVnode->inUse->freeNext = NULL;
+
+    ASSERT_EQ(tsdbMemTableCreate(pTsdb, &pTsdb->mem), 0);
+    memOpened = true;
+  }
+
+  // the schema of the tables of the tests: (ts TIMESTAMP, c1 INT)
+  static STSchema *buildSchema() {
+    SSchema aSchema[2] = {0};
+    aSchema[0].type = TSDB_DATA_TYPE_TIMESTAMP;
+    aSchema[0].colId = PRIMARYKEY_TIMESTAMP_COL_ID;
+    aSchema[0].bytes = TYPE_BYTES[TSDB_DATA_TYPE_TIMESTAMP];
+    strcpy(aSchema[0].name, "ts");
+    aSchema[1].type = TSDB_DATA_TYPE_INT;
+    aSchema[1].colId = PRIMARYKEY_TIMESTAMP_COL_ID + 1;
+    aSchema[1].bytes = TYPE_BYTES[TSDB_DATA_TYPE_INT];
+    strcpy(aSchema[1].name, "c1");
+    return tBuildTSchema(aSchema, 2, 1);
+  }
+
+  // a row of the schema of buildSchema, NULL on failure
+  static SRow *buildRow(STSchema *pTSchema, TSKEY ts, int32_t val) {
+    SValue tsVal = {.type = TSDB_DATA_TYPE_TIMESTAMP};
+    SValue intVal = {.type = TSDB_DATA_TYPE_INT};
+    tsVal.val = ts;
+    intVal.val = val;
+    SColVal colVal[] = {COL_VAL_VALUE(PRIMARYKEY_TIMESTAMP_COL_ID, tsVal),
+                        COL_VAL_VALUE(PRIMARYKEY_TIMESTAMP_COL_ID + 1, intVal)};
+
+    SRow   *pRow = NULL;
+    SArray *aColVal = taosArrayInit(2, sizeof(SColVal));
+    if (aColVal != NULL && taosArrayPush(aColVal, &colVal[0]) != NULL && taosArrayPush(aColVal, &colVal[1]) != NULL) {
+      if (tRowBuild(aColVal, pTSchema, &pRow) != 0) pRow = NULL;
+    }
+    taosArrayDestroy(aColVal);
+    return pRow;
+  }
+
+  // destroy the rows of a table of a submit
+  static void destroyRows(SArray *aRowP) {
+    for (int32_t i = 0; i < (int32_t)taosArrayGetSize(aRowP); i++) {
+      tRowDestroy(*(SRow **)taosArrayGet(aRowP, i));
+    }
+    taosArrayDestroy(aRowP);
+  }
+
+  SVnode *pVnode = nullptr;
+  STsdb  *pTsdb = nullptr;
+  bool    memOpened = false;
+};
+
+#endif /*_TD_VNODE_TEST_UTIL_H_*/
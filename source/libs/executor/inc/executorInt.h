@@ -263,6 +263,7 @@ typedef struct STableScanBase {
   // there are more than one table list exists in one task, if only one vnode exists.
   STableListInfo* pTableListInfo;
   TsdReader       readerAPI;
+  SArray*         pFilterColIds;  // SArray<int16_t>, columns loaded before the filter, NULL if all are loaded at once
 } STableScanBase;
 
 typedef struct STableScanInfo {
@@ -856,6 +857,10 @@ extern void doDestroyExchangeOperatorInfo(void* param);
 
 int32_t doFilterImpl(SSDataBlock* pBlock, SFilterInfo* pFilterInfo, SColMatchInfo* pColMatchInfo, SColumnInfoData** pResCol);
 int32_t doFilter(SSDataBlock* pBlock, SFilterInfo* pFilterInfo, SColMatchInfo* pColMatchInfo);
+// the callback is invoked with the filter result status before the unqualified rows are removed
+typedef int32_t (*__filter_res_fn_t)(void* param, int32_t status);
+int32_t doFilterEx(SSDataBlock* pBlock, SFilterInfo* pFilterInfo, SColMatchInfo* pColMatchInfo, __filter_res_fn_t fp,
+                   void* param);
 int32_t addTagPseudoColumnData(SReadHandle* pHandle, const SExprInfo* pExpr, int32_t numOfExpr, SSDataBlock* pBlock,
                                int32_t rows, SExecTaskInfo* pTask, STableMetaCacheInfo* pCache);
 
@@ -517,6 +517,11 @@ void clearResultRowInitFlag(SqlFunctionCtx* pCtx, int32_t numOfOutput) {
 }
 
 int32_t doFilter(SSDataBlock* pBlock, SFilterInfo* pFilterInfo, SColMatchInfo* pColMatchInfo) {
+  return doFilterEx(pBlock, pFilterInfo, pColMatchInfo, NULL, NULL);
+}
+
+int32_t doFilterEx(SSDataBlock* pBlock, SFilterInfo* pFilterInfo, SColMatchInfo* pColMatchInfo, __filter_res_fn_t fp,
+                   void* param) {
   if (pFilterInfo == NULL || pBlock->info.rows == 0) {
     return TSDB_CODE_SUCCESS;
   }
@@ -535,6 +540,13 @@ int32_t doFilter(SSDataBlock* pBlock, SFilterInfo* pFilterInfo, SColMatchInfo* p
     goto _err;
   }
 
+  if (fp != NULL) {
+    code = fp(param, status);
+    if (code != TSDB_CODE_SUCCESS) {
+      goto _err;
+    }
+  }
+
   extractQualifiedTupleByFilterResult(pBlock, p, status);
 
   if (pColMatchInfo != NULL) {
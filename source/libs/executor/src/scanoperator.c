@@ -293,6 +293,12 @@ bool applyLimitOffset(SLimitInfo* pLimitInfo, SSDataBlock* pBlock, SExecTaskInfo
   return false;
 }
 
+static int32_t doLoadRemainCols(void* param, int32_t status) {
+  STableScanBase* pTableScanInfo = param;
+  bool            load = (status != FILTER_RESULT_NONE_QUALIFIED);
+  return pTableScanInfo->readerAPI.tsdReaderRetrieveRemainCols(pTableScanInfo->dataReader, load);
+}
+
 static int32_t loadDataBlock(SOperatorInfo* pOperator, STableScanBase* pTableScanInfo, SSDataBlock* pBlock,
                              uint32_t* status) {
   SExecTaskInfo* pTaskInfo = pOperator->pTaskInfo;
@@ -393,7 +399,9 @@ static int32_t loadDataBlock(SOperatorInfo* pOperator, STableScanBase* pTableSca
   pCost->totalCheckedRows += pBlock->info.rows;
   pCost->loadBlocks += 1;
 
-  SSDataBlock* p = pAPI->tsdReader.tsdReaderRetrieveDataBlock(pTableScanInfo->dataReader, NULL);
+  // only the columns required by the filter are loaded, the other ones are loaded after the filter is applied.
+  SArray*      pIdList = (pOperator->exprSupp.pFilterInfo != NULL) ? pTableScanInfo->pFilterColIds : NULL;
+  SSDataBlock* p = pAPI->tsdReader.tsdReaderRetrieveDataBlock(pTableScanInfo->dataReader, pIdList);
   if (p == NULL) {
     return terrno;
   }
@@ -405,7 +413,15 @@ static int32_t loadDataBlock(SOperatorInfo* pOperator, STableScanBase* pTableSca
   pCost->totalRows -= pBlock->info.rows;
 
   if (pOperator->exprSupp.pFilterInfo != NULL) {
-    int32_t code = doFilter(pBlock, pOperator->exprSupp.pFilterInfo, &pTableScanInfo->matchInfo);
+    __filter_res_fn_t fp = (pIdList != NULL) ? doLoadRemainCols : NULL;
+    int32_t code = doFilterEx(pBlock, pOperator->exprSupp.pFilterInfo, &pTableScanInfo->matchInfo, fp, pTableScanInfo);
+    if (pIdList != NULL) {
+      // release the reader if the remained columns are not retrieved, e.g., no rows or failed to filter
+      int32_t ret = pAPI->tsdReader.tsdReaderRetrieveRemainCols(pTableScanInfo->dataReader, false);
+      if (code == TSDB_CODE_SUCCESS) {
+        code = ret;
+      }
+    }
     if (code != TSDB_CODE_SUCCESS) return code;
 
     int64_t st = taosGetTimestampUs();
@@ -1062,6 +1078,18 @@ static SSDataBlock* groupSeqTableScan(SOperatorInfo* pOperator) {
     if (pInfo->filesetDelimited) {
       pAPI->tsdReader.tsdSetFilesetDelimited(pInfo->base.dataReader);
     }
+    if (pOperator->exprSupp.pFilterInfo != NULL) {
+      pAPI->tsdReader.tsdSetFilterInfo(pInfo->base.dataReader, pOperator->exprSupp.pFilterInfo);
+    }
+    // the result block is consumed before the next block is requested, except in the stream model. The filter and the
+    // offset compact the result block in place, so its columns must not refer to the file block data of the reader.
+    if (pTaskInfo->execModel == OPTR_EXEC_MODEL_BATCH && pOperator->exprSupp.pFilterInfo == NULL &&
+        pInfo->base.limitInfo.limit.offset <= 0) {
+      code = pAPI->tsdReader.tsdSetZeroCopy(pInfo->base.dataReader, true);
+      if (code != TSDB_CODE_SUCCESS) {
+        T_LONG_JMP(pTaskInfo->env, code);
+      }
+    }
     if (pInfo->pResBlock->info.capacity > pOperator->resultInfo.capacity) {
       pOperator->resultInfo.capacity = pInfo->pResBlock->info.capacity;
     }
@@ -1160,6 +1188,75 @@ static int32_t getTableScannerExecInfo(struct SOperatorInfo* pOptr, void** pOptr
   return 0;
 }
 
+static EDealRes collectFilterColIdWalker(SNode* pNode, void* pContext) {
+  if (nodeType(pNode) != QUERY_NODE_COLUMN) {
+    return DEAL_RES_CONTINUE;
+  }
+
+  SColumnNode* pCol = (SColumnNode*)pNode;
+  if (pCol->colType != COLUMN_TYPE_COLUMN || pCol->colId == PRIMARYKEY_TIMESTAMP_COL_ID) {
+    return DEAL_RES_CONTINUE;
+  }
+
+  SArray* pList = pContext;
+  int16_t colId = pCol->colId;
+  for (int32_t i = 0; i < taosArrayGetSize(pList); ++i) {
+    if (*(int16_t*)taosArrayGet(pList, i) == colId) {
+      return DEAL_RES_CONTINUE;
+    }
+  }
+
+  if (taosArrayPush(pList, &colId) == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return DEAL_RES_ERROR;
+  }
+  return DEAL_RES_CONTINUE;
+}
+
+// columns referenced by the filter are loaded first, the rest of the data columns are loaded only if any row of the
+// data block survives the filter. The list is kept only if at least one data column is not referenced by the filter.
+static int32_t initFilterColIds(SNode* pConditions, SColMatchInfo* pMatchInfo, SArray** pFilterColIds) {
+  *pFilterColIds = NULL;
+
+  SArray* pList = taosArrayInit(4, sizeof(int16_t));
+  if (pList == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  terrno = TSDB_CODE_SUCCESS;
+  nodesWalkExpr(pConditions, collectFilterColIdWalker, pList);
+  if (terrno != TSDB_CODE_SUCCESS) {
+    taosArrayDestroy(pList);
+    return terrno;
+  }
+
+  int32_t numOfRemain = 0;
+  for (int32_t i = 0; i < taosArrayGetSize(pMatchInfo->pList); ++i) {
+    SColMatchItem* pItem = taosArrayGet(pMatchInfo->pList, i);
+    if (pItem->colId == PRIMARYKEY_TIMESTAMP_COL_ID || pItem->isPk) {
+      continue;
+    }
+
+    bool found = false;
+    for (int32_t j = 0; j < taosArrayGetSize(pList); ++j) {
+      if (*(int16_t*)taosArrayGet(pList, j) == pItem->colId) {
+        found = true;
+        break;
+      }
+    }
+
+    numOfRemain += found ? 0 : 1;
+  }
+
+  if (numOfRemain == 0) {
+    taosArrayDestroy(pList);
+  } else {
+    *pFilterColIds = pList;
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
 static void destroyTableScanBase(STableScanBase* pBase, TsdReader* pAPI) {
   cleanupQueryTableDataCond(&pBase->cond);
 
@@ -1170,6 +1267,7 @@ static void destroyTableScanBase(STableScanBase* pBase, TsdReader* pAPI) {
     taosArrayDestroy(pBase->matchInfo.pList);
   }
 
+  taosArrayDestroy(pBase->pFilterColIds);
   tableListDestroy(pBase->pTableListInfo);
   taosLRUCacheCleanup(pBase->metaCache.pTableMetaEntryCache);
   cleanupExprSupp(&pBase->pseudoSup);
@@ -1177,9 +1275,10 @@ static void destroyTableScanBase(STableScanBase* pBase, TsdReader* pAPI) {
 
 static void destroyTableScanOperatorInfo(void* param) {
   STableScanInfo* pTableScanInfo = (STableScanInfo*)param;
+  // close the reader first, the columns of the result block may refer to the data held by the reader
+  destroyTableScanBase(&pTableScanInfo->base, &pTableScanInfo->base.readerAPI);
   blockDataDestroy(pTableScanInfo->pResBlock);
   taosHashCleanup(pTableScanInfo->pIgnoreTables);
-  destroyTableScanBase(&pTableScanInfo->base, &pTableScanInfo->base.readerAPI);
   taosMemoryFreeClear(param);
 }
 
@@ -1234,7 +1333,14 @@ SOperatorInfo* createTableScanOperatorInfo(STableScanPhysiNode* pTableScanNode,
   if (code != TSDB_CODE_SUCCESS) {
     goto _error;
   }
-  
+
+  if (pOperator->exprSupp.pFilterInfo != NULL) {
+    code = initFilterColIds(pTableScanNode->scan.node.pConditions, &pInfo->base.matchInfo, &pInfo->base.pFilterColIds);
+    if (code != TSDB_CODE_SUCCESS) {
+      goto _error;
+    }
+  }
+
   pInfo->currentGroupId = -1;
 
   pInfo->tableEndIndex = -1;
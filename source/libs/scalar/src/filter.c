@@ -3782,6 +3782,83 @@ int32_t fltSclBuildRangeFromBlockSma(SFltSclColumnRange *colRange, SColumnDataAg
   return TSDB_CODE_SUCCESS;
 }
 
+// check if filterRangeExecute is able to filter out a data block by the column statistics
+bool filterHasColRange(SFilterInfo *info) {
+  if (info == NULL) {
+    return false;
+  }
+
+  if (info->scalarMode) {
+    return taosArrayGetSize(info->sclCtx.fltSclRange) > 0;
+  }
+
+  if (FILTER_EMPTY_RES(info)) {
+    return true;
+  }
+
+  return (!FILTER_ALL_RES(info)) && (info->colRangeNum > 0);
+}
+
+// The filter can be evaluated on the dictionary of a column instead of its rows, if all units compare the same var-length
+// column with a value by equality or IN.
+bool filterGetDictColId(SFilterInfo *info, int16_t *colId) {
+  if (info == NULL || info->scalarMode || FILTER_EMPTY_RES(info) || FILTER_ALL_RES(info) || info->unitNum == 0 ||
+      info->cunits == NULL) {
+    return false;
+  }
+
+  for (uint32_t i = 0; i < info->unitNum; ++i) {
+    SFilterComUnit *cunit = &info->cunits[i];
+    if (!IS_VAR_DATA_TYPE(cunit->dataType) || cunit->dataType == TSDB_DATA_TYPE_JSON) {
+      return false;
+    }
+
+    if (cunit->optr != OP_TYPE_EQUAL && cunit->optr != OP_TYPE_NOT_EQUAL && cunit->optr != OP_TYPE_IN &&
+        cunit->optr != OP_TYPE_NOT_IN) {
+      return false;
+    }
+
+    if (cunit->rfunc >= 0 || cunit->valData == NULL || cunit->colId != info->cunits[0].colId) {
+      return false;
+    }
+  }
+
+  *colId = info->cunits[0].colId;
+  return true;
+}
+
+// Evaluate the filter on each distinct value of the column returned by filterGetDictColId, the result of a row is the
+// one of its dictionary entry. A NULL entry never qualifies, as no unit is a null check.
+int32_t filterExecuteOnDict(SFilterInfo *info, SColumnInfoData *pDict, int32_t numOfEntries, int8_t *pRes,
+                            int32_t *numOfQualified) {
+  *numOfQualified = 0;
+
+  for (int32_t i = 0; i < numOfEntries; ++i) {
+    pRes[i] = 0;
+    if (colDataIsNull_s(pDict, i)) {
+      continue;
+    }
+
+    void *colData = colDataGetData(pDict, i);
+    for (uint32_t g = 0; g < info->groupNum && !pRes[i]; ++g) {
+      SFilterGroup *group = &info->groups[g];
+
+      pRes[i] = 1;
+      for (uint32_t u = 0; u < group->unitNum; ++u) {
+        SFilterComUnit *cunit = &info->cunits[group->unitIdxs[u]];
+        if (!filterDoCompare(gDataCompare[cunit->func], cunit->optr, colData, cunit->valData)) {
+          pRes[i] = 0;
+          break;
+        }
+      }
+    }
+
+    *numOfQualified += pRes[i];
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
 bool filterRangeExecute(SFilterInfo *info, SColumnDataAgg *pDataStatis, int32_t numOfCols, int32_t numOfRows) {
   if (info->scalarMode) {
     SArray *colRanges = info->sclCtx.fltSclRange;
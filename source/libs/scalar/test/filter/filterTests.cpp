@@ -1341,6 +1341,105 @@ TEST(scalarModelogicTest, diff_columns_or_and_or) {
 }
 #endif
 
+TEST(columnTest, int_column_range_by_block_sma) {
+  SNode  *pLeft = NULL, *pRight = NULL, *opNode = NULL;
+  int32_t rightv = 4;
+  int32_t rowNum = 10;
+  flttMakeColumnNode(&pLeft, NULL, TSDB_DATA_TYPE_INT, sizeof(int32_t), rowNum, NULL);
+  flttMakeValueNode(&pRight, TSDB_DATA_TYPE_INT, &rightv);
+  flttMakeOpNode(&opNode, OP_TYPE_GREATER_THAN, TSDB_DATA_TYPE_BOOL, pLeft, pRight);
+
+  SFilterInfo *filter = NULL;
+  int32_t      code = filterInitFromNode(opNode, &filter, 0);
+  ASSERT_EQ(code, 0);
+  ASSERT_TRUE(filterHasColRange(filter));
+  ASSERT_FALSE(filterHasColRange(NULL));
+
+  SColumnDataAgg stat = {0};
+  stat.colId = ((SColumnNode *)pLeft)->colId;
+  stat.max = 10;
+  stat.min = 5;
+  ASSERT_TRUE(filterRangeExecute(filter, &stat, 1, rowNum));
+
+  stat.max = 4;
+  stat.min = -1;
+  ASSERT_FALSE(filterRangeExecute(filter, &stat, 1, rowNum));
+
+  // no statistics for the filtered column, the block can not be skipped
+  stat.colId = ((SColumnNode *)pLeft)->colId + 1;
+  ASSERT_TRUE(filterRangeExecute(filter, &stat, 1, rowNum));
+
+  filterFreeInfo(filter);
+  nodesDestroyNode(opNode);
+}
+
+TEST(columnTest, binary_column_in_binary_list_by_dict) {
+  SNode *pLeft = NULL, *pRight = NULL, *listNode = NULL, *opNode = NULL;
+  char   entries[4][8] = {0};
+  char   rightv[2][8] = {0};
+  for (int32_t i = 0; i < 4; ++i) {
+    snprintf(varDataVal(entries[i]), 4, "ab%d", i);
+    varDataSetLen(entries[i], 3);
+  }
+  for (int32_t i = 0; i < 2; ++i) {
+    snprintf(varDataVal(rightv[i]), 4, "ab%d", i * 2);
+    varDataSetLen(rightv[i], 3);
+  }
+
+  flttMakeColumnNode(&pLeft, NULL, TSDB_DATA_TYPE_BINARY, 3, 4, NULL);
+  SNodeList *list = nodesMakeList();
+  flttMakeValueNode(&pRight, TSDB_DATA_TYPE_BINARY, rightv[0]);
+  nodesListAppend(list, pRight);
+  flttMakeValueNode(&pRight, TSDB_DATA_TYPE_BINARY, rightv[1]);
+  nodesListAppend(list, pRight);
+  flttMakeListNode(&listNode, list, TSDB_DATA_TYPE_BINARY);
+  flttMakeOpNode(&opNode, OP_TYPE_IN, TSDB_DATA_TYPE_BOOL, pLeft, listNode);
+
+  SFilterInfo *filter = NULL;
+  int32_t      code = filterInitFromNode(opNode, &filter, 0);
+  ASSERT_EQ(code, 0);
+
+  int16_t colId = 0;
+  ASSERT_TRUE(filterGetDictColId(filter, &colId));
+  ASSERT_EQ(colId, ((SColumnNode *)pLeft)->colId);
+
+  // the dictionary entries ab0..ab3 and a NULL entry, only ab0 and ab2 are in the list
+  SColumnInfoData dict = createColumnInfoData(TSDB_DATA_TYPE_BINARY, 3 + VARSTR_HEADER_SIZE, colId);
+  ASSERT_EQ(colInfoDataEnsureCapacity(&dict, 5, false), 0);
+  for (int32_t i = 0; i < 4; ++i) {
+    colDataSetVal(&dict, i, entries[i], false);
+  }
+  colDataSetNULL(&dict, 4);
+
+  int8_t  res[5] = {0};
+  int8_t  eRes[5] = {1, 0, 1, 0, 0};
+  int32_t numOfQualified = 0;
+  ASSERT_EQ(filterExecuteOnDict(filter, &dict, 5, res, &numOfQualified), 0);
+  ASSERT_EQ(numOfQualified, 2);
+  for (int32_t i = 0; i < 5; ++i) {
+    ASSERT_EQ(res[i], eRes[i]);
+  }
+
+  colDataDestroy(&dict);
+  filterFreeInfo(filter);
+  nodesDestroyNode(opNode);
+
+  // a filter on a numeric column can not be evaluated on a dictionary
+  int32_t v = 4;
+  flttMakeColumnNode(&pLeft, NULL, TSDB_DATA_TYPE_INT, sizeof(int32_t), 4, NULL);
+  flttMakeValueNode(&pRight, TSDB_DATA_TYPE_INT, &v);
+  flttMakeOpNode(&opNode, OP_TYPE_EQUAL, TSDB_DATA_TYPE_BOOL, pLeft, pRight);
+
+  filter = NULL;
+  code = filterInitFromNode(opNode, &filter, 0);
+  ASSERT_EQ(code, 0);
+  ASSERT_FALSE(filterGetDictColId(filter, &colId));
+  ASSERT_FALSE(filterGetDictColId(NULL, &colId));
+
+  filterFreeInfo(filter);
+  nodesDestroyNode(opNode);
+}
+
 template <class SignedT, class UnsignedT>
 int32_t compareSignedWithUnsigned(SignedT l, UnsignedT r) {
   if (l < 0) return -1;
@@ -131,41 +131,46 @@ int32_t syncNodeOnAppendEntries(SSyncNode* ths, const SRpcMsg* pRpcMsg) {
     resetElect = true;
   }
 
-  if (pMsg->dataLen < sizeof(SSyncRaftEntry)) {
-    sError("vgId:%d, incomplete append entries received. prev index:%" PRId64 ", term:%" PRId64 ", datalen:%d",
+  // the consecutive entries from prevLogIndex + 1, one at least
+  int32_t nEntry = syncEntryNumInAppendEntries(pMsg);
+  if (nEntry <= 0) {
+    sError("vgId:%d, invalid append entries received. prev index:%" PRId64 ", term:%" PRId64 ", datalen:%d",
            ths->vgId, pMsg->prevLogIndex, pMsg->prevLogTerm, pMsg->dataLen);
     goto _IGNORE;
   }
 
-  pEntry = syncEntryBuildFromAppendEntries(pMsg);
-  if (pEntry == NULL) {
-    sError("vgId:%d, failed to get raft entry from append entries since %s", ths->vgId, terrstr());
-    goto _IGNORE;
-  }
-
-  if (pMsg->prevLogIndex + 1 != pEntry->index || pEntry->term < 0) {
-    sError("vgId:%d, invalid previous log index in msg. index:%" PRId64 ",  term:%" PRId64 ", prevLogIndex:%" PRId64
-           ", prevLogTerm:%" PRId64,
-           ths->vgId, pEntry->index, pEntry->term, pMsg->prevLogIndex, pMsg->prevLogTerm);
-    goto _IGNORE;
-  }
-
-  sTrace("vgId:%d, recv append entries msg. index:%" PRId64 ", term:%" PRId64 ", preLogIndex:%" PRId64
-         ", prevLogTerm:%" PRId64 " commitIndex:%" PRId64 " entryterm:%" PRId64,
-         pMsg->vgId, pMsg->prevLogIndex + 1, pMsg->term, pMsg->prevLogIndex, pMsg->prevLogTerm, pMsg->commitIndex,
-         pEntry->term);
+  sTrace("vgId:%d, recv append entries msg. index:%" PRId64 ", entries:%d, term:%" PRId64 ", preLogIndex:%" PRId64
+         ", prevLogTerm:%" PRId64 " commitIndex:%" PRId64,
+         pMsg->vgId, pMsg->prevLogIndex + 1, nEntry, pMsg->term, pMsg->prevLogIndex, pMsg->prevLogTerm,
+         pMsg->commitIndex);
 
   if (ths->fsmState == SYNC_FSM_STATE_INCOMPLETE) {
     pReply->fsmState = ths->fsmState;
-    sWarn("vgId:%d, unable to accept, due to incomplete fsm state. index:%" PRId64, ths->vgId, pEntry->index);
-    syncEntryDestroy(pEntry);
+    sWarn("vgId:%d, unable to accept, due to incomplete fsm state. index:%" PRId64, ths->vgId, pMsg->prevLogIndex + 1);
     goto _SEND_RESPONSE;
   }
 
-  // accept
-  if (syncLogBufferAccept(ths->pLogBuf, ths, pEntry, pMsg->prevLogTerm) < 0) {
-    goto _SEND_RESPONSE;
+  // accept in order, and the entries accepted are persisted together on proceeding
+  SyncTerm prevLogTerm = pMsg->prevLogTerm;
+  uint32_t offset = 0;
+  for (int32_t i = 0; i < nEntry; i++) {
+    // the leader acks lastSendIndex, so a partial accept reports the last entry accepted, and the rest is resent
+    if (i > 0) pReply->lastSendIndex = pMsg->prevLogIndex + i;
+
+    pEntry = syncEntryBuildFromAppendEntries(pMsg, offset);
+    if (pEntry == NULL) {
+      sError("vgId:%d, failed to get raft entry from append entries since %s", ths->vgId, terrstr());
+      goto _SEND_RESPONSE;
+    }
+    offset += pEntry->bytes;
+
+    SyncTerm term = pEntry->term;
+    if (syncLogBufferAccept(ths->pLogBuf, ths, pEntry, prevLogTerm) < 0) {
+      goto _SEND_RESPONSE;
+    }
+    prevLogTerm = term;
   }
+  pReply->lastSendIndex = pMsg->prevLogIndex + nEntry;
   accepted = true;
 
 _SEND_RESPONSE:
@@ -59,6 +59,8 @@ static int32_t syncNodeLeaderTransferTo(SSyncNode* pSyncNode, SNodeInfo newLeade
 static int32_t syncDoLeaderTransfer(SSyncNode* ths, SRpcMsg* pRpcMsg, SSyncRaftEntry* pEntry);
 
 static ESyncStrategy syncNodeStrategy(SSyncNode* pSyncNode);
+static void          syncNodeEqWalSynced(int64_t rid, int64_t ver);
+static int32_t       syncNodeOnWalSynced(SSyncNode* ths);
 
 int64_t syncOpen(SSyncInfo* pSyncInfo, int32_t vnodeVersion) {
   SSyncNode* pSyncNode = syncNodeOpen(pSyncInfo, vnodeVersion);
@@ -79,6 +81,8 @@ int64_t syncOpen(SSyncInfo* pSyncInfo, int32_t vnodeVersion) {
   pSyncNode->hbBaseLine = pSyncInfo->heartbeatMs;
   pSyncNode->heartbeatTimerMS = pSyncInfo->heartbeatMs;
   pSyncNode->msgcb = pSyncInfo->msgcb;
+
+  walSetSyncedCb(pSyncNode->pWal, syncNodeEqWalSynced, pSyncNode->rid);
   return pSyncNode->rid;
 }
 
@@ -126,6 +130,7 @@ void syncStop(int64_t rid) {
   SSyncNode* pSyncNode = syncNodeAcquire(rid);
   if (pSyncNode != NULL) {
     pSyncNode->isStart = false;
+    walSetSyncedCb(pSyncNode->pWal, NULL, 0);
     syncNodeRelease(pSyncNode);
     syncNodeRemove(rid);
   }
@@ -3375,6 +3380,9 @@ int32_t syncNodeOnLocalCmd(SSyncNode* ths, const SRpcMsg* pRpcMsg) {
   if (pMsg->cmd == SYNC_LOCAL_CMD_STEP_DOWN) {
     syncNodeStepDown(ths, pMsg->currentTerm);
 
+  } else if (pMsg->cmd == SYNC_LOCAL_CMD_WAL_SYNCED) {
+    (void)syncNodeOnWalSynced(ths);
+
   } else if (pMsg->cmd == SYNC_LOCAL_CMD_FOLLOWER_CMT || pMsg->cmd == SYNC_LOCAL_CMD_LEARNER_CMT) {
     if (syncLogBufferIsEmpty(ths->pLogBuf)) {
       sError("vgId:%d, sync log buffer is empty.", ths->vgId);
@@ -3395,6 +3403,61 @@ int32_t syncNodeOnLocalCmd(SSyncNode* ths, const SRpcMsg* pRpcMsg) {
   return 0;
 }
 
+// called by the wal flush thread, the match index of the leader itself is updated in the sync thread
+static void syncNodeEqWalSynced(int64_t rid, int64_t ver) {
+  SSyncNode* pSyncNode = syncNodeAcquire(rid);
+  if (pSyncNode == NULL) return;
+
+  if (pSyncNode->state == TAOS_SYNC_STATE_LEADER || pSyncNode->state == TAOS_SYNC_STATE_ASSIGNED_LEADER) {
+    SRpcMsg rpcMsgLocalCmd = {0};
+    if (syncBuildLocalCmd(&rpcMsgLocalCmd, pSyncNode->vgId) == 0) {
+      SyncLocalCmd* pSyncMsg = rpcMsgLocalCmd.pCont;
+      pSyncMsg->cmd = SYNC_LOCAL_CMD_WAL_SYNCED;
+      pSyncMsg->commitIndex = ver;
+
+      if (pSyncNode->syncEqMsg == NULL || pSyncNode->msgcb == NULL ||
+          pSyncNode->syncEqMsg(pSyncNode->msgcb, &rpcMsgLocalCmd) != 0) {
+        sError("vgId:%d, failed to enqueue wal synced msg, index:%" PRId64, pSyncNode->vgId, ver);
+        rpcFreeCont(rpcMsgLocalCmd.pCont);
+      }
+    }
+  }
+
+  syncNodeRelease(pSyncNode);
+}
+
+static int32_t syncNodeOnWalSynced(SSyncNode* ths) {
+  if (ths->state != TAOS_SYNC_STATE_LEADER && ths->state != TAOS_SYNC_STATE_ASSIGNED_LEADER) {
+    return 0;
+  }
+
+  SyncIndex matchIndex = TMIN(ths->pLogBuf->matchIndex, ths->pLogStore->syncLogSyncedIndex(ths->pLogStore, false));
+  if (matchIndex <= syncIndexMgrGetIndex(ths->pMatchIndex, &ths->myRaftId)) {
+    return 0;
+  }
+  syncIndexMgrSetIndex(ths->pMatchIndex, &ths->myRaftId, matchIndex);
+
+  if (ths->state == TAOS_SYNC_STATE_ASSIGNED_LEADER) {
+    (void)syncNodeUpdateAssignedCommitIndex(ths, matchIndex);
+    if (ths->fsmState != SYNC_FSM_STATE_INCOMPLETE &&
+        syncLogBufferCommit(ths->pLogBuf, ths, ths->assignedCommitIndex) < 0) {
+      sError("vgId:%d, failed to commit until commitIndex:%" PRId64 "", ths->vgId, ths->commitIndex);
+      return -1;
+    }
+    if (ths->replicaNum > 1) {
+      return 0;
+    }
+  }
+
+  SyncIndex commitIndex = (ths->replicaNum > 1) ? syncNodeCheckCommitIndex(ths, matchIndex)
+                                                : syncNodeUpdateCommitIndex(ths, matchIndex);
+  if (ths->fsmState != SYNC_FSM_STATE_INCOMPLETE && syncLogBufferCommit(ths->pLogBuf, ths, commitIndex) < 0) {
+    sError("vgId:%d, failed to commit until commitIndex:%" PRId64 "", ths->vgId, commitIndex);
+    return -1;
+  }
+  return 0;
+}
+
 // TLA+ Spec
 // ClientRequest(i, v) ==
 //     /\ state[i] = Leader
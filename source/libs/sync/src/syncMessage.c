@@ -156,7 +156,17 @@ int32_t syncBuildAppendEntriesReply(SRpcMsg* pMsg, int32_t vgId) {
 
 int32_t syncBuildAppendEntriesFromRaftEntry(SSyncNode* pNode, SSyncRaftEntry* pEntry, SyncTerm prevLogTerm,
                                             SRpcMsg* pRpcMsg) {
-  uint32_t dataLen = pEntry->bytes;
+  return syncBuildAppendEntriesFromRaftEntries(pNode, &pEntry, 1, prevLogTerm, pRpcMsg);
+}
+
+// the consecutive entries follow one another in data, each led by its bytes
+int32_t syncBuildAppendEntriesFromRaftEntries(SSyncNode* pNode, SSyncRaftEntry** aEntry, int32_t nEntry,
+                                              SyncTerm prevLogTerm, SRpcMsg* pRpcMsg) {
+  uint32_t dataLen = 0;
+  for (int32_t i = 0; i < nEntry; i++) {
+    ASSERT(aEntry[i]->index == aEntry[0]->index + i);
+    dataLen += aEntry[i]->bytes;
+  }
   uint32_t bytes = sizeof(SyncAppendEntries) + dataLen;
   pRpcMsg->contLen = bytes;
   pRpcMsg->pCont = rpcMallocCont(pRpcMsg->contLen);
@@ -170,9 +180,13 @@ int32_t syncBuildAppendEntriesFromRaftEntry(SSyncNode* pNode, SSyncRaftEntry* pE
   pMsg->msgType = pRpcMsg->msgType = TDMT_SYNC_APPEND_ENTRIES;
   pMsg->dataLen = dataLen;
 
-  (void)memcpy(pMsg->data, pEntry, dataLen);
+  uint32_t offset = 0;
+  for (int32_t i = 0; i < nEntry; i++) {
+    (void)memcpy(pMsg->data + offset, aEntry[i], aEntry[i]->bytes);
+    offset += aEntry[i]->bytes;
+  }
 
-  pMsg->prevLogIndex = pEntry->index - 1;
+  pMsg->prevLogIndex = aEntry[0]->index - 1;
   pMsg->prevLogTerm = prevLogTerm;
   pMsg->vgId = pNode->vgId;
   pMsg->srcId = pNode->myRaftId;
@@ -304,6 +318,8 @@ const char* syncLocalCmdGetStr(ESyncLocalCmd cmd) {
       return "step-down";
     case SYNC_LOCAL_CMD_FOLLOWER_CMT:
       return "follower-commit";
+    case SYNC_LOCAL_CMD_WAL_SYNCED:
+      return "wal-synced";
     default:
       return "unknown-local-cmd";
   }
@@ -25,6 +25,7 @@
 #include "syncRespMgr.h"
 #include "syncSnapshot.h"
 #include "syncUtil.h"
+#include "tglobal.h"
 #include "syncRaftCfg.h"
 #include "syncVoteMgr.h"
 
@@ -408,7 +409,8 @@ static inline bool syncLogStoreNeedFlush(SSyncRaftEntry* pEntry, int32_t replica
   return (replicaNum > 1) && (pEntry->originalRpcType == TDMT_VND_COMMIT);
 }
 
-int32_t syncLogStorePersist(SSyncLogStore* pLogStore, SSyncNode* pNode, SSyncRaftEntry* pEntry) {
+// write the entry without flushing it, and tell whether the flush after the batch shall be forced
+int32_t syncLogStorePersist(SSyncLogStore* pLogStore, SSyncNode* pNode, SSyncRaftEntry* pEntry, bool* pForceFlush) {
   ASSERT(pEntry->index >= 0);
   SyncIndex lastVer = pLogStore->syncLogLastIndex(pLogStore);
   if (lastVer >= pEntry->index && pLogStore->syncLogTruncate(pLogStore, pEntry->index) < 0) {
@@ -418,8 +420,7 @@ int32_t syncLogStorePersist(SSyncLogStore* pLogStore, SSyncNode* pNode, SSyncRaf
   lastVer = pLogStore->syncLogLastIndex(pLogStore);
   ASSERT(pEntry->index == lastVer + 1);
 
-  bool doFsync = syncLogStoreNeedFlush(pEntry, pNode->replicaNum);
-  if (pLogStore->syncLogAppendEntry(pLogStore, pEntry, doFsync) < 0) {
+  if (pLogStore->syncLogWriteEntry(pLogStore, pEntry) < 0) {
     sError("failed to append sync log entry since %s. index:%" PRId64 ", term:%" PRId64 "", terrstr(), pEntry->index,
            pEntry->term);
     return -1;
@@ -427,6 +428,7 @@ int32_t syncLogStorePersist(SSyncLogStore* pLogStore, SSyncNode* pNode, SSyncRaf
 
   lastVer = pLogStore->syncLogLastIndex(pLogStore);
   ASSERT(pEntry->index == lastVer);
+  if (syncLogStoreNeedFlush(pEntry, pNode->replicaNum)) *pForceFlush = true;
   return 0;
 }
 
@@ -436,6 +438,9 @@ int64_t syncLogBufferProceed(SSyncLogBuffer* pBuf, SSyncNode* pNode, SyncTerm* p
 
   SSyncLogStore* pLogStore = pNode->pLogStore;
   int64_t        matchIndex = pBuf->matchIndex;
+  int64_t        startIndex = matchIndex;
+  bool           persisted = false;
+  bool           forceFlush = false;
 
   while (pBuf->matchIndex + 1 < pBuf->endIndex) {
     int64_t index = pBuf->matchIndex + 1;
@@ -478,12 +483,13 @@ int64_t syncLogBufferProceed(SSyncLogBuffer* pBuf, SSyncNode* pNode, SyncTerm* p
            pNode->vgId, pBuf->startIndex, pBuf->matchIndex, pBuf->endIndex);
 
     // persist
-    if (syncLogStorePersist(pLogStore, pNode, pEntry) < 0) {
+    if (syncLogStorePersist(pLogStore, pNode, pEntry, &forceFlush) < 0) {
       sError("vgId:%d, failed to persist sync log entry from buffer since %s. index:%" PRId64, pNode->vgId, terrstr(),
              pEntry->index);
       taosMsleep(1);
       goto _out;
     }
+    persisted = true;
 
     if(pEntry->originalRpcType == TDMT_SYNC_CONFIG_CHANGE){
       if(pNode->pLogBuf->commitIndex == pEntry->index -1){
@@ -519,19 +525,31 @@ int64_t syncLogBufferProceed(SSyncLogBuffer* pBuf, SSyncNode* pNode, SyncTerm* p
 
     ASSERT(pEntry->index == pBuf->matchIndex);
 
-    // update my match index
     matchIndex = pBuf->matchIndex;
-    syncIndexMgrSetIndex(pNode->pMatchIndex, &pNode->myRaftId, pBuf->matchIndex);
   }  // end of while
 
 _out:
+  // flush the entries persisted above at once, instead of once per entry
+  if (persisted) {
+    pLogStore->syncLogFlush(pLogStore, forceFlush);
+  }
+
   pBuf->matchIndex = matchIndex;
   if (pMatchTerm) {
     *pMatchTerm = pBuf->entries[(matchIndex + pBuf->size) % pBuf->size].pItem->term;
   }
+
+  // update my match index. With the wal group commit, the leader counts only the entries fsynced, and catches up when
+  // the wal tells; the others fsync the entries before the reply, so that the leader counts durable entries only.
+  bool    isLeader = pNode->state == TAOS_SYNC_STATE_LEADER || pNode->state == TAOS_SYNC_STATE_ASSIGNED_LEADER;
+  int64_t syncedIndex = TMIN(matchIndex, pLogStore->syncLogSyncedIndex(pLogStore, !isLeader));
+  if (matchIndex > startIndex) {
+    syncIndexMgrSetIndex(pNode->pMatchIndex, &pNode->myRaftId, syncedIndex);
+  }
+
   syncLogBufferValidate(pBuf);
   taosThreadMutexUnlock(&pBuf->mutex);
-  return matchIndex;
+  return syncedIndex;
 }
 
 int32_t syncFsmExecute(SSyncNode* pNode, SSyncFSM* pFsm, ESyncState role, SyncTerm term, SSyncRaftEntry* pEntry,
@@ -990,6 +1008,85 @@ int32_t syncLogReplProbe(SSyncLogReplMgr* pMgr, SSyncNode* pNode, SyncIndex inde
   return 0;
 }
 
+/*
+ * Send the entries from index on to lastIndex in one msg, but syncLogReplMaxBatchN of them and
+ * SYNC_LOG_REPL_MAX_BATCH_BYTES at most, the first entry is sent anyway. A barrier ends the batch, so it is the
+ * last entry sent. The states of the entries sent are set as they are sent one by one.
+ *
+ * @return the number of the entries sent, or -1 if failed
+ */
+int32_t syncLogReplSendBatchTo(SSyncLogReplMgr* pMgr, SSyncNode* pNode, SyncIndex index, SyncIndex lastIndex,
+                               SRaftId* pDestId, int64_t nowMs, SyncTerm* pTerm, bool* pBarrier) {
+  SSyncRaftEntry* aEntry[SYNC_LOG_REPL_MAX_BATCH_N];
+  bool            aInBuf[SYNC_LOG_REPL_MAX_BATCH_N];
+  int32_t         maxN = TMIN(tsSyncLogReplMaxBatchN, SYNC_LOG_REPL_MAX_BATCH_N);
+  int32_t         nEntry = 0;
+  int64_t         bytes = 0;
+  int32_t         ret = -1;
+  SRpcMsg         msgOut = {0};
+  SSyncLogBuffer* pBuf = pNode->pLogBuf;
+
+  SyncTerm prevLogTerm = syncLogReplGetPrevLogTerm(pMgr, pNode, index);
+  if (prevLogTerm < 0) {
+    sError("vgId:%d, failed to get prev log term since %s. index:%" PRId64 "", pNode->vgId, terrstr(), index);
+    return -1;
+  }
+
+  *pBarrier = false;
+  for (SyncIndex i = index; i <= lastIndex && nEntry < maxN && !*pBarrier; i++) {
+    bool            inBuf = false;
+    SSyncRaftEntry* pEntry = syncLogBufferGetOneEntry(pBuf, pNode, i, &inBuf);
+    if (pEntry == NULL) {
+      sWarn("vgId:%d, failed to get raft entry for index:%" PRId64 "", pNode->vgId, i);
+      if (nEntry > 0) break;
+      if (terrno == TSDB_CODE_WAL_LOG_NOT_EXIST) {
+        sInfo("vgId:%d, reset sync log repl of peer:%" PRIx64 " since %s. index:%" PRId64, pNode->vgId, pDestId->addr,
+              terrstr(), i);
+        (void)syncLogReplReset(pMgr);
+      }
+      goto _out;
+    }
+
+    if (nEntry > 0 && bytes + pEntry->bytes > SYNC_LOG_REPL_MAX_BATCH_BYTES) {
+      if (!inBuf) syncEntryDestroy(pEntry);
+      break;
+    }
+
+    aEntry[nEntry] = pEntry;
+    aInBuf[nEntry] = inBuf;
+    nEntry++;
+    bytes += pEntry->bytes;
+    *pBarrier = syncLogReplBarrier(pEntry);
+    *pTerm = pEntry->term;
+  }
+
+  if (syncBuildAppendEntriesFromRaftEntries(pNode, aEntry, nEntry, prevLogTerm, &msgOut) < 0) {
+    sError("vgId:%d, failed to get append entries for index:%" PRId64 "", pNode->vgId, index);
+    goto _out;
+  }
+
+  (void)syncNodeSendAppendEntries(pNode, pDestId, &msgOut);
+
+  for (int32_t i = 0; i < nEntry; i++) {
+    int64_t pos = aEntry[i]->index % pMgr->size;
+    pMgr->states[pos].barrier = syncLogReplBarrier(aEntry[i]);
+    pMgr->states[pos].timeMs = nowMs;
+    pMgr->states[pos].term = aEntry[i]->term;
+    pMgr->states[pos].acked = false;
+  }
+
+  sTrace("vgId:%d, replicate %d entries in one msg index:%" PRId64 " term:%" PRId64 " prevterm:%" PRId64
+         " bytes:%" PRId64 " to dest: 0x%016" PRIx64,
+         pNode->vgId, nEntry, index, *pTerm, prevLogTerm, bytes, pDestId->addr);
+  ret = nEntry;
+
+_out:
+  for (int32_t i = 0; i < nEntry; i++) {
+    if (!aInBuf[i]) syncEntryDestroy(aEntry[i]);
+  }
+  return ret;
+}
+
 int32_t syncLogReplAttempt(SSyncLogReplMgr* pMgr, SSyncNode* pNode) {
   ASSERT(pMgr->restored);
 
@@ -1001,35 +1098,34 @@ int32_t syncLogReplAttempt(SSyncLogReplMgr* pMgr, SSyncNode* pNode) {
   SyncTerm  term = -1;
   SyncIndex firstIndex = -1;
 
-  for (SyncIndex index = pMgr->endIndex; index <= pNode->pLogBuf->matchIndex; index++) {
+  for (SyncIndex index = pMgr->endIndex; index <= pNode->pLogBuf->matchIndex;) {
     if (batchSize < count || limit <= index - pMgr->startIndex) {
       break;
     }
     if (pMgr->startIndex + 1 < index && pMgr->states[(index - 1) % pMgr->size].barrier) {
       break;
     }
-    int64_t  pos = index % pMgr->size;
+    // the entries of one msg stay within the window and the batch size
+    SyncIndex lastIndex = TMIN(pNode->pLogBuf->matchIndex, pMgr->startIndex + limit - 1);
+    lastIndex = TMIN(lastIndex, index + batchSize - count);
     SRaftId* pDestId = &pNode->replicasId[pMgr->peerId];
     bool     barrier = false;
-    SyncTerm term = -1;
-    if (syncLogReplSendTo(pMgr, pNode, index, &term, pDestId, &barrier) < 0) {
+    int32_t  nSent = syncLogReplSendBatchTo(pMgr, pNode, index, lastIndex, pDestId, nowMs, &term, &barrier);
+    if (nSent < 0) {
       sError("vgId:%d, failed to replicate log entry since %s. index:%" PRId64 ", dest: 0x%016" PRIx64 "", pNode->vgId,
              terrstr(), index, pDestId->addr);
       return -1;
     }
-    pMgr->states[pos].barrier = barrier;
-    pMgr->states[pos].timeMs = nowMs;
-    pMgr->states[pos].term = term;
-    pMgr->states[pos].acked = false;
 
     if (firstIndex == -1) firstIndex = index;
-    count++;
+    count += nSent;
+    index += nSent;
 
-    pMgr->endIndex = index + 1;
+    pMgr->endIndex = index;
     if (barrier) {
       sInfo("vgId:%d, replicated sync barrier to dnode:%d. index:%" PRId64 ", term:%" PRId64 ", repl-mgr:[%" PRId64
             " %" PRId64 ", %" PRId64 ")",
-            pNode->vgId, DID(pDestId), index, term, pMgr->startIndex, pMgr->matchIndex, pMgr->endIndex);
+            pNode->vgId, DID(pDestId), index - 1, term, pMgr->startIndex, pMgr->matchIndex, pMgr->endIndex);
       break;
     }
   }
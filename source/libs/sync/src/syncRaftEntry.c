@@ -63,17 +63,46 @@ SSyncRaftEntry* syncEntryBuildFromRpcMsg(const SRpcMsg* pMsg, SyncTerm term, Syn
   return pEntry;
 }
 
-SSyncRaftEntry* syncEntryBuildFromAppendEntries(const SyncAppendEntries* pMsg) {
-  SSyncRaftEntry* pEntry = taosMemoryMalloc(pMsg->dataLen);
+// the entry at offset of data, validated by syncEntryNumInAppendEntries
+SSyncRaftEntry* syncEntryBuildFromAppendEntries(const SyncAppendEntries* pMsg, uint32_t offset) {
+  uint32_t bytes = 0;
+  memcpy(&bytes, pMsg->data + offset, sizeof(bytes));
+  ASSERT(offset + bytes <= pMsg->dataLen);
+
+  SSyncRaftEntry* pEntry = taosMemoryMalloc(bytes);
   if (pEntry == NULL) {
     terrno = TSDB_CODE_OUT_OF_MEMORY;
     return NULL;
   }
-  memcpy(pEntry, pMsg->data, pMsg->dataLen);
-  ASSERT(pEntry->bytes == pMsg->dataLen);
+  memcpy(pEntry, pMsg->data + offset, bytes);
   return pEntry;
 }
 
+/**
+ * @brief the number of the consecutive entries in data, from prevLogIndex + 1
+ *
+ * @return -1 if the entries do not fill the data exactly, are not consecutive, or any of them is malformed
+ */
+int32_t syncEntryNumInAppendEntries(const SyncAppendEntries* pMsg) {
+  int32_t  nEntry = 0;
+  uint32_t offset = 0;
+
+  while (offset < pMsg->dataLen) {
+    if (pMsg->dataLen - offset < sizeof(SSyncRaftEntry)) return -1;
+
+    SSyncRaftEntry entry;
+    memcpy(&entry, pMsg->data + offset, sizeof(SSyncRaftEntry));
+    if (entry.bytes < sizeof(SSyncRaftEntry) || entry.bytes > pMsg->dataLen - offset) return -1;
+    if (entry.bytes != sizeof(SSyncRaftEntry) + entry.dataLen) return -1;
+    if (entry.index != pMsg->prevLogIndex + 1 + nEntry || entry.term < 0) return -1;
+
+    offset += entry.bytes;
+    nEntry++;
+  }
+
+  return nEntry;
+}
+
 SSyncRaftEntry* syncEntryBuildNoop(SyncTerm term, SyncIndex index, int32_t vgId) {
   SSyncRaftEntry* pEntry = syncEntryBuild(sizeof(SMsgHead));
   if (pEntry == NULL) return NULL;
@@ -24,6 +24,9 @@
 // public function
 static int32_t   raftLogRestoreFromSnapshot(struct SSyncLogStore* pLogStore, SyncIndex snapshotIndex);
 static int32_t   raftLogAppendEntry(struct SSyncLogStore* pLogStore, SSyncRaftEntry* pEntry, bool forceSync);
+static int32_t   raftLogWriteEntry(struct SSyncLogStore* pLogStore, SSyncRaftEntry* pEntry);
+static void      raftLogFlush(struct SSyncLogStore* pLogStore, bool forceSync);
+static SyncIndex raftLogSyncedIndex(struct SSyncLogStore* pLogStore, bool forceSync);
 static int32_t   raftLogTruncate(struct SSyncLogStore* pLogStore, SyncIndex fromIndex);
 static bool      raftLogExist(struct SSyncLogStore* pLogStore, SyncIndex index);
 static int32_t   raftLogUpdateCommitIndex(SSyncLogStore* pLogStore, SyncIndex index);
@@ -70,9 +73,12 @@ SSyncLogStore* logStoreCreate(SSyncNode* pSyncNode) {
   pLogStore->syncLogIsEmpty = raftLogIsEmpty;
   pLogStore->syncLogEntryCount = raftLogEntryCount;
   pLogStore->syncLogLastIndex = raftLogLastIndex;
+  pLogStore->syncLogSyncedIndex = raftLogSyncedIndex;
   pLogStore->syncLogIndexRetention = raftLogIndexRetention;
   pLogStore->syncLogLastTerm = raftLogLastTerm;
   pLogStore->syncLogAppendEntry = raftLogAppendEntry;
+  pLogStore->syncLogWriteEntry = raftLogWriteEntry;
+  pLogStore->syncLogFlush = raftLogFlush;
   pLogStore->syncLogGetEntry = raftLogGetEntry;
   pLogStore->syncLogTruncate = raftLogTruncate;
   pLogStore->syncLogWriteIndex = raftLogWriteIndex;
@@ -155,6 +161,17 @@ SyncIndex raftLogLastIndex(struct SSyncLogStore* pLogStore) {
   return lastVer;
 }
 
+// the last index fsynced, which lags behind the last index with the wal group commit, unless forceSync
+static SyncIndex raftLogSyncedIndex(struct SSyncLogStore* pLogStore, bool forceSync) {
+  SSyncLogStoreData* pData = pLogStore->data;
+  SWal*              pWal = pData->pWal;
+
+  if (forceSync && walGetSyncedVer(pWal) < walGetLastVer(pWal)) {
+    walFsync(pWal, true);
+  }
+  return walGetSyncedVer(pWal);
+}
+
 SyncIndex raftLogIndexRetention(struct SSyncLogStore* pLogStore, int64_t bytes) {
   SyncIndex          lastIndex;
   SSyncLogStoreData* pData = pLogStore->data;
@@ -202,7 +219,8 @@ SyncTerm raftLogLastTerm(struct SSyncLogStore* pLogStore) {
   return SYNC_TERM_INVALID;
 }
 
-static int32_t raftLogAppendEntry(struct SSyncLogStore* pLogStore, SSyncRaftEntry* pEntry, bool forceSync) {
+// write the entry into the wal without flushing it, see raftLogFlush
+static int32_t raftLogWriteEntry(struct SSyncLogStore* pLogStore, SSyncRaftEntry* pEntry) {
   SSyncLogStoreData* pData = pLogStore->data;
   SWal*              pWal = pData->pWal;
 
@@ -229,13 +247,24 @@ static int32_t raftLogAppendEntry(struct SSyncLogStore* pLogStore, SSyncRaftEntr
 
   ASSERT(pEntry->index == index);
 
-  walFsync(pWal, forceSync);
-
   sNTrace(pData->pSyncNode, "write index:%" PRId64 ", type:%s, origin type:%s, elapsed:%" PRId64, pEntry->index,
           TMSG_INFO(pEntry->msgType), TMSG_INFO(pEntry->originalRpcType), tsElapsed);
   return 0;
 }
 
+static void raftLogFlush(struct SSyncLogStore* pLogStore, bool forceSync) {
+  SSyncLogStoreData* pData = pLogStore->data;
+  walFsync(pData->pWal, forceSync);
+}
+
+static int32_t raftLogAppendEntry(struct SSyncLogStore* pLogStore, SSyncRaftEntry* pEntry, bool forceSync) {
+  if (raftLogWriteEntry(pLogStore, pEntry) < 0) {
+    return -1;
+  }
+  raftLogFlush(pLogStore, forceSync);
+  return 0;
+}
+
 // entry found, return 0
 // entry not found, return -1, terrno = TSDB_CODE_WAL_LOG_NOT_EXIST
 // other error, return -1
@@ -0,0 +1,434 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "syncMessage.h"
+#include "syncPipeline.h"
+#include "syncRaftEntry.h"
+#include "tglobal.h"
+
+namespace {
+
+const int32_t   kVgId = 2;
+const SyncTerm  kTerm = 3;
+const SyncIndex kLastIndex = 1100;
+
+// the append entries msgs sent to the peer, in host order
+std::vector<std::string> sent;
+
+int32_t captureSend(const SEpSet *pEpSet, SRpcMsg *pMsg) {
+  SMsgHead *pHead = (SMsgHead *)pMsg->pCont;
+  pHead->contLen = ntohl(pHead->contLen);
+  pHead->vgId = ntohl(pHead->vgId);
+  sent.push_back(std::string((char *)pMsg->pCont, pMsg->contLen));
+  rpcFreeCont(pMsg->pCont);
+  return 0;
+}
+
+SSyncRaftEntry *createEntry(SyncIndex index, int32_t dataLen) {
+  SSyncRaftEntry *pEntry = syncEntryBuild(dataLen);
+  pEntry->msgType = TDMT_SYNC_CLIENT_REQUEST;
+  pEntry->originalRpcType = TDMT_VND_SUBMIT;
+  pEntry->term = kTerm;
+  pEntry->index = index;
+  for (int32_t i = 0; i < dataLen; i++) {
+    pEntry->data[i] = (char)(index + i);
+  }
+  return pEntry;
+}
+
+const SyncAppendEntries *sentMsg(int32_t i) { return (const SyncAppendEntries *)sent[i].data(); }
+
+// a writable copy of the msg with room for extra data
+SyncAppendEntries *copyMsg(const SRpcMsg *pRpcMsg, uint32_t extra) {
+  SyncAppendEntries *pMsg = (SyncAppendEntries *)taosMemoryCalloc(1, pRpcMsg->contLen + extra);
+  memcpy(pMsg, pRpcMsg->pCont, pRpcMsg->contLen);
+  return pMsg;
+}
+
+// the offset of the i-th entry in the data
+uint32_t entryOffset(const SyncAppendEntries *pMsg, int32_t i) {
+  uint32_t offset = 0;
+  for (; i > 0; i--) {
+    offset += ((SSyncRaftEntry *)(pMsg->data + offset))->bytes;
+  }
+  return offset;
+}
+
+class SyncLogReplBatchTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    oldMaxBatchN = tsSyncLogReplMaxBatchN;
+    sent.clear();
+
+    pNode = (SSyncNode *)taosMemoryCalloc(1, sizeof(SSyncNode));
+    ASSERT_NE(pNode, nullptr);
+    pNode->vgId = kVgId;
+    pNode->myRaftId.addr = 1;
+    pNode->myRaftId.vgId = kVgId;
+    pNode->peersNum = 1;
+    pNode->peersId[0].addr = 2;
+    pNode->peersId[0].vgId = kVgId;
+    pNode->replicasId[0] = pNode->peersId[0];
+    pNode->peersEpset[0].numOfEps = 1;
+    pNode->syncSendMSg = captureSend;
+    pNode->raftStore.currentTerm = kTerm;
+    ASSERT_EQ(taosThreadMutexInit(&pNode->raftStore.mutex, NULL), 0);
+
+    // the entries [0, kLastIndex] are matched, all of them in the buffer
+    pNode->pLogBuf = syncLogBufferCreate();
+    ASSERT_NE(pNode->pLogBuf, nullptr);
+    SSyncLogBuffer *pBuf = pNode->pLogBuf;
+    for (SyncIndex index = 0; index <= kLastIndex; index++) {
+      pBuf->entries[index % pBuf->size].pItem = createEntry(index, 16 + index % 7);
+    }
+    pBuf->startIndex = 0;
+    pBuf->commitIndex = 0;
+    pBuf->matchIndex = kLastIndex;
+    pBuf->endIndex = kLastIndex + 1;
+
+    // the peer has matched entry 0
+    pMgr = syncLogReplCreate();
+    ASSERT_NE(pMgr, nullptr);
+    pMgr->restored = true;
+    pMgr->startIndex = 0;
+    pMgr->matchIndex = 0;
+    pMgr->endIndex = 1;
+    pMgr->peerStartTime = 0;
+  }
+
+  void TearDown() override {
+    syncLogReplDestroy(pMgr);
+    if (pNode != NULL) {
+      syncLogBufferDestroy(pNode->pLogBuf);
+      taosThreadMutexDestroy(&pNode->raftStore.mutex);
+      taosMemoryFree(pNode);
+    }
+    tsSyncLogReplMaxBatchN = oldMaxBatchN;
+    sent.clear();
+  }
+
+  // replaces the buffered entry at index
+  void setEntry(SSyncRaftEntry *pEntry) {
+    SSyncLogBuffer *pBuf = pNode->pLogBuf;
+    syncEntryDestroy(pBuf->entries[pEntry->index % pBuf->size].pItem);
+    pBuf->entries[pEntry->index % pBuf->size].pItem = pEntry;
+  }
+
+  int32_t sendBatch(SyncIndex index, SyncIndex lastIndex, bool *pBarrier) {
+    SyncTerm term = -1;
+    return syncLogReplSendBatchTo(pMgr, pNode, index, lastIndex, &pNode->replicasId[0], taosGetMonoTimestampMs(),
+                                  &term, pBarrier);
+  }
+
+  // the msg carries the buffered entries from index on, one by one
+  void checkMsg(const SyncAppendEntries *pMsg, SyncIndex index, int32_t nEntry) {
+    EXPECT_EQ(pMsg->msgType, TDMT_SYNC_APPEND_ENTRIES);
+    EXPECT_EQ(pMsg->vgId, kVgId);
+    EXPECT_EQ(pMsg->term, kTerm);
+    EXPECT_EQ(pMsg->bytes, sizeof(SyncAppendEntries) + pMsg->dataLen);
+    EXPECT_EQ(pMsg->prevLogIndex, index - 1);
+    EXPECT_EQ(pMsg->prevLogTerm, kTerm);
+    ASSERT_EQ(syncEntryNumInAppendEntries(pMsg), nEntry);
+
+    uint32_t offset = 0;
+    for (int32_t i = 0; i < nEntry; i++) {
+      SSyncRaftEntry *pEntry = syncEntryBuildFromAppendEntries(pMsg, offset);
+      ASSERT_NE(pEntry, nullptr);
+      SSyncRaftEntry *pExpect = pNode->pLogBuf->entries[(index + i) % pNode->pLogBuf->size].pItem;
+      ASSERT_EQ(pEntry->bytes, pExpect->bytes);
+      EXPECT_EQ(memcmp(pEntry, pExpect, pExpect->bytes), 0) << "entry " << index + i;
+      offset += pEntry->bytes;
+      syncEntryDestroy(pEntry);
+    }
+    EXPECT_EQ(offset, pMsg->dataLen);
+  }
+
+  SSyncNode       *pNode = NULL;
+  SSyncLogReplMgr *pMgr = NULL;
+  int32_t          oldMaxBatchN = 1;
+};
+
+}  // namespace
+
+TEST_F(SyncLogReplBatchTest, build_parse) {
+  SSyncRaftEntry *aEntry[5];
+  for (int32_t i = 0; i < 5; i++) {
+    aEntry[i] = createEntry(11 + i, i * 100);  // an empty entry first
+    aEntry[i]->term = 7 + i / 2;
+  }
+
+  SRpcMsg rpcMsg = {0};
+  ASSERT_EQ(syncBuildAppendEntriesFromRaftEntries(pNode, aEntry, 5, 6, &rpcMsg), 0);
+  const SyncAppendEntries *pMsg = (const SyncAppendEntries *)rpcMsg.pCont;
+  EXPECT_EQ(rpcMsg.msgType, TDMT_SYNC_APPEND_ENTRIES);
+  EXPECT_EQ(pMsg->prevLogIndex, 10);
+  EXPECT_EQ(pMsg->prevLogTerm, 6);
+  EXPECT_EQ(pMsg->term, kTerm);
+  ASSERT_EQ(syncEntryNumInAppendEntries(pMsg), 5);
+
+  uint32_t offset = 0;
+  for (int32_t i = 0; i < 5; i++) {
+    SSyncRaftEntry *pEntry = syncEntryBuildFromAppendEntries(pMsg, offset);
+    ASSERT_NE(pEntry, nullptr);
+    ASSERT_EQ(pEntry->bytes, aEntry[i]->bytes);
+    EXPECT_EQ(memcmp(pEntry, aEntry[i], aEntry[i]->bytes), 0);
+    offset += pEntry->bytes;
+    syncEntryDestroy(pEntry);
+  }
+  EXPECT_EQ(offset, pMsg->dataLen);
+
+  // one entry is a batch as well
+  SRpcMsg rpcMsg1 = {0};
+  ASSERT_EQ(syncBuildAppendEntriesFromRaftEntry(pNode, aEntry[2], 7, &rpcMsg1), 0);
+  EXPECT_EQ(((SyncAppendEntries *)rpcMsg1.pCont)->prevLogIndex, 12);
+  EXPECT_EQ(syncEntryNumInAppendEntries((SyncAppendEntries *)rpcMsg1.pCont), 1);
+
+  rpcFreeCont(rpcMsg.pCont);
+  rpcFreeCont(rpcMsg1.pCont);
+  for (int32_t i = 0; i < 5; i++) syncEntryDestroy(aEntry[i]);
+}
+
+TEST_F(SyncLogReplBatchTest, malformed) {
+  SSyncRaftEntry *aEntry[3];
+  for (int32_t i = 0; i < 3; i++) {
+    aEntry[i] = createEntry(21 + i, 50);
+  }
+  SRpcMsg rpcMsg = {0};
+  ASSERT_EQ(syncBuildAppendEntriesFromRaftEntries(pNode, aEntry, 3, kTerm, &rpcMsg), 0);
+  for (int32_t i = 0; i < 3; i++) syncEntryDestroy(aEntry[i]);
+
+  SyncAppendEntries *pMsg = copyMsg(&rpcMsg, 0);
+  EXPECT_EQ(syncEntryNumInAppendEntries(pMsg), 3);
+
+  // no entry
+  pMsg->dataLen = 0;
+  EXPECT_EQ(syncEntryNumInAppendEntries(pMsg), 0);
+
+  // the last entry truncated, in its head or in its data
+  pMsg->dataLen = entryOffset(pMsg, 2) + sizeof(SSyncRaftEntry) - 1;
+  EXPECT_EQ(syncEntryNumInAppendEntries(pMsg), -1);
+  pMsg->dataLen = entryOffset(pMsg, 3) - 1;
+  EXPECT_EQ(syncEntryNumInAppendEntries(pMsg), -1);
+  taosMemoryFree(pMsg);
+
+  // junk after the last entry
+  pMsg = copyMsg(&rpcMsg, 16);
+  pMsg->dataLen += 16;
+  EXPECT_EQ(syncEntryNumInAppendEntries(pMsg), -1);
+  taosMemoryFree(pMsg);
+
+  // not consecutive, or not following prevLogIndex
+  pMsg = copyMsg(&rpcMsg, 0);
+  ((SSyncRaftEntry *)(pMsg->data + entryOffset(pMsg, 1)))->index = 23;
+  EXPECT_EQ(syncEntryNumInAppendEntries(pMsg), -1);
+  taosMemoryFree(pMsg);
+
+  pMsg = copyMsg(&rpcMsg, 0);
+  pMsg->prevLogIndex = 21;
+  EXPECT_EQ(syncEntryNumInAppendEntries(pMsg), -1);
+  taosMemoryFree(pMsg);
+
+  // a negative term
+  pMsg = copyMsg(&rpcMsg, 0);
+  ((SSyncRaftEntry *)(pMsg->data + entryOffset(pMsg, 2)))->term = -1;
+  EXPECT_EQ(syncEntryNumInAppendEntries(pMsg), -1);
+  taosMemoryFree(pMsg);
+
+  // the bytes of an entry less than its head, or over the data
+  pMsg = copyMsg(&rpcMsg, 0);
+  ((SSyncRaftEntry *)(pMsg->data + entryOffset(pMsg, 1)))->bytes = sizeof(SSyncRaftEntry) - 1;
+  EXPECT_EQ(syncEntryNumInAppendEntries(pMsg), -1);
+  ((SSyncRaftEntry *)(pMsg->data + entryOffset(pMsg, 0)))->bytes = pMsg->dataLen + 1;
+  EXPECT_EQ(syncEntryNumInAppendEntries(pMsg), -1);
+  taosMemoryFree(pMsg);
+
+  // the bytes of an entry not matching its data length, the boundaries of the entries still right
+  pMsg = copyMsg(&rpcMsg, 0);
+  ((SSyncRaftEntry *)(pMsg->data + entryOffset(pMsg, 1)))->dataLen = 51;
+  EXPECT_EQ(syncEntryNumInAppendEntries(pMsg), -1);
+  taosMemoryFree(pMsg);
+
+  rpcFreeCont(rpcMsg.pCont);
+}
+
+TEST_F(SyncLogReplBatchTest, send_batch) {
+  tsSyncLogReplMaxBatchN = 8;
+
+  bool    barrier = true;
+  int64_t nowMs = taosGetMonoTimestampMs();
+  ASSERT_EQ(sendBatch(1, kLastIndex, &barrier), 8);
+  EXPECT_FALSE(barrier);
+  ASSERT_EQ(sent.size(), 1);
+  checkMsg(sentMsg(0), 1, 8);
+  EXPECT_EQ(sentMsg(0)->destId.addr, pNode->peersId[0].addr);
+
+  for (SyncIndex index = 1; index <= 8; index++) {
+    SSyncReplInfo *pState = &pMgr->states[index % pMgr->size];
+    EXPECT_GE(pState->timeMs, nowMs);
+    EXPECT_EQ(pState->term, kTerm);
+    EXPECT_FALSE(pState->acked);
+    EXPECT_FALSE(pState->barrier);
+  }
+  EXPECT_EQ(pMgr->states[9].timeMs, 0);
+
+  // the batch stops at lastIndex
+  ASSERT_EQ(sendBatch(9, 11, &barrier), 3);
+  checkMsg(sentMsg(1), 9, 3);
+
+  // one entry in one msg, as the followers of old versions accept
+  tsSyncLogReplMaxBatchN = 1;
+  ASSERT_EQ(sendBatch(12, kLastIndex, &barrier), 1);
+  checkMsg(sentMsg(2), 12, 1);
+
+  // no more than SYNC_LOG_REPL_MAX_BATCH_N entries whatever configured
+  tsSyncLogReplMaxBatchN = SYNC_LOG_REPL_MAX_BATCH_N * 2;
+  ASSERT_EQ(sendBatch(13, kLastIndex, &barrier), SYNC_LOG_REPL_MAX_BATCH_N);
+  checkMsg(sentMsg(3), 13, SYNC_LOG_REPL_MAX_BATCH_N);
+
+  // nothing sent for the entries not matched yet
+  ASSERT_EQ(sendBatch(kLastIndex + 1, kLastIndex + 1, &barrier), -1);
+  EXPECT_EQ(sent.size(), 4);
+}
+
+TEST_F(SyncLogReplBatchTest, barrier) {
+  tsSyncLogReplMaxBatchN = 8;
+  setEntry(syncEntryBuildNoop(kTerm, 4, kVgId));
+
+  // the barrier is the last entry of its batch
+  bool barrier = false;
+  ASSERT_EQ(sendBatch(1, kLastIndex, &barrier), 4);
+  EXPECT_TRUE(barrier);
+  checkMsg(sentMsg(0), 1, 4);
+  EXPECT_TRUE(pMgr->states[4].barrier);
+  EXPECT_FALSE(pMgr->states[3].barrier);
+
+  // and the first of the next one, alone if it is the first entry
+  ASSERT_EQ(sendBatch(4, kLastIndex, &barrier), 1);
+  EXPECT_TRUE(barrier);
+  checkMsg(sentMsg(1), 4, 1);
+  ASSERT_EQ(sendBatch(5, kLastIndex, &barrier), 8);
+  EXPECT_FALSE(barrier);
+
+  // the replication waits for the barrier to be matched
+  sent.clear();
+  memset(pMgr->states, 0, sizeof(pMgr->states));
+  pMgr->endIndex = 1;
+  ASSERT_EQ(syncLogReplAttempt(pMgr, pNode), 0);
+  ASSERT_EQ(sent.size(), 1);
+  checkMsg(sentMsg(0), 1, 4);
+  EXPECT_EQ(pMgr->endIndex, 5);
+  ASSERT_EQ(syncLogReplAttempt(pMgr, pNode), 0);
+  EXPECT_EQ(sent.size(), 1);
+
+  SyncAppendEntriesReply reply = {0};
+  reply.success = true;
+  reply.lastSendIndex = 4;
+  reply.matchIndex = 4;
+  ASSERT_EQ(syncLogReplContinue(pMgr, pNode, &reply), 0);
+  EXPECT_EQ(pMgr->startIndex, 4);
+  ASSERT_GT(sent.size(), 1);
+  checkMsg(sentMsg(1), 5, 8);
+}
+
+TEST_F(SyncLogReplBatchTest, byte_limit) {
+  tsSyncLogReplMaxBatchN = SYNC_LOG_REPL_MAX_BATCH_N;
+
+  // three of the entries fill the bytes of one msg
+  const int32_t dataLen = SYNC_LOG_REPL_MAX_BATCH_BYTES / 3 - sizeof(SSyncRaftEntry);
+  for (SyncIndex index = 1; index <= 7; index++) {
+    setEntry(createEntry(index, dataLen));
+  }
+
+  bool barrier = false;
+  ASSERT_EQ(sendBatch(1, kLastIndex, &barrier), 3);
+  checkMsg(sentMsg(0), 1, 3);
+  EXPECT_LE(sentMsg(0)->dataLen, SYNC_LOG_REPL_MAX_BATCH_BYTES);
+
+  // the smaller entries after a large one fill the rest
+  for (SyncIndex index = 8; index <= 20; index++) {
+    setEntry(createEntry(index, 100000));
+  }
+  const int64_t bytes7 = sizeof(SSyncRaftEntry) + dataLen;
+  const int64_t bytes8 = sizeof(SSyncRaftEntry) + 100000;
+  ASSERT_EQ(sendBatch(7, kLastIndex, &barrier), 1 + (SYNC_LOG_REPL_MAX_BATCH_BYTES - bytes7) / bytes8);
+  checkMsg(sentMsg(1), 7, 1 + (SYNC_LOG_REPL_MAX_BATCH_BYTES - bytes7) / bytes8);
+  EXPECT_LE(sentMsg(1)->dataLen, SYNC_LOG_REPL_MAX_BATCH_BYTES);
+
+  // an entry over the limit is sent anyway, alone
+  setEntry(createEntry(2, SYNC_LOG_REPL_MAX_BATCH_BYTES * 2));
+  ASSERT_EQ(sendBatch(2, kLastIndex, &barrier), 1);
+  checkMsg(sentMsg(2), 2, 1);
+  ASSERT_EQ(sendBatch(1, kLastIndex, &barrier), 1);
+  checkMsg(sentMsg(3), 1, 1);
+}
+
+TEST_F(SyncLogReplBatchTest, partial_reply) {
+  tsSyncLogReplMaxBatchN = 8;
+
+  // the entries matched are sent in batches, one after another
+  ASSERT_EQ(syncLogReplAttempt(pMgr, pNode), 0);
+  ASSERT_GE(sent.size(), 2);
+  SyncIndex next = 1;
+  for (int32_t i = 0; i < (int32_t)sent.size(); i++) {
+    int32_t nEntry = syncEntryNumInAppendEntries(sentMsg(i));
+    EXPECT_GE(nEntry, 1);
+    EXPECT_LE(nEntry, 8);
+    checkMsg(sentMsg(i), next, nEntry);
+    next += nEntry;
+  }
+  checkMsg(sentMsg(0), 1, 8);
+  EXPECT_EQ(pMgr->endIndex, next);
+  SyncIndex endIndex = pMgr->endIndex;
+
+  // the peer accepts the first five entries of the first batch only, and acks the fifth one
+  sent.clear();
+  SyncAppendEntriesReply reply = {0};
+  reply.success = false;
+  reply.lastSendIndex = 5;
+  reply.matchIndex = 5;
+  ASSERT_EQ(syncLogReplContinue(pMgr, pNode, &reply), 0);
+  EXPECT_EQ(pMgr->startIndex, 5);
+  EXPECT_EQ(pMgr->matchIndex, 5);
+  EXPECT_TRUE(pMgr->states[5].acked);
+  for (SyncIndex index = 6; index < endIndex; index++) {
+    EXPECT_FALSE(pMgr->states[index % pMgr->size].acked) << "entry " << index;
+  }
+
+  // the entries not acked are resent one by one after the retry wait, from the one after the last accepted
+  for (SyncIndex index = pMgr->startIndex; index < pMgr->endIndex; index++) {
+    pMgr->states[index % pMgr->size].timeMs -= SYNC_LOG_REPL_RETRY_WAIT_MS * 2;
+  }
+  sent.clear();
+  ASSERT_EQ(syncLogReplRetryOnNeed(pMgr, pNode), 0);
+  ASSERT_EQ(sent.size(), TMIN(pMgr->endIndex - 6, (pMgr->size >> 4) + 1));
+  for (int32_t i = 0; i < (int32_t)sent.size(); i++) {
+    checkMsg(sentMsg(i), 6 + i, 1);
+  }
+  EXPECT_EQ(pMgr->retryBackoff, 1);
+
+  // an ack of the whole of a batch moves the window to its end
+  sent.clear();
+  reply.success = true;
+  reply.lastSendIndex = 16;
+  reply.matchIndex = 16;
+  ASSERT_EQ(syncLogReplContinue(pMgr, pNode, &reply), 0);
+  EXPECT_EQ(pMgr->startIndex, 16);
+  EXPECT_EQ(pMgr->matchIndex, 16);
+}
@@ -162,7 +162,24 @@ int64_t walChangeWrite(SWal* pWal, int64_t ver);
 int     walInitWriteFile(SWal* pWal);
 // seek section end
 
+// idx cache section
+#define WAL_IDX_CACHE_BLOCK_ENTRIES 1024
+#define WAL_IDX_CACHE_SIZE          (2 * 1024 * 1024)
+
+int32_t walIdxCacheOpen(SWal* pWal);
+void    walIdxCacheClose(SWal* pWal);
+void    walIdxCacheClear(SWal* pWal);
+void    walIdxCachePut(SWal* pWal, int64_t fileFirstVer, int64_t ver, int64_t offset);
+int32_t walIdxCacheGet(SWal* pWal, TdFilePtr pIdxFile, int64_t fileFirstVer, int64_t ver, int64_t* offset);
+// idx cache section end
+
 int64_t walGetSeq();
+void    walAddToFlushQueue(SWal* pWal);
+int32_t walFsyncFile(TdFilePtr pFile);
+
+// replace the fsync of the log files, for the tests
+typedef int32_t (*FWalFsync)(TdFilePtr pFile);
+FWalFsync walSetFsyncFp(FWalFsync fp);
 int     walSeekWriteVer(SWal* pWal, int64_t ver);
 int32_t walRollImpl(SWal* pWal);
 
@@ -0,0 +1,182 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "taoserror.h"
+#include "tlrucache.h"
+#include "walInt.h"
+
+/*
+ * The idx cache keeps the log offsets of the versions in blocks of WAL_IDX_CACHE_BLOCK_ENTRIES, aligned to the first
+ * version of the file, and shared by all the readers of the wal. A block is loaded from the idx file when a reader
+ * seeks into it first, and the block of the last version is extended by the writer, so the readers tailing the wal
+ * never read the idx file. The blocks are keyed by the log generation too, rollback and restore from snapshot leave
+ * the blocks cached before unreachable.
+ */
+typedef struct {
+  int64_t ver;  // first version of the block
+  int64_t gen;
+} SWalIdxBlockKey;
+
+typedef struct {
+  int32_t nEntry;
+  int64_t offsets[WAL_IDX_CACHE_BLOCK_ENTRIES];
+} SWalIdxBlock;
+
+static void walIdxBlockKey(SWal *pWal, int64_t fileFirstVer, int64_t ver, SWalIdxBlockKey *pKey) {
+  pKey->ver = fileFirstVer + (ver - fileFirstVer) / WAL_IDX_CACHE_BLOCK_ENTRIES * WAL_IDX_CACHE_BLOCK_ENTRIES;
+  pKey->gen = atomic_load_32(&pWal->logGen);
+}
+
+static void walIdxBlockFree(const void *key, size_t keyLen, void *value, void *ud) { taosMemoryFree(value); }
+
+int32_t walIdxCacheOpen(SWal *pWal) {
+  pWal->pIdxCache = taosLRUCacheInit(WAL_IDX_CACHE_SIZE, 0, .5);
+  if (pWal->pIdxCache == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return -1;
+  }
+  taosLRUCacheSetStrictCapacity(pWal->pIdxCache, false);
+  return 0;
+}
+
+void walIdxCacheClose(SWal *pWal) {
+  if (pWal->pIdxCache == NULL) return;
+
+  taosLRUCacheEraseUnrefEntries(pWal->pIdxCache);
+  taosLRUCacheCleanup(pWal->pIdxCache);
+  pWal->pIdxCache = NULL;
+}
+
+// drop the blocks of the generations before
+void walIdxCacheClear(SWal *pWal) { taosLRUCacheEraseUnrefEntries(pWal->pIdxCache); }
+
+static void walIdxCacheInsert(SWal *pWal, SWalIdxBlockKey *pKey, SWalIdxBlock *pBlock) {
+  LRUStatus status = taosLRUCacheInsert(pWal->pIdxCache, pKey, sizeof(*pKey), pBlock, sizeof(*pBlock),
+                                        walIdxBlockFree, NULL, TAOS_LRU_PRIORITY_LOW, NULL);
+  if (status != TAOS_LRU_STATUS_OK && status != TAOS_LRU_STATUS_OK_OVERWRITTEN) {
+    wDebug("vgId:%d, failed to cache idx block of ver:%" PRId64 ", status:%d", pWal->cfg.vgId, pKey->ver, status);
+  }
+}
+
+/**
+ * @brief add the log offset of a version just written, called with the wal mutex held
+ */
+void walIdxCachePut(SWal *pWal, int64_t fileFirstVer, int64_t ver, int64_t offset) {
+  SWalIdxBlockKey key;
+  walIdxBlockKey(pWal, fileFirstVer, ver, &key);
+  int32_t idx = ver - key.ver;
+
+  LRUHandle *h = taosLRUCacheLookup(pWal->pIdxCache, &key, sizeof(key));
+  if (h != NULL) {
+    SWalIdxBlock *pBlock = taosLRUCacheValue(pWal->pIdxCache, h);
+    // a block loaded by a reader meanwhile may miss the versions before, reloaded by the reader then
+    if (atomic_load_32(&pBlock->nEntry) == idx) {
+      pBlock->offsets[idx] = offset;
+      atomic_store_32(&pBlock->nEntry, idx + 1);
+    }
+    taosLRUCacheRelease(pWal->pIdxCache, h, false);
+    return;
+  }
+
+  if (idx != 0) return;
+
+  SWalIdxBlock *pBlock = taosMemoryMalloc(sizeof(SWalIdxBlock));
+  if (pBlock == NULL) return;
+  pBlock->nEntry = 1;
+  pBlock->offsets[0] = offset;
+  walIdxCacheInsert(pWal, &key, pBlock);
+}
+
+static int32_t walIdxBlockLoad(SWal *pWal, TdFilePtr pIdxFile, int64_t fileFirstVer, SWalIdxBlockKey *pKey,
+                               SWalIdxBlock **ppBlock) {
+  int64_t       size = WAL_IDX_CACHE_BLOCK_ENTRIES * sizeof(SWalIdxEntry);
+  SWalIdxEntry *aEntry = taosMemoryMalloc(size);
+  SWalIdxBlock *pBlock = taosMemoryMalloc(sizeof(SWalIdxBlock));
+  if (aEntry == NULL || pBlock == NULL) {
+    taosMemoryFree(aEntry);
+    taosMemoryFree(pBlock);
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return -1;
+  }
+
+  int64_t offset = (pKey->ver - fileFirstVer) * sizeof(SWalIdxEntry);
+  if (taosLSeekFile(pIdxFile, offset, SEEK_SET) < 0) {
+    terrno = TAOS_SYSTEM_ERROR(errno);
+    wError("vgId:%d, failed to seek idx file, ver:%" PRId64 ", pos:%" PRId64 ", since %s", pWal->cfg.vgId, pKey->ver,
+           offset, terrstr());
+    goto _err;
+  }
+
+  int64_t nread = taosReadFile(pIdxFile, aEntry, size);
+  if (nread < 0) {
+    terrno = TAOS_SYSTEM_ERROR(errno);
+    wError("vgId:%d, failed to read idx file, since %s", pWal->cfg.vgId, terrstr());
+    goto _err;
+  }
+
+  // the tail of the last file may be written meanwhile
+  pBlock->nEntry = 0;
+  int32_t nEntry = nread / sizeof(SWalIdxEntry);
+  for (int32_t i = 0; i < nEntry && aEntry[i].ver == pKey->ver + i; i++) {
+    pBlock->offsets[i] = aEntry[i].offset;
+    pBlock->nEntry++;
+  }
+
+  taosMemoryFree(aEntry);
+  *ppBlock = pBlock;
+  return 0;
+
+_err:
+  taosMemoryFree(aEntry);
+  taosMemoryFree(pBlock);
+  return -1;
+}
+
+/**
+ * @brief get the log offset of a version, from the idx file of the reader if the block is not cached
+ */
+int32_t walIdxCacheGet(SWal *pWal, TdFilePtr pIdxFile, int64_t fileFirstVer, int64_t ver, int64_t *offset) {
+  SWalIdxBlockKey key;
+  walIdxBlockKey(pWal, fileFirstVer, ver, &key);
+  int32_t idx = ver - key.ver;
+
+  LRUHandle *h = taosLRUCacheLookup(pWal->pIdxCache, &key, sizeof(key));
+  if (h != NULL) {
+    SWalIdxBlock *pBlock = taosLRUCacheValue(pWal->pIdxCache, h);
+    bool          found = idx < atomic_load_32(&pBlock->nEntry);
+    if (found) {
+      *offset = pBlock->offsets[idx];
+    }
+    taosLRUCacheRelease(pWal->pIdxCache, h, false);
+    if (found) return 0;
+  }
+
+  SWalIdxBlock *pBlock = NULL;
+  if (walIdxBlockLoad(pWal, pIdxFile, fileFirstVer, &key, &pBlock) < 0) {
+    return -1;
+  }
+
+  if (idx >= pBlock->nEntry) {
+    terrno = TSDB_CODE_WAL_FILE_CORRUPTED;
+    wError("vgId:%d, ver:%" PRId64 " not found in idx file, entries:%d from ver:%" PRId64, pWal->cfg.vgId, ver,
+           pBlock->nEntry, key.ver);
+    taosMemoryFree(pBlock);
+    return -1;
+  }
+
+  *offset = pBlock->offsets[idx];
+  walIdxCacheInsert(pWal, &key, pBlock);
+  return 0;
+}
@@ -17,6 +17,7 @@
 #include "os.h"
 #include "taoserror.h"
 #include "tcompare.h"
+#include "tglobal.h"
 #include "tref.h"
 #include "walInt.h"
 
@@ -26,15 +27,32 @@ typedef struct {
   uint32_t seq;
   int32_t  refSetId;
   TdThread thread;
+  // group commit
+  TdThread      flushThread;
+  TdThreadMutex flushMutex;
+  TdThreadCond  flushCond;
+  SArray       *flushQueue;  // SArray<int64_t>, refId of the wals to fsync
 } SWalMgmt;
 
 static SWalMgmt tsWal = {0, .seq = 1};
 static int32_t  walCreateThread();
 static void     walStopThread();
+static int32_t  walCreateFlushThread();
+static void     walStopFlushThread();
 static void     walFreeObj(void *pWal);
 
 int64_t walGetSeq() { return (int64_t)atomic_load_32(&tsWal.seq); }
 
+static FWalFsync walFsyncFp = taosFsyncFile;
+
+int32_t walFsyncFile(TdFilePtr pFile) { return walFsyncFp(pFile); }
+
+FWalFsync walSetFsyncFp(FWalFsync fp) {
+  FWalFsync old = walFsyncFp;
+  walFsyncFp = fp ? fp : taosFsyncFile;
+  return old;
+}
+
 int32_t walInit() {
   int8_t old;
   while (1) {
@@ -44,8 +62,13 @@ int32_t walInit() {
 
   if (old == 0) {
     tsWal.refSetId = taosOpenRef(TSDB_MIN_VNODES, walFreeObj);
+    atomic_store_8(&tsWal.stop, 0);
 
     int32_t code = walCreateThread();
+    if (code == 0 && tsWalGroupCommitUs > 0) {
+      code = walCreateFlushThread();
+      if (code != 0) walStopThread();
+    }
     if (code != 0) {
       wError("failed to init wal module since %s", tstrerror(code));
       atomic_store_8(&tsWal.inited, 0);
@@ -68,6 +91,7 @@ void walCleanUp() {
 
   if (old == 1) {
     walStopThread();
+    walStopFlushThread();
     taosCloseRef(tsWal.refSetId);
     wInfo("wal module is cleaned up");
     atomic_store_8(&tsWal.inited, 0);
@@ -114,6 +138,11 @@ SWal *walOpen(const char *path, SWalCfg *pCfg) {
     goto _err;
   }
 
+  if (walIdxCacheOpen(pWal) != 0) {
+    wError("vgId:%d, failed to open idx cache since %s", pWal->cfg.vgId, tstrerror(terrno));
+    goto _err;
+  }
+
   // open meta
   walResetVer(&pWal->vers);
   pWal->pLogFile = NULL;
@@ -156,6 +185,9 @@ SWal *walOpen(const char *path, SWalCfg *pCfg) {
     goto _err;
   }
 
+  // the logs on disk are taken as fsynced
+  pWal->syncedVer = pWal->vers.lastVer;
+
   // add ref
   pWal->refId = taosAddRef(tsWal.refSetId, pWal);
   if (pWal->refId < 0) {
@@ -163,19 +195,33 @@ SWal *walOpen(const char *path, SWalCfg *pCfg) {
     goto _err;
   }
 
-  wDebug("vgId:%d, wal:%p is opened, level:%d fsyncPeriod:%d", pWal->cfg.vgId, pWal, pWal->cfg.level,
-         pWal->cfg.fsyncPeriod);
+  wDebug("vgId:%d, wal:%p is opened, level:%d fsyncPeriod:%d compressor:%d", pWal->cfg.vgId, pWal, pWal->cfg.level,
+         pWal->cfg.fsyncPeriod, pWal->cfg.compressor);
   return pWal;
 
 _err:
   taosArrayDestroy(pWal->fileInfoSet);
   taosHashCleanup(pWal->pRefHash);
+  walIdxCacheClose(pWal);
   taosThreadMutexDestroy(&pWal->mutex);
   taosMemoryFree(pWal);
   pWal = NULL;
   return NULL;
 }
 
+EWalCmpr walGetCompressor(const char *name) {
+  if (name == NULL || name[0] == 0 || strcasecmp(name, "none") == 0) {
+    return TAOS_WAL_CMPR_NONE;
+  } else if (strcasecmp(name, "lz4") == 0) {
+    return TAOS_WAL_CMPR_LZ4;
+  } else if (strcasecmp(name, "zstd") == 0) {
+    return TAOS_WAL_CMPR_ZSTD;
+  }
+
+  wWarn("invalid wal compressor:%s, bodies are written uncompressed", name);
+  return TAOS_WAL_CMPR_NONE;
+}
+
 int32_t walAlter(SWal *pWal, SWalCfg *pCfg) {
   if (pWal == NULL) return TSDB_CODE_APP_ERROR;
 
@@ -245,6 +291,8 @@ static void walFreeObj(void *wal) {
   SWal *pWal = wal;
   wDebug("vgId:%d, wal:%p is freed", pWal->cfg.vgId, pWal);
 
+  walIdxCacheClose(pWal);
+  taosMemoryFreeClear(pWal->pCmprBuf);
   taosThreadMutexDestroy(&pWal->mutex);
   taosMemoryFreeClear(pWal);
 }
@@ -321,3 +369,175 @@ static void walStopThread() {
 
   wDebug("wal thread is stopped");
 }
+
+/*
+ * Group commit: with walGroupCommitUs set, the wals of fsync level and fsync period 0 do not fsync each write. The
+ * first write not fsynced puts the wal into the flush queue, and the flush thread fsyncs it walGroupCommitUs later,
+ * once for all the writes made in the window, then tells the writer how far the logs are durable. The writer takes a
+ * log as written only then, so the durability is the same as fsyncing each write. A wal failed to open is tried again
+ * in the next window. A failed fsync is not retried, since the os may have dropped the pages it failed to write: the
+ * logs not fsynced are never taken as written, and the later writes of the wal fail with the error.
+ */
+void walAddToFlushQueue(SWal *pWal) {
+  taosThreadMutexLock(&tsWal.flushMutex);
+  if (taosArrayPush(tsWal.flushQueue, &pWal->refId) == NULL) {
+    wError("vgId:%d, failed to add wal to flush queue since %s", pWal->cfg.vgId, tstrerror(TSDB_CODE_OUT_OF_MEMORY));
+    pWal->syncPending = 0;
+  }
+  taosThreadCondSignal(&tsWal.flushCond);
+  taosThreadMutexUnlock(&tsWal.flushMutex);
+}
+
+static void walGroupFsync(int64_t refId) {
+  SWal *pWal = taosAcquireRef(tsWal.refSetId, refId);
+  if (pWal == NULL) return;
+
+  char fnameStr[WAL_FILE_LEN];
+  taosThreadMutexLock(&pWal->mutex);
+  pWal->syncPending = 0;
+  int64_t ver = pWal->vers.lastVer;
+  int32_t gen = pWal->logGen;
+  bool    needFsync = ver > pWal->syncedVer && pWal->pLogFile != NULL && pWal->syncCode == 0;
+  if (needFsync) {
+    walBuildLogName(pWal, walGetCurFileFirstVer(pWal), fnameStr);
+  }
+  taosThreadMutexUnlock(&pWal->mutex);
+
+  // fsync through a descriptor of our own, so the writers go on meanwhile. The logs until ver are all in this file,
+  // the files before are fsynced when rolled.
+  int32_t code = 0;
+  bool    opened = false;
+  if (needFsync) {
+    TdFilePtr pFile = taosOpenFile(fnameStr, TD_FILE_WRITE);
+    if (pFile == NULL) {
+      code = TAOS_SYSTEM_ERROR(errno);
+      wError("vgId:%d, file:%s, failed to open for group fsync since %s, retry later", pWal->cfg.vgId, fnameStr,
+             tstrerror(code));
+    } else {
+      opened = true;
+      if (walFsyncFile(pFile) < 0) {
+        code = TAOS_SYSTEM_ERROR(errno);
+        wError("vgId:%d, file:%s, group fsync failed since %s", pWal->cfg.vgId, fnameStr, tstrerror(code));
+      }
+      taosCloseFile(&pFile);
+    }
+  }
+
+  taosThreadMutexLock(&pWal->mutex);
+  if (code == 0) {
+    if (needFsync && gen == pWal->logGen && ver > pWal->syncedVer) {
+      pWal->syncedVer = ver;
+    }
+  } else if (opened && gen == pWal->logGen) {
+    // the pages failed to write back may be dropped, so a later fsync does not make the logs durable
+    pWal->syncCode = code;
+  }
+  // the file failed to open, or the logs rewritten meanwhile, try again in the next window
+  if (pWal->syncCode == 0 && !pWal->syncPending && pWal->vers.lastVer > pWal->syncedVer) {
+    pWal->syncPending = 1;
+    walAddToFlushQueue(pWal);
+  }
+  FWalSynced fp = pWal->syncedFp;
+  int64_t    param = pWal->syncedParam;
+  ver = pWal->syncedVer;
+  taosThreadMutexUnlock(&pWal->mutex);
+
+  if (code == 0) {
+    wTrace("vgId:%d, group fsync until ver:%" PRId64, pWal->cfg.vgId, ver);
+    if (fp != NULL) {
+      fp(param, ver);
+    }
+  }
+
+  taosReleaseRef(tsWal.refSetId, refId);
+}
+
+static void *walFlushThreadFunc(void *param) {
+  setThreadName("wal-flush");
+
+  SArray *aRefId = taosArrayInit(TSDB_MIN_VNODES, sizeof(int64_t));
+  if (aRefId == NULL) {
+    wError("failed to start wal flush thread since %s", tstrerror(TSDB_CODE_OUT_OF_MEMORY));
+    return NULL;
+  }
+
+  while (1) {
+    taosThreadMutexLock(&tsWal.flushMutex);
+    while (taosArrayGetSize(tsWal.flushQueue) == 0 && !atomic_load_8(&tsWal.stop)) {
+      taosThreadCondWait(&tsWal.flushCond, &tsWal.flushMutex);
+    }
+    bool stop = taosArrayGetSize(tsWal.flushQueue) == 0;
+    taosThreadMutexUnlock(&tsWal.flushMutex);
+    if (stop) break;
+
+    // let the writes in the window join the group
+    if (!atomic_load_8(&tsWal.stop)) {
+      taosUsleep(tsWalGroupCommitUs);
+    }
+
+    taosThreadMutexLock(&tsWal.flushMutex);
+    SArray *aQueued = tsWal.flushQueue;
+    tsWal.flushQueue = aRefId;
+    aRefId = aQueued;
+    taosThreadMutexUnlock(&tsWal.flushMutex);
+
+    for (int32_t i = 0; i < taosArrayGetSize(aRefId); i++) {
+      walGroupFsync(*(int64_t *)taosArrayGet(aRefId, i));
+    }
+    taosArrayClear(aRefId);
+  }
+
+  taosArrayDestroy(aRefId);
+  return NULL;
+}
+
+static int32_t walCreateFlushThread() {
+  tsWal.flushQueue = taosArrayInit(TSDB_MIN_VNODES, sizeof(int64_t));
+  if (tsWal.flushQueue == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return -1;
+  }
+  taosThreadMutexInit(&tsWal.flushMutex, NULL);
+  taosThreadCondInit(&tsWal.flushCond, NULL);
+
+  TdThreadAttr thAttr;
+  taosThreadAttrInit(&thAttr);
+  taosThreadAttrSetDetachState(&thAttr, PTHREAD_CREATE_JOINABLE);
+
+  if (taosThreadCreate(&tsWal.flushThread, &thAttr, walFlushThreadFunc, NULL) != 0) {
+    wError("failed to create wal flush thread since %s", strerror(errno));
+    terrno = TAOS_SYSTEM_ERROR(errno);
+    taosThreadAttrDestroy(&thAttr);
+    taosThreadCondDestroy(&tsWal.flushCond);
+    taosThreadMutexDestroy(&tsWal.flushMutex);
+    taosArrayDestroy(tsWal.flushQueue);
+    tsWal.flushQueue = NULL;
+    return -1;
+  }
+
+  taosThreadAttrDestroy(&thAttr);
+  wInfo("wal flush thread is launched, group commit window:%dus", tsWalGroupCommitUs);
+
+  return 0;
+}
+
+static void walStopFlushThread() {
+  if (tsWal.flushQueue == NULL) return;
+
+  taosThreadMutexLock(&tsWal.flushMutex);
+  atomic_store_8(&tsWal.stop, 1);
+  taosThreadCondSignal(&tsWal.flushCond);
+  taosThreadMutexUnlock(&tsWal.flushMutex);
+
+  if (taosCheckPthreadValid(tsWal.flushThread)) {
+    taosThreadJoin(tsWal.flushThread, NULL);
+    taosThreadClear(&tsWal.flushThread);
+  }
+
+  taosThreadCondDestroy(&tsWal.flushCond);
+  taosThreadMutexDestroy(&tsWal.flushMutex);
+  taosArrayDestroy(tsWal.flushQueue);
+  tsWal.flushQueue = NULL;
+
+  wDebug("wal flush thread is stopped");
+}
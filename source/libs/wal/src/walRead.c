@@ -15,6 +15,7 @@
 
 #include "crypt.h"
 #include "taoserror.h"
+#include "tcompression.h"
 #include "wal.h"
 #include "walInt.h"
 
@@ -136,33 +137,17 @@ static int64_t walReadSeekFilePos(SWalReader *pReader, int64_t fileFirstVer, int
   TdFilePtr pIdxTFile = pReader->pIdxFile;
   TdFilePtr pLogTFile = pReader->pLogFile;
 
-  // seek position
-  int64_t offset = (ver - fileFirstVer) * sizeof(SWalIdxEntry);
-  ret = taosLSeekFile(pIdxTFile, offset, SEEK_SET);
-  if (ret < 0) {
-    terrno = TAOS_SYSTEM_ERROR(errno);
-    wError("vgId:%d, failed to seek idx file, index:%" PRId64 ", pos:%" PRId64 ", since %s", pReader->pWal->cfg.vgId,
-           ver, offset, terrstr());
-    return -1;
-  }
-  SWalIdxEntry entry = {0};
-  if ((ret = taosReadFile(pIdxTFile, &entry, sizeof(SWalIdxEntry))) != sizeof(SWalIdxEntry)) {
-    if (ret < 0) {
-      terrno = TAOS_SYSTEM_ERROR(errno);
-      wError("vgId:%d, failed to read idx file, since %s", pReader->pWal->cfg.vgId, terrstr());
-    } else {
-      terrno = TSDB_CODE_WAL_FILE_CORRUPTED;
-      wError("vgId:%d, read idx file incompletely, read bytes %" PRId64 ", bytes should be %ld",
-             pReader->pWal->cfg.vgId, ret, sizeof(SWalIdxEntry));
-    }
+  // seek position, the idx file is read only if the block of ver is not cached
+  int64_t offset = 0;
+  if (walIdxCacheGet(pReader->pWal, pIdxTFile, fileFirstVer, ver, &offset) < 0) {
     return -1;
   }
 
-  ret = taosLSeekFile(pLogTFile, entry.offset, SEEK_SET);
+  ret = taosLSeekFile(pLogTFile, offset, SEEK_SET);
   if (ret < 0) {
     terrno = TAOS_SYSTEM_ERROR(errno);
     wError("vgId:%d, failed to seek log file, index:%" PRId64 ", pos:%" PRId64 ", since %s", pReader->pWal->cfg.vgId,
-           ver, entry.offset, terrstr());
+           ver, offset, terrstr());
     return -1;
   }
   return ret;
@@ -303,6 +288,54 @@ int32_t walFetchHead(SWalReader *pRead, int64_t ver) {
   return 0;
 }
 
+/**
+ * @brief decompress the body read if it is compressed, the compressed body is checksumed already
+ */
+static int32_t walDecompressBody(SWalReader *pRead) {
+  SWalCont *pHead = &pRead->pHead->head;
+  if (pHead->protoVer != WAL_PROTO_VER_CMPR) return 0;
+
+  SWalCmprHead cmprHead;
+  int32_t      cmprLen = pHead->bodyLen - (int32_t)sizeof(SWalCmprHead);
+  if (cmprLen <= 0) goto _err;
+  memcpy(&cmprHead, pHead->body, sizeof(SWalCmprHead));
+  if (cmprHead.rawLen <= 0 ||
+      (cmprHead.compressor != TAOS_WAL_CMPR_LZ4 && cmprHead.compressor != TAOS_WAL_CMPR_ZSTD)) {
+    goto _err;
+  }
+
+  // decompress behind the compressed body, then move it to the front
+  int64_t capacity = (int64_t)pHead->bodyLen + cmprHead.rawLen;
+  if (pRead->capacity < capacity) {
+    SWalCkHead *ptr = (SWalCkHead *)taosMemoryRealloc(pRead->pHead, sizeof(SWalCkHead) + capacity);
+    if (ptr == NULL) {
+      terrno = TSDB_CODE_OUT_OF_MEMORY;
+      return -1;
+    }
+    pRead->pHead = ptr;
+    pHead = &pRead->pHead->head;
+    pRead->capacity = capacity;
+  }
+
+  uint32_t cmprAlg = 0;
+  SET_COMPRESS(L1_DISABLED, cmprHead.compressor == TAOS_WAL_CMPR_LZ4 ? L2_LZ4 : L2_ZSTD, 0, cmprAlg);
+  char   *pRaw = pHead->body + pHead->bodyLen;
+  int32_t rawLen = tsDecompressString2(pHead->body + sizeof(SWalCmprHead), cmprLen, 1, pRaw, cmprHead.rawLen, cmprAlg,
+                                       NULL, 0);
+  if (rawLen != cmprHead.rawLen) goto _err;
+
+  memmove(pHead->body, pRaw, rawLen);
+  pHead->bodyLen = rawLen;
+  pHead->protoVer = WAL_PROTO_VER;
+  return 0;
+
+_err:
+  wError("vgId:%d, failed to decompress wal log, index:%" PRId64 ", len:%d, 0x%" PRIx64, pRead->pWal->cfg.vgId,
+         pHead->version, pHead->bodyLen, pRead->readerId);
+  terrno = TSDB_CODE_WAL_FILE_CORRUPTED;
+  return -1;
+}
+
 int32_t walSkipFetchBody(SWalReader *pRead) {
   wDebug("vgId:%d, skip:%" PRId64 ", first:%" PRId64 ", commit:%" PRId64 ", last:%" PRId64
          ", applied:%" PRId64 ", 0x%" PRIx64,
@@ -383,6 +416,10 @@ int32_t walFetchBody(SWalReader *pRead) {
     return -1;
   }
 
+  if (walDecompressBody(pRead) != 0) {
+    return -1;
+  }
+
   pRead->curVersion++;
   return 0;
 }
@@ -505,6 +542,11 @@ int32_t walReadVer(SWalReader *pReader, int64_t ver) {
     taosThreadMutexUnlock(&pReader->mutex);
     return -1;
   }
+
+  if (walDecompressBody(pReader) != 0) {
+    taosThreadMutexUnlock(&pReader->mutex);
+    return -1;
+  }
   pReader->curVersion++;
 
   taosThreadMutexUnlock(&pReader->mutex);
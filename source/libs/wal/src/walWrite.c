@@ -17,6 +17,7 @@
 #include "os.h"
 #include "taoserror.h"
 #include "tchecksum.h"
+#include "tcompression.h"
 #include "tglobal.h"
 #include "walInt.h"
 
@@ -73,6 +74,9 @@ int32_t walRestoreFromSnapshot(SWal *pWal, int64_t ver) {
   taosArrayClear(pWal->fileInfoSet);
   pWal->vers.firstVer = ver + 1;
   pWal->vers.lastVer = ver;
+  pWal->syncedVer = ver;
+  atomic_add_fetch_32(&pWal->logGen, 1);
+  walIdxCacheClear(pWal);
   pWal->vers.commitVer = ver;
   pWal->vers.snapshotVer = ver;
   pWal->vers.verInSnapshotting = -1;
@@ -205,6 +209,9 @@ int32_t walRollback(SWal *pWal, int64_t ver) {
     return -1;
   }
   pWal->vers.lastVer = ver - 1;
+  pWal->syncedVer = TMIN(pWal->syncedVer, ver - 1);
+  atomic_add_fetch_32(&pWal->logGen, 1);
+  walIdxCacheClear(pWal);
   ((SWalFileInfo *)taosArrayGetLast(pWal->fileInfoSet))->lastVer = ver - 1;
   ((SWalFileInfo *)taosArrayGetLast(pWal->fileInfoSet))->fileSize = entry.offset;
 
@@ -412,6 +419,7 @@ int32_t walRollImpl(SWal *pWal) {
       terrno = TAOS_SYSTEM_ERROR(errno);
       goto END;
     }
+    pWal->syncedVer = pWal->vers.lastVer;
     code = taosCloseFile(&pWal->pLogFile);
     if (code != 0) {
       terrno = TAOS_SYSTEM_ERROR(errno);
@@ -487,9 +495,53 @@ static int32_t walWriteIndex(SWal *pWal, int64_t ver, int64_t offset) {
   return 0;
 }
 
+#define WAL_CMPR_MIN_BODY_LEN 512
+#define WAL_CMPR_ZSTD_LEVEL   1
+
+/**
+ * @brief compress a body into the reusable buffer of the wal, led by SWalCmprHead
+ *
+ * @return the length compressed, or 0 if the body is to be written as it is
+ */
+static int32_t walCompressBody(SWal *pWal, const void *body, int32_t bodyLen) {
+  int8_t compressor = pWal->cfg.compressor;
+  if (compressor == TAOS_WAL_CMPR_NONE || pWal->cfg.level == TAOS_WAL_SKIP || bodyLen < WAL_CMPR_MIN_BODY_LEN) {
+    return 0;
+  }
+
+  // one more byte for the indicator of the compressed data
+  int32_t size = sizeof(SWalCmprHead) + bodyLen + 1;
+  if (pWal->cmprBufLen < size) {
+    void *pBuf = taosMemoryRealloc(pWal->pCmprBuf, size);
+    if (pBuf == NULL) return 0;
+    pWal->pCmprBuf = pBuf;
+    pWal->cmprBufLen = size;
+  }
+
+  uint32_t cmprAlg = 0;
+  SET_COMPRESS(L1_DISABLED, compressor == TAOS_WAL_CMPR_LZ4 ? L2_LZ4 : L2_ZSTD, WAL_CMPR_ZSTD_LEVEL, cmprAlg);
+  int32_t len = tsCompressString2((void *)body, bodyLen, 1, (char *)pWal->pCmprBuf + sizeof(SWalCmprHead), bodyLen + 1,
+                                  cmprAlg, NULL, 0);
+  if (len <= 0 || len + (int32_t)sizeof(SWalCmprHead) >= bodyLen) {
+    return 0;
+  }
+
+  SWalCmprHead *pHead = pWal->pCmprBuf;
+  pHead->compressor = compressor;
+  pHead->rawLen = bodyLen;
+  return len + sizeof(SWalCmprHead);
+}
+
 static FORCE_INLINE int32_t walWriteImpl(SWal *pWal, int64_t index, tmsg_t msgType, SWalSyncInfo syncMeta,
                                          const void *body, int32_t bodyLen) {
   int64_t code = 0;
+
+  // the compressed body is checksumed and encrypted as the body written
+  int32_t cmprBodyLen = walCompressBody(pWal, body, bodyLen);
+  if (cmprBodyLen > 0) {
+    body = pWal->pCmprBuf;
+    bodyLen = cmprBodyLen;
+  }
   int32_t plainBodyLen = bodyLen;
 
   int64_t       offset = walGetCurFileOffset(pWal);
@@ -498,6 +550,7 @@ static FORCE_INLINE int32_t walWriteImpl(SWal *pWal, int64_t index, tmsg_t msgTy
   pWal->writeHead.head.version = index;
   pWal->writeHead.head.bodyLen = plainBodyLen;
   pWal->writeHead.head.msgType = msgType;
+  pWal->writeHead.head.protoVer = cmprBodyLen > 0 ? WAL_PROTO_VER_CMPR : WAL_PROTO_VER;
   pWal->writeHead.head.ingestTs = taosGetTimestampUs();
 
   // sync info for sync module
@@ -594,6 +647,10 @@ static FORCE_INLINE int32_t walWriteImpl(SWal *pWal, int64_t index, tmsg_t msgTy
   pFileInfo->lastVer = index;
   pFileInfo->fileSize += sizeof(SWalCkHead) + cyptedBodyLen;
 
+  if (pWal->cfg.level != TAOS_WAL_SKIP) {
+    walIdxCachePut(pWal, pFileInfo->firstVer, index, offset);
+  }
+
   return 0;
 
 END:
@@ -627,6 +684,12 @@ int64_t walAppendLog(SWal *pWal, int64_t index, tmsg_t msgType, SWalSyncInfo syn
     return -1;
   }
 
+  if (pWal->syncCode != 0) {
+    terrno = pWal->syncCode;
+    taosThreadMutexUnlock(&pWal->mutex);
+    return -1;
+  }
+
   if (walCheckAndRoll(pWal) < 0) {
     taosThreadMutexUnlock(&pWal->mutex);
     return -1;
@@ -663,6 +726,12 @@ int32_t walWriteWithSyncInfo(SWal *pWal, int64_t index, tmsg_t msgType, SWalSync
     return -1;
   }
 
+  if (pWal->syncCode != 0) {
+    terrno = pWal->syncCode;
+    taosThreadMutexUnlock(&pWal->mutex);
+    return -1;
+  }
+
   if (walCheckAndRoll(pWal) < 0) {
     taosThreadMutexUnlock(&pWal->mutex);
     return -1;
@@ -693,18 +762,50 @@ int32_t walWrite(SWal *pWal, int64_t index, tmsg_t msgType, const void *body, in
   return walWriteWithSyncInfo(pWal, index, msgType, syncMeta, body, bodyLen);
 }
 
+static FORCE_INLINE bool walGroupCommit(SWal *pWal) {
+  return tsWalGroupCommitUs > 0 && pWal->cfg.level == TAOS_WAL_FSYNC && pWal->cfg.fsyncPeriod == 0;
+}
+
 void walFsync(SWal *pWal, bool forceFsync) {
   if (pWal->cfg.level == TAOS_WAL_SKIP) {
     return;
   }
 
   taosThreadMutexLock(&pWal->mutex);
-  if (forceFsync || (pWal->cfg.level == TAOS_WAL_FSYNC && pWal->cfg.fsyncPeriod == 0)) {
+  if (!forceFsync && walGroupCommit(pWal)) {
+    // fsynced by the flush thread together with the other writes in the window
+    if (!pWal->syncPending && pWal->vers.lastVer > pWal->syncedVer && pWal->syncCode == 0) {
+      pWal->syncPending = 1;
+      walAddToFlushQueue(pWal);
+    }
+  } else if (forceFsync || (pWal->cfg.level == TAOS_WAL_FSYNC && pWal->cfg.fsyncPeriod == 0)) {
     wTrace("vgId:%d, fileId:%" PRId64 ".log, do fsync", pWal->cfg.vgId, walGetCurFileFirstVer(pWal));
-    if (taosFsyncFile(pWal->pLogFile) < 0) {
+    if (walFsyncFile(pWal->pLogFile) < 0) {
       wError("vgId:%d, file:%" PRId64 ".log, fsync failed since %s", pWal->cfg.vgId, walGetCurFileFirstVer(pWal),
              strerror(errno));
+      if (walGroupCommit(pWal)) {
+        pWal->syncCode = TAOS_SYSTEM_ERROR(errno);
+      }
+    } else if (pWal->syncCode == 0) {
+      pWal->syncedVer = pWal->vers.lastVer;
     }
   }
   taosThreadMutexUnlock(&pWal->mutex);
 }
+
+/**
+ * @brief get the last version fsynced by the group commit, or the last version if the wal is not in group commit
+ */
+int64_t walGetSyncedVer(SWal *pWal) {
+  if (!walGroupCommit(pWal)) {
+    return walGetLastVer(pWal);
+  }
+  return atomic_load_64(&pWal->syncedVer);
+}
+
+void walSetSyncedCb(SWal *pWal, FWalSynced fp, int64_t param) {
+  taosThreadMutexLock(&pWal->mutex);
+  pWal->syncedFp = fp;
+  pWal->syncedParam = param;
+  taosThreadMutexUnlock(&pWal->mutex);
+}
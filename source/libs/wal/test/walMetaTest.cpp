@@ -3,6 +3,7 @@
 #include <iostream>
 #include <queue>
 
+#include "tglobal.h"
 #include "walInt.h"
 
 const char* ranStr = "tvapq02tcp";
@@ -443,3 +444,254 @@ TEST_F(WalRetentionEnv, repairMeta1) {
   }
   walCloseReader(pRead);
 }
+
+TEST_F(WalKeepEnv, readAfterRollback) {
+  walResetEnv();
+  int         code;
+  SWalReader* pRead = walOpenReader(pWal, NULL, 0);
+  ASSERT(pRead != NULL);
+
+  int i;
+  for (i = 0; i < 2000; i++) {
+    char newStr[100];
+    sprintf(newStr, "%s-%d", ranStr, i);
+    code = walWrite(pWal, i, 0, newStr, strlen(newStr));
+    ASSERT_EQ(code, 0);
+  }
+  for (i = 0; i < 1000; i++) {
+    int ver = taosRand() % 2000;
+    code = walReadVer(pRead, ver);
+    ASSERT_EQ(code, 0);
+    ASSERT_EQ(pRead->pHead->head.version, ver);
+  }
+
+  // the cached offsets of the versions rewritten must not be used
+  code = walRollback(pWal, 1000);
+  ASSERT_EQ(code, 0);
+  for (i = 1000; i < 2000; i++) {
+    char newStr[100];
+    sprintf(newStr, "%s-%s-%d", ranStr, ranStr, i);
+    code = walWrite(pWal, i, 0, newStr, strlen(newStr));
+    ASSERT_EQ(code, 0);
+  }
+
+  for (i = 0; i < 1000; i++) {
+    int ver = taosRand() % 2000;
+    code = walReadVer(pRead, ver);
+    ASSERT_EQ(code, 0);
+    ASSERT_EQ(pRead->pHead->head.version, ver);
+
+    char newStr[100];
+    if (ver < 1000) {
+      sprintf(newStr, "%s-%d", ranStr, ver);
+    } else {
+      sprintf(newStr, "%s-%s-%d", ranStr, ranStr, ver);
+    }
+    int len = strlen(newStr);
+    ASSERT_EQ(pRead->pHead->head.bodyLen, len);
+    for (int j = 0; j < len; j++) {
+      EXPECT_EQ(newStr[j], pRead->pHead->head.body[j]);
+    }
+  }
+  walCloseReader(pRead);
+}
+
+TEST_F(WalKeepEnv, readCompressed) {
+  walResetEnv();
+  int         code;
+  SWalReader* pRead = walOpenReader(pWal, NULL, 0);
+  ASSERT(pRead != NULL);
+
+  // the records of different compressors are mixed in the same file
+  int8_t compressors[] = {TAOS_WAL_CMPR_ZSTD, TAOS_WAL_CMPR_LZ4, TAOS_WAL_CMPR_NONE};
+  char   body[4096];
+  int    i;
+  for (i = 0; i < 300; i++) {
+    pWal->cfg.compressor = compressors[i / 100];
+    int len = (i % 2 == 0) ? 4000 : 100;
+    for (int j = 0; j < len; j++) {
+      body[j] = 'a' + (i + j / 64) % 26;
+    }
+    code = walWrite(pWal, i, 0, body, len);
+    ASSERT_EQ(code, 0);
+  }
+
+  for (i = 0; i < 300; i++) {
+    code = walReadVer(pRead, i);
+    ASSERT_EQ(code, 0);
+    ASSERT_EQ(pRead->pHead->head.version, i);
+    ASSERT_EQ(pRead->pHead->head.protoVer, WAL_PROTO_VER);
+
+    int len = (i % 2 == 0) ? 4000 : 100;
+    ASSERT_EQ(pRead->pHead->head.bodyLen, len);
+    for (int j = 0; j < len; j++) {
+      ASSERT_EQ(pRead->pHead->head.body[j], 'a' + (i + j / 64) % 26);
+    }
+  }
+  walCloseReader(pRead);
+}
+
+// told by the flush thread, which may outlive a fixture
+static int32_t nSynced = 0;
+static int64_t cbVer = -1;
+
+class WalGroupCommitEnv : public ::testing::Test {
+ protected:
+  static void SetUpTestCase() {
+    tsWalGroupCommitUs = 100 * 1000;
+    int code = walInit();
+    ASSERT(code == 0);
+  }
+
+  static void TearDownTestCase() {
+    walCleanUp();
+    tsWalGroupCommitUs = 0;
+  }
+
+  static void onSynced(int64_t param, int64_t ver) {
+    atomic_add_fetch_32(&nSynced, 1);
+    atomic_store_64(&cbVer, ver);
+  }
+
+  static int32_t failFsync(TdFilePtr pFile) {
+    errno = EIO;
+    return -1;
+  }
+
+  void SetUp() override {
+    taosRemoveDir(pathName);
+    SWalCfg cfg;
+    memset(&cfg, 0, sizeof(SWalCfg));
+    cfg.rollPeriod = -1;
+    cfg.segSize = -1;
+    cfg.level = TAOS_WAL_FSYNC;
+    cfg.fsyncPeriod = 0;
+    pWal = walOpen(pathName, &cfg);
+    ASSERT(pWal != NULL);
+    atomic_store_32(&nSynced, 0);
+    atomic_store_64(&cbVer, -1);
+    walSetSyncedCb(pWal, onSynced, 0);
+  }
+
+  void TearDown() override {
+    walSetFsyncFp(NULL);
+    walSetSyncedCb(pWal, NULL, 0);
+    walClose(pWal);
+    pWal = NULL;
+  }
+
+  void write(int64_t from, int64_t to) {
+    for (int64_t ver = from; ver <= to; ver++) {
+      char newStr[100];
+      sprintf(newStr, "%s-%" PRId64, ranStr, ver);
+      ASSERT_EQ(walWrite(pWal, ver, 0, newStr, strlen(newStr)), 0);
+      walFsync(pWal, false);
+    }
+  }
+
+  // waits a few windows for the flush thread to fsync until ver
+  bool waitSynced(int64_t ver) {
+    for (int32_t i = 0; i < 100 && walGetSyncedVer(pWal) < ver; i++) {
+      taosMsleep(20);
+    }
+    return walGetSyncedVer(pWal) >= ver;
+  }
+
+  SWal*       pWal = NULL;
+  const char* pathName = TD_TMP_DIR_PATH "wal_test";
+};
+
+TEST_F(WalGroupCommitEnv, syncedVerCatchUp) {
+  EXPECT_EQ(walGetSyncedVer(pWal), -1);
+
+  // the writes in the window are fsynced later, at once
+  write(0, 9);
+  EXPECT_EQ(walGetLastVer(pWal), 9);
+  EXPECT_LT(walGetSyncedVer(pWal), 9);
+
+  ASSERT_TRUE(waitSynced(9));
+  EXPECT_EQ(walGetSyncedVer(pWal), 9);
+  EXPECT_EQ(atomic_load_64(&cbVer), 9);
+  EXPECT_GE(atomic_load_32(&nSynced), 1);
+
+  // the next group
+  write(10, 19);
+  EXPECT_LT(walGetSyncedVer(pWal), 19);
+  ASSERT_TRUE(waitSynced(19));
+  EXPECT_EQ(atomic_load_64(&cbVer), 19);
+
+  // a forced fsync catches up at once
+  write(20, 20);
+  walFsync(pWal, true);
+  EXPECT_EQ(walGetSyncedVer(pWal), 20);
+
+  // the rolled back logs are not fsynced
+  write(21, 25);
+  ASSERT_EQ(walRollback(pWal, 23), 0);
+  EXPECT_LE(walGetSyncedVer(pWal), 22);
+  ASSERT_TRUE(waitSynced(22));
+  EXPECT_EQ(walGetSyncedVer(pWal), 22);
+}
+
+TEST_F(WalGroupCommitEnv, openFailureRetry) {
+  write(0, 0);
+  ASSERT_TRUE(waitSynced(0));
+
+  // the flush thread fails to open the log file by name, the writer goes on with its own descriptor
+  char fnameStr[WAL_FILE_LEN];
+  char bakStr[WAL_FILE_LEN + 4];
+  walBuildLogName(pWal, walGetCurFileFirstVer(pWal), fnameStr);
+  sprintf(bakStr, "%s.bak", fnameStr);
+  ASSERT_EQ(taosRenameFile(fnameStr, bakStr), 0);
+
+  write(1, 5);
+  taosMsleep(300);
+  EXPECT_EQ(walGetSyncedVer(pWal), 0);
+  EXPECT_EQ(atomic_load_64(&cbVer), 0);
+
+  // tried again in the next windows
+  ASSERT_EQ(taosRenameFile(bakStr, fnameStr), 0);
+  ASSERT_TRUE(waitSynced(5));
+  EXPECT_EQ(atomic_load_64(&cbVer), 5);
+  write(6, 6);
+}
+
+TEST_F(WalGroupCommitEnv, fsyncFailure) {
+  write(0, 4);
+  ASSERT_TRUE(waitSynced(4));
+  int32_t nSyncedBefore = atomic_load_32(&nSynced);
+
+  walSetFsyncFp(failFsync);
+  write(5, 9);
+  taosMsleep(300);
+
+  // the logs are kept pending, and the writer is not told they are synced
+  EXPECT_EQ(walGetSyncedVer(pWal), 4);
+  EXPECT_EQ(atomic_load_32(&nSynced), nSyncedBefore);
+  EXPECT_EQ(atomic_load_64(&cbVer), 4);
+
+  // the wal is in error, a later fsync succeeding does not make the logs durable
+  walSetFsyncFp(NULL);
+  char newStr[] = "after failure";
+  EXPECT_EQ(walWrite(pWal, 10, 0, newStr, strlen(newStr)), -1);
+  EXPECT_EQ(terrno, TAOS_SYSTEM_ERROR(EIO));
+  walFsync(pWal, false);
+  taosMsleep(300);
+  EXPECT_EQ(walGetSyncedVer(pWal), 4);
+  EXPECT_EQ(walGetLastVer(pWal), 9);
+
+  // so does a forced fsync
+  walFsync(pWal, true);
+  EXPECT_EQ(walGetSyncedVer(pWal), 4);
+}
+
+TEST_F(WalGroupCommitEnv, forcedFsyncFailure) {
+  write(0, 2);
+  walSetFsyncFp(failFsync);
+  walFsync(pWal, true);
+  EXPECT_LT(walGetSyncedVer(pWal), 2);
+
+  char newStr[] = "after failure";
+  EXPECT_EQ(walWrite(pWal, 3, 0, newStr, strlen(newStr)), -1);
+  EXPECT_EQ(terrno, TAOS_SYSTEM_ERROR(EIO));
+}
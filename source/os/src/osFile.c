@@ -1172,6 +1172,36 @@ int64_t taosPReadFile(TdFilePtr pFile, void *buf, int64_t count, int64_t offset)
   return ret;
 }
 
+// ask the kernel to read a range of the file into page cache in the background, it is only a hint
+int32_t taosPrefetchFile(TdFilePtr pFile, int64_t offset, int64_t count) {
+  if (pFile == NULL || count <= 0) {
+    return 0;
+  }
+
+#if defined(WINDOWS) || defined(_TD_DARWIN_64)
+  return 0;
+#else
+#if FILE_WITH_LOCK
+  taosThreadRwlockRdlock(&(pFile->rwlock));
+#endif
+  if (pFile->fd < 0) {
+#if FILE_WITH_LOCK
+    taosThreadRwlockUnlock(&(pFile->rwlock));
+#endif
+    return -1;
+  }
+  int32_t ret = posix_fadvise(pFile->fd, offset, count, POSIX_FADV_WILLNEED);
+#if FILE_WITH_LOCK
+  taosThreadRwlockUnlock(&(pFile->rwlock));
+#endif
+  if (ret != 0) {
+    errno = ret;
+    return -1;
+  }
+  return 0;
+#endif
+}
+
 int32_t taosFsyncFile(TdFilePtr pFile) {
   if (pFile == NULL) {
     return 0;
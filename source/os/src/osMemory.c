@@ -20,6 +20,9 @@
 #include <malloc.h>
 #endif
 #include "os.h"
+#if defined(LINUX)
+#include <sys/syscall.h>
+#endif
 
 #if defined(USE_TD_MEMORY) || defined(USE_ADDR2LINE)
 
@@ -382,6 +385,75 @@ void taosMemoryTrim(int32_t size) {
 #endif
 }
 
+void *taosMemoryMapHuge(int64_t size, int32_t hugePage, int64_t *pMapSize) {
+#if defined(LINUX)
+  const int64_t size2M = 1LL << 21;
+  const int64_t size1G = 1LL << 30;
+  void         *p = MAP_FAILED;
+  int64_t       mapSize = 0;
+
+#ifdef MAP_HUGETLB
+  if (hugePage == TD_HUGE_PAGE_2M || hugePage == TD_HUGE_PAGE_1G) {
+    int64_t pageSize = (hugePage == TD_HUGE_PAGE_1G) ? size1G : size2M;
+    int32_t flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB;
+#ifdef MAP_HUGE_SHIFT
+    flags |= ((hugePage == TD_HUGE_PAGE_1G) ? 30 : 21) << MAP_HUGE_SHIFT;
+#endif
+    mapSize = (size + pageSize - 1) / pageSize * pageSize;
+    p = mmap(NULL, mapSize, PROT_READ | PROT_WRITE, flags, -1, 0);
+  }
+#endif
+
+  if (p == MAP_FAILED) {
+    // no reserved huge pages, ask for transparent ones
+    int64_t align = (hugePage == TD_HUGE_PAGE_NONE) ? (int64_t)getpagesize() : size2M;
+    mapSize = (size + align - 1) / align * align;
+    p = mmap(NULL, mapSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED) {
+      return NULL;
+    }
+#ifdef MADV_HUGEPAGE
+    if (hugePage != TD_HUGE_PAGE_NONE) {
+      (void)madvise(p, mapSize, MADV_HUGEPAGE);
+    }
+#endif
+  }
+
+  *pMapSize = mapSize;
+  return p;
+#else
+  errno = ENOTSUP;
+  return NULL;
+#endif
+}
+
+void taosMemoryUnmap(void *ptr, int64_t mapSize) {
+#if defined(LINUX)
+  if (ptr) (void)munmap(ptr, mapSize);
+#endif
+}
+
+// Prefer the NUMA node for the pages of a mapped region, called before the pages are touched so nothing is moved.
+int32_t taosMemoryBindNode(void *ptr, int64_t mapSize, int32_t node) {
+#if defined(LINUX) && defined(SYS_mbind)
+  const int32_t maxNode = 1024;
+  unsigned long mask[1024 / (8 * sizeof(unsigned long))] = {0};
+
+  if (node < 0 || node >= maxNode) {
+    return EINVAL;
+  }
+  mask[node / (8 * sizeof(unsigned long))] |= 1UL << (node % (8 * sizeof(unsigned long)));
+
+  // MPOL_PREFERRED, spelled out to avoid the dependency on libnuma headers
+  if (syscall(SYS_mbind, ptr, mapSize, 1, mask, maxNode, 0) != 0) {
+    return errno;
+  }
+  return 0;
+#else
+  return 0;
+#endif
+}
+
 void *taosMemoryMallocAlign(uint32_t alignment, int64_t size) {
 #ifdef USE_TD_MEMORY
   ASSERT(0);
@@ -277,7 +277,8 @@ TCmprL1FnSet compressL1Dict[] = {{"PLAIN", NULL, tsCompressPlain2, tsDecompressP
                                  {"SIMPLE-8B", NULL, tsCompressINTImp2, tsDecompressINTImp2},
                                  {"DELTAI", NULL, tsCompressTimestampImp2, tsDecompressTimestampImp2},
                                  {"BIT-PACKING", NULL, tsCompressBoolImp2, tsDecompressBoolImp2},
-                                 {"DELTAD", NULL, tsCompressDoubleImp2, tsDecompressDoubleImp2}};
+                                 {"DELTAD", NULL, tsCompressDoubleImp2, tsDecompressDoubleImp2},
+                                 {"DICT", NULL, tsCompressPlain2, tsDecompressPlain2}};
 
 TCmprLvlSet compressL2LevelDict[] = {
     {"unknown", .lvl = {1, 2, 3}}, {"lz4", .lvl = {1, 2, 3}}, {"zlib", .lvl = {1, 6, 9}},
@@ -1030,6 +1031,19 @@ int32_t tsDecompressDoubleImp(const char *const input, const int32_t nelements,
     return nelements * DOUBLE_BYTES;
   }
 
+  // the SIMD implementations return 0 if they are not compiled in
+  int32_t nbytes = 0;
+  if (tsSIMDEnable && tsAVX512Supported && tsAVX512Enable) {
+    nbytes = tsDecompressDoubleImplAvx512(input, nelements, output);
+  } else if (tsSIMDEnable && tsAVX2Supported) {
+    nbytes = tsDecompressDoubleImplAvx2(input, nelements, output);
+  }
+
+  if (nbytes > 0) {
+    return nbytes;
+  }
+
+  // alternative implementation without SIMD instructions.
   uint8_t  flags = 0;
   int32_t  ipos = 1;
   int32_t  opos = 0;
@@ -1198,11 +1212,15 @@ int32_t tsDecompressFloatImp(const char *const input, const int32_t nelements, c
     return nelements * FLOAT_BYTES;
   }
 
-  if (tsSIMDEnable && tsAVX2Supported) {
-    tsDecompressFloatImplAvx2(input, nelements, output);
-  } else if (tsSIMDEnable && tsAVX512Supported && tsAVX512Enable) {
-    tsDecompressFloatImplAvx512(input, nelements, output);
-  } else {  // alternative implementation without SIMD instructions.
+  // the SIMD implementations return 0 if they are not compiled in
+  int32_t nbytes = 0;
+  if (tsSIMDEnable && tsAVX512Supported && tsAVX512Enable) {
+    nbytes = tsDecompressFloatImplAvx512(input, nelements, output);
+  } else if (tsSIMDEnable && tsAVX2Supported) {
+    nbytes = tsDecompressFloatImplAvx2(input, nelements, output);
+  }
+
+  if (nbytes == 0) {  // alternative implementation without SIMD instructions.
     tsDecompressFloatHelper(input, nelements, (float *)output);
   }
 
@@ -314,16 +314,180 @@ int32_t tsDecompressIntImpl_Hw(const char *const input, const int32_t nelements,
   return nelements * word_length;
 }
 
+// The XOR codec stores the diff of each value against its predecessor in 1~N bytes, either aligned to the lowest
+// byte or to the highest byte (bit 3 of the flag), and every two values share one flag byte. The diffs can only be
+// located sequentially, so they are unpacked into the output buffer first, then restored in batch by a prefix-xor.
+static FORCE_INLINE uint32_t decodeFloatDiff(const char *const input, int32_t *const ipos, uint8_t flag) {
+  uint32_t diff = 0;
+  int32_t  nbytes = (flag & INT8MASK(3)) + 1;
+  memcpy(&diff, input + (*ipos), nbytes);
+  (*ipos) += nbytes;
+  return diff << ((FLOAT_BYTES - nbytes) * BITS_PER_BYTE * ((flag >> 3) & 0x01));
+}
+
+static FORCE_INLINE uint64_t decodeDoubleDiff(const char *const input, int32_t *const ipos, uint8_t flag) {
+  uint64_t diff = 0;
+  int32_t  nbytes = (flag & INT8MASK(3)) + 1;
+  memcpy(&diff, input + (*ipos), nbytes);
+  (*ipos) += nbytes;
+  return diff << ((DOUBLE_BYTES - nbytes) * BITS_PER_BYTE * ((flag >> 3) & 0x01));
+}
+
+// unpack the diffs of num values (num is even) into the output buffer.
+#define DECODE_XOR_DIFF_BATCH(_fn, _input, _ipos, _p, _num)        \
+  do {                                                              \
+    for (int32_t _j = 0; _j < (_num); _j += 2) {                    \
+      uint8_t _flags = (_input)[(_ipos)++];                         \
+      (_p)[_j] = _fn((_input), &(_ipos), _flags & INT8MASK(4));     \
+      (_p)[_j + 1] = _fn((_input), &(_ipos), (_flags >> 4) & 0x0F); \
+    }                                                               \
+  } while (0)
+
+// decode the values that do not fill a whole batch, starting from an even position.
+#define DECODE_XOR_REMAIN(_fn, _input, _ipos, _p, _num, _prev)         \
+  do {                                                                 \
+    uint8_t _flags = 0;                                                \
+    for (int32_t _j = 0; _j < (_num); ++_j) {                          \
+      if ((_j & 0x01) == 0) {                                          \
+        _flags = (_input)[(_ipos)++];                                  \
+      }                                                                \
+      (_prev) ^= _fn((_input), &(_ipos), _flags & INT8MASK(4));        \
+      _flags >>= 4;                                                    \
+      (_p)[_j] = (_prev);                                              \
+    }                                                                  \
+  } while (0)
+
 int32_t tsDecompressFloatImplAvx512(const char *const input, const int32_t nelements, char *const output) {
 #if __AVX512F__
-  // todo add it
+  uint32_t *p = (uint32_t *)output;
+  int32_t   ipos = 1, opos = 0;
+
+  int32_t batch = nelements >> 4;
+  int32_t remain = nelements & 0x0F;
+
+  __m512i zero = _mm512_setzero_si512();
+  __m512i last = _mm512_set1_epi32(15);
+  __m512i prev = zero;
+
+  for (int32_t i = 0; i < batch; ++i) {
+    DECODE_XOR_DIFF_BATCH(decodeFloatDiff, input, ipos, &p[opos], 16);
+
+    // prefix-xor of sixteen lanes by shifting 1, 2, 4, 8 lanes, then apply the last value of the previous batch
+    __m512i val = _mm512_loadu_si512((const void *)&p[opos]);
+    val = _mm512_xor_si512(val, _mm512_alignr_epi32(val, zero, 15));
+    val = _mm512_xor_si512(val, _mm512_alignr_epi32(val, zero, 14));
+    val = _mm512_xor_si512(val, _mm512_alignr_epi32(val, zero, 12));
+    val = _mm512_xor_si512(val, _mm512_alignr_epi32(val, zero, 8));
+    val = _mm512_xor_si512(val, prev);
+    _mm512_storeu_si512((void *)&p[opos], val);
+
+    prev = _mm512_permutexvar_epi32(last, val);
+    opos += 16;
+  }
+
+  uint32_t prevValue = (opos > 0) ? p[opos - 1] : 0;
+  DECODE_XOR_REMAIN(decodeFloatDiff, input, ipos, &p[opos], remain, prevValue);
+  return nelements * FLOAT_BYTES;
 #endif
   return 0;
 }
 
-// todo add later
 int32_t tsDecompressFloatImplAvx2(const char *const input, const int32_t nelements, char *const output) {
 #if __AVX2__
+  uint32_t *p = (uint32_t *)output;
+  int32_t   ipos = 1, opos = 0;
+
+  int32_t batch = nelements >> 3;
+  int32_t remain = nelements & 0x07;
+
+  __m256i last = _mm256_set1_epi32(7);
+  __m256i prev = _mm256_setzero_si256();
+
+  for (int32_t i = 0; i < batch; ++i) {
+    DECODE_XOR_DIFF_BATCH(decodeFloatDiff, input, ipos, &p[opos], 8);
+
+    // prefix-xor in each 128-bit lane, then carry the last value of the low lane into the high lane
+    __m256i val = _mm256_loadu_si256((const __m256i *)&p[opos]);
+    val = _mm256_xor_si256(val, _mm256_slli_si256(val, 4));
+    val = _mm256_xor_si256(val, _mm256_slli_si256(val, 8));
+    __m256i low = _mm256_permute2x128_si256(val, val, 0x08);
+    val = _mm256_xor_si256(val, _mm256_shuffle_epi32(low, 0xFF));
+    val = _mm256_xor_si256(val, prev);
+    _mm256_storeu_si256((__m256i *)&p[opos], val);
+
+    prev = _mm256_permutevar8x32_epi32(val, last);
+    opos += 8;
+  }
+
+  uint32_t prevValue = (opos > 0) ? p[opos - 1] : 0;
+  DECODE_XOR_REMAIN(decodeFloatDiff, input, ipos, &p[opos], remain, prevValue);
+  return nelements * FLOAT_BYTES;
+#endif
+  return 0;
+}
+
+int32_t tsDecompressDoubleImplAvx512(const char *const input, const int32_t nelements, char *const output) {
+#if __AVX512F__
+  uint64_t *p = (uint64_t *)output;
+  int32_t   ipos = 1, opos = 0;
+
+  int32_t batch = nelements >> 3;
+  int32_t remain = nelements & 0x07;
+
+  __m512i zero = _mm512_setzero_si512();
+  __m512i last = _mm512_set1_epi64(7);
+  __m512i prev = zero;
+
+  for (int32_t i = 0; i < batch; ++i) {
+    DECODE_XOR_DIFF_BATCH(decodeDoubleDiff, input, ipos, &p[opos], 8);
+
+    // prefix-xor of eight lanes by shifting 1, 2, 4 lanes, then apply the last value of the previous batch
+    __m512i val = _mm512_loadu_si512((const void *)&p[opos]);
+    val = _mm512_xor_si512(val, _mm512_alignr_epi64(val, zero, 7));
+    val = _mm512_xor_si512(val, _mm512_alignr_epi64(val, zero, 6));
+    val = _mm512_xor_si512(val, _mm512_alignr_epi64(val, zero, 4));
+    val = _mm512_xor_si512(val, prev);
+    _mm512_storeu_si512((void *)&p[opos], val);
+
+    prev = _mm512_permutexvar_epi64(last, val);
+    opos += 8;
+  }
+
+  uint64_t prevValue = (opos > 0) ? p[opos - 1] : 0;
+  DECODE_XOR_REMAIN(decodeDoubleDiff, input, ipos, &p[opos], remain, prevValue);
+  return nelements * DOUBLE_BYTES;
+#endif
+  return 0;
+}
+
+int32_t tsDecompressDoubleImplAvx2(const char *const input, const int32_t nelements, char *const output) {
+#if __AVX2__
+  uint64_t *p = (uint64_t *)output;
+  int32_t   ipos = 1, opos = 0;
+
+  int32_t batch = nelements >> 2;
+  int32_t remain = nelements & 0x03;
+
+  __m256i prev = _mm256_setzero_si256();
+
+  for (int32_t i = 0; i < batch; ++i) {
+    DECODE_XOR_DIFF_BATCH(decodeDoubleDiff, input, ipos, &p[opos], 4);
+
+    // prefix-xor in each 128-bit lane, then carry the last value of the low lane into the high lane
+    __m256i val = _mm256_loadu_si256((const __m256i *)&p[opos]);
+    val = _mm256_xor_si256(val, _mm256_slli_si256(val, 8));
+    __m256i low = _mm256_permute2x128_si256(val, val, 0x08);
+    val = _mm256_xor_si256(val, _mm256_shuffle_epi32(low, 0xEE));
+    val = _mm256_xor_si256(val, prev);
+    _mm256_storeu_si256((__m256i *)&p[opos], val);
+
+    prev = _mm256_permute4x64_epi64(val, 0xFF);
+    opos += 4;
+  }
+
+  uint64_t prevValue = (opos > 0) ? p[opos - 1] : 0;
+  DECODE_XOR_REMAIN(decodeDoubleDiff, input, ipos, &p[opos], remain, prevValue);
+  return nelements * DOUBLE_BYTES;
 #endif
   return 0;
 }
@@ -0,0 +1,393 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Codec micro-benchmarks, run as:
+//   compressBench [--benchmark_filter=<regex>] [<type>=<file> ...]
+// where each <type>=<file> pair (type is one of the names of kCodecs, e.g. timestamp, ubigint, varchar) adds a recorded
+// column, a raw little-endian array of the type, to the synthetic ones. Each dataset is measured with the two level
+// codecs for every L2 algorithm and with the legacy one stage and two stage codecs. Throughput is reported as
+// bytes_per_second of the uncompressed data and the compression ratio as the "ratio" counter.
+
+#include <benchmark/benchmark.h>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "tcompression.h"
+#include "tdataformat.h"
+#include "ttypes.h"
+
+namespace {
+
+typedef int32_t (*CompressFn)(void *pIn, int32_t nIn, int32_t nEle, void *pOut, int32_t nOut, uint32_t cmprAlg,
+                              void *pBuf, int32_t nBuf);
+
+typedef int32_t (*LegacyCompressFn)(void *pIn, int32_t nIn, int32_t nEle, void *pOut, int32_t nOut, uint8_t cmprAlg,
+                                    void *pBuf, int32_t nBuf);
+
+typedef struct {
+  const char      *name;
+  int8_t           type;
+  uint8_t          l1;
+  CompressFn       compress;
+  CompressFn       decompress;
+  LegacyCompressFn legacyCompress;
+  LegacyCompressFn legacyDecompress;
+} SCodec;
+
+typedef struct {
+  std::string          name;
+  SCodec               codec;
+  int32_t              nEle;
+  std::vector<uint8_t> data;
+} SDataset;
+
+typedef enum {
+  SIMD_NONE = 0,
+  SIMD_AVX2,
+  SIMD_AVX512,
+} ESimdMode;
+
+const int32_t kRows = 4096;  // default rows of a block
+
+// the unsigned types share the codecs of their signed counterparts, as tDataCompress and tDataTypes do
+const SCodec kCodecs[] = {
+    {"timestamp", TSDB_DATA_TYPE_TIMESTAMP, L1_XOR, tsCompressTimestamp2, tsDecompressTimestamp2, tsCompressTimestamp,
+     tsDecompressTimestamp},
+    {"tinyint", TSDB_DATA_TYPE_TINYINT, L1_SIMPLE_8B, tsCompressTinyint2, tsDecompressTinyint2, tsCompressTinyint,
+     tsDecompressTinyint},
+    {"smallint", TSDB_DATA_TYPE_SMALLINT, L1_SIMPLE_8B, tsCompressSmallint2, tsDecompressSmallint2, tsCompressSmallint,
+     tsDecompressSmallint},
+    {"int", TSDB_DATA_TYPE_INT, L1_SIMPLE_8B, tsCompressInt2, tsDecompressInt2, tsCompressInt, tsDecompressInt},
+    {"bigint", TSDB_DATA_TYPE_BIGINT, L1_SIMPLE_8B, tsCompressBigint2, tsDecompressBigint2, tsCompressBigint,
+     tsDecompressBigint},
+    {"utinyint", TSDB_DATA_TYPE_UTINYINT, L1_SIMPLE_8B, tsCompressTinyint2, tsDecompressTinyint2, tsCompressTinyint,
+     tsDecompressTinyint},
+    {"usmallint", TSDB_DATA_TYPE_USMALLINT, L1_SIMPLE_8B, tsCompressSmallint2, tsDecompressSmallint2,
+     tsCompressSmallint, tsDecompressSmallint},
+    {"uint", TSDB_DATA_TYPE_UINT, L1_SIMPLE_8B, tsCompressInt2, tsDecompressInt2, tsCompressInt, tsDecompressInt},
+    {"ubigint", TSDB_DATA_TYPE_UBIGINT, L1_SIMPLE_8B, tsCompressBigint2, tsDecompressBigint2, tsCompressBigint,
+     tsDecompressBigint},
+    {"float", TSDB_DATA_TYPE_FLOAT, L1_DELTAD, tsCompressFloat2, tsDecompressFloat2, tsCompressFloat,
+     tsDecompressFloat},
+    {"double", TSDB_DATA_TYPE_DOUBLE, L1_DELTAD, tsCompressDouble2, tsDecompressDouble2, tsCompressDouble,
+     tsDecompressDouble},
+    {"bool", TSDB_DATA_TYPE_BOOL, L1_RLE, tsCompressBool2, tsDecompressBool2, tsCompressBool, tsDecompressBool},
+    {"varchar", TSDB_DATA_TYPE_VARCHAR, L1_DISABLED, tsCompressString2, tsDecompressString2, tsCompressString,
+     tsDecompressString},
+};
+
+const struct {
+  const char *name;
+  uint8_t     l2;
+} kL2[] = {{"none", L2_DISABLED}, {"lz4", L2_LZ4}, {"zstd", L2_ZSTD}, {"zlib", L2_ZLIB}};
+
+const struct {
+  const char *name;
+  uint8_t     stage;
+} kLegacy[] = {{"legacy_one_stage", ONE_STAGE_COMP}, {"legacy_two_stage", TWO_STAGE_COMP}};
+
+const char *kSimdNames[] = {"scalar", "avx2", "avx512"};
+
+const SCodec *getCodec(int8_t type) {
+  for (const SCodec &codec : kCodecs) {
+    if (codec.type == type) return &codec;
+  }
+  return nullptr;
+}
+
+template <typename T>
+SDataset makeDataset(const char *name, int8_t type, const std::vector<T> &values) {
+  SDataset ds = {name, *getCodec(type), (int32_t)values.size()};
+  ds.data.resize(values.size() * sizeof(T));
+  memcpy(ds.data.data(), values.data(), ds.data.size());
+  return ds;
+}
+
+// the values of a column with sparse NULLs, as laid out by a SColData the rows are appended to
+template <typename T>
+SDataset makeNullDataset(const char *name, int8_t type, const std::vector<T> &values, const std::vector<bool> &isNull) {
+  SColData colData;
+  tColDataInit(&colData, 1, type, 0);
+  for (size_t i = 0; i < values.size(); i++) {
+    SValue value = {.type = type};
+    memcpy(&value.val, &values[i], sizeof(T));
+    SColVal colVal = isNull[i] ? COL_VAL_NULL(1, type) : COL_VAL_VALUE(1, value);
+    if (tColDataAppendValue(&colData, &colVal) != 0) {
+      tColDataDestroy(&colData);
+      return makeDataset(name, type, values);
+    }
+  }
+
+  SDataset ds = {name, *getCodec(type), colData.nVal};
+  ds.data.assign(colData.pData, colData.pData + colData.nData);
+  tColDataDestroy(&colData);
+  return ds;
+}
+
+std::vector<SDataset> genDatasets() {
+  std::vector<SDataset> datasets;
+  std::mt19937_64       rng(20240601);
+  std::vector<int64_t>  i64(kRows);
+  std::vector<int32_t>  i32(kRows);
+  std::vector<int16_t>  i16(kRows);
+  std::vector<int8_t>   i8(kRows);
+  std::vector<uint64_t> u64(kRows);
+  std::vector<uint32_t> u32(kRows);
+  std::vector<uint16_t> u16(kRows);
+  std::vector<uint8_t>  u8(kRows);
+  std::vector<float>    f32(kRows);
+  std::vector<double>   f64(kRows);
+  std::vector<int8_t>   b8(kRows);
+  std::vector<bool>     isNull(kRows);
+
+  // timestamps: fixed interval, then the same with network jitter
+  for (int32_t i = 0; i < kRows; i++) i64[i] = 1700000000000 + (int64_t)i * 1000;
+  datasets.push_back(makeDataset("ts_monotonic", TSDB_DATA_TYPE_TIMESTAMP, i64));
+
+  std::uniform_int_distribution<int64_t> jitter(-50, 50);
+  for (int32_t i = 0; i < kRows; i++) i64[i] = 1700000000000 + (int64_t)i * 1000 + jitter(rng);
+  datasets.push_back(makeDataset("ts_jitter", TSDB_DATA_TYPE_TIMESTAMP, i64));
+
+  // constant
+  for (int32_t i = 0; i < kRows; i++) i64[i] = 42;
+  datasets.push_back(makeDataset("bigint_const", TSDB_DATA_TYPE_BIGINT, i64));
+
+  // sparse NULLs: only 5% of the rows hold a value
+  std::uniform_int_distribution<int32_t> pct(0, 99);
+  std::uniform_int_distribution<int32_t> val(0, 1000000);
+  for (int32_t i = 0; i < kRows; i++) {
+    isNull[i] = pct(rng) >= 5;
+    i32[i] = val(rng);
+  }
+  datasets.push_back(makeNullDataset("int_sparse_null", TSDB_DATA_TYPE_INT, i32, isNull));
+
+  for (int32_t i = 0; i < kRows; i++) i32[i] = val(rng);
+  datasets.push_back(makeDataset("int_random", TSDB_DATA_TYPE_INT, i32));
+
+  // narrow types: small status codes and a random walk
+  std::uniform_int_distribution<int32_t> level(0, 7);
+  std::uniform_int_distribution<int32_t> delta(-3, 3);
+  int16_t                                s = 0;
+  for (int32_t i = 0; i < kRows; i++) {
+    i8[i] = (int8_t)level(rng);
+    s += delta(rng);
+    i16[i] = s;
+  }
+  datasets.push_back(makeDataset("tinyint_status", TSDB_DATA_TYPE_TINYINT, i8));
+  datasets.push_back(makeDataset("smallint_random_walk", TSDB_DATA_TYPE_SMALLINT, i16));
+
+  // unsigned: counters, and values above the signed range
+  std::uniform_int_distribution<int32_t> inc(0, 10);
+  uint64_t                               counter = 1ULL << 40;
+  for (int32_t i = 0; i < kRows; i++) {
+    counter += inc(rng);
+    u64[i] = counter;
+    u32[i] = (uint32_t)counter;
+    u16[i] = (uint16_t)(UINT16_MAX - level(rng));
+    u8[i] = (uint8_t)(UINT8_MAX - level(rng));
+  }
+  datasets.push_back(makeDataset("ubigint_counter", TSDB_DATA_TYPE_UBIGINT, u64));
+  datasets.push_back(makeDataset("uint_counter", TSDB_DATA_TYPE_UINT, u32));
+  datasets.push_back(makeDataset("usmallint_high", TSDB_DATA_TYPE_USMALLINT, u16));
+  datasets.push_back(makeDataset("utinyint_high", TSDB_DATA_TYPE_UTINYINT, u8));
+
+  // random walk
+  std::normal_distribution<double> step(0.0, 0.1);
+  double                           v = 220.0;
+  for (int32_t i = 0; i < kRows; i++) {
+    v += step(rng);
+    f32[i] = (float)v;
+    f64[i] = v;
+  }
+  datasets.push_back(makeDataset("float_random_walk", TSDB_DATA_TYPE_FLOAT, f32));
+  datasets.push_back(makeDataset("double_random_walk", TSDB_DATA_TYPE_DOUBLE, f64));
+
+  for (int32_t i = 0; i < kRows; i++) isNull[i] = pct(rng) >= 5;
+  datasets.push_back(makeNullDataset("double_sparse_null", TSDB_DATA_TYPE_DOUBLE, f64, isNull));
+
+  for (int32_t i = 0; i < kRows; i++) b8[i] = pct(rng) < 10;
+  datasets.push_back(makeDataset("bool_skewed", TSDB_DATA_TYPE_BOOL, b8));
+
+  // low cardinality strings
+  SDataset ds = {"varchar_low_card", *getCodec(TSDB_DATA_TYPE_VARCHAR), kRows};
+  for (int32_t i = 0; i < kRows; i++) {
+    std::string s = "device-" + std::to_string(i % 16);
+    ds.data.insert(ds.data.end(), s.begin(), s.end());
+  }
+  datasets.push_back(ds);
+
+  return datasets;
+}
+
+bool loadDataset(const char *arg, SDataset *ds) {
+  const char *sep = strchr(arg, '=');
+  if (sep == nullptr) return false;
+
+  std::string typeName(arg, sep - arg);
+  int8_t      type = -1;
+  for (const SCodec &codec : kCodecs) {
+    if (strcasecmp(typeName.c_str(), codec.name) == 0) type = codec.type;
+  }
+  if (type < 0) return false;
+
+  TdFilePtr pFile = taosOpenFile(sep + 1, TD_FILE_READ);
+  if (pFile == NULL) return false;
+
+  int64_t size = 0;
+  if (taosFStatFile(pFile, &size, NULL) < 0 || size <= 0) {
+    taosCloseFile(&pFile);
+    return false;
+  }
+
+  int32_t bytes = IS_VAR_DATA_TYPE(type) ? 1 : tDataTypes[type].bytes;
+  size = TMIN(size, (int64_t)kRows * (IS_VAR_DATA_TYPE(type) ? 64 : bytes));
+
+  ds->name = std::string("recorded_") + typeName;
+  ds->codec = *getCodec(type);
+  ds->data.resize(size);
+  if (taosReadFile(pFile, ds->data.data(), size) != size) {
+    taosCloseFile(&pFile);
+    return false;
+  }
+  taosCloseFile(&pFile);
+
+  ds->data.resize(size / bytes * bytes);
+  ds->nEle = IS_VAR_DATA_TYPE(type) ? kRows : (int32_t)(size / bytes);
+  return true;
+}
+
+bool setSimdMode(ESimdMode mode) {
+  char sse42 = 0, avx = 0, avx2 = 0, fma = 0, avx512 = 0;
+  taosGetCpuInstructions(&sse42, &avx, &avx2, &fma, &avx512);
+
+  tsSIMDEnable = (mode != SIMD_NONE);
+  tsAVX2Supported = (mode != SIMD_NONE) && avx2;
+  tsAVX512Supported = (mode == SIMD_AVX512) && avx512;
+  tsAVX512Enable = tsAVX512Supported;
+
+  return mode == SIMD_NONE || (mode == SIMD_AVX2 && avx2) || (mode == SIMD_AVX512 && avx512);
+}
+
+// cmprAlg is a two level algorithm, or the stage of a legacy codec
+int32_t doCompress(const SCodec *codec, bool legacy, void *pIn, int32_t nIn, int32_t nEle, void *pOut, int32_t nOut,
+                   uint32_t cmprAlg, void *pBuf, int32_t nBuf) {
+  if (legacy) return codec->legacyCompress(pIn, nIn, nEle, pOut, nOut, (uint8_t)cmprAlg, pBuf, nBuf);
+  return codec->compress(pIn, nIn, nEle, pOut, nOut, cmprAlg, pBuf, nBuf);
+}
+
+int32_t doDecompress(const SCodec *codec, bool legacy, void *pIn, int32_t nIn, int32_t nEle, void *pOut, int32_t nOut,
+                     uint32_t cmprAlg, void *pBuf, int32_t nBuf) {
+  if (legacy) return codec->legacyDecompress(pIn, nIn, nEle, pOut, nOut, (uint8_t)cmprAlg, pBuf, nBuf);
+  return codec->decompress(pIn, nIn, nEle, pOut, nOut, cmprAlg, pBuf, nBuf);
+}
+
+void benchCompress(benchmark::State &state, const SDataset *ds, uint32_t cmprAlg, bool legacy) {
+  int32_t              nIn = (int32_t)ds->data.size();
+  std::vector<uint8_t> in(ds->data);
+  std::vector<uint8_t> out(nIn * 2 + 1024);
+  std::vector<uint8_t> buf(nIn * 2 + 1024);
+  int32_t              nOut = 0;
+
+  for (auto _ : state) {
+    nOut = doCompress(&ds->codec, legacy, in.data(), nIn, ds->nEle, out.data(), out.size(), cmprAlg, buf.data(),
+                      buf.size());
+    benchmark::DoNotOptimize(nOut);
+  }
+
+  if (nOut <= 0) {
+    state.SkipWithError("compress failed");
+    return;
+  }
+  state.SetBytesProcessed(state.iterations() * nIn);
+  state.counters["ratio"] = (double)nIn / nOut;
+}
+
+void benchDecompress(benchmark::State &state, const SDataset *ds, uint32_t cmprAlg, bool legacy, ESimdMode mode) {
+  if (!setSimdMode(mode)) {
+    state.SkipWithError("instruction set not supported");
+    return;
+  }
+
+  int32_t              nIn = (int32_t)ds->data.size();
+  std::vector<uint8_t> in(ds->data);
+  std::vector<uint8_t> cmpr(nIn * 2 + 1024);
+  std::vector<uint8_t> out(nIn + 1024);
+  std::vector<uint8_t> buf(nIn * 2 + 1024);
+
+  int32_t nCmpr = doCompress(&ds->codec, legacy, in.data(), nIn, ds->nEle, cmpr.data(), cmpr.size(), cmprAlg,
+                             buf.data(), buf.size());
+  if (nCmpr <= 0) {
+    state.SkipWithError("compress failed");
+    return;
+  }
+
+  int32_t nOut = 0;
+  for (auto _ : state) {
+    nOut = doDecompress(&ds->codec, legacy, cmpr.data(), nCmpr, ds->nEle, out.data(), out.size(), cmprAlg, buf.data(),
+                        buf.size());
+    benchmark::DoNotOptimize(nOut);
+  }
+
+  if (nOut != nIn || memcmp(out.data(), in.data(), nIn) != 0) {
+    state.SkipWithError("decompressed data mismatch");
+  }
+  state.SetBytesProcessed(state.iterations() * nIn);
+  state.counters["ratio"] = (double)nIn / nCmpr;
+
+  setSimdMode(SIMD_NONE);
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  benchmark::Initialize(&argc, argv);
+
+  static std::vector<SDataset> datasets = genDatasets();
+  for (int32_t i = 1; i < argc; i++) {
+    SDataset ds;
+    if (!loadDataset(argv[i], &ds)) {
+      fprintf(stderr, "invalid recorded column:%s, expect <type>=<file>\n", argv[i]);
+      return 1;
+    }
+    datasets.push_back(ds);
+  }
+
+  for (const SDataset &ds : datasets) {
+    for (const auto &l2 : kL2) {
+      std::string name = ds.name + "/" + l2.name;
+      uint32_t    cmprAlg = 0;
+      SET_COMPRESS(ds.codec.l1, l2.l2, L2_LVL_MEDIUM, cmprAlg);
+      benchmark::RegisterBenchmark((name + "/compress").c_str(), benchCompress, &ds, cmprAlg, false);
+      for (int32_t mode = SIMD_NONE; mode <= SIMD_AVX512; mode++) {
+        benchmark::RegisterBenchmark((name + "/decompress/" + kSimdNames[mode]).c_str(), benchDecompress, &ds, cmprAlg,
+                                     false, (ESimdMode)mode);
+      }
+    }
+
+    for (const auto &legacy : kLegacy) {
+      std::string name = ds.name + "/" + legacy.name;
+      benchmark::RegisterBenchmark((name + "/compress").c_str(), benchCompress, &ds, (uint32_t)legacy.stage, true);
+      for (int32_t mode = SIMD_NONE; mode <= SIMD_AVX512; mode++) {
+        benchmark::RegisterBenchmark((name + "/decompress/" + kSimdNames[mode]).c_str(), benchDecompress, &ds,
+                                     (uint32_t)legacy.stage, true, (ESimdMode)mode);
+      }
+    }
+  }
+
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
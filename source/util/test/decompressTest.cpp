@@ -6,9 +6,26 @@
 
 namespace {
 
+// Restores the SIMD switches on scope exit, so a test that forces a code path,
+// or fails an ASSERT halfway, does not change the path taken by later tests.
+struct SSimdFlagGuard {
+  char simdEnable = tsSIMDEnable;
+  char avx2Supported = tsAVX2Supported;
+  char avx512Supported = tsAVX512Supported;
+  char avx512Enable = tsAVX512Enable;
+
+  ~SSimdFlagGuard() {
+    tsSIMDEnable = simdEnable;
+    tsAVX2Supported = avx2Supported;
+    tsAVX512Supported = avx512Supported;
+    tsAVX512Enable = avx512Enable;
+  }
+};
+
 }  // namespace
 
 TEST(utilTest, decompress_ts_test) {
+  SSimdFlagGuard guard;
   {
     tsSIMDEnable = 1;
     tsAVX2Supported = 1;
@@ -79,6 +96,7 @@ TEST(utilTest, decompress_ts_test) {
 }
 
 TEST(utilTest, decompress_bigint_avx2_test) {
+  SSimdFlagGuard guard;
   {
     tsSIMDEnable = 1;
     tsAVX2Supported = 1;
@@ -101,6 +119,7 @@ TEST(utilTest, decompress_bigint_avx2_test) {
 }
 
 TEST(utilTest, decompress_int_avx2_test) {
+  SSimdFlagGuard guard;
   {
     tsSIMDEnable = 1;
     tsAVX2Supported = 1;
@@ -121,6 +140,51 @@ TEST(utilTest, decompress_int_avx2_test) {
   }
 }
 
+TEST(utilTest, decompress_float_simd_test) {
+  int32_t  num = 1029;  // not a multiple of the batch size of any SIMD implementation
+  uint32_t v = 100;
+
+  float*  pFloat = static_cast<float*>(taosMemoryCalloc(num, sizeof(float)));
+  double* pDouble = static_cast<double*>(taosMemoryCalloc(num, sizeof(double)));
+
+  double walk = 220.0;
+  for (int32_t i = 0; i < num; ++i) {
+    walk += (taosRandR(&v) % 100 - 50) * 0.01;
+    pFloat[i] = (i % 7 == 0) ? pFloat[i > 0 ? i - 1 : 0] : (float)walk;
+    pDouble[i] = (i % 7 == 0) ? pDouble[i > 0 ? i - 1 : 0] : walk;
+  }
+
+  int32_t bufSize = num * sizeof(double) + 64;
+  char*   pBuf = static_cast<char*>(taosMemoryMalloc(bufSize));
+  char*   pOutput = static_cast<char*>(taosMemoryMalloc(bufSize));
+
+  SSimdFlagGuard guard;
+
+  for (int32_t mode = 0; mode < 3; ++mode) {
+    tsSIMDEnable = (mode > 0);
+    tsAVX2Supported = (mode > 0);
+    tsAVX512Supported = (mode == 2);
+    tsAVX512Enable = (mode == 2);
+
+    for (int32_t n = 0; n <= num; n += (n < 40) ? 1 : 99) {
+      int32_t len = tsCompressFloat(pFloat, n * sizeof(float), n, pBuf, bufSize, ONE_STAGE_COMP, NULL, 0);
+      memset(pOutput, 0, bufSize);
+      tsDecompressFloat(pBuf, len, n, pOutput, bufSize, ONE_STAGE_COMP, NULL, 0);
+      ASSERT_EQ(memcmp(pOutput, pFloat, n * sizeof(float)), 0);
+
+      len = tsCompressDouble(pDouble, n * sizeof(double), n, pBuf, bufSize, ONE_STAGE_COMP, NULL, 0);
+      memset(pOutput, 0, bufSize);
+      tsDecompressDouble(pBuf, len, n, pOutput, bufSize, ONE_STAGE_COMP, NULL, 0);
+      ASSERT_EQ(memcmp(pOutput, pDouble, n * sizeof(double)), 0);
+    }
+  }
+
+  taosMemoryFree(pFloat);
+  taosMemoryFree(pDouble);
+  taosMemoryFree(pBuf);
+  taosMemoryFree(pOutput);
+}
+
 TEST(utilTest, decompress_perf_test) {
   int32_t num = 10000;
 
@@ -0,0 +1,75 @@
+from util.log import *
+from util.cases import *
+from util.sql import *
+
+
+class TDTestCase:
+    """The columns not referenced by the filter of a table scan are loaded after the filter is evaluated on a clean file
+    block, check that their values are not left NULL."""
+
+    def init(self, conn, logSql, replicaVar=1):
+        self.replicaVar = int(replicaVar)
+        tdLog.debug("start to execute %s" % __file__)
+        tdSql.init(conn.cursor())
+
+        self.rowNum = 10000
+        self.ts = 1537146000000
+
+    def row(self, i):
+        # c6 is NULL on every 7th row, the other columns are never NULL
+        c6 = None if i % 7 == 0 else "v%d" % (i % 100)
+        return [i % 127, i, i * 10, i + 0.5, i % 1000 + 0.25, c6, i % 2 == 0]
+
+    def insertData(self, dbname):
+        tdSql.execute(f"create table {dbname}.ntb(ts timestamp, c1 tinyint, c2 int, c3 bigint, c4 double, c5 float, "
+                      f"c6 binary(10), c7 bool)")
+        batch = 500
+        for start in range(0, self.rowNum, batch):
+            values = []
+            for i in range(start, start + batch):
+                r = self.row(i)
+                c6 = "NULL" if r[5] is None else f"'{r[5]}'"
+                values.append(f"({self.ts + i}, {r[0]}, {r[1]}, {r[2]}, {r[3]}, {r[4]}, {c6}, {r[6]})")
+            tdSql.execute(f"insert into {dbname}.ntb values " + " ".join(values))
+        tdSql.execute(f"flush database {dbname}")
+
+    def checkRows(self, sql, expected):
+        tdSql.query(sql)
+        tdSql.checkRows(len(expected))
+        for r, i in enumerate(expected):
+            exp = self.row(i)
+            tdSql.checkData(r, 1, exp[0])
+            tdSql.checkData(r, 2, exp[1])
+            tdSql.checkData(r, 3, exp[2])
+            tdSql.checkData(r, 4, exp[3])
+            tdSql.checkData(r, 5, exp[5])
+            tdSql.checkData(r, 6, exp[6])
+
+    def run(self):
+        dbname = "db"
+        tdSql.prepare(dbname=dbname, drop=True, stt_trigger=1)
+        self.insertData(dbname)
+
+        # the filter refers to c5 only, so c1, c2, c3, c4, c6 and c7 are loaded in the second phase
+        cols = "ts, c1, c2, c3, c4, c6, c7"
+        expected = [i for i in range(self.rowNum) if i % 1000 + 0.25 > 990]
+        self.checkRows(f"select {cols} from {dbname}.ntb where c5 > 990 order by ts asc", expected)
+        self.checkRows(f"select {cols} from {dbname}.ntb where c5 > 990 order by ts desc", expected[::-1])
+
+        # a filter qualifying all rows of a block
+        expected = [i for i in range(self.rowNum) if i % 1000 + 0.25 < 2000]
+        tdSql.query(f"select count(*), sum(c2), count(c6) from {dbname}.ntb where c5 < 2000")
+        tdSql.checkData(0, 0, len(expected))
+        tdSql.checkData(0, 1, sum(expected))
+        tdSql.checkData(0, 2, len([i for i in expected if i % 7 != 0]))
+
+        # no rows qualify, the remained columns are not loaded
+        tdSql.query(f"select {cols} from {dbname}.ntb where c5 > 5000")
+        tdSql.checkRows(0)
+
+    def stop(self):
+        tdSql.close()
+        tdLog.success("%s successfully executed" % __file__)
+
+tdCases.addWindows(__file__, TDTestCase())
+tdCases.addLinux(__file__, TDTestCase())
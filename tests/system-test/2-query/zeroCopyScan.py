@@ -0,0 +1,69 @@
+from util.log import *
+from util.cases import *
+from util.sql import *
+
+
+class TDTestCase:
+    """A table scan without filter and offset hands the clean file blocks to the result block without copying the
+    columns. Check the results over many consecutive file blocks, with and without the filter and the offset, which
+    compact the result block in place."""
+
+    def init(self, conn, logSql, replicaVar=1):
+        self.replicaVar = int(replicaVar)
+        tdLog.debug("start to execute %s" % __file__)
+        tdSql.init(conn.cursor())
+
+        self.rowNum = 5000
+        self.ts = 1537146000000
+
+    def insertData(self, dbname):
+        tdSql.execute(f"create table {dbname}.ntb(ts timestamp, c1 int, c2 bigint, c3 double, c4 smallint)")
+        batch = 500
+        for start in range(0, self.rowNum, batch):
+            values = " ".join(f"({self.ts + i}, {i}, {i * 3}, {i + 0.5}, {i % 100})"
+                              for i in range(start, start + batch))
+            tdSql.execute(f"insert into {dbname}.ntb values {values}")
+        tdSql.execute(f"flush database {dbname}")
+
+    def checkRows(self, sql, expected):
+        tdSql.query(sql)
+        tdSql.checkRows(len(expected))
+        for r, i in enumerate(expected):
+            tdSql.checkData(r, 1, i)
+            tdSql.checkData(r, 2, i * 3)
+            tdSql.checkData(r, 3, i + 0.5)
+            tdSql.checkData(r, 4, i % 100)
+
+    def run(self):
+        dbname = "db"
+        # maxrows 200 splits the data into file blocks of 200 rows
+        tdSql.prepare(dbname=dbname, drop=True, maxrows=200, minrows=10, stt_trigger=1)
+        self.insertData(dbname)
+
+        cols = "ts, c1, c2, c3, c4"
+        self.checkRows(f"select {cols} from {dbname}.ntb", list(range(self.rowNum)))
+
+        # the filter keeps a few rows of each block
+        expected = [i for i in range(self.rowNum) if i % 100 < 3]
+        self.checkRows(f"select {cols} from {dbname}.ntb where c4 < 3", expected)
+
+        # the filter drops the first rows of a block only
+        expected = [i for i in range(self.rowNum) if i % 200 >= 150]
+        self.checkRows(f"select {cols} from {dbname}.ntb where c1 % 200 >= 150", expected)
+
+        # the offset trims the first rows of a block
+        self.checkRows(f"select {cols} from {dbname}.ntb limit 300 offset 250", list(range(250, 550)))
+
+        tdSql.query(f"select sum(c1), sum(c2), count(c3), max(c4) from {dbname}.ntb where c4 >= 50")
+        expected = [i for i in range(self.rowNum) if i % 100 >= 50]
+        tdSql.checkData(0, 0, sum(expected))
+        tdSql.checkData(0, 1, sum(expected) * 3)
+        tdSql.checkData(0, 2, len(expected))
+        tdSql.checkData(0, 3, 99)
+
+    def stop(self):
+        tdSql.close()
+        tdLog.success("%s successfully executed" % __file__)
+
+tdCases.addWindows(__file__, TDTestCase())
+tdCases.addLinux(__file__, TDTestCase())